@@ -0,0 +1,96 @@
+#ifndef AXIS_CURVE_H
+#define AXIS_CURVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * Axis Response Curves
+ *
+ * Reshapes stick and trigger travel before it is forwarded: a deadzone
+ * that hides a worn stick's drift, an outer deadzone so full deflection
+ * is reachable short of the gate, an anti-deadzone that starts output
+ * just past a game's own deadzone, and an expo curve that trades centre
+ * sensitivity for precision.  For a magnitude r on 0..full:
+ *
+ *   r <= deadzone            → 0
+ *   r >= full - outer        → full
+ *   otherwise  t = (r - deadzone) / (full - outer - deadzone)
+ *              s = t + expo% * (t³ - t)
+ *              out = anti + s * (full - anti)
+ *
+ * Sticks are shaped radially: the curve applies to the length of the
+ * (x, y) vector and the direction is kept, so the deadzone is a circle
+ * rather than a cross and diagonals behave like the axes.
+ *
+ * Everything after the deadzone test is fixed point.  axis_curve_init()
+ * samples the curve into a 257-entry table; evaluating it is one
+ * multiply, one table lookup and a linear interpolation.  A stick adds
+ * an integer square root (table seed, one Newton step) and one divide.
+ * With every setting 0 a curve is the identity and reports pass through
+ * untouched.
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+#define AXIS_CURVE_STICK_FULL   32767   /* gamepad_report_t stick radius */
+#define AXIS_CURVE_TRIGGER_FULL 1023    /* gamepad_report_t trigger max  */
+
+#define AXIS_CURVE_LUT_BITS     8
+#define AXIS_CURVE_LUT_SIZE     ((1 << AXIS_CURVE_LUT_BITS) + 1)
+
+/** Settings for one curve, in the units of the axis it shapes. */
+typedef struct {
+    uint16_t deadzone;  /* magnitudes up to this read as 0             */
+    uint16_t outer;     /* within this of full reads as full           */
+    uint16_t anti;      /* smallest output past the deadzone           */
+    uint16_t expo;      /* 0 = linear .. 100 = cubic                   */
+} axis_curve_cfg_t;
+
+typedef struct {
+    bool     identity;  /* all settings 0: pass values through         */
+    uint16_t full;
+    uint16_t dz;
+    uint16_t top;       /* full - outer                                */
+    uint32_t dz2;       /* dz², for the stick deadzone test            */
+    uint32_t inv_span;  /* 2^31 / (top - dz): (r - dz) → Q31 position  */
+    uint16_t lut[AXIS_CURVE_LUT_SIZE];
+} axis_curve_t;
+
+/** The curves applied to one report. */
+typedef struct {
+    bool         identity;  /* every curve is the identity */
+    axis_curve_t lstick;
+    axis_curve_t rstick;
+    axis_curve_t trigger;   /* lt and rt */
+} axis_curve_set_t;
+
+/**
+ * Build a curve.  Out-of-range settings are clamped so that at least
+ * one step of travel is left between the two deadzones.
+ * @param full  Largest magnitude of the axis (AXIS_CURVE_*_FULL).
+ */
+void axis_curve_init(axis_curve_t *c, const axis_curve_cfg_t *cfg,
+                     uint16_t full);
+
+/** Shape one magnitude (0..full; larger saturates to full). */
+uint16_t axis_curve_eval(const axis_curve_t *c, uint32_t r);
+
+/** Shape a stick radially, in place. */
+void axis_curve_stick(const axis_curve_t *c, int16_t *x, int16_t *y);
+
+/** Build all curves of a set. */
+void axis_curve_set_init(axis_curve_set_t *s,
+                         const axis_curve_cfg_t *lstick,
+                         const axis_curve_cfg_t *rstick,
+                         const axis_curve_cfg_t *trigger);
+
+/** Shape a report's sticks and triggers in place. */
+void axis_curve_set_apply(const axis_curve_set_t *s, gamepad_report_t *r);
+
+/** floor(sqrt(v)); exposed for the tests. */
+uint32_t axis_curve_isqrt(uint32_t v);
+
+#endif /* AXIS_CURVE_H */
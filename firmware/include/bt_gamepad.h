@@ -9,15 +9,45 @@
  * Bluetooth Gamepad Interface
  *
  * Manages Bluetooth Classic and BLE gamepad connections via Bluepad32.
- * Supports Xbox, PlayStation, Switch Pro, 8BitDo, and generic BT gamepads.
+ * Supports Xbox, PlayStation, Switch Pro, 8BitDo, and generic BT gamepads,
+ * up to BT_GAMEPAD_MAX at once.  Scanning stops while every slot is taken.
  *
  * Thread safety: Bluepad32 callbacks run on its internal task. This module
  * uses a spinlock to protect the shared report data so the main loop can
  * safely read it.
  */
 
-/** Maximum simultaneous Bluetooth gamepads (1 keeps things simple). */
-#define BT_GAMEPAD_MAX 1
+/**
+ * Maximum simultaneous Bluetooth gamepads.  Each slot is one player and
+ * one USB HID interface; a controller keeps its slot across reconnects
+ * (see bt_slot.h).
+ */
+#define BT_GAMEPAD_MAX 4
+
+/**
+ * How long one rumble command runs on the controller.  To keep a motor
+ * running, send its state again within this time.
+ */
+#define BT_GAMEPAD_RUMBLE_MS 500
+
+/**
+ * Largest native input report kept for passthrough: the DualShock 4's
+ * Bluetooth report 0x11 (see ds4_report.h).
+ */
+#define BT_GAMEPAD_RAW_MAX 78
+
+/** Native report formats kept for passthrough. */
+typedef enum {
+    BT_GAMEPAD_RAW_NONE,    /* not kept; use bt_gamepad_get_report() */
+    BT_GAMEPAD_RAW_DS4,     /* DualShock 4 Bluetooth input report    */
+} bt_gamepad_raw_kind_t;
+
+/** A controller's native input report, as received. */
+typedef struct {
+    bt_gamepad_raw_kind_t kind;
+    uint16_t len;
+    uint8_t  data[BT_GAMEPAD_RAW_MAX];
+} bt_gamepad_raw_t;
 
 typedef enum {
     BT_GAMEPAD_DISCONNECTED,
@@ -32,6 +62,12 @@ typedef enum {
  */
 typedef void (*bt_gamepad_event_cb_t)(uint8_t idx, bt_gamepad_state_t state);
 
+/**
+ * Callback invoked after a new report has been stored for a slot.
+ * Runs in Bluepad32's context: keep it to setting a flag.
+ */
+typedef void (*bt_gamepad_data_cb_t)(uint8_t idx);
+
 /**
  * Initialize the Bluetooth gamepad subsystem.
  *
@@ -42,25 +78,90 @@ typedef void (*bt_gamepad_event_cb_t)(uint8_t idx, bt_gamepad_state_t state);
  */
 void bt_gamepad_init(bt_gamepad_event_cb_t event_cb);
 
+/**
+ * Set the new-report callback (may be NULL).  Lets the main loop
+ * forward input as soon as it arrives instead of polling for it.
+ */
+void bt_gamepad_set_data_cb(bt_gamepad_data_cb_t data_cb);
+
 /**
  * Check if a gamepad is connected at the given slot.
  */
 bool bt_gamepad_is_connected(uint8_t idx);
 
+/**
+ * Number of connected gamepads.
+ */
+uint8_t bt_gamepad_connected_count(void);
+
 /**
  * Get the latest gamepad report for the given slot.
  *
- * @param idx     Gamepad slot (0-based, must be < BT_GAMEPAD_MAX).
- * @param report  Output: filled with current controller state.
+ * Also returns the buttons pressed since the previous call for this
+ * slot, including taps already released again, so the caller can keep
+ * them from being lost between samples (see button_latch.h).
+ *
+ * @param idx      Gamepad slot (0-based, must be < BT_GAMEPAD_MAX).
+ * @param report   Output: filled with current controller state.
+ * @param pressed  Output: GAMEPAD_BTN_* press edges since the last call
+ *                 (may be NULL, which still consumes them).
  * @return true if a connected gamepad provided data; false if no gamepad.
  */
-bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report);
+bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report,
+                           uint16_t *pressed);
+
+/**
+ * Get the newest motion sample for the given slot, if one arrived since
+ * the last call.  Only controllers with motion sensors (DualShock 4,
+ * DualSense, Switch Pro) produce samples.
+ *
+ * @param idx     Gamepad slot (0-based).
+ * @param motion  Output: gyro, accelerometer and arrival time.
+ * @return true if *motion is a new sample.
+ */
+bool bt_gamepad_get_motion(uint8_t idx, gamepad_motion_t *motion);
+
+/**
+ * Which native report format, if any, this slot's controller keeps.
+ * Fixed while the controller stays connected.
+ */
+bt_gamepad_raw_kind_t bt_gamepad_raw_kind(uint8_t idx);
+
+/**
+ * Get the controller's newest native input report, if one arrived since
+ * the last call.  Lets a matching USB personality forward it nearly
+ * verbatim instead of through gamepad_report_t, keeping every field the
+ * controller sends.  bt_gamepad_get_report() keeps working alongside.
+ * Withheld while button_map overrides remap this controller, since the
+ * native report would carry the buttons and axes unmapped.
+ *
+ * @param idx  Gamepad slot (0-based).
+ * @param raw  Output: the report, starting at its report ID (truncated
+ *             to BT_GAMEPAD_RAW_MAX).
+ * @return true if *raw is a new report.
+ */
+bool bt_gamepad_get_raw(uint8_t idx, bt_gamepad_raw_t *raw);
 
 /**
- * Enable or disable discovery of new Bluetooth controllers.
+ * Drive a controller's rumble motors and player LEDs.
  *
- * @param enabled  true to accept new pairings, false to stop scanning.
+ * Only the latest state per slot is kept: it is handed to Bluepad32's
+ * context and sent from there, replacing any state not yet sent.  The
+ * caller bounds the rate (see output_coalesce.h).  Controllers without
+ * rumble or LEDs ignore that part.
+ *
+ * @param idx  Gamepad slot (0-based).
+ * @param out  Motors run for BT_GAMEPAD_RUMBLE_MS; leds == 0 leaves the
+ *             controller's LEDs as they are.
+ */
+void bt_gamepad_set_output(uint8_t idx, const gamepad_output_t *out);
+
+/**
+ * Set the button_map overrides (see button_map.h) for every controller,
+ * on top of each controller family's defaults.  Cheap when unchanged, so
+ * it can be called with the current setting every pass; a change is
+ * compiled in Bluepad32's context shortly after.
  */
-void bt_gamepad_set_pairing(bool enabled);
+void bt_gamepad_set_button_map(const char *overrides);
 
 #endif /* BT_GAMEPAD_H */
@@ -20,4 +20,12 @@ int16_t bt_gamepad_scale_axis(int32_t value);
  */
 uint16_t bt_gamepad_clamp_trigger(int32_t value);
 
+/**
+ * Clamp a Bluepad32 gyro/accelerometer value to int16_t.
+ *
+ * Bluepad32 widens the controllers' 16-bit sensor counts to int32, so
+ * in-range values pass through unchanged; anything outside saturates.
+ */
+int16_t bt_gamepad_clamp_motion(int32_t value);
+
 #endif /* BT_GAMEPAD_CONVERT_H */
@@ -0,0 +1,57 @@
+#ifndef BT_SLOT_H
+#define BT_SLOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bt_gamepad.h"
+
+/**
+ * Bluetooth Controller Slot Assignment
+ *
+ * Maps controllers (by Bluetooth address) to player slots 0 ..
+ * BT_GAMEPAD_MAX - 1, each of which is its own USB HID interface.  A
+ * controller that reconnects gets its previous slot back, so player 2
+ * stays player 2 after a controller sleeps or runs out of battery:
+ *
+ *   1. a controller seen before gets its old slot, if that slot is free;
+ *   2. otherwise the lowest slot never used since boot;
+ *   3. otherwise the free slot whose controller left longest ago;
+ *   4. otherwise none (all slots connected).
+ *
+ * Assignments live in RAM, so they reset with the MCU.  Pure logic, so
+ * it can be unit-tested on the host.
+ */
+
+#define BT_SLOT_ADDR_LEN 6
+#define BT_SLOT_NONE     (-1)
+
+typedef struct {
+    uint8_t  addr[BT_SLOT_ADDR_LEN];
+    bool     used;          /* addr is valid */
+    bool     connected;
+    uint32_t released;      /* stamp of the last release */
+} bt_slot_t;
+
+typedef struct {
+    bt_slot_t slot[BT_GAMEPAD_MAX];
+    uint32_t  stamp;        /* increments on every release */
+} bt_slot_table_t;
+
+void bt_slot_init(bt_slot_table_t *t);
+
+/**
+ * Pick a slot for a connecting controller and mark it connected.
+ *
+ * @return  Slot index, or BT_SLOT_NONE if every slot is connected.
+ *          A controller that is already connected keeps its slot.
+ */
+int bt_slot_assign(bt_slot_table_t *t, const uint8_t addr[BT_SLOT_ADDR_LEN]);
+
+/** Mark a slot disconnected; it stays reserved for the same address. */
+void bt_slot_release(bt_slot_table_t *t, int slot);
+
+/** Connected controllers. */
+int bt_slot_connected_count(const bt_slot_table_t *t);
+
+#endif /* BT_SLOT_H */
@@ -0,0 +1,53 @@
+#ifndef BUTTON_LATCH_H
+#define BUTTON_LATCH_H
+
+#include <stdint.h>
+
+/**
+ * Button Press Latching
+ *
+ * The main loop samples each controller's latest report, so a button
+ * pressed and released between two samples (a fast tap on a 1 ms BT
+ * link while a long CDC command runs) would never reach the host.  The
+ * Bluetooth layer therefore also reports which buttons were pressed
+ * since the last sample (bt_gamepad_get_report), and this latch turns
+ * those press edges into buttons for the next USB report:
+ *
+ *   - pressed and already released: reported pressed for one report,
+ *     released in the one after;
+ *   - released and pressed again while the host still sees it held:
+ *     reported released for one report, pressed again in the next.
+ *
+ * A press is only consumed once its report was actually sent
+ * (button_latch_sent), so a busy endpoint delays it instead of losing
+ * it.  Several presses of one button between two reports count as one.
+ *
+ * Single-threaded: call from the main loop only.  Pure logic, so it can
+ * be unit-tested on the host.
+ */
+
+typedef struct {
+    uint16_t held;      /* latest raw buttons                        */
+    uint16_t owed;      /* press edges not yet shown to the host     */
+    uint16_t pending;   /* forced presses for the next report        */
+    uint16_t last_out;  /* buttons in the last report sent           */
+    uint32_t latched;   /* presses plain sampling would have dropped */
+} button_latch_t;
+
+/** Forget all edges (e.g. controller disconnected). Keeps the counter. */
+void button_latch_reset(button_latch_t *l);
+
+/**
+ * Add a sample and return the buttons to send.
+ *
+ * @param held     Buttons currently down (GAMEPAD_BTN_* mask).
+ * @param pressed  Buttons that went down since the previous sample.
+ * @return  Buttons for the next report; repeatable until sent.
+ */
+uint16_t button_latch_merge(button_latch_t *l, uint16_t held,
+                            uint16_t pressed);
+
+/** The report with these buttons reached the host (or was consumed). */
+void button_latch_sent(button_latch_t *l, uint16_t buttons);
+
+#endif /* BUTTON_LATCH_H */
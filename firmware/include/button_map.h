@@ -0,0 +1,153 @@
+#ifndef BUTTON_MAP_H
+#define BUTTON_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * Button and Axis Remapping
+ *
+ * Turns the buttons a controller reports into GAMEPAD_BTN_* bits.  The
+ * input is Bluepad32's buttons and misc_buttons packed into one 14-bit
+ * mask (button_map_pack); each of those sources maps to one gamepad
+ * button or to nothing.  Stick and trigger axes can be moved too: a
+ * stick axis to any stick axis, optionally inverted, a trigger to
+ * either trigger.
+ *
+ * Each controller family has a default mapping.  Bluepad32 already
+ * names face buttons by position (BUTTON_A is the bottom one, even on a
+ * Nintendo pad where it is labelled B), so the defaults keep positions
+ * and send Capture, Share or touchpad click as GAMEPAD_BTN_MISC.  The
+ * button_map setting overrides them, as comma- or space-separated
+ * entries:
+ *
+ *   [family.]source=button      e.g.  "switch.a=b,switch.b=a,l2=l1"
+ *   [family.]axis=[-]axis       e.g.  "ly=-ly" (invert left Y),
+ *                                     "lx=rx,ly=ry,rx=lx,ry=ly"
+ *
+ *   family  xbox, ps, switch, other; without one, every family
+ *   source  a b x y l1 r1 l2 r2 l3 r3 guide select start capture
+ *   button  a b x y l1 r1 l3 r3 start select guide misc none
+ *   axis    lx ly rx ry (sticks), lt rt (triggers); none centres or
+ *           releases; '-' inverts a stick axis
+ *
+ * Later entries win.  An output axis nothing maps to reads centred (or
+ * released); one that two source axes map to takes the later source in
+ * lx ly rx ry lt rt order.  A mapping is compiled into two lookup tables indexed by
+ * the low byte and the high bits of the input mask, so converting a
+ * report is two loads and an OR whatever the mapping, plus an axis
+ * shuffle when the axes are not the identity.
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+/** Input bits: Bluepad32 buttons (bits 0..9) then misc_buttons. */
+typedef enum {
+    BUTTON_MAP_SRC_A,
+    BUTTON_MAP_SRC_B,
+    BUTTON_MAP_SRC_X,
+    BUTTON_MAP_SRC_Y,
+    BUTTON_MAP_SRC_L1,
+    BUTTON_MAP_SRC_R1,
+    BUTTON_MAP_SRC_L2,          /* digital trigger */
+    BUTTON_MAP_SRC_R2,
+    BUTTON_MAP_SRC_L3,
+    BUTTON_MAP_SRC_R3,
+    BUTTON_MAP_SRC_GUIDE,       /* MISC_BUTTON_SYSTEM */
+    BUTTON_MAP_SRC_SELECT,
+    BUTTON_MAP_SRC_START,
+    BUTTON_MAP_SRC_CAPTURE,
+    BUTTON_MAP_SRC_COUNT,
+} button_map_src_t;
+
+/** Axes, as sources and as outputs.  Sticks come before triggers. */
+typedef enum {
+    BUTTON_MAP_AXIS_LX,
+    BUTTON_MAP_AXIS_LY,
+    BUTTON_MAP_AXIS_RX,
+    BUTTON_MAP_AXIS_RY,
+    BUTTON_MAP_AXIS_LT,
+    BUTTON_MAP_AXIS_RT,
+    BUTTON_MAP_AXIS_COUNT,
+} button_map_axis_t;
+
+#define BUTTON_MAP_AXIS_STICKS  BUTTON_MAP_AXIS_LT  /* axes below are sticks */
+#define BUTTON_MAP_AXIS_INVERT  0x80    /* with an axis: negate it      */
+#define BUTTON_MAP_AXIS_NONE    0xFF    /* centred / released           */
+
+/** Longest override text (the button_map setting). */
+#define BUTTON_MAP_TEXT_MAX 79
+
+#define BUTTON_MAP_MISC_SHIFT BUTTON_MAP_SRC_GUIDE
+#define BUTTON_MAP_HI_SIZE    (1 << (BUTTON_MAP_SRC_COUNT - 8))
+
+/** Controller families with their own defaults and overrides. */
+typedef enum {
+    BUTTON_MAP_PAD_OTHER,
+    BUTTON_MAP_PAD_XBOX,
+    BUTTON_MAP_PAD_PS,
+    BUTTON_MAP_PAD_SWITCH,
+    BUTTON_MAP_PAD_COUNT,
+} button_map_pad_t;
+
+/**
+ * A mapping: the GAMEPAD_BTN_* bits each source sets (0 = dropped) and
+ * the output axis each source axis drives (button_map_axis_t, maybe
+ * with BUTTON_MAP_AXIS_INVERT, or BUTTON_MAP_AXIS_NONE).
+ */
+typedef struct {
+    uint16_t dst[BUTTON_MAP_SRC_COUNT];
+    uint8_t  axis[BUTTON_MAP_AXIS_COUNT];
+} button_map_spec_t;
+
+/** A compiled mapping. */
+typedef struct {
+    uint16_t lo[256];                   /* sources 0..7 */
+    uint16_t hi[BUTTON_MAP_HI_SIZE];    /* sources 8..  */
+    bool     axes_identity;             /* every axis stays put */
+    uint8_t  axis[BUTTON_MAP_AXIS_COUNT];   /* per output: its source */
+} button_map_t;
+
+/** Pack Bluepad32's buttons and misc_buttons into a source mask. */
+static inline uint16_t button_map_pack(uint32_t buttons, uint32_t misc)
+{
+    return (uint16_t)((buttons & ((1u << BUTTON_MAP_MISC_SHIFT) - 1)) |
+                      (misc & ((1u << (BUTTON_MAP_SRC_COUNT -
+                                       BUTTON_MAP_MISC_SHIFT)) - 1))
+                          << BUTTON_MAP_MISC_SHIFT);
+}
+
+/** GAMEPAD_BTN_* bits for a source mask. */
+static inline uint16_t button_map_apply(const button_map_t *m, uint16_t src)
+{
+    return m->lo[src & 0xFF] | m->hi[(src >> 8) & (BUTTON_MAP_HI_SIZE - 1)];
+}
+
+/** Move a report's axes as the mapping says, in place. */
+void button_map_apply_axes(const button_map_t *m, gamepad_report_t *r);
+
+/** The default mapping of a controller family. */
+void button_map_default(button_map_pad_t pad, button_map_spec_t *spec);
+
+/**
+ * Apply the overrides in @p text that concern @p pad to @p spec.
+ * @param spec  May be NULL to only check the syntax.
+ * @return false if any entry is malformed (spec is then partly updated).
+ */
+bool button_map_parse(const char *text, button_map_pad_t pad,
+                      button_map_spec_t *spec);
+
+/** Compile a mapping into its lookup tables. */
+void button_map_compile(button_map_t *m, const button_map_spec_t *spec);
+
+/**
+ * Compile @p pad's default mapping with @p overrides applied (malformed
+ * overrides are ignored).
+ * @return true if the overrides changed the default.
+ */
+bool button_map_build(button_map_t *m, button_map_pad_t pad,
+                      const char *overrides);
+
+#endif /* BUTTON_MAP_H */
@@ -0,0 +1,19 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * CRC-32 (ISO 3309 / zlib, reflected polynomial 0xEDB88320).
+ *
+ * Shared by the config blob and the firmware streaming path.  The
+ * result matches zlib's crc32(), so host tools (Python's zlib.crc32,
+ * `crc32` from libarchive, etc.) compute the same value for a .bin.
+ *
+ * Incremental: pass 0 for the first chunk, then the previous return
+ * value to continue over the next chunk.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif /* CRC32_H */
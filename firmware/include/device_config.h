@@ -5,11 +5,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "button_map.h"
+#include "wol_packet.h"
+
 /**
  * Device Configuration
  *
  * Persistent settings stored in flash.  The struct is serialized to a
- * fixed-size binary blob with a magic number and CRC-32 for integrity.
+ * compact tag-length-value blob (only non-default fields) with a magic
+ * number and CRC-32 for integrity.
  * Serialization/deserialization is pure logic — no hardware access —
  * so it can be unit-tested on the host.
  *
@@ -21,24 +25,131 @@
 #define DEVICE_CONFIG_WIFI_SSID_MAX     32
 #define DEVICE_CONFIG_WIFI_PASSWORD_MAX 63
 #define DEVICE_CONFIG_DEVICE_NAME_MAX   32
+#define DEVICE_CONFIG_WOL_MAC_MAX       WOL_MAC_STR_MAX
+#define DEVICE_CONFIG_BUTTON_MAP_MAX    BUTTON_MAP_TEXT_MAX
 
 #define DEVICE_CONFIG_DEFAULT_POWER_PULSE_MS   200
 #define DEVICE_CONFIG_DEFAULT_BOOT_TIMEOUT_MS  30000
 #define DEVICE_CONFIG_DEFAULT_DEVICE_NAME      "PadProxy"
+#define DEVICE_CONFIG_DEFAULT_USB_KEEPALIVE_MS 100
+#define DEVICE_CONFIG_DEFAULT_MOTION_REPORT    1
 
 #define DEVICE_CONFIG_POWER_PULSE_MIN   50
 #define DEVICE_CONFIG_POWER_PULSE_MAX   2000
 #define DEVICE_CONFIG_BOOT_TIMEOUT_MIN  5000
 #define DEVICE_CONFIG_BOOT_TIMEOUT_MAX  60000
+#define DEVICE_CONFIG_USB_KEEPALIVE_MAX 10000  /* 0 = send on change only */
+#define DEVICE_CONFIG_STICK_THRESH_MAX  4096   /* of -32768 .. 32767      */
+#define DEVICE_CONFIG_TRIG_THRESH_MAX   64     /* of 0 .. 1023            */
+#define DEVICE_CONFIG_USB_MODE_MAX      3      /* hid, xinput, ds4, switch */
+#define DEVICE_CONFIG_STICK_ZONE_MAX    16000  /* of 32767 stick radius   */
+#define DEVICE_CONFIG_TRIG_ZONE_MAX     400    /* of 0 .. 1023            */
+#define DEVICE_CONFIG_EXPO_MAX          100    /* percent cubic           */
+
+/* ── Schema ─────────────────────────────────────────────────────────── */
+
+/**
+ * Every setting is declared exactly once here.  The struct, defaults,
+ * validation, flash (de)serialization and the setup-protocol key table
+ * are all generated from this list, so adding a setting is one line.
+ *
+ *   X(name, type, lo, hi, default, flags)
+ *
+ *   type   STR: char[hi + 1]; lo/hi bound the string length
+ *          U16: uint16_t;     lo/hi bound the value
+ *   flags  DEVICE_CONFIG_F_* bits
+ *
+ * A field's position is its key id (binary setup protocol) and fixes its
+ * place in the v1 flash payload: append new fields, never reorder.
+ */
+#define DEVICE_CONFIG_FIELDS(X)                                             \
+    X(wifi_ssid,       STR, 0, DEVICE_CONFIG_WIFI_SSID_MAX,                 \
+      "", 0)                                                                \
+    X(wifi_password,   STR, 0, DEVICE_CONFIG_WIFI_PASSWORD_MAX,             \
+      "", DEVICE_CONFIG_F_SECRET)                                           \
+    X(power_pulse_ms,  U16, DEVICE_CONFIG_POWER_PULSE_MIN,                  \
+      DEVICE_CONFIG_POWER_PULSE_MAX,                                        \
+      DEVICE_CONFIG_DEFAULT_POWER_PULSE_MS, 0)                              \
+    X(boot_timeout_ms, U16, DEVICE_CONFIG_BOOT_TIMEOUT_MIN,                 \
+      DEVICE_CONFIG_BOOT_TIMEOUT_MAX,                                       \
+      DEVICE_CONFIG_DEFAULT_BOOT_TIMEOUT_MS, 0)                             \
+    X(device_name,     STR, 1, DEVICE_CONFIG_DEVICE_NAME_MAX,               \
+      DEVICE_CONFIG_DEFAULT_DEVICE_NAME, 0)                                 \
+    X(wol_mac,         STR, 0, DEVICE_CONFIG_WOL_MAC_MAX,                   \
+      "", DEVICE_CONFIG_F_MAC)                                              \
+    X(usb_keepalive_ms, U16, 0, DEVICE_CONFIG_USB_KEEPALIVE_MAX,            \
+      DEVICE_CONFIG_DEFAULT_USB_KEEPALIVE_MS, 0)                            \
+    X(stick_threshold, U16, 0, DEVICE_CONFIG_STICK_THRESH_MAX, 0, 0)        \
+    X(trigger_threshold, U16, 0, DEVICE_CONFIG_TRIG_THRESH_MAX, 0, 0)       \
+    X(motion_report,   U16, 0, 1, DEVICE_CONFIG_DEFAULT_MOTION_REPORT, 0)   \
+    X(usb_mode,        U16, 0, DEVICE_CONFIG_USB_MODE_MAX, 0, 0)            \
+    X(lstick_deadzone, U16, 0, DEVICE_CONFIG_STICK_ZONE_MAX, 0, 0)          \
+    X(lstick_outer,    U16, 0, DEVICE_CONFIG_STICK_ZONE_MAX, 0, 0)          \
+    X(lstick_anti,     U16, 0, DEVICE_CONFIG_STICK_ZONE_MAX, 0, 0)          \
+    X(lstick_expo,     U16, 0, DEVICE_CONFIG_EXPO_MAX, 0, 0)                \
+    X(rstick_deadzone, U16, 0, DEVICE_CONFIG_STICK_ZONE_MAX, 0, 0)          \
+    X(rstick_outer,    U16, 0, DEVICE_CONFIG_STICK_ZONE_MAX, 0, 0)          \
+    X(rstick_anti,     U16, 0, DEVICE_CONFIG_STICK_ZONE_MAX, 0, 0)          \
+    X(rstick_expo,     U16, 0, DEVICE_CONFIG_EXPO_MAX, 0, 0)                \
+    X(trigger_deadzone, U16, 0, DEVICE_CONFIG_TRIG_ZONE_MAX, 0, 0)          \
+    X(trigger_outer,   U16, 0, DEVICE_CONFIG_TRIG_ZONE_MAX, 0, 0)           \
+    X(trigger_anti,    U16, 0, DEVICE_CONFIG_TRIG_ZONE_MAX, 0, 0)           \
+    X(trigger_expo,    U16, 0, DEVICE_CONFIG_EXPO_MAX, 0, 0)                \
+    X(button_map,      STR, 0, DEVICE_CONFIG_BUTTON_MAP_MAX,                \
+      "", DEVICE_CONFIG_F_BUTTON_MAP)
+
+/** Field flags. */
+#define DEVICE_CONFIG_F_SECRET     0x01  /* never echoed back to the host  */
+#define DEVICE_CONFIG_F_MAC        0x02  /* empty or a MAC (wol_parse_mac) */
+#define DEVICE_CONFIG_F_BUTTON_MAP 0x04  /* overrides (button_map_parse)   */
+
+/* Per-type expansions used by the generators below. */
+#define DEVICE_CONFIG_CTYPE_STR(name, hi)  char name[(hi) + 1];
+#define DEVICE_CONFIG_CTYPE_U16(name, hi)  uint16_t name;
+#define DEVICE_CONFIG_SIZE_STR(hi)         ((hi) + 1)
+#define DEVICE_CONFIG_SIZE_U16(hi)         2
+
+#define DEVICE_CONFIG_X_MEMBER(name, type, lo, hi, def, flags) \
+    DEVICE_CONFIG_CTYPE_##type(name, hi)
+#define DEVICE_CONFIG_X_ID(name, type, lo, hi, def, flags) \
+    DEVICE_CONFIG_ID_##name,
 
 typedef struct {
-    char     wifi_ssid[DEVICE_CONFIG_WIFI_SSID_MAX + 1];
-    char     wifi_password[DEVICE_CONFIG_WIFI_PASSWORD_MAX + 1];
-    uint16_t power_pulse_ms;
-    uint16_t boot_timeout_ms;
-    char     device_name[DEVICE_CONFIG_DEVICE_NAME_MAX + 1];
+    DEVICE_CONFIG_FIELDS(DEVICE_CONFIG_X_MEMBER)
 } device_config_t;
 
+/** Field ids, in schema order. */
+typedef enum {
+    DEVICE_CONFIG_FIELDS(DEVICE_CONFIG_X_ID)
+    DEVICE_CONFIG_FIELD_COUNT
+} device_config_id_t;
+
+typedef enum {
+    DEVICE_CONFIG_TYPE_STR,
+    DEVICE_CONFIG_TYPE_U16,
+} device_config_type_t;
+
+/** Descriptor for one schema field. */
+typedef struct {
+    const char          *name;
+    device_config_type_t type;
+    uint16_t             offset;   /* offsetof in device_config_t        */
+    uint16_t             size;     /* bytes in struct and v1 payload     */
+    uint16_t             lo, hi;   /* U16: value range; STR: length range */
+    uint16_t             def_u16;  /* U16 default                        */
+    const char          *def_str;  /* STR default                        */
+    uint8_t              flags;
+} device_config_field_t;
+
+/** Schema table, indexed by device_config_id_t. */
+extern const device_config_field_t device_config_fields[DEVICE_CONFIG_FIELD_COUNT];
+
+/**
+ * Look up a field id by name.
+ * @return  Field id, or -1 if unknown.
+ */
+int device_config_find(const char *name);
+
 /**
  * Initialize a config struct with compiled-in defaults.
  */
@@ -53,15 +164,16 @@ bool device_config_validate(const device_config_t *cfg);
 /**
  * Required buffer size for serialization.
  */
-#define DEVICE_CONFIG_SERIAL_SIZE 256
+#define DEVICE_CONFIG_SERIAL_SIZE 512
 
 /**
  * Serialize config to a binary buffer suitable for flash storage.
  *
- * Format: [magic: 4B][version: 2B][payload][crc32: 4B]
+ * Format: [magic: 4B][version: 2B][length: 2B][tag, len, value]...[crc32: 4B]
+ * Only fields that differ from their default are written.
  *
  * @param cfg  Config to serialize.
- * @param buf  Output buffer (must be >= DEVICE_CONFIG_SERIAL_SIZE bytes).
+ * @param buf  Output buffer (DEVICE_CONFIG_SERIAL_SIZE bytes always fits).
  * @param len  Size of buf.
  * @return     Number of bytes written, or -1 on error.
  */
@@ -71,9 +183,11 @@ int device_config_serialize(const device_config_t *cfg,
 /**
  * Deserialize config from a binary buffer.
  *
- * Validates magic, version, and CRC.  On failure the output struct is
- * left unchanged and false is returned (caller should fall back to
- * defaults).
+ * Validates magic and CRC.  Version 1 fixed-layout blobs are migrated;
+ * version 2+ records with unknown tags or unusable values are skipped
+ * and those fields keep their defaults, so settings survive firmware
+ * upgrades and downgrades.  On failure the output struct is left
+ * unchanged and false is returned (caller should fall back to defaults).
  *
  * @param cfg  Output config struct.
  * @param buf  Input buffer.
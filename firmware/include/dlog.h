@@ -0,0 +1,161 @@
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Deferred Binary Log
+ *
+ * printf() to the UART blocks for roughly 87 µs per character at
+ * 115200 baud, so a single log line in a USB or Bluetooth callback can
+ * stall the main loop for over a millisecond.  DLOG_*() instead records
+ * the format string pointer, up to DLOG_MAX_ARGS integer/pointer
+ * arguments and a timestamp into a fixed RAM ring — a few stores and
+ * one atomic increment — and the text is produced later, in idle time
+ * or when the host asks for it with "log dump".
+ *
+ * The format string pointer is the message ID: it lives in flash, and
+ * the only decoder is dlog_format() on the device itself, so no
+ * interning table is needed.  Consequences:
+ *   - format strings must be string literals;
+ *   - %s arguments must have static lifetime (literals, state names);
+ *   - only integer and pointer conversions are supported (no floats).
+ * Format strings carry no trailing newline.
+ *
+ * Writers never block or lock and may run in interrupt context or on
+ * the other core.  Once the ring is full the oldest entries are
+ * overwritten; readers each hold a cursor and count what they missed.
+ *
+ * Messages less severe than DLOG_LEVEL are removed at compile time (the
+ * arguments are still type-checked but never evaluated).  Build with e.g.
+ * -DDLOG_LEVEL=DLOG_LEVEL_DEBUG to keep debug messages.
+ *
+ * This module is pure logic apart from the clock callback, so it can
+ * be unit-tested on the host.
+ */
+
+#define DLOG_LEVEL_ERROR  0
+#define DLOG_LEVEL_WARN   1
+#define DLOG_LEVEL_INFO   2
+#define DLOG_LEVEL_DEBUG  3
+
+#ifndef DLOG_LEVEL
+#define DLOG_LEVEL DLOG_LEVEL_INFO
+#endif
+
+/** Ring capacity in entries (power of two). */
+#ifndef DLOG_RING_SIZE
+#define DLOG_RING_SIZE 64
+#endif
+
+#define DLOG_MAX_ARGS 4
+
+/** Longest line dlog_format() produces (plus NUL). */
+#define DLOG_LINE_MAX 128
+
+_Static_assert((DLOG_RING_SIZE & (DLOG_RING_SIZE - 1)) == 0,
+               "DLOG_RING_SIZE must be a power of two");
+
+/** Microsecond clock used to timestamp entries. */
+typedef uint32_t (*dlog_clock_us_t)(void);
+
+/** One decoded log record. */
+typedef struct {
+    const char *fmt;
+    uint32_t    seq;                  /* 0, 1, 2, ... in write order */
+    uint32_t    time_us;
+    uint8_t     level;
+    uint8_t     nargs;
+    uintptr_t   args[DLOG_MAX_ARGS];
+} dlog_entry_t;
+
+/** Independent read position; start zeroed to read from the oldest. */
+typedef struct {
+    uint32_t next;      /* sequence number of the next entry to read  */
+    uint32_t lost;      /* entries overwritten before this reader got them */
+} dlog_cursor_t;
+
+/**
+ * Empty the ring and set the timestamp clock (may be NULL: time 0).
+ */
+void dlog_init(dlog_clock_us_t clock_us);
+
+/**
+ * Record one entry.  Normally called through the DLOG_*() macros.
+ */
+void dlog_push(uint8_t level, const char *fmt, uint8_t nargs,
+               uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3);
+
+/** Total entries written since dlog_init() (wraps). */
+uint32_t dlog_written(void);
+
+/**
+ * Position a cursor at the oldest entry still in the ring, so a dump
+ * shows the retained history without counting older entries as lost.
+ */
+void dlog_cursor_oldest(dlog_cursor_t *c);
+
+/**
+ * Read the next entry for this cursor.
+ *
+ * @return  true with *out filled, or false when the reader has caught
+ *          up (or the next entry is still being written).
+ */
+bool dlog_read(dlog_cursor_t *c, dlog_entry_t *out);
+
+/**
+ * Render an entry as "<s>.<us> <L> <message>" (no newline), e.g.
+ * "12.345678 I [usb_hid] USB mounted".  The 32-bit microsecond clock
+ * wraps every ~71 minutes; seq orders entries regardless.
+ *
+ * @return  Length written (excluding NUL), truncated to size - 1.
+ */
+int dlog_format(const dlog_entry_t *e, char *buf, size_t size);
+
+/* ── Logging macros ─────────────────────────────────────────────────── */
+
+#define DLOG__A(x) ((uintptr_t)(x))
+
+#define DLOG__0(l, f)             dlog_push(l, f, 0, 0, 0, 0, 0)
+#define DLOG__1(l, f, a)          dlog_push(l, f, 1, DLOG__A(a), 0, 0, 0)
+#define DLOG__2(l, f, a, b)       dlog_push(l, f, 2, DLOG__A(a), DLOG__A(b), 0, 0)
+#define DLOG__3(l, f, a, b, c)    dlog_push(l, f, 3, DLOG__A(a), DLOG__A(b), \
+                                            DLOG__A(c), 0)
+#define DLOG__4(l, f, a, b, c, d) dlog_push(l, f, 4, DLOG__A(a), DLOG__A(b), \
+                                            DLOG__A(c), DLOG__A(d))
+
+#define DLOG__PICK(_f, _1, _2, _3, _4, name, ...) name
+#define DLOG__WRITE(l, ...) \
+    DLOG__PICK(__VA_ARGS__, DLOG__4, DLOG__3, DLOG__2, DLOG__1, DLOG__0, \
+               _unused)(l, __VA_ARGS__)
+
+/* Filtered levels compile to dead code so arguments are still checked */
+#define DLOG__OFF(l, ...) do { if (0) DLOG__WRITE(l, __VA_ARGS__); } while (0)
+
+#if DLOG_LEVEL >= DLOG_LEVEL_ERROR
+#define DLOG_ERROR(...) DLOG__WRITE(DLOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define DLOG_ERROR(...) DLOG__OFF(DLOG_LEVEL_ERROR, __VA_ARGS__)
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_WARN
+#define DLOG_WARN(...)  DLOG__WRITE(DLOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define DLOG_WARN(...)  DLOG__OFF(DLOG_LEVEL_WARN, __VA_ARGS__)
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_INFO
+#define DLOG_INFO(...)  DLOG__WRITE(DLOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define DLOG_INFO(...)  DLOG__OFF(DLOG_LEVEL_INFO, __VA_ARGS__)
+#endif
+
+#if DLOG_LEVEL >= DLOG_LEVEL_DEBUG
+#define DLOG_DEBUG(...) DLOG__WRITE(DLOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define DLOG_DEBUG(...) DLOG__OFF(DLOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+
+#endif /* DLOG_H */
@@ -0,0 +1,96 @@
+#ifndef DS4_REPORT_H
+#define DS4_REPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * DualShock 4 Native Reports
+ *
+ * A DualShock 4 sends the same input report over Bluetooth as over USB,
+ * only framed differently, so a DS4 can be forwarded to a host that
+ * expects a USB DS4 without going through gamepad_report_t: sticks,
+ * 8-bit triggers, touchpad, IMU and battery all pass through untouched.
+ *
+ * USB input report (64 bytes):
+ *   Offset  Size  Field
+ *   0       1     Report ID 0x01
+ *   1       4     LX, LY, RX, RY (uint8, 0x80 centred)
+ *   5       3     Hat (low nibble, 8 = centred), buttons, PS, counter
+ *   8       2     L2, R2 (uint8)
+ *   10      3     Sensor timestamp, temperature
+ *   13      12    Gyro X/Y/Z, accel X/Y/Z (int16)
+ *   25      39    Status, battery, touchpad packets
+ *
+ * Bluetooth sends report 0x11: ID, two header bytes, the same 63 payload
+ * bytes as USB offsets 1-63, then padding and a CRC-32.  Until the host
+ * reads feature report 0x02 the controller sends a basic report 0x01
+ * instead, carrying only offsets 1-9 (sticks, buttons, triggers).
+ *
+ * Other controllers reach a DS4 host through ds4_report_from_gamepad(),
+ * which fills the same layout from gamepad_report_t.
+ *
+ * Output report 0x05 (host → device) carries the motors and lightbar;
+ * feature reports 0x02 (IMU calibration), 0x81 (MAC) and 0xA3 (firmware)
+ * answer the host's GET_REPORTs at start-up.
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+#define DS4_REPORT_ID       0x01
+#define DS4_REPORT_LEN      64
+#define DS4_BT_REPORT_ID    0x11
+#define DS4_BT_HEADER_LEN   3
+#define DS4_BT_BASIC_LEN    10
+
+#define DS4_OUTPUT_ID       0x05
+#define DS4_FEATURE_CALIB   0x02
+#define DS4_FEATURE_MAC     0x81
+#define DS4_FEATURE_FW      0xA3
+
+/** Size of the DS4 HID report descriptor in bytes. */
+#define DS4_REPORT_DESCRIPTOR_LEN 132
+
+/** The DS4 report descriptor: report 0x01 in, 0x05 out, three features. */
+extern const uint8_t ds4_report_descriptor[DS4_REPORT_DESCRIPTOR_LEN];
+
+/**
+ * Turn a DS4 Bluetooth input report into the USB input report.
+ *
+ * @param bt   Report as received, starting at the report ID.
+ * @param len  Its length.
+ * @param out  USB report; fields a basic report lacks read as zero.
+ * @return false if this is not a DS4 input report (out untouched).
+ */
+bool ds4_report_from_bt(const uint8_t *bt, uint16_t len,
+                        uint8_t out[DS4_REPORT_LEN]);
+
+/**
+ * Fill the USB input report from gamepad_report_t.  Touchpad and IMU
+ * read as idle.
+ *
+ * @param seq  Report counter, wraps at 64.
+ * @return Report length (DS4_REPORT_LEN).
+ */
+uint8_t ds4_report_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                uint8_t out[DS4_REPORT_LEN]);
+
+/**
+ * Parse host output report 0x05 (report ID first).
+ *
+ * @return true if it set the motors (out->strong/weak updated).
+ */
+bool ds4_report_to_output(const uint8_t *buf, uint16_t len,
+                          gamepad_output_t *out);
+
+/**
+ * Answer a feature report GET_REPORT.
+ *
+ * @param buf  Report data, after the report ID.
+ * @return Bytes written, or 0 for an unknown report (STALL).
+ */
+uint16_t ds4_report_feature(uint8_t id, uint8_t *buf, uint16_t len);
+
+#endif /* DS4_REPORT_H */
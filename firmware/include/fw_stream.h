@@ -0,0 +1,166 @@
+#ifndef FW_STREAM_H
+#define FW_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Firmware Streaming Receiver (USB CDC firmware update)
+ *
+ * Receives a raw .bin image over the CDC setup port after the text
+ * command "firmware <nbytes> <crc32>" and hands the payload to a sink
+ * (the OTA flash writer on the device, a buffer in tests).  This module
+ * is pure logic with no hardware dependencies so it can be unit-tested
+ * on the host.
+ *
+ * The host must never wait a USB round-trip per chunk, so frames are
+ * pipelined against a sliding acknowledgement window:
+ *
+ *   → firmware 245760 1a2b3c4d     text command (size decimal, CRC hex)
+ *   ← OK 16 1020                   window (frames), max payload per frame
+ *   → DATA 0, DATA 1, ... DATA 15  host may run <window> frames ahead
+ *   ←   ACK 3                      cumulative: frames 0..3 accepted
+ *   → DATA 16 ...                  window slides forward on every ACK
+ *   ← OK 245760 1843 133           bytes, elapsed ms, KB/s (CRC matched)
+ *   ← ERR <reason>                 or failure; device back in text mode
+ *
+ * Wire format (all integers little-endian):
+ *
+ *   DATA  [seq: u16][len: u16][payload: len bytes]
+ *   ACK   [0x06][seq: u16]
+ *
+ * Every frame except the last carries exactly `chunk` bytes.  Sequence
+ * numbers start at 0 and wrap at 65536.  USB bulk transfers are
+ * lossless and flow-controlled, so an out-of-order sequence number or a
+ * bad length is a host bug: the session is aborted rather than retried.
+ * ACKs are sent every FW_STREAM_ACK_EVERY frames (and on the last one)
+ * so upstream traffic stays small while the window never drains.
+ */
+
+/** Frames the host may send beyond the last acknowledged one. */
+#define FW_STREAM_WINDOW        16
+
+/** Maximum payload bytes per DATA frame (header + payload = 1 KB). */
+#define FW_STREAM_CHUNK_MAX     1020
+
+/** Size of a DATA frame header in bytes. */
+#define FW_STREAM_HEADER_SIZE   4
+
+/** Acknowledge every Nth frame (must divide into the window). */
+#define FW_STREAM_ACK_EVERY     4
+
+/** Size of an ACK message in bytes. */
+#define FW_STREAM_ACK_SIZE      3
+
+/** ACK message marker byte (ASCII ACK). */
+#define FW_STREAM_ACK_BYTE      0x06
+
+/** Abort the session if the host goes quiet for this long. */
+#define FW_STREAM_IDLE_TIMEOUT_MS 5000
+
+/**
+ * Consumes received payload bytes in order.
+ * @return false to abort the session (e.g. flash write failure).
+ */
+typedef bool (*fw_stream_sink_t)(const uint8_t *data, size_t len, void *ctx);
+
+typedef enum {
+    FW_STREAM_IDLE,
+    FW_STREAM_ACTIVE,
+    FW_STREAM_DONE,
+    FW_STREAM_ERROR_PROTOCOL,
+    FW_STREAM_ERROR_SINK,
+    FW_STREAM_ERROR_CRC,
+    FW_STREAM_ERROR_TIMEOUT,
+} fw_stream_status_t;
+
+typedef struct {
+    fw_stream_status_t status;
+
+    /* Session parameters */
+    uint32_t total_size;
+    uint32_t expected_crc;
+    fw_stream_sink_t sink;
+    void    *sink_ctx;
+
+    /* Progress */
+    uint32_t received;      /* payload bytes accepted so far          */
+    uint32_t crc;           /* running CRC-32 over accepted payload    */
+    uint16_t next_seq;      /* sequence number expected next           */
+    uint16_t frame_len;     /* payload length of the current frame     */
+    uint16_t frame_pos;     /* payload bytes consumed of current frame */
+    uint8_t  hdr[FW_STREAM_HEADER_SIZE];
+    uint8_t  hdr_pos;       /* header bytes collected (0..4)           */
+
+    /* Acknowledgements */
+    bool     ack_pending;
+    uint16_t ack_seq;
+
+    /* Timing */
+    uint32_t start_ms;
+    uint32_t last_rx_ms;
+    uint32_t end_ms;
+} fw_stream_t;
+
+/**
+ * Start a new session.
+ *
+ * @param s             Receiver state.
+ * @param total_size    Image size announced by the host (must be > 0).
+ * @param expected_crc  CRC-32 of the whole image announced by the host.
+ * @param sink          Payload consumer (must not be NULL).
+ * @param sink_ctx      Opaque pointer passed to sink.
+ * @param now_ms        Current time, for timeouts and throughput.
+ */
+void fw_stream_begin(fw_stream_t *s, uint32_t total_size,
+                     uint32_t expected_crc, fw_stream_sink_t sink,
+                     void *sink_ctx, uint32_t now_ms);
+
+/**
+ * Feed raw bytes received from the CDC port.
+ *
+ * Bytes may split frames arbitrarily.  Bytes arriving after the final
+ * frame are ignored.  Payload is passed to the sink directly from
+ * `data` without an intermediate copy.
+ *
+ * @return  Session status after consuming the bytes.
+ */
+fw_stream_status_t fw_stream_feed(fw_stream_t *s, const uint8_t *data,
+                                  size_t len, uint32_t now_ms);
+
+/**
+ * Check the idle timeout.  Call periodically while ACTIVE.
+ */
+fw_stream_status_t fw_stream_poll(fw_stream_t *s, uint32_t now_ms);
+
+/**
+ * Fetch the pending ACK message, if any.
+ *
+ * ACKs are cumulative, so when several frames complete within one feed
+ * only the newest is reported.
+ *
+ * @param out  Receives FW_STREAM_ACK_SIZE bytes.
+ * @return     true if `out` was filled and should be sent to the host.
+ */
+bool fw_stream_take_ack(fw_stream_t *s, uint8_t out[FW_STREAM_ACK_SIZE]);
+
+/**
+ * True while the session is receiving data.
+ */
+bool fw_stream_active(const fw_stream_t *s);
+
+/**
+ * Format the final text response ("OK <bytes> <ms> <KB/s>\n" or
+ * "ERR <reason>\n").
+ *
+ * @return  Bytes written (excluding NUL).
+ */
+int fw_stream_format_result(const fw_stream_t *s, char *buf, size_t size);
+
+/**
+ * Get a human-readable name for a status.
+ */
+const char *fw_stream_status_name(fw_stream_status_t status);
+
+#endif /* FW_STREAM_H */
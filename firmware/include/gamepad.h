@@ -49,6 +49,31 @@ typedef struct {
     uint8_t dpad;       /* GAMEPAD_DPAD_* value (hat switch) */
 } gamepad_report_t;
 
+/**
+ * Motion sensor sample (DualShock 4, DualSense, Switch Pro).  Raw sensor
+ * counts as the controller reports them; scale and axis orientation are
+ * the controller's own.
+ */
+typedef struct {
+    int16_t  gyro[3];       /* Angular rate X, Y, Z */
+    int16_t  accel[3];      /* Acceleration X, Y, Z */
+    uint32_t timestamp_us;  /* PadProxy clock when the sample arrived */
+} gamepad_motion_t;
+
+/* Player indicator LEDs, one bit each (GAMEPAD_LED_PLAYER(1..4)) */
+#define GAMEPAD_LED_PLAYER(n)   (1 << ((n) - 1))
+
+/**
+ * Output state the host asks of a controller: force feedback and player
+ * LEDs.  Like gamepad_report_t, this is the device-neutral form between
+ * the USB output report and Bluepad32.
+ */
+typedef struct {
+    uint8_t strong;     /* Strong (low-frequency) motor: 0 = off .. 255 */
+    uint8_t weak;       /* Weak (high-frequency) motor:  0 = off .. 255 */
+    uint8_t leds;       /* GAMEPAD_LED_PLAYER bits; 0 = leave as is */
+} gamepad_output_t;
+
 /**
  * Convert a 4-bit d-pad bitmask (UP=1, DOWN=2, RIGHT=4, LEFT=8) to a
  * hat-switch value (0-7 clockwise from N, 8=centered).
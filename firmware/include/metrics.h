@@ -0,0 +1,82 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Metrics Registry
+ *
+ * Single surface for device instrumentation.  Modules register named
+ * counters (plain uint32_t variables they increment themselves) and
+ * getter callbacks once at init.  Nothing is evaluated or formatted
+ * until a reader asks — the "status" and "stats" setup commands — so
+ * the main loop pays nothing beyond the counter increments.
+ *
+ * This module is pure logic with no hardware dependencies so it can be
+ * unit-tested on the host.  Registration is not thread-safe; do it
+ * before the main loop starts.
+ */
+
+/**
+ * Maximum number of registered metrics: main's own plus four per
+ * scheduler task (sched_register_metrics), with room to grow.
+ */
+#define METRICS_MAX 96
+
+/** Include this metric in the one-line "status" summary. */
+#define METRICS_F_STATUS  0x01
+
+/** Getter returning a number (evaluated on read). */
+typedef uint32_t (*metrics_u32_fn)(void *ctx);
+
+/** Getter returning a static or long-lived string (evaluated on read). */
+typedef const char *(*metrics_text_fn)(void *ctx);
+
+/**
+ * Remove all registrations (tests, or re-init).
+ */
+void metrics_reset(void);
+
+/**
+ * Register a counter.  The owner increments *counter directly; reads
+ * happen only when metrics are formatted.
+ *
+ * @param name     Metric name (must outlive the registry, e.g. a literal).
+ * @param counter  Variable to report.
+ * @param flags    METRICS_F_* bits.
+ * @return         false if the registry is full or arguments are NULL.
+ */
+bool metrics_register_counter(const char *name, const volatile uint32_t *counter,
+                              uint8_t flags);
+
+/** Register a numeric getter. */
+bool metrics_register_u32(const char *name, metrics_u32_fn fn, void *ctx,
+                          uint8_t flags);
+
+/** Register a text getter. */
+bool metrics_register_text(const char *name, metrics_text_fn fn, void *ctx,
+                           uint8_t flags);
+
+/** Number of registered metrics. */
+int metrics_count(void);
+
+/**
+ * Format one metric's current value.
+ * @return  Length written (excluding NUL), or -1 if index is out of range.
+ */
+int metrics_format_value(int index, char *buf, size_t size);
+
+/** Name of a metric, or NULL if index is out of range. */
+const char *metrics_name(int index);
+
+/**
+ * Format "name=value" pairs for every metric whose flags include all of
+ * `flags` (0 = every metric), joined by `sep`.
+ *
+ * @return  Bytes written (excluding NUL); output is truncated to fit.
+ */
+int metrics_format(uint8_t flags, const char *sep, char *buf, size_t size);
+
+#endif /* METRICS_H */
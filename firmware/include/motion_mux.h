@@ -0,0 +1,49 @@
+#ifndef MOTION_MUX_H
+#define MOTION_MUX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bt_gamepad.h"
+#include "gamepad.h"
+
+/**
+ * Motion Report Multiplexer
+ *
+ * All players share the one motion interface and its endpoint, which
+ * carries one report per USB frame.  Each player has a single slot
+ * holding its newest sample; a sample not yet sent is replaced, never
+ * queued, because only the latest orientation matters and a backlog
+ * would only add latency.
+ *
+ * take() picks players round-robin, so with every controller streaming
+ * each still gets 1/BT_GAMEPAD_MAX of the endpoint's reports.
+ *
+ * Call everything from one context.  Pure logic, so it can be
+ * unit-tested on the host.
+ */
+
+typedef struct {
+    gamepad_motion_t latest[BT_GAMEPAD_MAX];
+    bool     pending[BT_GAMEPAD_MAX];
+    uint8_t  next;              /* player to look at first */
+
+    uint32_t pushed;            /* samples offered                    */
+    uint32_t sent;              /* samples taken for the endpoint     */
+    uint32_t replaced;          /* samples superseded before sending  */
+} motion_mux_t;
+
+/** Drop every pending sample (bus reset, unmount). Keeps the counters. */
+void motion_mux_reset(motion_mux_t *m);
+
+/** Make this the player's newest sample. */
+void motion_mux_push(motion_mux_t *m, uint8_t idx, const gamepad_motion_t *s);
+
+/**
+ * Take the next pending sample, round-robin over players.
+ *
+ * @return false if no player has one.
+ */
+bool motion_mux_take(motion_mux_t *m, uint8_t *idx, gamepad_motion_t *out);
+
+#endif /* MOTION_MUX_H */
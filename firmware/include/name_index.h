@@ -0,0 +1,46 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Name Index
+ *
+ * Looks a string up in a fixed list of names by hashing it into a slot
+ * table with a seeded FNV-1a.  C11 cannot hash string literals in a
+ * constant expression, so name_index_build() searches for a seed that
+ * puts every name in its own slot: each lookup is then one hash and at
+ * most one strcmp, however many names there are.
+ *
+ * With NAME_INDEX_SLOTS at least four times the name count a seed is
+ * all but certain, but if the search fails (or the list is too long or
+ * holds duplicates) the index says so and lookups scan the list
+ * instead, so a lookup never misses a listed name.
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+#define NAME_INDEX_SLOTS      128   /* power of two */
+#define NAME_INDEX_MAX        (NAME_INDEX_SLOTS / 4)
+#define NAME_INDEX_SEED_TRIES 4096
+
+typedef struct {
+    const char *const *names;
+    int      count;
+    bool     perfect;   /* false: name_index_find() scans names */
+    uint32_t seed;
+    int8_t   slot[NAME_INDEX_SLOTS];    /* name number, -1 = empty */
+} name_index_t;
+
+/**
+ * Build an index over names[0..count).  The names are not copied.
+ * @return true if a perfect seed was found.
+ */
+bool name_index_build(name_index_t *idx, const char *const *names,
+                      int count);
+
+/** Number of the name equal to @p name, or -1 (also for NULL). */
+int name_index_find(const name_index_t *idx, const char *name);
+
+#endif /* NAME_INDEX_H */
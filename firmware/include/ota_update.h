@@ -2,6 +2,7 @@
 #define OTA_UPDATE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -77,6 +78,39 @@ typedef struct {
  */
 ota_update_result_t ota_update_check_and_apply(const ota_wifi_creds_t *creds);
 
+/* ── USB firmware update (streamed over the CDC setup port) ────────── */
+
+/**
+ * Prepare the inactive A/B partition to receive an image over USB.
+ *
+ * Used by the "firmware" setup command together with fw_stream.  Pairs
+ * with ota_update_stream_write() / ota_update_stream_finish().
+ *
+ * @param image_size  Total image size in bytes.
+ * @return false if there is no update partition or the image is too big.
+ */
+bool ota_update_stream_begin(uint32_t image_size);
+
+/**
+ * Append image bytes (fw_stream_sink_t-compatible; ctx is unused).
+ * Erases and programs one flash sector at a time.
+ */
+bool ota_update_stream_write(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * Flush the final sector and verify the programmed flash contents
+ * against the CRC-32 announced by the host.
+ *
+ * @return true if the partition holds exactly the expected image.
+ */
+bool ota_update_stream_finish(uint32_t expected_crc);
+
+/**
+ * Reboot into the freshly written partition in TBYB mode.  Does not
+ * return.  Only valid after ota_update_stream_finish() succeeded.
+ */
+void ota_update_stream_reboot(void);
+
 /**
  * Get a human-readable name for a result code.
  */
@@ -0,0 +1,61 @@
+#ifndef OUTPUT_COALESCE_H
+#define OUTPUT_COALESCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * Output Coalescer (rumble / player LEDs)
+ *
+ * One per player.  Games may rewrite force feedback every frame or
+ * faster, but each update to a Bluetooth controller costs an outgoing
+ * ACL packet, and the controller has only a few ACL buffers
+ * (MAX_NR_CONTROLLER_ACL_BUFFERS).  A backlog of rumble packets delays
+ * everything else on the link.
+ *
+ * The host's requests only replace the wanted state; take() hands out
+ * the latest state at most once per min_interval_ms, so intermediate
+ * states are dropped, never queued.  Bluepad32 plays rumble for a fixed
+ * duration, so while a motor is on, take() also hands the state out
+ * again every refresh_ms to keep it running.
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+typedef struct {
+    uint32_t min_interval_ms;   /* between two updates to the controller */
+    uint32_t refresh_ms;        /* resend a running motor; 0 = never     */
+
+    gamepad_output_t want;      /* latest state asked for by the host    */
+    gamepad_output_t sent;      /* state last handed to the controller   */
+    bool     dirty;             /* want differs from sent                */
+    bool     primed;            /* sent / last_ms are valid              */
+    uint32_t last_ms;
+
+    uint32_t requests;          /* host updates received                 */
+    uint32_t updates;           /* states handed to the controller       */
+    uint32_t coalesced;         /* host updates replaced before sending  */
+} output_coalesce_t;
+
+void output_coalesce_init(output_coalesce_t *c, uint32_t min_interval_ms,
+                          uint32_t refresh_ms);
+
+/** Forget what the controller has (new connection).  Keeps the counters
+ *  and drops any unsent state: motors start off. */
+void output_coalesce_reset(output_coalesce_t *c);
+
+/** Record the host's latest wanted state. */
+void output_coalesce_set(output_coalesce_t *c, const gamepad_output_t *o);
+
+/**
+ * Get the state to send to the controller now, if any.
+ *
+ * @return true if *out should be sent; the coalescer then counts it as
+ *         sent at now_ms.
+ */
+bool output_coalesce_take(output_coalesce_t *c, uint32_t now_ms,
+                          gamepad_output_t *out);
+
+#endif /* OUTPUT_COALESCE_H */
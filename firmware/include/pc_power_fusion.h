@@ -0,0 +1,128 @@
+#ifndef PC_POWER_FUSION_H
+#define PC_POWER_FUSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pc_power_state.h"
+#include "power_led.h"
+
+/**
+ * PC Power Signal Fusion
+ *
+ * Sits between the raw signals and the power state machine.  Instead of
+ * letting whichever signal arrives first drive a transition, every
+ * available signal votes for each hypothesis about the PC:
+ *
+ *   S0 - running (POST or OS)
+ *   S3 - suspended to RAM
+ *   S5 - soft off
+ *
+ * Signals and what they suggest:
+ *   power-LED pattern   on: S0   blink: S3   off: S5
+ *   power-LED raw level a level change not yet confirmed by the
+ *                       classifier (early hint, never decisive alone)
+ *   USB device state    mounted: S0   suspended: S3   detached: S5
+ *   VBUS (if routed)    present: S0/S3   absent: S5
+ *
+ * Timing windows:
+ *   - An LED or USB level that has not changed for PC_FUSION_STALE_MS
+ *     longer than the most recently changed signal counts half: a fresh
+ *     change is new information, an old level may just be a board that
+ *     never reports (LED lit in S3, host that never suspends the bus).
+ *     VBUS measures power directly and never goes stale.
+ *   - USB suspend counts more once it has lasted PC_FUSION_SUSPEND_
+ *     CONFIRM_MS with a quiet LED, so a brief bus suspend (selective
+ *     suspend, reset) never moves the PC to sleep on its own, while a
+ *     board whose LED stays lit in S3 is still recognised.
+ *
+ * A verdict is reached when the leading hypothesis scores at least
+ * PC_FUSION_DECIDE and leads by PC_FUSION_MARGIN; otherwise the previous
+ * verdict stands.  S0 is reported as RUNNING while USB is mounted and
+ * POWERED otherwise.
+ *
+ * Verdict changes are delivered in the state machine's own event
+ * vocabulary, so transitions and actions stay in pc_power_state.c:
+ *   RUNNING  -> PC_EVENT_USB_ENUMERATED
+ *   POWERED  -> PC_EVENT_POWER_LED_ON
+ *   SLEEPING -> PC_EVENT_POWER_LED_BLINK
+ *   OFF      -> PC_EVENT_POWER_LED_OFF
+ *
+ * Pure logic (no hardware access), so it can be unit-tested on the host.
+ */
+
+#define PC_FUSION_DECIDE              60
+#define PC_FUSION_MARGIN              20
+#define PC_FUSION_STALE_MS          5000
+#define PC_FUSION_SUSPEND_CONFIRM_MS 3000
+
+typedef enum {
+    PC_FUSION_USB_DETACHED = 0,
+    PC_FUSION_USB_SUSPENDED,
+    PC_FUSION_USB_MOUNTED,
+} pc_fusion_usb_t;
+
+typedef enum {
+    PC_FUSION_S0 = 0,
+    PC_FUSION_S3,
+    PC_FUSION_S5,
+    PC_FUSION_HYP_COUNT
+} pc_fusion_hyp_t;
+
+typedef enum {
+    PC_FUSION_UNKNOWN = 0,
+    PC_FUSION_OFF,
+    PC_FUSION_SLEEPING,
+    PC_FUSION_POWERED,
+    PC_FUSION_RUNNING,
+} pc_fusion_verdict_t;
+
+typedef struct {
+    uint8_t  value;
+    uint32_t since_ms;      /* when value last changed */
+} pc_fusion_signal_t;
+
+typedef struct {
+    bool               has_vbus;
+    pc_fusion_signal_t led;         /* power_led_pattern_t  */
+    pc_fusion_signal_t usb;         /* pc_fusion_usb_t      */
+    pc_fusion_signal_t vbus;        /* bool (if has_vbus)   */
+    bool               led_raw;     /* unconfirmed LED level */
+
+    int16_t             score[PC_FUSION_HYP_COUNT];  /* last update */
+    pc_fusion_verdict_t verdict;
+    uint32_t            verdicts;   /* verdict changes so far */
+} pc_fusion_t;
+
+/**
+ * Start with the signal levels read at boot (USB starts detached).
+ *
+ * @param has_vbus  The board routes VBUS sense; otherwise VBUS is
+ *                  left out of every score.
+ */
+void pc_fusion_init(pc_fusion_t *f, power_led_pattern_t led, bool led_raw,
+                    bool has_vbus, bool vbus, uint32_t now_ms);
+
+/** Power-LED classifier output and current (glitch-filtered) level. */
+void pc_fusion_set_led(pc_fusion_t *f, power_led_pattern_t pattern,
+                       bool raw, uint32_t now_ms);
+
+void pc_fusion_set_usb(pc_fusion_t *f, pc_fusion_usb_t usb, uint32_t now_ms);
+
+void pc_fusion_set_vbus(pc_fusion_t *f, bool present, uint32_t now_ms);
+
+/**
+ * Re-score the signals.  Call after any input and periodically (the
+ * suspend window matures with time alone).
+ *
+ * @param event  Set to the state-machine event for a new verdict.
+ * @return       true if the verdict changed.
+ */
+bool pc_fusion_update(pc_fusion_t *f, uint32_t now_ms, pc_power_event_t *event);
+
+pc_fusion_verdict_t pc_fusion_verdict(const pc_fusion_t *f);
+
+/** Human-readable verdict name ("running", "sleeping", ...). */
+const char *pc_fusion_verdict_name(pc_fusion_verdict_t verdict);
+
+#endif /* PC_POWER_FUSION_H */
@@ -13,12 +13,23 @@
  * GPIO mapping (from design doc):
  *   GPIO 2 - PWR_BTN_TRIGGER (output, drives TLP222A photo-MOSFET)
  *   GPIO 3 - PWR_LED_SENSE   (input, PC817 optocoupler, active LOW = PC on)
+ *   ADC n  - USB_NATIVE_VBUS_SENSE (optional, PCB v2: ADC0 / GPIO 26),
+ *            selected with -DPADPROXY_VBUS_SENSE_ADC=n
  */
 
+/** One captured power-LED edge. */
+typedef struct {
+    uint32_t time_us;   /* pc_power_hal_micros() when the IRQ ran      */
+    bool     on;        /* LED level after the edge (true = PC on)     */
+} pc_power_led_edge_t;
+
+/** Capacity of the edge ring; older edges are dropped when full. */
+#define PC_POWER_LED_EDGE_RING 32
+
 /**
  * Initialize power management GPIOs.
  *   - PWR_BTN_TRIGGER (GPIO 2): output, initially LOW
- *   - PWR_LED_SENSE (GPIO 3): input with pull-up
+ *   - PWR_LED_SENSE (GPIO 3): input with pull-up, IRQ on both edges
  */
 void pc_power_hal_init(void);
 
@@ -30,6 +41,39 @@ void pc_power_hal_init(void);
  */
 bool pc_power_hal_read_power_led(void);
 
+/**
+ * Take the oldest captured power-LED edge.
+ *
+ * The GPIO interrupt timestamps every level change of PWR_LED_SENSE
+ * into a ring, so the main loop never has to sample the pin.
+ *
+ * @return true if an edge was returned, false if the ring is empty.
+ */
+bool pc_power_hal_pop_led_edge(pc_power_led_edge_t *edge);
+
+/**
+ * Number of edges dropped because the ring was full.  When this
+ * changes, the caller should resync from pc_power_hal_read_power_led().
+ */
+uint32_t pc_power_hal_led_edges_dropped(void);
+
+/**
+ * Register a function called from the GPIO interrupt after each edge
+ * is queued (e.g. to wake the task that drains the ring).  May be NULL.
+ */
+void pc_power_hal_set_led_edge_cb(void (*cb)(void));
+
+/**
+ * Whether this build reads USB_NATIVE VBUS (PADPROXY_VBUS_SENSE_ADC >= 0).
+ */
+bool pc_power_hal_has_vbus_sense(void);
+
+/**
+ * Sample USB_NATIVE VBUS through its 100k/47k divider.
+ * @return true if VBUS is above ~4 V; false if absent or not routed.
+ */
+bool pc_power_hal_read_vbus(void);
+
 /**
  * Pulse the power button trigger optocoupler.
  * Drives GPIO 2 HIGH for the specified duration, then LOW.
@@ -43,6 +87,12 @@ void pc_power_hal_trigger_power_button(uint32_t duration_ms);
  */
 uint32_t pc_power_hal_millis(void);
 
+/**
+ * Free-running microsecond clock (wraps every ~71 minutes); the same
+ * clock that stamps LED edges.
+ */
+uint32_t pc_power_hal_micros(void);
+
 /**
  * Start the boot timeout timer.
  * @param timeout_ms Duration before PC_EVENT_BOOT_TIMEOUT fires.
@@ -15,9 +15,27 @@
  *   PC_BOOTING  - Power button was triggered, waiting for USB enumeration.
  *   PC_ON       - PC is running. USB enumerated, power LED active.
  *   PC_SLEEPING - PC entered sleep/hibernate (S3/S4). LED off, USB suspended.
+ *   PC_WAKING   - USB remote wakeup was signalled to a sleeping PC, waiting
+ *                 for it to resume.  The boot timer doubles as the fallback:
+ *                 if it expires first, the power button is pulsed instead.
  *
  * The state machine is designed as a pure-logic module with no direct hardware
  * access. All I/O is handled through events (input) and actions (output).
+ * Transitions live in one const table indexed by (state, event), with an
+ * optional guard on sm context (e.g. remote wakeup armed) selecting an
+ * alternative entry; test_pc_power_model explores every event sequence
+ * up to a fixed depth against the invariants the table must keep.
+ *
+ * Boot durations:
+ *   Every BOOTING -> ON transition records how long the PC took, in a
+ *   rolling window per boot source (cold boot from OFF, or resume from
+ *   SLEEPING/WAKING).  A PC that enumerates within PC_BOOT_LATE_MAX_MS of
+ *   a boot timeout is recorded too, so a timeout that is too short learns
+ *   from the boots it cut off.  Once a source has PC_BOOT_MIN_SAMPLES,
+ *   pc_power_sm_boot_timeout() replaces the configured timeout with
+ *   PC_BOOT_TIMEOUT_PCT of the observed boots plus headroom, and
+ *   pc_power_sm_boot_eta_ms() predicts the time left from the median.
+ *   The history lives in RAM and survives PC power cycles, not MCU resets.
  */
 
 typedef enum {
@@ -25,6 +43,7 @@ typedef enum {
     PC_STATE_BOOTING,
     PC_STATE_ON,
     PC_STATE_SLEEPING,
+    PC_STATE_WAKING,
     PC_STATE_COUNT
 } pc_power_state_t;
 
@@ -41,6 +60,8 @@ typedef enum {
     PC_EVENT_POWER_LED_OFF,
     /** Boot timeout expired (no USB enumeration within deadline) */
     PC_EVENT_BOOT_TIMEOUT,
+    /** Power LED is blinking periodically (motherboard sleep indicator) */
+    PC_EVENT_POWER_LED_BLINK,
     PC_EVENT_COUNT
 } pc_power_event_t;
 
@@ -52,16 +73,61 @@ typedef enum {
     PC_ACTION_NONE            = 0,
     /** Pulse the power button optocoupler (100-500ms) */
     PC_ACTION_TRIGGER_POWER   = (1 << 0),
-    /** Start the boot timeout timer */
+    /** Start the boot timeout timer (in PC_WAKING: the remote-wakeup
+     *  fallback timeout, which is shorter) */
     PC_ACTION_START_BOOT_TIMER = (1 << 1),
     /** Cancel the boot timeout timer */
     PC_ACTION_CANCEL_BOOT_TIMER = (1 << 2),
+    /** Signal USB remote wakeup to the suspended host */
+    PC_ACTION_USB_REMOTE_WAKEUP = (1 << 3),
+    /** Broadcast a Wake-on-LAN magic packet (if configured); requested
+     *  with every power-button pulse that is meant to wake the PC */
+    PC_ACTION_SEND_WOL        = (1 << 4),
 } pc_power_action_t;
 
+/** Boot durations kept per source. */
+#define PC_BOOT_HISTORY             16
+/** Samples a source needs before its learned timeout is used. */
+#define PC_BOOT_MIN_SAMPLES          4
+/** Learned timeout: this percentile of recent boots ... */
+#define PC_BOOT_TIMEOUT_PCT         90
+/** ... times this headroom (percent) ... */
+#define PC_BOOT_TIMEOUT_HEADROOM   150
+/** ... clamped to the range allowed for the configured boot_timeout_ms. */
+#define PC_BOOT_TIMEOUT_MIN_MS    5000
+#define PC_BOOT_TIMEOUT_MAX_MS   60000
+/** Longest boot (USB after a timeout) still recorded as a late sample. */
+#define PC_BOOT_LATE_MAX_MS     120000
+
+typedef enum {
+    /** BOOTING entered from PC_OFF (power button, WoL, auto power-on) */
+    PC_BOOT_COLD,
+    /** BOOTING entered from PC_SLEEPING or PC_WAKING (S3 resume) */
+    PC_BOOT_RESUME,
+    PC_BOOT_SOURCE_COUNT
+} pc_boot_source_t;
+
+typedef struct {
+    /** Ring of recent BOOTING -> ON durations (ms), oldest overwritten */
+    uint32_t ms[PC_BOOT_HISTORY];
+    uint8_t  count;
+    uint8_t  next;
+} pc_boot_history_t;
+
 typedef struct {
     pc_power_state_t state;
     /** Timestamp (ms) of the last state transition, set by caller */
     uint32_t last_transition_ms;
+    /** Host suspended the bus with remote wakeup enabled */
+    bool remote_wakeup_armed;
+
+    /** Source and start (ms) of the current or most recent boot */
+    pc_boot_source_t boot_source;
+    uint32_t boot_start_ms;
+    /** That boot ended in PC_EVENT_BOOT_TIMEOUT; a USB enumeration from
+     *  PC_OFF soon after is still recorded */
+    bool boot_timed_out;
+    pc_boot_history_t boot_history[PC_BOOT_SOURCE_COUNT];
 } pc_power_sm_t;
 
 typedef struct {
@@ -77,6 +143,13 @@ typedef struct {
  */
 void pc_power_sm_init(pc_power_sm_t *sm);
 
+/**
+ * Record whether the host armed USB remote wakeup when it suspended the
+ * bus.  While armed, a wake request from SLEEPING tries remote wakeup
+ * before falling back to the power button.
+ */
+void pc_power_sm_set_remote_wakeup(pc_power_sm_t *sm, bool armed);
+
 /**
  * Process an event and return the resulting state + actions.
  *
@@ -95,6 +168,27 @@ pc_power_result_t pc_power_sm_process(pc_power_sm_t *sm,
  */
 pc_power_state_t pc_power_sm_get_state(const pc_power_sm_t *sm);
 
+/**
+ * Boot timeout for the boot in progress (call after entering BOOTING):
+ * learned from that source's history, or default_ms until it has
+ * PC_BOOT_MIN_SAMPLES.
+ */
+uint32_t pc_power_sm_boot_timeout(const pc_power_sm_t *sm,
+                                  uint32_t default_ms);
+
+/**
+ * Median recorded boot duration for a source, or 0 if none recorded.
+ */
+uint32_t pc_power_sm_boot_typical_ms(const pc_power_sm_t *sm,
+                                     pc_boot_source_t source);
+
+/**
+ * Predicted time (ms) until the PC is ready: the typical boot for the
+ * current source minus the time already spent.  0 when not in PC_BOOTING,
+ * when nothing is recorded yet, or once the typical time has passed.
+ */
+uint32_t pc_power_sm_boot_eta_ms(const pc_power_sm_t *sm, uint32_t now_ms);
+
 /**
  * Get a human-readable name for a state.
  */
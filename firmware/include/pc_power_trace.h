@@ -0,0 +1,123 @@
+#ifndef PC_POWER_TRACE_H
+#define PC_POWER_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pc_power_state.h"
+
+/**
+ * Power-State Trace
+ *
+ * A fixed RAM ring of everything the power state machine saw: each
+ * pc_power_sm_process() call (event, old and new state, actions, time)
+ * and each raw power-LED edge fed to the classifier.  When a unit
+ * mistakes sleep for off, "trace" over CDC shows the sequence that led
+ * there.
+ *
+ * Recording is one 8-byte store and an index increment, so the trace
+ * stays enabled in production.  A sleep blink would otherwise flush the
+ * ring within minutes, so after PC_TRACE_LED_BURST consecutive LED edges
+ * further edges are only counted, in one entry that follows them (timed
+ * at the latest counted edge) until the next state-machine entry.
+ *
+ * Single writer: call from the main loop only, not from interrupts.
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+/** Ring capacity in entries (power of two). */
+#ifndef PC_TRACE_SIZE
+#define PC_TRACE_SIZE 256
+#endif
+
+/** LED edges stored in a row before the rest are only counted. */
+#define PC_TRACE_LED_BURST 16
+
+/** Longest line pc_power_trace_format() produces (plus NUL). */
+#define PC_TRACE_LINE_MAX 64
+
+_Static_assert((PC_TRACE_SIZE & (PC_TRACE_SIZE - 1)) == 0,
+               "PC_TRACE_SIZE must be a power of two");
+
+typedef enum {
+    /** pc_power_sm_process() call */
+    PC_TRACE_SM = 0,
+    /** Raw power-LED edge */
+    PC_TRACE_LED,
+    /** LED edges counted but not stored (count in .skipped) */
+    PC_TRACE_LED_SKIPPED,
+} pc_power_trace_kind_t;
+
+typedef struct {
+    uint32_t time_ms;
+    uint8_t  kind;              /* pc_power_trace_kind_t */
+    uint8_t  event;             /* PC_TRACE_SM: pc_power_event_t */
+    union {
+        struct {
+            uint8_t states;     /* old << 4 | new */
+            uint8_t actions;    /* pc_power_action_t bits; 0x80: transitioned */
+        } sm;
+        uint16_t led_on;        /* PC_TRACE_LED: new level */
+        uint16_t skipped;       /* PC_TRACE_LED_SKIPPED: edges counted */
+    } u;
+} pc_power_trace_entry_t;
+
+_Static_assert(sizeof(pc_power_trace_entry_t) == 8,
+               "trace entries are one 8-byte store");
+
+/** Set in u.sm.actions when the call changed state. */
+#define PC_TRACE_TRANSITIONED 0x80
+
+/** Empty the ring. */
+void pc_power_trace_init(void);
+
+/** Record a state-machine call and its result. */
+void pc_power_trace_sm(pc_power_event_t event, pc_power_state_t old_state,
+                       const pc_power_result_t *r, uint32_t now_ms);
+
+/**
+ * Feed an event to the state machine and record the call.  Every
+ * pc_power_sm_process() call should go through here so the trace sees
+ * all transitions.
+ */
+pc_power_result_t pc_power_trace_process(pc_power_sm_t *sm,
+                                         pc_power_event_t event,
+                                         uint32_t now_ms);
+
+/** Record a raw LED level change, timed on the millisecond clock. */
+void pc_power_trace_led(bool on, uint32_t at_ms);
+
+/*
+ * Entries are numbered 0, 1, 2, ... in write order.  Reading by number
+ * keeps a dump consistent while new entries arrive (e.g. USB callbacks
+ * run while the dump is being sent).
+ */
+
+/** Number of the next entry to be written (= entries written). */
+uint32_t pc_power_trace_written(void);
+
+/** Number of the oldest entry still in the ring. */
+uint32_t pc_power_trace_oldest(void);
+
+/**
+ * Read entry number seq.
+ *
+ * @return  false if it has been overwritten or not written yet.
+ */
+bool pc_power_trace_read(uint32_t seq, pc_power_trace_entry_t *out);
+
+/**
+ * Render an entry compactly (no newline), e.g.
+ *   "812.034 USB_SUSPENDED ON>SLEEPING 00"
+ *   "815.500 BOOT_TIMEOUT OFF -"          (ignored: no transition)
+ *   "816.120 LED 1"
+ *   "830.700 LED +42"                     (edges counted, not stored)
+ * Actions are pc_power_action_t bits in hex.
+ *
+ * @return  Length written (excluding NUL), truncated to size - 1.
+ */
+int pc_power_trace_format(const pc_power_trace_entry_t *e, char *buf,
+                          size_t size);
+
+#endif /* PC_POWER_TRACE_H */
@@ -0,0 +1,111 @@
+#ifndef POWER_LED_H
+#define POWER_LED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Power LED Pattern Classifier
+ *
+ * Turns timestamped raw edges from the power-LED sense line into
+ * pattern changes for the power state machine: steady on, steady off,
+ * or the periodic blink many motherboards show in S3 sleep.
+ *
+ * Edges come from the GPIO interrupt (pc_power_hal_pop_led_edge), so
+ * every timing below is measured from when the line actually changed.
+ *
+ *   - Pulses shorter than POWER_LED_GLITCH_MS are dropped as noise.
+ *   - Four edges whose two overlapping periods agree (within 25 %) and
+ *     fall in POWER_LED_BLINK_MIN_MS .. POWER_LED_BLINK_MAX_MS identify
+ *     a blink; its period and duty cycle are learned and BLINKING is
+ *     reported immediately (about 1.5 periods after the blink starts).
+ *   - A level is steady once it has been held longer than a blink
+ *     phase could last: 1.5x the learned on- or off-phase once a blink
+ *     has been seen, otherwise the conservative hold given at init.
+ *     Learning is kept after the blink stops, so later on/off changes
+ *     on the same board are reported in well under a second.
+ *
+ * power_led_update() only compares timestamps, so it can be called as
+ * rarely as the caller likes.  Times are microseconds from a free-
+ * running 32-bit clock; differences are wrap-safe.  This module is pure
+ * logic so it can be unit-tested on the host.
+ */
+
+#define POWER_LED_GLITCH_MS     20
+#define POWER_LED_BLINK_MIN_MS  200
+#define POWER_LED_BLINK_MAX_MS  10000
+
+/** Shortest hold used even for fast learned blinks. */
+#define POWER_LED_HOLD_MIN_MS   100
+
+/** Edges kept for period detection: four plus one spare, so undoing a
+ *  glitch never costs the detector an edge. */
+#define POWER_LED_HISTORY       5
+
+typedef enum {
+    POWER_LED_UNCHANGED = 0,
+    POWER_LED_BECAME_ON,
+    POWER_LED_BECAME_OFF,
+    POWER_LED_BECAME_BLINKING,
+} power_led_change_t;
+
+typedef enum {
+    POWER_LED_PATTERN_OFF = 0,
+    POWER_LED_PATTERN_ON,
+    POWER_LED_PATTERN_BLINK,
+} power_led_pattern_t;
+
+typedef struct {
+    uint32_t hold_us;       /* steady hold before any blink is learned */
+    bool     level;         /* latest raw level (glitches removed)     */
+    uint32_t changed_us;    /* when level last changed                 */
+    uint32_t prev_changed_us; /* changed_us before the last edge       */
+    uint32_t edges;         /* raw level changes seen                  */
+    uint32_t glitches;      /* pulses dropped as noise                 */
+
+    power_led_pattern_t pattern;   /* last reported pattern            */
+    bool     blinking;             /* edge history currently periodic  */
+
+    /* Recent accepted edges, oldest first; levels alternate and the
+     * newest edge switched to `level` */
+    uint32_t hist_us[POWER_LED_HISTORY];
+    uint8_t  hist_count;
+
+    /* Learned blink (0 = none seen yet) */
+    uint32_t blink_period_us;
+    uint32_t blink_on_us;
+} power_led_t;
+
+/**
+ * Start from a known level (e.g. a GPIO read at boot) that is already
+ * considered steady.
+ *
+ * @param hold_ms  How long a new level must persist before any blink
+ *                 has been learned; must exceed the longest blink phase
+ *                 expected from an unknown board.
+ */
+void power_led_init(power_led_t *p, bool level, uint32_t hold_ms);
+
+/**
+ * Record a raw edge.  Repeats of the current level (e.g. a resync
+ * after lost edges) are ignored.
+ */
+void power_led_edge(power_led_t *p, bool on, uint32_t at_us);
+
+/**
+ * Report a pattern change: BLINKING as soon as a blink is identified,
+ * ON/OFF once a level has been held past the applicable hold.
+ */
+power_led_change_t power_led_update(power_led_t *p, uint32_t now_us);
+
+/** Current reported pattern. */
+power_led_pattern_t power_led_pattern(const power_led_t *p);
+
+/** Human-readable pattern name ("off", "on", "blink"). */
+const char *power_led_pattern_name(power_led_pattern_t pattern);
+
+/** Learned blink period in ms (0 if none) and on-time in percent. */
+uint32_t power_led_blink_period_ms(const power_led_t *p);
+uint32_t power_led_blink_duty_pct(const power_led_t *p);
+
+#endif /* POWER_LED_H */
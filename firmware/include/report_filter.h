@@ -0,0 +1,74 @@
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * USB Report Filter (send-on-change)
+ *
+ * Controllers report at up to 1 kHz whether or not anything moved, and
+ * each USB report wakes the host's HID stack.  The filter passes a
+ * report only when it differs from the last one the host received:
+ *
+ *   - any change of buttons or d-pad;
+ *   - an axis moving at least its noise threshold away from the value
+ *     last sent (0 or 1 = any change), so slow drift is still sent
+ *     once it adds up;
+ *   - otherwise a keepalive after keepalive_ms without a report, which
+ *     also delivers sub-threshold values eventually.
+ *
+ * Between reports the host's interrupt endpoint simply NAKs, which is
+ * what an idle USB HID gamepad does.  The first report after reset is
+ * always sent.
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+typedef enum {
+    REPORT_FILTER_LX = 0,
+    REPORT_FILTER_LY,
+    REPORT_FILTER_RX,
+    REPORT_FILTER_RY,
+    REPORT_FILTER_LT,
+    REPORT_FILTER_RT,
+    REPORT_FILTER_AXES,
+} report_filter_axis_t;
+
+typedef struct {
+    /** Smallest change per axis that counts; 0 or 1 = any change. */
+    uint16_t threshold[REPORT_FILTER_AXES];
+    /** Resend an unchanged report after this long; 0 = never. */
+    uint32_t keepalive_ms;
+} report_filter_config_t;
+
+typedef struct {
+    report_filter_config_t cfg;
+    gamepad_report_t last;      /* last report sent          */
+    uint32_t last_ms;           /* when it was sent          */
+    bool     primed;            /* last/last_ms are valid    */
+    uint32_t sent;
+    uint32_t suppressed;
+} report_filter_t;
+
+/** Start empty with the given settings (counters cleared). */
+void report_filter_init(report_filter_t *f, const report_filter_config_t *cfg);
+
+/** Forget the last report (e.g. host re-enumerated); keeps counters. */
+void report_filter_reset(report_filter_t *f);
+
+/**
+ * Decide whether a report needs sending.  Counts a suppression when
+ * it does not; a report that needs sending is counted by
+ * report_filter_sent() once USB accepts it.
+ */
+bool report_filter_check(report_filter_t *f, const gamepad_report_t *r,
+                         uint32_t now_ms);
+
+/** USB accepted this report. */
+void report_filter_sent(report_filter_t *f, const gamepad_report_t *r,
+                        uint32_t now_ms);
+
+#endif /* REPORT_FILTER_H */
@@ -0,0 +1,119 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Cooperative Deadline Scheduler
+ *
+ * Runs the main-loop tasks at their own rates instead of all of them
+ * on every 1 ms iteration.  Each task has a period (its deadline is the
+ * last run plus the period) and a priority; a task can also be notified
+ * from a callback or interrupt to run on the next pass regardless of
+ * its deadline.  Tasks never preempt each other.
+ *
+ * Each pass of sched_run() runs every due task once, highest priority
+ * (lowest number) first, then reports how long the caller may sleep.
+ * Tasks at SCHED_PRIO_IDLE run only on passes where nothing else was
+ * due, i.e. in otherwise idle time.
+ *
+ * Per-task runtime and lateness are counted for the "stats" command
+ * (see sched_register_metrics).  This module is pure logic — time comes
+ * from the caller and a microsecond clock callback — so it can be
+ * unit-tested on the host.
+ */
+
+#define SCHED_MAX_TASKS   8
+#define SCHED_NAME_MAX    12
+
+/** Tasks at this priority run only when nothing else is due. */
+#define SCHED_PRIO_IDLE   255
+
+/** Longest sleep sched_run() will suggest. */
+#define SCHED_MAX_SLEEP_MS 100
+
+typedef void (*sched_fn_t)(uint32_t now_ms, void *ctx);
+
+/** Microsecond clock used to measure task runtime. */
+typedef uint32_t (*sched_clock_us_t)(void);
+
+typedef struct {
+    char       name[SCHED_NAME_MAX + 1];
+    sched_fn_t fn;
+    void      *ctx;
+    uint32_t   period_ms;      /* 0 = runs only when notified           */
+    uint8_t    priority;       /* lower runs first                      */
+    uint32_t   next_ms;        /* next deadline (periodic tasks)        */
+    volatile bool notified;    /* set by sched_notify(), cleared on run */
+
+    /* Statistics */
+    uint32_t   runs;
+    uint32_t   late;           /* started a full period after deadline  */
+    uint32_t   max_us;         /* longest single run                    */
+    uint32_t   total_us;       /* cumulative runtime (wraps)            */
+
+    /* Metric names for sched_register_metrics() */
+    char       metric_names[4][SCHED_NAME_MAX + 10];
+} sched_task_t;
+
+typedef struct {
+    sched_task_t     tasks[SCHED_MAX_TASKS];   /* indexed by task id     */
+    uint8_t          order[SCHED_MAX_TASKS];   /* task ids by priority   */
+    uint8_t          count;
+    sched_clock_us_t clock_us;
+    uint32_t         passes;
+    uint32_t         idle_passes;   /* passes where no regular task ran */
+} sched_t;
+
+/**
+ * Initialize an empty scheduler.
+ *
+ * @param clock_us  Microsecond clock for runtime stats (may be NULL,
+ *                  in which case runtimes read as 0).
+ */
+void sched_init(sched_t *s, sched_clock_us_t clock_us);
+
+/**
+ * Add a task.  The first periodic run happens on the first pass.
+ *
+ * @param name       Short name for stats (truncated to SCHED_NAME_MAX).
+ * @param fn         Task body.
+ * @param ctx        Passed to fn.
+ * @param period_ms  Run every period_ms; 0 for notify-only tasks.
+ * @param priority   0 = most urgent; SCHED_PRIO_IDLE = idle time only.
+ * @return           Task id for sched_notify(), or -1 if full.
+ */
+int sched_add(sched_t *s, const char *name, sched_fn_t fn, void *ctx,
+              uint32_t period_ms, uint8_t priority);
+
+/**
+ * Ask for a task to run on the next pass.  Safe to call from interrupt
+ * context or the other core (sets a flag only).
+ */
+void sched_notify(sched_t *s, int task_id);
+
+/**
+ * Run every due or notified task once, in priority order.
+ *
+ * @return  Milliseconds until the next periodic deadline (0 if a task
+ *          is already due or notified; capped at SCHED_MAX_SLEEP_MS).
+ */
+uint32_t sched_run(sched_t *s, uint32_t now_ms);
+
+/**
+ * Look up a task by id (for stats); NULL if out of range.
+ */
+const sched_task_t *sched_task(const sched_t *s, int task_id);
+
+/**
+ * Register "<task>.runs", "<task>.late", "<task>.max_us" and
+ * "<task>.total_us" for every task with the metrics registry.  Call
+ * after all tasks are added.
+ *
+ * @return  false if the registry ran out of room.
+ */
+bool sched_register_metrics(sched_t *s);
+
+#endif /* SCHED_H */
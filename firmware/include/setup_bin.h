@@ -0,0 +1,145 @@
+#ifndef SETUP_BIN_H
+#define SETUP_BIN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "device_config.h"
+#include "setup_cmd.h"
+
+/**
+ * Binary Framed Setup Protocol
+ *
+ * A COBS-framed request/response protocol that runs on the same CDC
+ * port as the text commands, for tools (e.g. the Web Serial setup page)
+ * that want to load or save every setting in one USB round-trip.  Like
+ * setup_cmd, this module is pure logic and host-testable.
+ *
+ * Framing:
+ *   [SETUP_BIN_MAGIC][COBS(body)][0x00]
+ *
+ * The magic byte is not valid ASCII, so the CDC reader switches to
+ * binary mode when it sees it at the start of a line; anything else is
+ * treated as a text command.  COBS guarantees the body contains no 0x00,
+ * so the terminator is unambiguous.  A frame that goes quiet for
+ * SETUP_BIN_IDLE_MS or outgrows SETUP_BIN_FRAME_MAX is dropped and the
+ * port returns to text mode, so a stray magic byte cannot lock out the
+ * text commands (setup_bin_rx_*).
+ *
+ * Request body:   [op][tag][payload...]
+ * Response body:  [op | 0x80][tag][status][payload...]
+ *
+ * `tag` is echoed back so the host can pipeline several requests.  Key
+ * ids are the setup_cmd key ids; values are the same text the text
+ * protocol uses, so validation is shared.
+ *
+ *   GET    payload: [key]...              → [key][len][value]...
+ *   SET    payload: [flags][key][len][value]...
+ *          All pairs are validated against a scratch copy and applied
+ *          together, or none are (transactional).  flags bit 0 = save
+ *          to flash after a successful apply.
+ *          On error → [key][reason text]
+ *   LIST   payload: none                  → [key][nlen][name][len][value]...
+ *   STATUS payload: none                  → [status text]
+ *   TEXT   payload: [command line]        → [text response]
+ *          Runs any text command (save, defaults, version, reboot, ...).
+ */
+
+/** First byte of every binary frame. */
+#define SETUP_BIN_MAGIC 0xB5
+
+/** Largest decoded request or response body. */
+#define SETUP_BIN_BODY_MAX 1024
+
+/** Worst-case encoded frame: magic + COBS overhead + terminator. */
+#define SETUP_BIN_FRAME_MAX \
+    (1 + SETUP_BIN_BODY_MAX + SETUP_BIN_BODY_MAX / 254 + 1 + 1)
+
+/** A partial frame idle this long is dropped. */
+#define SETUP_BIN_IDLE_MS 200
+
+typedef enum {
+    SETUP_BIN_OP_GET    = 0x01,
+    SETUP_BIN_OP_SET    = 0x02,
+    SETUP_BIN_OP_LIST   = 0x03,
+    SETUP_BIN_OP_STATUS = 0x04,
+    SETUP_BIN_OP_TEXT   = 0x05,
+} setup_bin_op_t;
+
+/** SET flags. */
+#define SETUP_BIN_SET_SAVE  0x01
+
+typedef enum {
+    SETUP_BIN_OK            = 0,
+    SETUP_BIN_ERR_OP        = 1,   /* unknown op                     */
+    SETUP_BIN_ERR_MALFORMED = 2,   /* truncated or bad COBS          */
+    SETUP_BIN_ERR_KEY       = 3,   /* unknown key id                 */
+    SETUP_BIN_ERR_VALUE     = 4,   /* value rejected by validation   */
+    SETUP_BIN_ERR_OVERFLOW  = 5,   /* response would not fit         */
+} setup_bin_status_t;
+
+/** Collects one frame from the port, between magic and terminator. */
+typedef struct {
+    uint8_t  buf[SETUP_BIN_FRAME_MAX];
+    uint16_t len;
+    bool     active;        /* a frame is being collected */
+    uint32_t last_ms;       /* when its last byte arrived */
+    uint32_t dropped;       /* partial frames abandoned   */
+} setup_bin_rx_t;
+
+typedef enum {
+    SETUP_BIN_RX_MORE,      /* byte taken, frame continues            */
+    SETUP_BIN_RX_FRAME,     /* terminator: buf[0..len) is the body    */
+    SETUP_BIN_RX_DROPPED,   /* frame overflowed; back to text mode    */
+} setup_bin_rx_status_t;
+
+/** Start collecting a frame (the magic byte was just read). */
+void setup_bin_rx_start(setup_bin_rx_t *rx, uint32_t now_ms);
+
+/**
+ * Feed the next byte of an active frame.  After SETUP_BIN_RX_FRAME the
+ * caller processes buf[0..len) and calls setup_bin_rx_done().
+ */
+setup_bin_rx_status_t setup_bin_rx_byte(setup_bin_rx_t *rx, uint8_t b,
+                                        uint32_t now_ms);
+
+/** Finish with a complete frame and return to text mode. */
+void setup_bin_rx_done(setup_bin_rx_t *rx);
+
+/**
+ * Drop a partial frame that has been idle for SETUP_BIN_IDLE_MS.  Call
+ * before reading more bytes.
+ * @return true if a frame was dropped (the port is back in text mode).
+ */
+bool setup_bin_rx_expire(setup_bin_rx_t *rx, uint32_t now_ms);
+
+/**
+ * COBS-encode `len` bytes.
+ * @return  Encoded length, or 0 if out_size is too small.
+ */
+size_t setup_bin_cobs_encode(const uint8_t *in, size_t len,
+                             uint8_t *out, size_t out_size);
+
+/**
+ * COBS-decode `len` bytes (without the 0x00 terminator).
+ * @return  Decoded length, or -1 if the input is malformed or too long.
+ */
+int setup_bin_cobs_decode(const uint8_t *in, size_t len,
+                          uint8_t *out, size_t out_size);
+
+/**
+ * Process one binary request.
+ *
+ * @param frame     COBS-encoded body (bytes between magic and 0x00).
+ * @param len       Length of frame.
+ * @param cfg       Config struct to read/modify.
+ * @param out_buf   Receives the complete response frame (magic, COBS
+ *                  body and terminator), ready to write to the port.
+ * @param out_size  Size of out_buf (SETUP_BIN_FRAME_MAX is always enough).
+ * @return          Action code and response length, as setup_cmd_process.
+ */
+setup_cmd_result_t setup_bin_process(const uint8_t *frame, size_t len,
+                                     device_config_t *cfg,
+                                     uint8_t *out_buf, size_t out_size);
+
+#endif /* SETUP_BIN_H */
@@ -2,7 +2,9 @@
 #define SETUP_CMD_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include "device_config.h"
+#include "metrics.h"
 
 /**
  * Setup Command Processor
@@ -19,11 +21,22 @@
  *   → save                Request flash persist (action returned)
  *   → defaults            Reset config to defaults
  *   → version             Show firmware version
+ *   → status              One-line summary (METRICS_F_STATUS metrics)
+ *   → stats               Every registered metric, one per line
  *   → reboot              Request device reboot (action returned)
+ *   → log dump            Print the deferred log ring (action returned;
+ *                         the caller streams the entries, see dlog.h)
+ *   → trace               Print the power-state trace ring (action
+ *                         returned; see pc_power_trace.h)
+ *   → firmware <n> <crc>  Stream an n-byte .bin (CRC-32 in hex) into the
+ *                         update partition (see fw_stream.h)
  *
  * Responses:
  *   ← OK [data]           Success
  *   ← ERR <message>       Error
+ *
+ * A batched binary protocol for tools shares the same port and key
+ * accessors (see setup_bin.h).
  */
 
 /**
@@ -35,6 +48,12 @@ typedef enum {
     SETUP_ACTION_NONE   = 0,
     SETUP_ACTION_SAVE   = 1,
     SETUP_ACTION_REBOOT = 2,
+    /** Switch the port to binary firmware streaming (fw_size/fw_crc32). */
+    SETUP_ACTION_FIRMWARE = 3,
+    /** Stream the deferred log as "OK <line>" lines (text port only). */
+    SETUP_ACTION_LOG_DUMP = 4,
+    /** Stream the power-state trace as "OK <line>" lines (text port only). */
+    SETUP_ACTION_TRACE_DUMP = 5,
 } setup_cmd_action_t;
 
 typedef struct {
@@ -42,6 +61,9 @@ typedef struct {
     setup_cmd_action_t action;
     /** Number of bytes written to the output buffer (excluding NUL). */
     int out_len;
+    /** For SETUP_ACTION_FIRMWARE: image size and CRC-32 from the host. */
+    uint32_t fw_size;
+    uint32_t fw_crc32;
 } setup_cmd_result_t;
 
 /**
@@ -50,11 +72,48 @@ typedef struct {
  */
 void setup_cmd_set_version(const char *version_str);
 
+/* ── Key access ─────────────────────────────────────────────────────── */
+
+/*
+ * Per-key accessors shared by the text protocol and the binary framed
+ * protocol (setup_bin.h), so both apply identical validation.  Key ids
+ * are 0 .. setup_cmd_key_count() - 1.  Values are always text, exactly
+ * as typed after "set <key> " or printed by "get <key>".
+ */
+
+/** Longest value text any key produces or accepts (plus NUL). */
+#define SETUP_CMD_VALUE_MAX 80
+
+/**
+ * Reply buffer that holds "stats" for a full registry: METRICS_MAX
+ * lines of "OK name=value", names up to 24 characters and values up to
+ * 16.
+ */
+#define SETUP_CMD_STATS_LINE_MAX 48
+#define SETUP_CMD_STATS_SIZE     (METRICS_MAX * SETUP_CMD_STATS_LINE_MAX)
+
+/** Number of config keys. */
+int setup_cmd_key_count(void);
+
+/** Name of a key id, or NULL if out of range. */
+const char *setup_cmd_key_name(int key);
+
+/** Key id for a name, or -1 if unknown. */
+int setup_cmd_find_key(const char *name);
+
+/**
+ * Format a key's current value (secrets are masked).
+ * @return  Length written (excluding NUL), or -1 for an unknown key.
+ */
+int setup_cmd_get_value(int key, const device_config_t *cfg,
+                        char *buf, size_t size);
+
 /**
- * Device status string passed to "status" command.
- * Set before each main-loop iteration; must outlive the call.
+ * Validate and store a value.  On failure cfg is unchanged and a short
+ * reason (e.g. "out of range (50-2000)") is written to err.
  */
-void setup_cmd_set_status(const char *status_str);
+bool setup_cmd_set_value(int key, const char *value, device_config_t *cfg,
+                         char *err, size_t err_size);
 
 /**
  * Process one line of input and produce a response.
@@ -0,0 +1,102 @@
+#ifndef SWITCH_PRO_H
+#define SWITCH_PRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * Nintendo Switch Pro Controller (USB)
+ *
+ * Every report is 64 bytes with the report ID first.  The controller
+ * streams full input report 0x30; the host talks to it with output
+ * reports, each answered by an input report:
+ *
+ *   0x80 <cmd>                  USB command     → 0x81 <cmd> ...
+ *   0x01 <seq> <rumble 8> <sub> subcommand      → 0x21 ... <ack> <sub> <data>
+ *   0x10 <seq> <rumble 8>       rumble only       (no reply)
+ *
+ * Hosts read stick and IMU calibration from SPI flash with subcommand
+ * 0x10; switch_pro_spi_read() answers from a small map of factory
+ * values matching how switch_pro_from_gamepad() scales the sticks.
+ *
+ * Input report 0x30:
+ *   Offset  Size  Field
+ *   0       1     Report ID 0x30
+ *   1       1     Timer (increments per report)
+ *   2       1     Battery and connection
+ *   3       3     Buttons: right, shared, left (SWITCH_BTN_*)
+ *   6       3     Left stick  (12-bit X, 12-bit Y, Y up)
+ *   9       3     Right stick
+ *   12      1     Vibrator report
+ *   13      36    IMU (3 samples; zero here)
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+#define SWITCH_PRO_REPORT_LEN   64
+#define SWITCH_PRO_INPUT_ID     0x30
+#define SWITCH_PRO_REPLY_ID     0x21
+#define SWITCH_PRO_USB_REPLY_ID 0x81
+
+/* Button bits, byte 3 (right) */
+#define SWITCH_BTN_Y        0x01
+#define SWITCH_BTN_X        0x02
+#define SWITCH_BTN_B        0x04
+#define SWITCH_BTN_A        0x08
+#define SWITCH_BTN_R        0x40
+#define SWITCH_BTN_ZR       0x80
+/* byte 4 (shared) */
+#define SWITCH_BTN_MINUS    0x01
+#define SWITCH_BTN_PLUS     0x02
+#define SWITCH_BTN_RSTICK   0x04
+#define SWITCH_BTN_LSTICK   0x08
+#define SWITCH_BTN_HOME     0x10
+#define SWITCH_BTN_CAPTURE  0x20
+/* byte 5 (left) */
+#define SWITCH_BTN_DOWN     0x01
+#define SWITCH_BTN_UP       0x02
+#define SWITCH_BTN_RIGHT    0x04
+#define SWITCH_BTN_LEFT     0x08
+#define SWITCH_BTN_L        0x40
+#define SWITCH_BTN_ZL       0x80
+
+/** Stick centre and the deflection full scale maps to (12-bit units). */
+#define SWITCH_STICK_CENTER 2048
+#define SWITCH_STICK_RANGE  1536
+
+/** Size of the report descriptor in bytes. */
+#define SWITCH_PRO_REPORT_DESCRIPTOR_LEN 61
+
+/** Vendor-defined reports 0x30/0x21/0x81 in and 0x01/0x10/0x80/0x82 out. */
+extern const uint8_t switch_pro_report_descriptor[SWITCH_PRO_REPORT_DESCRIPTOR_LEN];
+
+/**
+ * Fill input report 0x30 from gamepad_report_t.  Buttons map by
+ * position: our A (bottom) is Nintendo's B.
+ *
+ * @param seq  Timer byte.
+ * @return Report length (SWITCH_PRO_REPORT_LEN).
+ */
+uint8_t switch_pro_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                uint8_t out[SWITCH_PRO_REPORT_LEN]);
+
+/**
+ * Handle an output report from the host (report ID first).
+ *
+ * @param out        Current output state; rumble and player-light
+ *                   requests update it.
+ * @param has_output Set true if *out changed.
+ * @param reply      Reply input report, if the request takes one.
+ * @return Reply length, or 0 for none.
+ */
+uint8_t switch_pro_from_host(const uint8_t *buf, uint16_t len, uint8_t seq,
+                             gamepad_output_t *out, bool *has_output,
+                             uint8_t reply[SWITCH_PRO_REPORT_LEN]);
+
+/** Read the emulated SPI flash: calibration where hosts look, 0xFF (unset)
+ *  everywhere else. */
+void switch_pro_spi_read(uint32_t addr, uint8_t *buf, uint8_t len);
+
+#endif /* SWITCH_PRO_H */
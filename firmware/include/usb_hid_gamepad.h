@@ -2,19 +2,34 @@
 #define USB_HID_GAMEPAD_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "bt_gamepad.h"
 #include "gamepad.h"
+#include "usb_report_pipe.h"
+#include "motion_mux.h"
 
 /**
  * USB HID Gamepad Device
  *
- * Presents the Pico 2 W as a USB HID gamepad to the host PC using TinyUSB.
+ * Presents the Pico 2 W as BT_GAMEPAD_MAX USB HID gamepads to the host PC
+ * using TinyUSB, one interface and interrupt endpoint per player.
  * The native USB peripheral connects directly to one port on the
- * motherboard's internal USB header for low-latency input.
+ * motherboard's internal USB header for low-latency input.  Each
+ * gamepad also takes an output report (SET_REPORT) for rumble and
+ * player LEDs, passed on through the output callback.  One more HID
+ * interface carries motion sensor samples for all players, on its own
+ * endpoint so it never takes a gamepad report's poll slot.
  *
- * USB state transitions feed into the PC power state machine:
- *   mounted   → PC_EVENT_USB_ENUMERATED  (OS is running)
- *   suspended → PC_EVENT_USB_SUSPENDED   (PC entering sleep)
- *   unmounted → PC_EVENT_USB_SUSPENDED   (PC shut down)
+ * What the player interfaces look like is the USB personality
+ * (usb_personality.h): generic HID, XInput, DualShock 4 or Switch Pro.
+ * Changing it makes the device drop off the bus and re-enumerate with
+ * the new descriptors.  The motion interface exists in HID mode only.
+ *
+ * USB state transitions are one input to PC power signal fusion
+ * (pc_power_fusion.h), alongside the power LED and optional VBUS sense:
+ *   mounted   → OS is running
+ *   suspended → PC likely entering sleep (confirmed by LED or time)
+ *   unmounted → PC shut down, rebooting, or cable unplugged
  */
 
 typedef enum {
@@ -28,15 +43,28 @@ typedef enum {
  */
 typedef void (*usb_hid_state_cb_t)(usb_hid_state_t state);
 
+/**
+ * Callback when a player's endpoint frees after send_report refused a
+ * report, so the caller can offer it again right away.
+ */
+typedef void (*usb_hid_ready_cb_t)(uint8_t idx);
+
+/**
+ * Callback for an output report from the host (rumble, player LEDs).
+ * Runs from tud_task, once per report; hosts may send them at any rate.
+ */
+typedef void (*usb_hid_output_cb_t)(uint8_t idx, const gamepad_output_t *out);
+
 /**
  * Initialize the USB HID gamepad device.
  *
- * Configures the TinyUSB stack with our gamepad HID descriptor and
+ * Configures the TinyUSB stack with the personality's descriptors and
  * installs the USB driver on the RP2350 native USB peripheral.
  *
  * @param state_cb  Callback for mount/suspend/resume events (may be NULL).
+ * @param mode      usb_mode setting (usb_mode_t) to enumerate as.
  */
-void usb_hid_gamepad_init(usb_hid_state_cb_t state_cb);
+void usb_hid_gamepad_init(usb_hid_state_cb_t state_cb, uint16_t mode);
 
 /**
  * Process TinyUSB device events. Call from the main loop.
@@ -46,18 +74,83 @@ void usb_hid_gamepad_task(void);
 /**
  * Send a gamepad report to the host PC.
  *
- * Converts the report to USB HID wire format and queues it for
- * transmission.  Drops the report silently if USB is not mounted
- * or the previous report has not finished sending.
+ * Converts the report to the personality's wire format and submits it,
+ * or, while this player's previous report is still in flight, keeps it
+ * as the newest waiting report (usb_report_pipe.h).  The waiting report
+ * goes out from the transfer-complete callback as soon as the host has
+ * taken the previous one.
  *
+ * @param idx     Player (Bluetooth slot, HID instance) 0 .. BT_GAMEPAD_MAX-1.
  * @param report  Current gamepad state.
- * @return true if the report was queued, false if dropped.
+ * @return true if the report was queued; false if USB is not mounted
+ *         or a waiting report with other buttons is still queued (the
+ *         ready callback fires when it has gone out).
+ */
+bool usb_hid_gamepad_send_report(uint8_t idx, const gamepad_report_t *report);
+
+/**
+ * Send a controller's native input report unchanged, if the personality
+ * speaks its format (DualShock 4 over DS4 mode), else convert @p report
+ * as send_report does.  @p report also supplies the buttons the pipe
+ * compares, so the same refusal rule applies.
+ */
+bool usb_hid_gamepad_send_raw(uint8_t idx, const gamepad_report_t *report,
+                              const bt_gamepad_raw_t *raw);
+
+/** True if the personality forwards native reports of this kind. */
+bool usb_hid_gamepad_takes_raw(bt_gamepad_raw_kind_t kind);
+
+/**
+ * Switch to another USB personality (usb_mode_t; out of range means HID).
+ * No-op if it is already active.  The device detaches shortly after,
+ * leaving time for a setup reply to drain, and re-attaches with the new
+ * descriptors; the host sees an unplug and replug.
  */
-bool usb_hid_gamepad_send_report(const gamepad_report_t *report);
+void usb_hid_gamepad_set_mode(uint16_t mode);
+
+/** Name of the active personality ("hid", "xinput", "ds4", "switch"). */
+const char *usb_hid_gamepad_mode_name(void);
+
+/** Set the callback for a freed endpoint (may be NULL). */
+void usb_hid_gamepad_set_ready_cb(usb_hid_ready_cb_t ready_cb);
+
+/**
+ * Send a motion sample on the motion interface (report ID idx + 1).
+ *
+ * Each player keeps only its newest unsent sample; players share the
+ * endpoint round-robin (motion_mux.h).
+ *
+ * @return false if USB is not mounted or the personality has no motion
+ *         interface.
+ */
+bool usb_hid_gamepad_send_motion(uint8_t idx, const gamepad_motion_t *motion);
+
+/** The motion multiplexer, for its counters. */
+const motion_mux_t *usb_hid_gamepad_motion(void);
+
+/** Set the callback for host output reports (may be NULL). */
+void usb_hid_gamepad_set_output_cb(usb_hid_output_cb_t output_cb);
+
+/** A player's report pipe, for its counters. */
+const usb_report_pipe_t *usb_hid_gamepad_pipe(uint8_t idx);
 
 /**
  * Get the current USB connection state.
  */
 usb_hid_state_t usb_hid_gamepad_get_state(void);
 
+/**
+ * True while the bus is suspended by a host that enabled remote wakeup
+ * (SET_FEATURE DEVICE_REMOTE_WAKEUP before suspending).
+ */
+bool usb_hid_gamepad_remote_wakeup_armed(void);
+
+/**
+ * Signal remote wakeup (resume) to the suspended host.  The host's
+ * resume arrives later as a MOUNTED state change.
+ *
+ * @return false if remote wakeup is not armed or could not be signalled.
+ */
+bool usb_hid_gamepad_remote_wakeup(void);
+
 #endif /* USB_HID_GAMEPAD_H */
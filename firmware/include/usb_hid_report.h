@@ -1,6 +1,7 @@
 #ifndef USB_HID_REPORT_H
 #define USB_HID_REPORT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "gamepad.h"
 
@@ -22,14 +23,35 @@
  *   10      1     Hat switch (4 bits, 1-8 clockwise + null) + padding (4 bits)
  *   11      2     Buttons (16 bits)
  *
+ * Output report layout (3 bytes, host → device):
+ *   Offset  Size  Field
+ *   0       1     Strong motor (uint8, 0 = off)
+ *   1       1     Weak motor   (uint8, 0 = off)
+ *   2       1     Player LEDs 1-4 (4 bits) + padding (4 bits)
+ *
  * The HID descriptor uses:
  *   - Generic Desktop / Gamepad
  *   - X, Y axes for left stick; Rx, Ry for right stick
  *   - Z, Rz for triggers
  *   - Hat Switch for d-pad
  *   - 16 buttons
+ *   - Vendor page outputs 0x01/0x02 for the motors
+ *   - LED page Player 1-4 indicators
+ *
+ * Motion report (separate HID interface, report ID = player 1-4):
+ *   Offset  Size  Field
+ *   0       6     Gyro X, Y, Z  (int16, raw sensor counts)
+ *   6       6     Accel X, Y, Z (int16, raw sensor counts)
+ *   12      4     Sample timestamp (uint32, microseconds, wraps)
+ *
+ * The motion interface has its own interrupt endpoint, so the gamepad
+ * reports keep their endpoints and poll slots; see
+ * USB_HID_PERIODIC_BYTES for the per-frame bandwidth budget.
  */
 
+/** Longest report any USB personality sends, report ID included. */
+#define USB_REPORT_MAX 64
+
 /** Wire-format report sent to the USB host. Must match the HID descriptor. */
 typedef struct __attribute__((packed)) {
     int16_t  lx;        /* Left stick X */
@@ -42,6 +64,40 @@ typedef struct __attribute__((packed)) {
     uint16_t buttons;   /* 16 buttons */
 } usb_gamepad_report_t;
 
+/** Wire-format output report from the USB host. Must match the descriptor. */
+typedef struct __attribute__((packed)) {
+    uint8_t strong;     /* Strong motor (0..255) */
+    uint8_t weak;       /* Weak motor   (0..255) */
+    uint8_t leds;       /* Player LEDs 1-4 in bits 0-3 */
+} usb_gamepad_output_t;
+
+/** Wire-format motion report (after the report ID byte). */
+typedef struct __attribute__((packed)) {
+    int16_t  gyro[3];
+    int16_t  accel[3];
+    uint32_t timestamp_us;
+} usb_motion_report_t;
+
+/**
+ * Full-speed periodic bandwidth per 1 ms frame.  At most 90% of a frame
+ * (1500 bytes at 12 Mbit/s) may be reserved for periodic transfers, and
+ * each interrupt transaction costs 13 bytes of protocol overhead (USB 2.0
+ * section 5.7.4).
+ */
+#define USB_FS_PERIODIC_FRAME_BYTES   1350
+#define USB_FS_INTERRUPT_OVERHEAD     13
+
+/**
+ * Periodic bytes per frame with every endpoint sending a report: one
+ * gamepad report per player plus one motion report (with its ID byte).
+ * While this fits in a frame, the host polls every gamepad endpoint in
+ * every frame whatever the motion interface does, so motion adds no
+ * latency to gamepad reports.
+ */
+#define USB_HID_PERIODIC_BYTES(players)                                  \
+    ((players) * (sizeof(usb_gamepad_report_t) + USB_FS_INTERRUPT_OVERHEAD) \
+     + 1 + sizeof(usb_motion_report_t) + USB_FS_INTERRUPT_OVERHEAD)
+
 /**
  * Convert a gamepad_report_t to the USB wire format.
  *
@@ -54,10 +110,31 @@ typedef struct __attribute__((packed)) {
 void usb_hid_report_from_gamepad(const gamepad_report_t *in,
                                   usb_gamepad_report_t *out);
 
+/**
+ * Parse an output report received from the host.
+ *
+ * @param buf  Report bytes (no report ID; the descriptor defines none).
+ * @param len  Length received.
+ * @return false if too short to be an output report.
+ */
+bool usb_hid_report_to_output(const uint8_t *buf, uint16_t len,
+                              gamepad_output_t *out);
+
+/** Convert a motion sample to the USB wire format (copied 1:1). */
+void usb_hid_report_from_motion(const gamepad_motion_t *in,
+                                usb_motion_report_t *out);
+
 /** Size of the HID report descriptor in bytes (compile-time constant). */
-#define USB_HID_REPORT_DESCRIPTOR_LEN 91
+#define USB_HID_REPORT_DESCRIPTOR_LEN 129
 
 /** The HID report descriptor. */
 extern const uint8_t usb_hid_report_descriptor[USB_HID_REPORT_DESCRIPTOR_LEN];
 
+/** Size of the motion interface's report descriptor in bytes. */
+#define USB_HID_MOTION_DESCRIPTOR_LEN 176
+
+/** The motion interface's report descriptor: report IDs 1-4, one per
+ *  player, each a usb_motion_report_t. */
+extern const uint8_t usb_hid_motion_descriptor[USB_HID_MOTION_DESCRIPTOR_LEN];
+
 #endif /* USB_HID_REPORT_H */
@@ -0,0 +1,94 @@
+#ifndef USB_PERSONALITY_H
+#define USB_PERSONALITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bt_gamepad.h"
+#include "gamepad.h"
+#include "usb_hid_report.h"
+
+/**
+ * USB Device Personalities
+ *
+ * What PadProxy looks like to the host: each player interface can be a
+ * generic HID gamepad, an Xbox 360 controller (XInput), a DualShock 4 or
+ * a Switch Pro Controller.  A personality bundles the USB identity, the
+ * report descriptor and that wire format's converters.  The usb_mode
+ * setting picks one; it takes effect when the device re-enumerates.
+ *
+ * Every personality has its own converter functions, with nothing in
+ * them that depends on the mode.  The USB layer looks the personality up
+ * once per enumeration and then calls through it, so forwarding a
+ * report never tests which mode is active.
+ *
+ * Pure logic (tables and converters), so it can be unit-tested on the
+ * host.  Descriptors other than the HID report descriptor are TinyUSB's
+ * business and live in usb_hid_gamepad.c.
+ */
+
+typedef enum {
+    USB_MODE_HID,       /* generic DirectInput gamepad (default) */
+    USB_MODE_XINPUT,    /* Xbox 360 controller, vendor class     */
+    USB_MODE_DS4,       /* DualShock 4                           */
+    USB_MODE_SWITCH,    /* Switch Pro Controller                 */
+    USB_MODE_COUNT,
+} usb_mode_t;
+
+/** What a report from the host asks for. */
+typedef struct {
+    bool             has_output;    /* output was changed               */
+    gamepad_output_t output;        /* in: current state; out: new state */
+    uint8_t          reply_len;     /* input report to answer with, or 0 */
+    uint8_t          reply[USB_REPORT_MAX];
+} usb_host_result_t;
+
+typedef struct {
+    const char *name;               /* setup/metrics name               */
+    uint16_t    vid;
+    uint16_t    pid;
+    uint16_t    bcd_device;
+    const char *manufacturer;
+    const char *product;
+
+    const uint8_t *report_desc;     /* NULL: vendor class (XInput)      */
+    uint16_t    report_desc_len;
+    bool        report_ids;         /* reports start with their ID      */
+    bool        motion;             /* motion interface present         */
+    bt_gamepad_raw_kind_t raw_kind; /* native reports forwarded as is   */
+
+    /**
+     * Fill one input report from gamepad_report_t.
+     * @param seq  Per-player report counter, for formats that carry one.
+     * @return Report length, report ID included.
+     */
+    uint8_t (*from_gamepad)(const gamepad_report_t *in, uint8_t seq,
+                            uint8_t out[USB_REPORT_MAX]);
+
+    /**
+     * Fill one input report from a raw_kind native report.  NULL when
+     * raw_kind is BT_GAMEPAD_RAW_NONE.
+     * @return Report length, or 0 if unusable (use from_gamepad).
+     */
+    uint8_t (*from_raw)(const bt_gamepad_raw_t *raw,
+                        uint8_t out[USB_REPORT_MAX]);
+
+    /** Handle a report from the host (report ID first if report_ids). */
+    void (*from_host)(const uint8_t *buf, uint16_t len, uint8_t seq,
+                      usb_host_result_t *res);
+
+    /**
+     * Answer a feature GET_REPORT (data after the report ID).  NULL if
+     * the personality has no feature reports.
+     * @return Bytes written, or 0 to STALL.
+     */
+    uint16_t (*feature)(uint8_t id, uint8_t *buf, uint16_t len);
+} usb_personality_t;
+
+/**
+ * The personality for a usb_mode setting.  Out-of-range values get the
+ * generic HID gamepad.
+ */
+const usb_personality_t *usb_personality_get(uint16_t mode);
+
+#endif /* USB_PERSONALITY_H */
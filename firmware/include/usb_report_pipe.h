@@ -0,0 +1,84 @@
+#ifndef USB_REPORT_PIPE_H
+#define USB_REPORT_PIPE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "usb_hid_report.h"
+
+/**
+ * USB Report Pipe (double buffer)
+ *
+ * One per HID instance.  Two slots: the report in flight (copied into
+ * TinyUSB's endpoint buffer) and the newest report waiting behind it.
+ * The waiting report is submitted from the report-complete callback the
+ * moment the host has taken the previous one, instead of a full loop
+ * iteration later.
+ *
+ * Reports are kept in wire format, whatever the USB personality (see
+ * usb_personality.h), tagged with the buttons and d-pad they carry.
+ * A newer report replaces the waiting one only if buttons and d-pad are
+ * unchanged (an axis-only update), so every button change the caller
+ * was promised still reaches the host.  A push that would overwrite a
+ * button change is refused; the caller keeps it and is told when the
+ * slot frees (usb_report_pipe_complete returns true).
+ *
+ * Call everything from one context (TinyUSB callbacks run from
+ * tud_task in the main loop).  Pure logic, so it can be unit-tested on
+ * the host.
+ */
+
+/** One wire report and the button state it carries. */
+typedef struct {
+    uint16_t buttons;       /* GAMEPAD_BTN_* in the report             */
+    uint8_t  dpad;          /* GAMEPAD_DPAD_* in the report            */
+    uint8_t  len;           /* bytes in data, report ID first if any   */
+    uint8_t  data[USB_REPORT_MAX];
+} usb_report_t;
+
+typedef struct {
+    usb_report_t pending;
+    bool     has_pending;
+    bool     in_flight;
+    bool     refused;       /* a push was turned away since completion */
+
+    uint32_t submitted;     /* transfers started                       */
+    uint32_t deferred;      /* reports queued behind a busy endpoint   */
+    uint32_t replaced;      /* waiting reports superseded (dropped)    */
+    uint32_t refusals;      /* pushes turned away, retried by caller   */
+    uint32_t retries;       /* submissions the stack rejected          */
+} usb_report_pipe_t;
+
+/** Empty both slots (bus reset, unmount). Keeps the counters. */
+void usb_report_pipe_reset(usb_report_pipe_t *p);
+
+/**
+ * Queue a report as the newest.
+ *
+ * @return false if refused: it would overwrite a waiting report with
+ *         different buttons or d-pad.  Offer it again after completion.
+ */
+bool usb_report_pipe_push(usb_report_pipe_t *p, const usb_report_t *r);
+
+/**
+ * Take the waiting report for submission if the endpoint is free; the
+ * pipe then counts it in flight.
+ *
+ * @return false if nothing to submit now.
+ */
+bool usb_report_pipe_next(usb_report_pipe_t *p, usb_report_t *out);
+
+/** The stack rejected a report from next(); it waits again (unless a
+ *  newer one already does) and is retried on the next pump. */
+void usb_report_pipe_failed(usb_report_pipe_t *p,
+                            const usb_report_t *r);
+
+/**
+ * The host has taken the in-flight report.
+ *
+ * @return true if a push was refused meanwhile, so the producer should
+ *         offer its report again now.
+ */
+bool usb_report_pipe_complete(usb_report_pipe_t *p);
+
+#endif /* USB_REPORT_PIPE_H */
@@ -0,0 +1,51 @@
+#ifndef WIFI_STA_H
+#define WIFI_STA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wol_packet.h"
+
+/**
+ * Background WiFi Station
+ *
+ * Keeps the CYW43 associated with the configured network for the whole
+ * session, so a Wake-on-LAN packet goes out as soon as the guide button
+ * is pressed instead of after a blocking join (which can take the full
+ * 15 s OTA connect timeout).  Association and DHCP run in the cyw43/lwIP
+ * background context; wifi_sta_task() only watches the link and rejoins
+ * with backoff when it drops.
+ *
+ * The radio is shared with Bluepad32, so initialise this before
+ * bt_gamepad_init().
+ */
+
+typedef enum {
+    WIFI_STA_OFF,       /* no SSID configured or radio init failed */
+    WIFI_STA_JOINING,   /* associating / waiting for DHCP          */
+    WIFI_STA_UP,        /* associated with an IP address           */
+    WIFI_STA_DOWN,      /* join failed or link lost; retry pending */
+} wifi_sta_state_t;
+
+/**
+ * Bring up the radio in station mode and start joining in the
+ * background.  Does nothing if ssid is empty.
+ */
+void wifi_sta_init(const char *ssid, const char *password);
+
+/** Watch the link and rejoin when it drops.  Call periodically. */
+void wifi_sta_task(uint32_t now_ms);
+
+wifi_sta_state_t wifi_sta_state(void);
+
+/** Human-readable state name ("off", "joining", "up", "down"). */
+const char *wifi_sta_state_name(wifi_sta_state_t state);
+
+/**
+ * Broadcast a Wake-on-LAN magic packet for mac (UDP, port WOL_PORT).
+ *
+ * @return false if the link is not up or lwIP could not queue it.
+ */
+bool wifi_sta_send_wol(const uint8_t mac[WOL_MAC_LEN]);
+
+#endif /* WIFI_STA_H */
@@ -0,0 +1,38 @@
+#ifndef WOL_PACKET_H
+#define WOL_PACKET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Wake-on-LAN Magic Packet
+ *
+ * The payload a NIC watches for while the PC sleeps or is off: six 0xFF
+ * bytes followed by the target MAC address repeated sixteen times.  It
+ * is sent as a UDP broadcast to WOL_PORT; the NIC matches the payload
+ * regardless of addressing.
+ *
+ * Pure logic (no network access), so it can be unit-tested on the host.
+ */
+
+#define WOL_MAC_LEN      6
+#define WOL_PACKET_SIZE  (6 + 16 * WOL_MAC_LEN)   /* 102 bytes */
+#define WOL_PORT         9
+
+/** Longest accepted MAC string ("aa:bb:cc:dd:ee:ff"). */
+#define WOL_MAC_STR_MAX  17
+
+/**
+ * Parse a MAC address: six hex pairs separated by ':' or '-' (one
+ * separator style throughout), or twelve bare hex digits.
+ *
+ * @param mac  Receives the address; may be NULL to only validate.
+ * @return     false if the string is not a unicast MAC address.
+ */
+bool wol_parse_mac(const char *str, uint8_t mac[WOL_MAC_LEN]);
+
+/** Build the magic packet for mac into out. */
+void wol_packet_build(const uint8_t mac[WOL_MAC_LEN],
+                      uint8_t out[WOL_PACKET_SIZE]);
+
+#endif /* WOL_PACKET_H */
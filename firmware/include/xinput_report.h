@@ -0,0 +1,67 @@
+#ifndef XINPUT_REPORT_H
+#define XINPUT_REPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gamepad.h"
+
+/**
+ * XInput (Xbox 360 Wired Controller) Reports
+ *
+ * XInput is a vendor class (0xFF/0x5D/0x01), not HID: there is no
+ * report descriptor, and every message starts with a type and length.
+ *
+ * Input message (20 bytes, device → host):
+ *   Offset  Size  Field
+ *   0       1     Type 0x00
+ *   1       1     Length 0x14
+ *   2       2     Buttons (XINPUT_BTN_*)
+ *   4       2     Left, right trigger (uint8)
+ *   6       8     LX, LY, RX, RY (int16, Y up positive)
+ *   14      6     Reserved
+ *
+ * Output messages (host → device):
+ *   00 08 00 <strong> <weak> 00 00 00   rumble
+ *   01 03 <pattern>                     ring LED animation
+ *
+ * Pure logic, so it can be unit-tested on the host.
+ */
+
+#define XINPUT_REPORT_LEN   20
+
+#define XINPUT_BTN_UP       0x0001
+#define XINPUT_BTN_DOWN     0x0002
+#define XINPUT_BTN_LEFT     0x0004
+#define XINPUT_BTN_RIGHT    0x0008
+#define XINPUT_BTN_START    0x0010
+#define XINPUT_BTN_BACK     0x0020
+#define XINPUT_BTN_LS       0x0040
+#define XINPUT_BTN_RS       0x0080
+#define XINPUT_BTN_LB       0x0100
+#define XINPUT_BTN_RB       0x0200
+#define XINPUT_BTN_GUIDE    0x0400
+#define XINPUT_BTN_A        0x1000
+#define XINPUT_BTN_B        0x2000
+#define XINPUT_BTN_X        0x4000
+#define XINPUT_BTN_Y        0x8000
+
+/**
+ * Fill the input message from gamepad_report_t.  Our Y axes point down,
+ * XInput's up.  GAMEPAD_BTN_MISC has no XInput button.
+ *
+ * @return Message length (XINPUT_REPORT_LEN).
+ */
+uint8_t xinput_report_from_gamepad(const gamepad_report_t *in,
+                                   uint8_t out[XINPUT_REPORT_LEN]);
+
+/**
+ * Parse an output message into *out, changing only what it sets: a
+ * rumble message the motors, an LED message the player LEDs.
+ *
+ * @return false if the message sets nothing.
+ */
+bool xinput_report_to_output(const uint8_t *buf, uint16_t len,
+                             gamepad_output_t *out);
+
+#endif /* XINPUT_REPORT_H */
@@ -0,0 +1,141 @@
+#include "axis_curve.h"
+
+#define EXPO_MAX  100
+#define LUT_SHIFT (15 - AXIS_CURVE_LUT_BITS)   /* Q15 position → index */
+
+/*
+ * sqrt((i + 0.5) * 2^24) for i = 64..255: the square root of a value
+ * normalised so its top two bits are not both 0, seeded from its top
+ * byte.  That is within 0.4 %, so one Newton step lands on floor(sqrt)
+ * or one above it.
+ */
+static const uint16_t s_sqrt_seed[192] = {
+    32896, 33150, 33402, 33652, 33900, 34147, 34392, 34635,
+    34876, 35116, 35354, 35590, 35825, 36059, 36291, 36521,
+    36750, 36978, 37204, 37429, 37652, 37874, 38095, 38315,
+    38533, 38750, 38966, 39181, 39394, 39606, 39818, 40028,
+    40237, 40445, 40652, 40857, 41062, 41266, 41469, 41671,
+    41871, 42071, 42270, 42468, 42665, 42861, 43057, 43251,
+    43445, 43637, 43829, 44020, 44210, 44400, 44588, 44776,
+    44963, 45149, 45334, 45519, 45703, 45886, 46069, 46250,
+    46431, 46612, 46791, 46970, 47149, 47326, 47503, 47679,
+    47855, 48030, 48204, 48378, 48551, 48723, 48895, 49067,
+    49237, 49407, 49577, 49746, 49914, 50082, 50249, 50416,
+    50582, 50747, 50912, 51077, 51241, 51404, 51567, 51730,
+    51892, 52053, 52214, 52374, 52534, 52694, 52853, 53011,
+    53169, 53327, 53484, 53640, 53797, 53952, 54108, 54262,
+    54417, 54571, 54724, 54877, 55030, 55182, 55334, 55485,
+    55636, 55787, 55937, 56087, 56236, 56385, 56534, 56682,
+    56830, 56977, 57124, 57271, 57417, 57563, 57709, 57854,
+    57999, 58143, 58287, 58431, 58574, 58717, 58860, 59002,
+    59144, 59286, 59427, 59568, 59709, 59849, 59989, 60129,
+    60268, 60407, 60546, 60684, 60822, 60960, 61098, 61235,
+    61372, 61508, 61644, 61780, 61916, 62051, 62186, 62321,
+    62456, 62590, 62724, 62857, 62991, 63124, 63256, 63389,
+    63521, 63653, 63785, 63916, 64047, 64178, 64309, 64439,
+    64569, 64699, 64828, 64957, 65086, 65215, 65344, 65472,
+};
+
+uint32_t axis_curve_isqrt(uint32_t v)
+{
+    if (v == 0)
+        return 0;
+
+    unsigned shift = (unsigned)__builtin_clz(v) & ~1u;
+    uint32_t r = s_sqrt_seed[((v << shift) >> 24) - 64] >> (shift / 2);
+    r = (r + v / r) / 2;
+    if ((uint64_t)r * r > v)
+        r--;
+    return r;
+}
+
+void axis_curve_init(axis_curve_t *c, const axis_curve_cfg_t *cfg,
+                     uint16_t full)
+{
+    uint16_t dz    = cfg->deadzone < full - 1 ? cfg->deadzone : full - 2;
+    uint16_t outer = cfg->outer < full - dz ? cfg->outer : full - dz - 1;
+    uint16_t anti  = cfg->anti < full ? cfg->anti : full;
+    uint16_t expo  = cfg->expo < EXPO_MAX ? cfg->expo : EXPO_MAX;
+
+    c->identity = !cfg->deadzone && !cfg->outer && !cfg->anti && !cfg->expo;
+    c->full     = full;
+    c->dz       = dz;
+    c->top      = (uint16_t)(full - outer);
+    c->dz2      = (uint32_t)dz * dz;
+    c->inv_span = (1u << 31) / (uint32_t)(c->top - dz);
+
+    for (int32_t i = 0; i < AXIS_CURVE_LUT_SIZE; i++) {
+        int64_t t = (int64_t)i << LUT_SHIFT;               /* Q15 */
+        int64_t s = t + expo * (((t * t * t) >> 30) - t) / EXPO_MAX;
+        c->lut[i] = (uint16_t)(anti + ((full - anti) * s + 16384) / 32768);
+    }
+}
+
+/* The curve of a non-identity axis */
+static uint16_t shape(const axis_curve_t *c, uint32_t r)
+{
+    if (r <= c->dz)
+        return 0;
+    if (r >= c->top)
+        return c->full;
+
+    uint32_t t = (r - c->dz) * c->inv_span;                /* Q31 < 1 */
+    uint32_t i = t >> (31 - AXIS_CURVE_LUT_BITS);
+    uint32_t f = (t >> (15 - AXIS_CURVE_LUT_BITS)) & 0xFFFF;
+    uint32_t a = c->lut[i];
+    uint32_t b = c->lut[i + 1];
+    return (uint16_t)(a + (((b - a) * f + 0x8000) >> 16));
+}
+
+uint16_t axis_curve_eval(const axis_curve_t *c, uint32_t r)
+{
+    if (c->identity)
+        return r < c->full ? (uint16_t)r : c->full;
+    return shape(c, r);
+}
+
+void axis_curve_stick(const axis_curve_t *c, int16_t *x, int16_t *y)
+{
+    if (c->identity)
+        return;
+
+    int32_t vx = *x, vy = *y;
+    uint32_t r2 = (uint32_t)(vx * vx) + (uint32_t)(vy * vy);
+    if (r2 <= c->dz2) {
+        *x = 0;
+        *y = 0;
+        return;
+    }
+
+    /*
+     * Scale the vector from length r to the shaped length m.  |v| <= r
+     * and m <= 32767, so v * gain stays within int32.
+     */
+    uint32_t r = axis_curve_isqrt(r2);
+    uint32_t m = shape(c, r);
+    int32_t gain = (int32_t)((m << 16) / r);
+    *x = (int16_t)(vx * gain / 65536);
+    *y = (int16_t)(vy * gain / 65536);
+}
+
+void axis_curve_set_init(axis_curve_set_t *s,
+                         const axis_curve_cfg_t *lstick,
+                         const axis_curve_cfg_t *rstick,
+                         const axis_curve_cfg_t *trigger)
+{
+    axis_curve_init(&s->lstick, lstick, AXIS_CURVE_STICK_FULL);
+    axis_curve_init(&s->rstick, rstick, AXIS_CURVE_STICK_FULL);
+    axis_curve_init(&s->trigger, trigger, AXIS_CURVE_TRIGGER_FULL);
+    s->identity = s->lstick.identity && s->rstick.identity &&
+                  s->trigger.identity;
+}
+
+void axis_curve_set_apply(const axis_curve_set_t *s, gamepad_report_t *r)
+{
+    if (s->identity)
+        return;
+    axis_curve_stick(&s->lstick, &r->lx, &r->ly);
+    axis_curve_stick(&s->rstick, &r->rx, &r->ry);
+    r->lt = axis_curve_eval(&s->trigger, r->lt);
+    r->rt = axis_curve_eval(&s->trigger, r->rt);
+}
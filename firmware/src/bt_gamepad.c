@@ -7,49 +7,96 @@
  * and receive callbacks when controllers connect, disconnect, or send data.
  * Data arrives on Bluepad32's internal task, so we copy it under a critical
  * section for the main loop to read safely.
+ *
+ * Each controller is keyed by its uni_hid_device_t while connected and
+ * by its Bluetooth address across reconnects (bt_slot.c), so a player's
+ * reports always go to the same slot and USB HID interface.  Slot
+ * bookkeeping is only touched from Bluepad32 callbacks.
+ *
+ * DualShock 4 input is also kept as received: the device's input report
+ * parser is wrapped so the raw report is copied before Bluepad32 parses
+ * it, for USB personalities that forward it verbatim.
+ *
+ * Buttons and axes go through each slot's compiled button map
+ * (button_map.c), built in Bluepad32's context when the controller
+ * becomes ready or the button_map setting changes, so only that context
+ * ever reads it.
+ *
+ * Output (rumble, LEDs) flows the other way: the main loop stores the
+ * latest state under the lock and schedules one callback on the BTstack
+ * run loop, which sends whatever is latest by the time it runs.
  */
 
 #include <string.h>
 #include <uni.h>
+#include "btstack_run_loop.h"
 #include "pico/critical_section.h"
+#include "pico/time.h"
 #include "bt_gamepad_convert.h"
+#include "bt_slot.h"
+#include "button_map.h"
 
 /* ── Shared state ────────────────────────────────────────────────────── */
 
 static bt_gamepad_event_cb_t s_event_cb;
+static bt_gamepad_data_cb_t  s_data_cb;
 static gamepad_report_t      s_reports[BT_GAMEPAD_MAX];
+static uint16_t              s_pressed[BT_GAMEPAD_MAX];  /* since read */
+static gamepad_motion_t      s_motion[BT_GAMEPAD_MAX];
+static bool                  s_motion_new[BT_GAMEPAD_MAX];
+static bt_gamepad_raw_t      s_raw[BT_GAMEPAD_MAX];
+static bool                  s_raw_new[BT_GAMEPAD_MAX];
 static bool                  s_connected[BT_GAMEPAD_MAX];
 static critical_section_t    s_lock;
 
-/* ── Helpers: Bluepad32 → gamepad_report_t conversion ────────────────── */
+static gamepad_output_t      s_output[BT_GAMEPAD_MAX];
+static bool                  s_output_pending[BT_GAMEPAD_MAX];
+static bool                  s_output_scheduled;
+static btstack_context_callback_registration_t s_output_cb;
 
-/**
- * Map Bluepad32 button bits to our GAMEPAD_BTN_* bitmask.
- *
- * Bluepad32 splits buttons into "buttons" (face/shoulder) and
- * "misc_buttons" (guide/start/select), so we merge both.
- */
-static uint16_t map_buttons(uint32_t bp_buttons, uint32_t bp_misc)
-{
-    uint16_t out = 0;
+static bt_slot_table_t       s_slots;
+static uint8_t               s_leds[BT_GAMEPAD_MAX];  /* last set */
+static uni_hid_device_t     *s_devices[BT_GAMEPAD_MAX];
 
-    if (bp_buttons & BUTTON_A)          out |= GAMEPAD_BTN_A;
-    if (bp_buttons & BUTTON_B)          out |= GAMEPAD_BTN_B;
-    if (bp_buttons & BUTTON_X)          out |= GAMEPAD_BTN_X;
-    if (bp_buttons & BUTTON_Y)          out |= GAMEPAD_BTN_Y;
-    if (bp_buttons & BUTTON_SHOULDER_L) out |= GAMEPAD_BTN_L1;
-    if (bp_buttons & BUTTON_SHOULDER_R) out |= GAMEPAD_BTN_R1;
-    if (bp_buttons & BUTTON_THUMB_L)    out |= GAMEPAD_BTN_L3;
-    if (bp_buttons & BUTTON_THUMB_R)    out |= GAMEPAD_BTN_R3;
+/* Button maps: built and read only in Bluepad32's context */
+static button_map_t          s_maps[BT_GAMEPAD_MAX];
+static button_map_pad_t      s_map_pad[BT_GAMEPAD_MAX];
+static bool                  s_remapped[BT_GAMEPAD_MAX];  /* under lock */
+static char                  s_overrides[BUTTON_MAP_TEXT_MAX + 1];
+static bool                  s_maps_scheduled;
+static btstack_context_callback_registration_t s_maps_cb;
 
-    if (bp_misc & MISC_BUTTON_START)    out |= GAMEPAD_BTN_START;
-    if (bp_misc & MISC_BUTTON_SELECT)   out |= GAMEPAD_BTN_SELECT;
-    if (bp_misc & MISC_BUTTON_SYSTEM)   out |= GAMEPAD_BTN_GUIDE;
+/* Bluepad32's own input parser for each slot whose reports are kept */
+typedef void (*parse_input_fn_t)(uni_hid_device_t *d, const uint8_t *report,
+                                 uint16_t len);
+static parse_input_fn_t      s_parse_input[BT_GAMEPAD_MAX];
 
-    return out;
-}
+/* ── Helpers: Bluepad32 → gamepad_report_t conversion ────────────────── */
 
-static void convert_report(const uni_gamepad_t *gp, gamepad_report_t *out)
+/* button_map_pack() relies on Bluepad32's bit order */
+_Static_assert(BUTTON_A == 1 << BUTTON_MAP_SRC_A &&
+               BUTTON_B == 1 << BUTTON_MAP_SRC_B &&
+               BUTTON_X == 1 << BUTTON_MAP_SRC_X &&
+               BUTTON_Y == 1 << BUTTON_MAP_SRC_Y &&
+               BUTTON_SHOULDER_L == 1 << BUTTON_MAP_SRC_L1 &&
+               BUTTON_SHOULDER_R == 1 << BUTTON_MAP_SRC_R1 &&
+               BUTTON_TRIGGER_L == 1 << BUTTON_MAP_SRC_L2 &&
+               BUTTON_TRIGGER_R == 1 << BUTTON_MAP_SRC_R2 &&
+               BUTTON_THUMB_L == 1 << BUTTON_MAP_SRC_L3 &&
+               BUTTON_THUMB_R == 1 << BUTTON_MAP_SRC_R3,
+               "Bluepad32 button bits moved");
+_Static_assert(MISC_BUTTON_SYSTEM ==
+                   1 << (BUTTON_MAP_SRC_GUIDE - BUTTON_MAP_MISC_SHIFT) &&
+               MISC_BUTTON_SELECT ==
+                   1 << (BUTTON_MAP_SRC_SELECT - BUTTON_MAP_MISC_SHIFT) &&
+               MISC_BUTTON_START ==
+                   1 << (BUTTON_MAP_SRC_START - BUTTON_MAP_MISC_SHIFT) &&
+               MISC_BUTTON_CAPTURE ==
+                   1 << (BUTTON_MAP_SRC_CAPTURE - BUTTON_MAP_MISC_SHIFT),
+               "Bluepad32 misc button bits moved");
+
+static void convert_report(const uni_gamepad_t *gp, const button_map_t *map,
+                           gamepad_report_t *out)
 {
     out->lx = bt_gamepad_scale_axis(gp->axis_x);
     out->ly = bt_gamepad_scale_axis(gp->axis_y);
@@ -57,8 +104,180 @@ static void convert_report(const uni_gamepad_t *gp, gamepad_report_t *out)
     out->ry = bt_gamepad_scale_axis(gp->axis_ry);
     out->lt = bt_gamepad_clamp_trigger(gp->brake);
     out->rt = bt_gamepad_clamp_trigger(gp->throttle);
-    out->buttons = map_buttons(gp->buttons, gp->misc_buttons);
+    out->buttons = button_map_apply(map, button_map_pack(gp->buttons,
+                                                         gp->misc_buttons));
     out->dpad = gamepad_dpad_to_hat(gp->dpad);
+    button_map_apply_axes(map, out);
+}
+
+/**
+ * Copy the IMU sample, if the controller has one.  Bluepad32 leaves the
+ * fields zero for controllers without sensors; a real accelerometer
+ * always reads gravity, so all-zero means no sample.
+ */
+static bool convert_motion(const uni_gamepad_t *gp, gamepad_motion_t *out)
+{
+    bool any = false;
+    for (int i = 0; i < 3; i++) {
+        out->gyro[i]  = bt_gamepad_clamp_motion(gp->gyro[i]);
+        out->accel[i] = bt_gamepad_clamp_motion(gp->accel[i]);
+        any |= out->gyro[i] != 0 || out->accel[i] != 0;
+    }
+    out->timestamp_us = time_us_32();
+    return any;
+}
+
+/* ── Slots ───────────────────────────────────────────────────────────── */
+
+static int slot_of(const uni_hid_device_t *d)
+{
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        if (s_devices[i] == d)
+            return i;
+    return BT_SLOT_NONE;
+}
+
+/** Scan only while a slot is free.  Bluepad32 context only. */
+static void update_scanning(void)
+{
+    if (bt_slot_connected_count(&s_slots) < BT_GAMEPAD_MAX)
+        uni_bt_start_scanning_and_autoconnect_unsafe();
+    else
+        uni_bt_stop_scanning_unsafe();
+}
+
+/* ── Raw reports ─────────────────────────────────────────────────────── */
+
+/** Wraps the device's parser: keep the report, then parse it as usual. */
+static void parse_input_raw(uni_hid_device_t *d, const uint8_t *report,
+                            uint16_t len)
+{
+    int slot = slot_of(d);
+    if (slot == BT_SLOT_NONE)
+        return;  /* disconnecting; its reports no longer matter */
+
+    uint16_t n = len < BT_GAMEPAD_RAW_MAX ? len : BT_GAMEPAD_RAW_MAX;
+    critical_section_enter_blocking(&s_lock);
+    memcpy(s_raw[slot].data, report, n);
+    s_raw[slot].len = n;
+    s_raw_new[slot] = true;
+    critical_section_exit(&s_lock);
+
+    /* Parsing ends in on_controller_data, which signals the data cb */
+    s_parse_input[slot](d, report, len);
+}
+
+static bt_gamepad_raw_kind_t raw_kind_of(const uni_hid_device_t *d)
+{
+    if (d->controller_type == CONTROLLER_TYPE_PS4Controller)
+        return BT_GAMEPAD_RAW_DS4;
+    return BT_GAMEPAD_RAW_NONE;
+}
+
+/** Keep this slot's native reports if its controller has a known format. */
+static void keep_raw(int slot, uni_hid_device_t *d)
+{
+    bt_gamepad_raw_kind_t kind = raw_kind_of(d);
+    parse_input_fn_t parse = d->report_parser.parse_input_report;
+
+    if (kind == BT_GAMEPAD_RAW_NONE || parse == NULL)
+        kind = BT_GAMEPAD_RAW_NONE;
+    else if (parse != parse_input_raw) {
+        s_parse_input[slot] = parse;
+        d->report_parser.parse_input_report = parse_input_raw;
+    }
+
+    critical_section_enter_blocking(&s_lock);
+    s_raw[slot].kind = kind;
+    s_raw[slot].len  = 0;
+    s_raw_new[slot]  = false;
+    critical_section_exit(&s_lock);
+}
+
+/* ── Button maps ─────────────────────────────────────────────────────── */
+
+static button_map_pad_t pad_of(const uni_hid_device_t *d)
+{
+    switch (d->controller_type) {
+    case CONTROLLER_TYPE_XBox360Controller:
+    case CONTROLLER_TYPE_XBoxOneController:
+        return BUTTON_MAP_PAD_XBOX;
+    case CONTROLLER_TYPE_PS3Controller:
+    case CONTROLLER_TYPE_PS4Controller:
+    case CONTROLLER_TYPE_PS5Controller:
+        return BUTTON_MAP_PAD_PS;
+    case CONTROLLER_TYPE_SwitchProController:
+    case CONTROLLER_TYPE_SwitchJoyConLeft:
+    case CONTROLLER_TYPE_SwitchJoyConRight:
+    case CONTROLLER_TYPE_SwitchJoyConPair:
+        return BUTTON_MAP_PAD_SWITCH;
+    default:
+        return BUTTON_MAP_PAD_OTHER;
+    }
+}
+
+/** Compile a slot's map from its family default and the overrides. */
+static void build_map(int slot)
+{
+    char overrides[BUTTON_MAP_TEXT_MAX + 1];
+    critical_section_enter_blocking(&s_lock);
+    memcpy(overrides, s_overrides, sizeof(overrides));
+    critical_section_exit(&s_lock);
+
+    bool remapped = button_map_build(&s_maps[slot], s_map_pad[slot],
+                                     overrides);
+
+    critical_section_enter_blocking(&s_lock);
+    s_remapped[slot] = remapped;
+    critical_section_exit(&s_lock);
+}
+
+/** BTstack run loop: rebuild connected slots' maps after a change. */
+static void rebuild_maps(void *context)
+{
+    (void)context;
+    critical_section_enter_blocking(&s_lock);
+    s_maps_scheduled = false;
+    critical_section_exit(&s_lock);
+
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        if (s_devices[i] != NULL)
+            build_map(i);
+}
+
+/* ── Output ──────────────────────────────────────────────────────────── */
+
+/** BTstack run loop: send each slot's latest pending output. */
+static void send_outputs(void *context)
+{
+    (void)context;
+    gamepad_output_t out[BT_GAMEPAD_MAX];
+    bool pending[BT_GAMEPAD_MAX];
+
+    /* Updates from here on schedule another run */
+    critical_section_enter_blocking(&s_lock);
+    s_output_scheduled = false;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++) {
+        out[i]     = s_output[i];
+        pending[i] = s_output_pending[i];
+        s_output_pending[i] = false;
+    }
+    critical_section_exit(&s_lock);
+
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++) {
+        uni_hid_device_t *d = s_devices[i];
+        if (!pending[i] || d == NULL)
+            continue;
+
+        if (d->report_parser.play_dual_rumble)
+            d->report_parser.play_dual_rumble(d, 0, BT_GAMEPAD_RUMBLE_MS,
+                                              out[i].weak, out[i].strong);
+        if (out[i].leds && out[i].leds != s_leds[i] &&
+            d->report_parser.set_player_leds) {
+            d->report_parser.set_player_leds(d, out[i].leds);
+            s_leds[i] = out[i].leds;
+        }
+    }
 }
 
 /* ── Bluepad32 platform callbacks ────────────────────────────────────── */
@@ -72,7 +291,7 @@ static void platform_init(int argc, const char **argv)
 
 static void platform_on_init_complete(void)
 {
-    uni_bt_start_scanning_and_autoconnect_unsafe();
+    update_scanning();
 }
 
 static void platform_on_device_connected(uni_hid_device_t *d)
@@ -82,39 +301,54 @@ static void platform_on_device_connected(uni_hid_device_t *d)
 
 static void platform_on_device_disconnected(uni_hid_device_t *d)
 {
-    (void)d;
-    /*
-     * Mark slot 0 as disconnected. With BT_GAMEPAD_MAX == 1 we only
-     * track one controller.
-     */
+    int slot = slot_of(d);
+    if (slot == BT_SLOT_NONE)
+        return;  /* never became ready (or was refused) */
+
+    s_devices[slot] = NULL;
+    s_leds[slot] = 0;
+    bt_slot_release(&s_slots, slot);
+
     critical_section_enter_blocking(&s_lock);
-    s_connected[0] = false;
-    memset(&s_reports[0], 0, sizeof(s_reports[0]));
-    s_reports[0].dpad = GAMEPAD_DPAD_CENTERED;
+    s_connected[slot] = false;
+    memset(&s_reports[slot], 0, sizeof(s_reports[slot]));
+    s_reports[slot].dpad = GAMEPAD_DPAD_CENTERED;
+    s_pressed[slot] = 0;
+    s_motion_new[slot] = false;
+    s_raw[slot].kind = BT_GAMEPAD_RAW_NONE;
+    s_raw_new[slot] = false;
+    s_output_pending[slot] = false;
     critical_section_exit(&s_lock);
 
     if (s_event_cb) {
-        s_event_cb(0, BT_GAMEPAD_DISCONNECTED);
+        s_event_cb((uint8_t)slot, BT_GAMEPAD_DISCONNECTED);
     }
 
-    /* Re-enable scanning so another controller can connect. */
-    uni_bt_start_scanning_and_autoconnect_unsafe();
+    /* A slot is free again: let another controller connect. */
+    update_scanning();
 }
 
 static uni_error_t platform_on_device_ready(uni_hid_device_t *d)
 {
-    (void)d;
+    int slot = bt_slot_assign(&s_slots, d->conn.btaddr);
+    if (slot == BT_SLOT_NONE)
+        return UNI_ERROR_NO_SLOTS;
+
+    s_devices[slot] = d;
+    s_map_pad[slot] = pad_of(d);
+    build_map(slot);
+    keep_raw(slot, d);
 
     critical_section_enter_blocking(&s_lock);
-    s_connected[0] = true;
+    s_connected[slot] = true;
     critical_section_exit(&s_lock);
 
     if (s_event_cb) {
-        s_event_cb(0, BT_GAMEPAD_CONNECTED);
+        s_event_cb((uint8_t)slot, BT_GAMEPAD_CONNECTED);
     }
 
-    /* Stop scanning once we have a controller. */
-    uni_bt_stop_scanning_unsafe();
+    /* Stop scanning once every slot has a controller. */
+    update_scanning();
 
     return UNI_ERROR_SUCCESS;
 }
@@ -122,17 +356,30 @@ static uni_error_t platform_on_device_ready(uni_hid_device_t *d)
 static void platform_on_controller_data(uni_hid_device_t *d,
                                          uni_controller_t *ctl)
 {
-    (void)d;
-
     if (ctl->klass != UNI_CONTROLLER_CLASS_GAMEPAD)
         return;
 
+    int slot = slot_of(d);
+    if (slot == BT_SLOT_NONE)
+        return;
+
     gamepad_report_t report;
-    convert_report(&ctl->gamepad, &report);
+    gamepad_motion_t motion;
+    convert_report(&ctl->gamepad, &s_maps[slot], &report);
+    bool has_motion = convert_motion(&ctl->gamepad, &motion);
 
     critical_section_enter_blocking(&s_lock);
-    s_reports[0] = report;
+    s_pressed[slot] |= report.buttons & ~s_reports[slot].buttons;
+    s_reports[slot]  = report;
+    if (has_motion) {
+        s_motion[slot]     = motion;
+        s_motion_new[slot] = true;
+    }
     critical_section_exit(&s_lock);
+
+    if (s_data_cb) {
+        s_data_cb((uint8_t)slot);
+    }
 }
 
 static const uni_property_t *platform_get_property(uni_property_idx_t idx)
@@ -169,17 +416,36 @@ void bt_gamepad_init(bt_gamepad_event_cb_t event_cb)
     s_event_cb = event_cb;
 
     critical_section_init(&s_lock);
+    bt_slot_init(&s_slots);
 
     for (int i = 0; i < BT_GAMEPAD_MAX; i++) {
+        s_devices[i] = NULL;
         s_connected[i] = false;
+        s_pressed[i] = 0;
+        s_motion_new[i] = false;
+        s_raw[i].kind = BT_GAMEPAD_RAW_NONE;
+        s_raw_new[i] = false;
+        s_output_pending[i] = false;
+        s_leds[i] = 0;
         memset(&s_reports[i], 0, sizeof(s_reports[i]));
         s_reports[i].dpad = GAMEPAD_DPAD_CENTERED;
     }
 
+    s_output_cb.callback = send_outputs;
+    s_output_cb.context  = NULL;
+    s_maps_cb.callback   = rebuild_maps;
+    s_maps_cb.context    = NULL;
+    s_overrides[0]       = '\0';
+
     uni_platform_set_custom(&s_platform);
     uni_init(0, NULL);
 }
 
+void bt_gamepad_set_data_cb(bt_gamepad_data_cb_t data_cb)
+{
+    s_data_cb = data_cb;
+}
+
 bool bt_gamepad_is_connected(uint8_t idx)
 {
     if (idx >= BT_GAMEPAD_MAX)
@@ -192,7 +458,8 @@ bool bt_gamepad_is_connected(uint8_t idx)
     return connected;
 }
 
-bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report)
+bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report,
+                           uint16_t *pressed)
 {
     if (idx >= BT_GAMEPAD_MAX)
         return false;
@@ -201,17 +468,97 @@ bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report)
     bool connected = s_connected[idx];
     if (connected) {
         *report = s_reports[idx];
+        if (pressed)
+            *pressed = s_pressed[idx];
+        s_pressed[idx] = 0;
     }
     critical_section_exit(&s_lock);
 
     return connected;
 }
 
-void bt_gamepad_set_pairing(bool enabled)
+bool bt_gamepad_get_motion(uint8_t idx, gamepad_motion_t *motion)
 {
-    if (enabled) {
-        uni_bt_start_scanning_and_autoconnect_unsafe();
-    } else {
-        uni_bt_stop_scanning_unsafe();
+    if (idx >= BT_GAMEPAD_MAX)
+        return false;
+
+    critical_section_enter_blocking(&s_lock);
+    bool fresh = s_motion_new[idx];
+    if (fresh) {
+        *motion = s_motion[idx];
+        s_motion_new[idx] = false;
+    }
+    critical_section_exit(&s_lock);
+
+    return fresh;
+}
+
+bt_gamepad_raw_kind_t bt_gamepad_raw_kind(uint8_t idx)
+{
+    if (idx >= BT_GAMEPAD_MAX)
+        return BT_GAMEPAD_RAW_NONE;
+
+    critical_section_enter_blocking(&s_lock);
+    bt_gamepad_raw_kind_t kind = s_raw[idx].kind;
+    critical_section_exit(&s_lock);
+    return kind;
+}
+
+bool bt_gamepad_get_raw(uint8_t idx, bt_gamepad_raw_t *raw)
+{
+    if (idx >= BT_GAMEPAD_MAX)
+        return false;
+
+    critical_section_enter_blocking(&s_lock);
+    bool fresh = s_raw_new[idx] && !s_remapped[idx];
+    if (fresh)
+        *raw = s_raw[idx];
+    s_raw_new[idx] = false;
+    critical_section_exit(&s_lock);
+
+    return fresh;
+}
+
+uint8_t bt_gamepad_connected_count(void)
+{
+    uint8_t n = 0;
+    critical_section_enter_blocking(&s_lock);
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += s_connected[i];
+    critical_section_exit(&s_lock);
+    return n;
+}
+
+void bt_gamepad_set_output(uint8_t idx, const gamepad_output_t *out)
+{
+    if (idx >= BT_GAMEPAD_MAX)
+        return;
+
+    critical_section_enter_blocking(&s_lock);
+    s_output[idx]         = *out;
+    s_output_pending[idx] = true;
+    bool schedule         = !s_output_scheduled;
+    s_output_scheduled    = true;
+    critical_section_exit(&s_lock);
+
+    /* One callback in flight at a time; it picks up later updates too */
+    if (schedule)
+        btstack_run_loop_execute_on_main_thread(&s_output_cb);
+}
+
+void bt_gamepad_set_button_map(const char *overrides)
+{
+    critical_section_enter_blocking(&s_lock);
+    bool changed = strncmp(s_overrides, overrides, BUTTON_MAP_TEXT_MAX) != 0;
+    if (changed) {
+        strncpy(s_overrides, overrides, BUTTON_MAP_TEXT_MAX);
+        s_overrides[BUTTON_MAP_TEXT_MAX] = '\0';
     }
+    bool schedule = changed && !s_maps_scheduled;
+    s_maps_scheduled |= changed;
+    critical_section_exit(&s_lock);
+
+    /* Maps are only touched in Bluepad32's context */
+    if (schedule)
+        btstack_run_loop_execute_on_main_thread(&s_maps_cb);
 }
@@ -14,3 +14,10 @@ uint16_t bt_gamepad_clamp_trigger(int32_t value)
     if (value > 1023) return 1023;
     return (uint16_t)value;
 }
+
+int16_t bt_gamepad_clamp_motion(int32_t value)
+{
+    if (value >  32767) return  32767;
+    if (value < -32768) return -32768;
+    return (int16_t)value;
+}
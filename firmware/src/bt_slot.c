@@ -0,0 +1,68 @@
+#include "bt_slot.h"
+
+#include <string.h>
+
+void bt_slot_init(bt_slot_table_t *t)
+{
+    memset(t, 0, sizeof(*t));
+}
+
+static int find_addr(const bt_slot_table_t *t,
+                     const uint8_t addr[BT_SLOT_ADDR_LEN])
+{
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        if (t->slot[i].used &&
+            memcmp(t->slot[i].addr, addr, BT_SLOT_ADDR_LEN) == 0)
+            return i;
+    return BT_SLOT_NONE;
+}
+
+static int pick_free(const bt_slot_table_t *t)
+{
+    int oldest = BT_SLOT_NONE;
+
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++) {
+        const bt_slot_t *s = &t->slot[i];
+        if (!s->used)
+            return i;
+        if (s->connected)
+            continue;
+        if (oldest == BT_SLOT_NONE ||
+            (int32_t)(s->released - t->slot[oldest].released) < 0)
+            oldest = i;
+    }
+    return oldest;
+}
+
+int bt_slot_assign(bt_slot_table_t *t, const uint8_t addr[BT_SLOT_ADDR_LEN])
+{
+    /* An evicted controller's address is overwritten, so a match is
+     * always this controller's own slot */
+    int i = find_addr(t, addr);
+    if (i == BT_SLOT_NONE)
+        i = pick_free(t);
+    if (i == BT_SLOT_NONE)
+        return BT_SLOT_NONE;
+
+    bt_slot_t *s = &t->slot[i];
+    memcpy(s->addr, addr, BT_SLOT_ADDR_LEN);
+    s->used      = true;
+    s->connected = true;
+    return i;
+}
+
+void bt_slot_release(bt_slot_table_t *t, int slot)
+{
+    if (slot < 0 || slot >= BT_GAMEPAD_MAX)
+        return;
+    t->slot[slot].connected = false;
+    t->slot[slot].released  = ++t->stamp;
+}
+
+int bt_slot_connected_count(const bt_slot_table_t *t)
+{
+    int n = 0;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += t->slot[i].connected;
+    return n;
+}
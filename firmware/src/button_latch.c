@@ -0,0 +1,42 @@
+#include "button_latch.h"
+
+static unsigned count_bits(uint16_t v)
+{
+    unsigned n = 0;
+    for (; v; v &= (uint16_t)(v - 1))
+        n++;
+    return n;
+}
+
+void button_latch_reset(button_latch_t *l)
+{
+    l->held     = 0;
+    l->owed     = 0;
+    l->pending  = 0;
+    l->last_out = 0;
+}
+
+uint16_t button_latch_merge(button_latch_t *l, uint16_t held,
+                            uint16_t pressed)
+{
+    l->held  = held;
+    l->owed |= pressed;
+
+    /* An owed press shows now if the host last saw the button up;
+     * otherwise the host needs to see a release first */
+    uint16_t out = l->held | l->pending | (l->owed & ~l->last_out);
+    return (uint16_t)(out & ~(l->owed & l->last_out));
+}
+
+void button_latch_sent(button_latch_t *l, uint16_t buttons)
+{
+    /* A press owed while a forced one was being shown still needs its
+     * own release and press */
+    uint16_t carry   = l->owed & l->pending;
+    uint16_t natural = l->held & ~l->last_out;
+
+    l->latched  += count_bits(l->owed & ~carry & ~natural);
+    l->pending   = l->owed & l->last_out & ~buttons;
+    l->owed      = carry;
+    l->last_out  = buttons;
+}
@@ -0,0 +1,271 @@
+#include "button_map.h"
+
+#include <string.h>
+
+#include "gamepad.h"
+
+/* ── Names ──────────────────────────────────────────────────────────── */
+
+static const char *const s_pad_names[BUTTON_MAP_PAD_COUNT] = {
+    "other", "xbox", "ps", "switch",
+};
+
+static const char *const s_src_names[BUTTON_MAP_SRC_COUNT] = {
+    "a", "b", "x", "y", "l1", "r1", "l2", "r2", "l3", "r3",
+    "guide", "select", "start", "capture",
+};
+
+static const struct {
+    const char *name;
+    uint16_t    bits;
+} s_dst_names[] = {
+    { "a",      GAMEPAD_BTN_A      },
+    { "b",      GAMEPAD_BTN_B      },
+    { "x",      GAMEPAD_BTN_X      },
+    { "y",      GAMEPAD_BTN_Y      },
+    { "l1",     GAMEPAD_BTN_L1     },
+    { "r1",     GAMEPAD_BTN_R1     },
+    { "l3",     GAMEPAD_BTN_L3     },
+    { "r3",     GAMEPAD_BTN_R3     },
+    { "start",  GAMEPAD_BTN_START  },
+    { "select", GAMEPAD_BTN_SELECT },
+    { "guide",  GAMEPAD_BTN_GUIDE  },
+    { "misc",   GAMEPAD_BTN_MISC   },
+    { "none",   0                  },
+};
+
+#define DST_COUNT (int)(sizeof(s_dst_names) / sizeof(s_dst_names[0]))
+
+static const char *const s_axis_names[BUTTON_MAP_AXIS_COUNT] = {
+    "lx", "ly", "rx", "ry", "lt", "rt",
+};
+
+/* ── Defaults ───────────────────────────────────────────────────────── */
+
+/*
+ * Bluepad32 reports every family by position already, so the families
+ * start out alike; each has its own entry so one can diverge without
+ * touching the others.  Digital L2/R2 are dropped: the analog triggers
+ * carry them.
+ */
+#define POSITIONAL {                                                     \
+    [BUTTON_MAP_SRC_A]       = GAMEPAD_BTN_A,                            \
+    [BUTTON_MAP_SRC_B]       = GAMEPAD_BTN_B,                            \
+    [BUTTON_MAP_SRC_X]       = GAMEPAD_BTN_X,                            \
+    [BUTTON_MAP_SRC_Y]       = GAMEPAD_BTN_Y,                            \
+    [BUTTON_MAP_SRC_L1]      = GAMEPAD_BTN_L1,                           \
+    [BUTTON_MAP_SRC_R1]      = GAMEPAD_BTN_R1,                           \
+    [BUTTON_MAP_SRC_L3]      = GAMEPAD_BTN_L3,                           \
+    [BUTTON_MAP_SRC_R3]      = GAMEPAD_BTN_R3,                           \
+    [BUTTON_MAP_SRC_GUIDE]   = GAMEPAD_BTN_GUIDE,                        \
+    [BUTTON_MAP_SRC_SELECT]  = GAMEPAD_BTN_SELECT,                       \
+    [BUTTON_MAP_SRC_START]   = GAMEPAD_BTN_START,                        \
+    [BUTTON_MAP_SRC_CAPTURE] = GAMEPAD_BTN_MISC,                         \
+}
+
+#define AXES_IN_PLACE {                                                  \
+    BUTTON_MAP_AXIS_LX, BUTTON_MAP_AXIS_LY,                              \
+    BUTTON_MAP_AXIS_RX, BUTTON_MAP_AXIS_RY,                              \
+    BUTTON_MAP_AXIS_LT, BUTTON_MAP_AXIS_RT,                              \
+}
+
+static const button_map_spec_t s_defaults[BUTTON_MAP_PAD_COUNT] = {
+    [BUTTON_MAP_PAD_OTHER]  = { POSITIONAL, AXES_IN_PLACE },
+    [BUTTON_MAP_PAD_XBOX]   = { POSITIONAL, AXES_IN_PLACE },
+    [BUTTON_MAP_PAD_PS]     = { POSITIONAL, AXES_IN_PLACE },
+    [BUTTON_MAP_PAD_SWITCH] = { POSITIONAL, AXES_IN_PLACE },
+};
+
+void button_map_default(button_map_pad_t pad, button_map_spec_t *spec)
+{
+    if ((unsigned)pad >= BUTTON_MAP_PAD_COUNT)
+        pad = BUTTON_MAP_PAD_OTHER;
+    *spec = s_defaults[pad];
+}
+
+/* ── Overrides ──────────────────────────────────────────────────────── */
+
+/** Index of the name equal to s[0..len), or -1. */
+static int find_name(const char *const *names, int count,
+                     const char *s, size_t len)
+{
+    for (int i = 0; i < count; i++)
+        if (strlen(names[i]) == len && memcmp(names[i], s, len) == 0)
+            return i;
+    return -1;
+}
+
+static int find_dst(const char *s, size_t len)
+{
+    for (int i = 0; i < DST_COUNT; i++)
+        if (strlen(s_dst_names[i].name) == len &&
+            memcmp(s_dst_names[i].name, s, len) == 0)
+            return i;
+    return -1;
+}
+
+static bool is_stick(int axis)
+{
+    return axis < BUTTON_MAP_AXIS_STICKS;
+}
+
+/**
+ * Target of an axis source from s[0..len): "[-]axis" or "none", or -1.
+ * Sticks map to sticks and triggers to triggers; only sticks invert.
+ */
+static int parse_axis_dst(int src, const char *s, size_t len)
+{
+    if (len == 4 && memcmp(s, "none", 4) == 0)
+        return BUTTON_MAP_AXIS_NONE;
+
+    int invert = 0;
+    if (len > 0 && s[0] == '-') {
+        invert = BUTTON_MAP_AXIS_INVERT;
+        s++;
+        len--;
+    }
+    int dst = find_name(s_axis_names, BUTTON_MAP_AXIS_COUNT, s, len);
+    if (dst < 0 || is_stick(dst) != is_stick(src) ||
+        (invert && !is_stick(dst)))
+        return -1;
+    return dst | invert;
+}
+
+/** One "[family.]source=button" or "[family.]axis=[-]axis" entry. */
+static bool parse_entry(const char *s, size_t len, button_map_pad_t pad,
+                        button_map_spec_t *spec)
+{
+    const char *end = s + len;
+    const char *eq  = memchr(s, '=', len);
+    if (!eq)
+        return false;
+
+    bool ours = true;
+    const char *dot = memchr(s, '.', (size_t)(eq - s));
+    if (dot) {
+        int fam = find_name(s_pad_names, BUTTON_MAP_PAD_COUNT, s,
+                            (size_t)(dot - s));
+        if (fam < 0)
+            return false;
+        ours = fam == (int)pad;
+        s = dot + 1;
+    }
+
+    int axis = find_name(s_axis_names, BUTTON_MAP_AXIS_COUNT, s,
+                         (size_t)(eq - s));
+    if (axis >= 0) {
+        int dst = parse_axis_dst(axis, eq + 1, (size_t)(end - eq - 1));
+        if (dst < 0)
+            return false;
+        if (ours && spec)
+            spec->axis[axis] = (uint8_t)dst;
+        return true;
+    }
+
+    int src = find_name(s_src_names, BUTTON_MAP_SRC_COUNT, s,
+                        (size_t)(eq - s));
+    int dst = find_dst(eq + 1, (size_t)(end - eq - 1));
+    if (src < 0 || dst < 0)
+        return false;
+
+    if (ours && spec)
+        spec->dst[src] = s_dst_names[dst].bits;
+    return true;
+}
+
+bool button_map_parse(const char *text, button_map_pad_t pad,
+                      button_map_spec_t *spec)
+{
+    if (!text)
+        return true;
+
+    while (*text) {
+        if (*text == ',' || *text == ' ') {
+            text++;
+            continue;
+        }
+        size_t len = strcspn(text, ", ");
+        if (!parse_entry(text, len, pad, spec))
+            return false;
+        text += len;
+    }
+    return true;
+}
+
+/* ── Compiled tables ────────────────────────────────────────────────── */
+
+/*
+ * Entry b of a table ORs the destinations of b's set bits.  Entries
+ * with top bit k are entry b - 2^k plus source k, so each costs one OR.
+ */
+static void fill(uint16_t *table, const uint16_t *dst, int bits)
+{
+    table[0] = 0;
+    for (int k = 0; k < bits; k++)
+        for (int b = 0; b < 1 << k; b++)
+            table[(1 << k) + b] = table[b] | dst[k];
+}
+
+void button_map_compile(button_map_t *m, const button_map_spec_t *spec)
+{
+    fill(m->lo, spec->dst, 8);
+    fill(m->hi, spec->dst + 8, BUTTON_MAP_SRC_COUNT - 8);
+
+    /* Invert source → output into output ← source; later sources win */
+    memset(m->axis, BUTTON_MAP_AXIS_NONE, sizeof(m->axis));
+    for (int src = 0; src < BUTTON_MAP_AXIS_COUNT; src++) {
+        uint8_t a = spec->axis[src];
+        if (a == BUTTON_MAP_AXIS_NONE)
+            continue;
+        int dst = a & ~BUTTON_MAP_AXIS_INVERT;
+        if (dst >= BUTTON_MAP_AXIS_COUNT || is_stick(dst) != is_stick(src))
+            continue;
+        m->axis[dst] = (uint8_t)(src | (a & BUTTON_MAP_AXIS_INVERT));
+    }
+
+    m->axes_identity = true;
+    for (int i = 0; i < BUTTON_MAP_AXIS_COUNT; i++)
+        m->axes_identity &= m->axis[i] == i;
+}
+
+void button_map_apply_axes(const button_map_t *m, gamepad_report_t *r)
+{
+    if (m->axes_identity)
+        return;
+
+    const int32_t in[BUTTON_MAP_AXIS_COUNT] = {
+        r->lx, r->ly, r->rx, r->ry, r->lt, r->rt,
+    };
+    int32_t out[BUTTON_MAP_AXIS_COUNT];
+
+    for (int i = 0; i < BUTTON_MAP_AXIS_COUNT; i++) {
+        uint8_t a = m->axis[i];
+        if (a == BUTTON_MAP_AXIS_NONE) {
+            out[i] = 0;
+            continue;
+        }
+        int32_t v = in[a & ~BUTTON_MAP_AXIS_INVERT];
+        if (a & BUTTON_MAP_AXIS_INVERT)
+            v = v == INT16_MIN ? INT16_MAX : -v;
+        out[i] = v;
+    }
+
+    r->lx = (int16_t)out[BUTTON_MAP_AXIS_LX];
+    r->ly = (int16_t)out[BUTTON_MAP_AXIS_LY];
+    r->rx = (int16_t)out[BUTTON_MAP_AXIS_RX];
+    r->ry = (int16_t)out[BUTTON_MAP_AXIS_RY];
+    r->lt = (uint16_t)out[BUTTON_MAP_AXIS_LT];
+    r->rt = (uint16_t)out[BUTTON_MAP_AXIS_RT];
+}
+
+bool button_map_build(button_map_t *m, button_map_pad_t pad,
+                      const char *overrides)
+{
+    button_map_spec_t def, spec;
+    button_map_default(pad, &def);
+    spec = def;
+    if (!button_map_parse(overrides, pad, &spec))
+        spec = def;
+    button_map_compile(m, &spec);
+    return memcmp(&spec, &def, sizeof(spec)) != 0;
+}
@@ -1,50 +1,90 @@
 #include "device_config.h"
+#include "crc32.h"
+#include "name_index.h"
 #include <string.h>
 
 /* ── Wire format ────────────────────────────────────────────────────── */
 
 #define CONFIG_MAGIC   0x50434647  /* "PCFG" */
-#define CONFIG_VERSION 1
+#define CONFIG_VERSION 2
 
 /*
- * Binary layout (fixed size):
+ * v2 binary layout (variable size, what serialize writes):
  *   [0..3]   magic    (uint32, little-endian)
  *   [4..5]   version  (uint16, little-endian)
- *   [6..N]   payload  (device_config_t fields, packed)
- *   [N..N+3] crc32    (uint32, little-endian)
+ *   [6..7]   length   (uint16, little-endian) of the records
+ *   [8..N]   records  [tag: u8][len: u8][value: len bytes] ...
+ *   [N..N+3] crc32    (uint32, little-endian) over everything before it
  *
- * Payload fields are written in order with explicit sizes so the format
- * is stable across compiler struct-layout differences.
+ * The tag is the schema field id.  Only fields that differ from their
+ * default are stored.  Strings are stored without the NUL, U16 values
+ * as 2 little-endian bytes.  Readers skip unknown tags and any record
+ * that does not fit or validate for its field (that field keeps its
+ * default), so settings survive both upgrades and downgrades.  Any
+ * version >= 2 is read this way.
+ *
+ * v1 (fixed size, read-only for migration):
+ *   [magic][version = 1][134-byte payload][crc32]
+ * The payload is the first five schema fields, each in its full slot
+ * (strings NUL-padded).
  */
 
-#define HEADER_SIZE  6  /* magic (4) + version (2) */
-#define CRC_SIZE     4
-#define PAYLOAD_SIZE (                               \
-    (DEVICE_CONFIG_WIFI_SSID_MAX + 1) +              \
-    (DEVICE_CONFIG_WIFI_PASSWORD_MAX + 1) +          \
-    2 + /* power_pulse_ms */                         \
-    2 + /* boot_timeout_ms */                        \
-    (DEVICE_CONFIG_DEVICE_NAME_MAX + 1)              \
-)
-#define TOTAL_SIZE (HEADER_SIZE + PAYLOAD_SIZE + CRC_SIZE)
+#define HEADER_SIZE     6  /* magic (4) + version (2) */
+#define V2_HEADER_SIZE  8  /* + records length (2) */
+#define CRC_SIZE        4
+
+#define X_RECORD_MAX(name, type, lo, hi, def, flags) \
+    + 2 + DEVICE_CONFIG_SIZE_##type(hi)
+#define RECORDS_MAX (0 DEVICE_CONFIG_FIELDS(X_RECORD_MAX))
 
 /* Static assert that our advertised serial size is large enough */
-_Static_assert(DEVICE_CONFIG_SERIAL_SIZE >= TOTAL_SIZE,
+_Static_assert(DEVICE_CONFIG_SERIAL_SIZE >= V2_HEADER_SIZE + RECORDS_MAX + CRC_SIZE,
                "DEVICE_CONFIG_SERIAL_SIZE too small");
-
-/* ── CRC-32 (ISO 3309 / zlib) ──────────────────────────────────────── */
-
-static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
-{
-    crc = ~crc;
-    for (size_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            crc = (crc >> 1) ^ (0xEDB88320 & (-(crc & 1)));
-        }
-    }
-    return ~crc;
-}
+_Static_assert(DEVICE_CONFIG_FIELD_COUNT <= 256, "tags are one byte");
+
+/* The v1 layout is frozen: these fields, in this order, at these sizes */
+#define V1_FIELD_COUNT    5
+#define V1_PAYLOAD_SIZE   134
+_Static_assert(DEVICE_CONFIG_ID_wifi_ssid == 0 &&
+               DEVICE_CONFIG_ID_wifi_password == 1 &&
+               DEVICE_CONFIG_ID_power_pulse_ms == 2 &&
+               DEVICE_CONFIG_ID_boot_timeout_ms == 3 &&
+               DEVICE_CONFIG_ID_device_name == 4,
+               "v1 fields must keep their ids");
+_Static_assert(sizeof(((device_config_t *)0)->wifi_ssid) +
+               sizeof(((device_config_t *)0)->wifi_password) +
+               sizeof(((device_config_t *)0)->power_pulse_ms) +
+               sizeof(((device_config_t *)0)->boot_timeout_ms) +
+               sizeof(((device_config_t *)0)->device_name) == V1_PAYLOAD_SIZE,
+               "v1 flash payload layout changed");
+
+/* Each struct member must be exactly as wide as the schema says */
+#define X_ASSERT_SIZE(name, type, lo, hi, def, flags)                     \
+    _Static_assert(sizeof(((device_config_t *)0)->name) ==                \
+                   DEVICE_CONFIG_SIZE_##type(hi),                         \
+                   #name " size does not match the schema");
+DEVICE_CONFIG_FIELDS(X_ASSERT_SIZE)
+
+/* ── Schema table ───────────────────────────────────────────────────── */
+
+#define DEF_STR(def)  .def_str = (const char *)(def)
+#define DEF_U16(def)  .def_u16 = (uint16_t)(def)
+
+#define X_FIELD(name_, type_, lo_, hi_, def_, flags_)                     \
+    [DEVICE_CONFIG_ID_##name_] = {                                        \
+        .name   = #name_,                                                 \
+        .type   = DEVICE_CONFIG_TYPE_##type_,                             \
+        .offset = (uint16_t)offsetof(device_config_t, name_),             \
+        .size   = (uint16_t)DEVICE_CONFIG_SIZE_##type_(hi_),              \
+        .lo     = (lo_),                                                  \
+        .hi     = (hi_),                                                  \
+        DEF_##type_(def_),                                                \
+        .flags  = (flags_),                                               \
+    },
+
+const device_config_field_t device_config_fields[DEVICE_CONFIG_FIELD_COUNT] = {
+    DEVICE_CONFIG_FIELDS(X_FIELD)
+};
 
 /* ── Little-endian helpers ──────────────────────────────────────────── */
 
@@ -72,6 +112,27 @@ static uint32_t get_u32(const uint8_t *p)
     return (uint32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24));
 }
 
+/* ── Name lookup ────────────────────────────────────────────────────── */
+
+#define X_NAME(name, type, lo, hi, def, flags) #name,
+static const char *const s_field_names[] = { DEVICE_CONFIG_FIELDS(X_NAME) };
+#undef X_NAME
+
+_Static_assert(DEVICE_CONFIG_FIELD_COUNT <= NAME_INDEX_MAX,
+               "grow NAME_INDEX_SLOTS with the schema");
+
+static name_index_t s_names;
+static bool         s_names_ready;
+
+int device_config_find(const char *name)
+{
+    if (!s_names_ready) {
+        name_index_build(&s_names, s_field_names, DEVICE_CONFIG_FIELD_COUNT);
+        s_names_ready = true;
+    }
+    return name_index_find(&s_names, name);
+}
+
 /* ── Public API ─────────────────────────────────────────────────────── */
 
 void device_config_init(device_config_t *cfg)
@@ -79,115 +140,224 @@ void device_config_init(device_config_t *cfg)
     if (!cfg) return;
 
     memset(cfg, 0, sizeof(*cfg));
-    cfg->power_pulse_ms  = DEVICE_CONFIG_DEFAULT_POWER_PULSE_MS;
-    cfg->boot_timeout_ms = DEVICE_CONFIG_DEFAULT_BOOT_TIMEOUT_MS;
-    strncpy(cfg->device_name, DEVICE_CONFIG_DEFAULT_DEVICE_NAME,
-            DEVICE_CONFIG_DEVICE_NAME_MAX);
-    cfg->device_name[DEVICE_CONFIG_DEVICE_NAME_MAX] = '\0';
+    for (int i = 0; i < DEVICE_CONFIG_FIELD_COUNT; i++) {
+        const device_config_field_t *f = &device_config_fields[i];
+        uint8_t *v = (uint8_t *)cfg + f->offset;
+
+        if (f->type == DEVICE_CONFIG_TYPE_U16) {
+            memcpy(v, &f->def_u16, sizeof(uint16_t));
+        } else {
+            strncpy((char *)v, f->def_str, f->hi);
+            v[f->hi] = '\0';
+        }
+    }
+}
+
+/** True if the value stored at v is acceptable for field f. */
+static bool field_valid(const device_config_field_t *f, const uint8_t *v)
+{
+    if (f->type == DEVICE_CONFIG_TYPE_U16) {
+        uint16_t n;
+        memcpy(&n, v, sizeof(n));
+        return n >= f->lo && n <= f->hi;
+    }
+    /* Must be null-terminated within bounds */
+    if (v[f->hi] != '\0' || strlen((const char *)v) < f->lo)
+        return false;
+    if ((f->flags & DEVICE_CONFIG_F_MAC) && v[0] != '\0')
+        return wol_parse_mac((const char *)v, NULL);
+    if (f->flags & DEVICE_CONFIG_F_BUTTON_MAP)
+        return button_map_parse((const char *)v, BUTTON_MAP_PAD_OTHER, NULL);
+    return true;
 }
 
 bool device_config_validate(const device_config_t *cfg)
 {
     if (!cfg) return false;
 
-    if (cfg->power_pulse_ms < DEVICE_CONFIG_POWER_PULSE_MIN ||
-        cfg->power_pulse_ms > DEVICE_CONFIG_POWER_PULSE_MAX)
-        return false;
+    for (int i = 0; i < DEVICE_CONFIG_FIELD_COUNT; i++) {
+        const device_config_field_t *f = &device_config_fields[i];
+        if (!field_valid(f, (const uint8_t *)cfg + f->offset))
+            return false;
+    }
 
-    if (cfg->boot_timeout_ms < DEVICE_CONFIG_BOOT_TIMEOUT_MIN ||
-        cfg->boot_timeout_ms > DEVICE_CONFIG_BOOT_TIMEOUT_MAX)
-        return false;
+    return true;
+}
 
-    if (cfg->device_name[0] == '\0')
-        return false;
+/** True if field f of cfg holds its default value. */
+static bool field_is_default(const device_config_field_t *f,
+                             const device_config_t *cfg)
+{
+    const uint8_t *v = (const uint8_t *)cfg + f->offset;
 
-    /* Ensure strings are null-terminated within bounds */
-    if (cfg->wifi_ssid[DEVICE_CONFIG_WIFI_SSID_MAX] != '\0')
-        return false;
-    if (cfg->wifi_password[DEVICE_CONFIG_WIFI_PASSWORD_MAX] != '\0')
-        return false;
-    if (cfg->device_name[DEVICE_CONFIG_DEVICE_NAME_MAX] != '\0')
-        return false;
+    if (f->type == DEVICE_CONFIG_TYPE_U16) {
+        uint16_t n;
+        memcpy(&n, v, sizeof(n));
+        return n == f->def_u16;
+    }
+    return strcmp((const char *)v, f->def_str) == 0;
+}
 
-    return true;
+/**
+ * Store one TLV record into field f of cfg.  Records that do not fit or
+ * validate are ignored so the field keeps its current (default) value.
+ */
+static void apply_record(const device_config_field_t *f, device_config_t *cfg,
+                         const uint8_t *value, uint8_t len)
+{
+    uint8_t tmp[256];
+
+    if (f->type == DEVICE_CONFIG_TYPE_U16) {
+        if (len != 2) return;
+        uint16_t n = get_u16(value);
+        memcpy(tmp, &n, sizeof(n));
+    } else {
+        if (len > f->hi || memchr(value, '\0', len)) return;
+        memset(tmp, 0, f->size);
+        memcpy(tmp, value, len);
+    }
+
+    if (field_valid(f, tmp))
+        memcpy((uint8_t *)cfg + f->offset, tmp, f->size);
 }
 
 int device_config_serialize(const device_config_t *cfg,
                             uint8_t *buf, size_t len)
 {
-    if (!cfg || !buf || len < TOTAL_SIZE)
+    if (!cfg || !buf)
         return -1;
 
-    memset(buf, 0, TOTAL_SIZE);
+    uint8_t records[RECORDS_MAX];
+    size_t n = 0;
+
+    /* Records — only fields that differ from their default */
+    for (int i = 0; i < DEVICE_CONFIG_FIELD_COUNT; i++) {
+        const device_config_field_t *f = &device_config_fields[i];
+        const uint8_t *v = (const uint8_t *)cfg + f->offset;
+
+        if (field_is_default(f, cfg))
+            continue;
+
+        records[n++] = (uint8_t)i;
+        if (f->type == DEVICE_CONFIG_TYPE_U16) {
+            uint16_t u;
+            memcpy(&u, v, sizeof(u));
+            records[n++] = 2;
+            put_u16(&records[n], u);
+            n += 2;
+        } else {
+            size_t slen = 0;
+            while (slen < f->hi && v[slen] != '\0') slen++;
+            records[n++] = (uint8_t)slen;
+            memcpy(&records[n], v, slen);
+            n += slen;
+        }
+    }
 
-    uint8_t *p = buf;
+    size_t total = V2_HEADER_SIZE + n + CRC_SIZE;
+    if (len < total)
+        return -1;
 
     /* Header */
-    put_u32(p, CONFIG_MAGIC);   p += 4;
-    put_u16(p, CONFIG_VERSION); p += 2;
+    put_u32(buf, CONFIG_MAGIC);
+    put_u16(buf + 4, CONFIG_VERSION);
+    put_u16(buf + 6, (uint16_t)n);
+    memcpy(buf + V2_HEADER_SIZE, records, n);
 
-    /* Payload — fixed-size fields in stable order */
-    memcpy(p, cfg->wifi_ssid, DEVICE_CONFIG_WIFI_SSID_MAX + 1);
-    p += DEVICE_CONFIG_WIFI_SSID_MAX + 1;
+    /* CRC over header + records */
+    uint32_t crc = crc32_update(0, buf, V2_HEADER_SIZE + n);
+    put_u32(buf + V2_HEADER_SIZE + n, crc);
 
-    memcpy(p, cfg->wifi_password, DEVICE_CONFIG_WIFI_PASSWORD_MAX + 1);
-    p += DEVICE_CONFIG_WIFI_PASSWORD_MAX + 1;
+    return (int)total;
+}
+
+/** Decode a v1 fixed-layout blob (header already checked) into tmp. */
+static bool deserialize_v1(device_config_t *tmp, const uint8_t *buf,
+                           size_t len)
+{
+    if (len < HEADER_SIZE + V1_PAYLOAD_SIZE + CRC_SIZE)
+        return false;
 
-    put_u16(p, cfg->power_pulse_ms);  p += 2;
-    put_u16(p, cfg->boot_timeout_ms); p += 2;
+    uint32_t expected_crc = get_u32(buf + HEADER_SIZE + V1_PAYLOAD_SIZE);
+    uint32_t actual_crc = crc32_update(0, buf, HEADER_SIZE + V1_PAYLOAD_SIZE);
+    if (actual_crc != expected_crc)
+        return false;
 
-    memcpy(p, cfg->device_name, DEVICE_CONFIG_DEVICE_NAME_MAX + 1);
-    p += DEVICE_CONFIG_DEVICE_NAME_MAX + 1;
+    const uint8_t *p = buf + HEADER_SIZE;
+    for (int i = 0; i < V1_FIELD_COUNT; i++) {
+        const device_config_field_t *f = &device_config_fields[i];
+        uint8_t *v = (uint8_t *)tmp + f->offset;
 
-    /* CRC over header + payload */
-    uint32_t crc = crc32_update(0, buf, HEADER_SIZE + PAYLOAD_SIZE);
-    put_u32(p, crc);
+        if (f->type == DEVICE_CONFIG_TYPE_U16) {
+            uint16_t n = get_u16(p);
+            memcpy(v, &n, sizeof(n));
+        } else {
+            memcpy(v, p, f->size);
+        }
+        p += f->size;
+    }
 
-    return TOTAL_SIZE;
+    /* v1 was validated as a whole; keep that behaviour */
+    return device_config_validate(tmp);
 }
 
-bool device_config_deserialize(device_config_t *cfg,
-                               const uint8_t *buf, size_t len)
+/** Decode a v2+ TLV blob (header already checked) into tmp. */
+static bool deserialize_tlv(device_config_t *tmp, const uint8_t *buf,
+                            size_t len)
 {
-    if (!cfg || !buf || len < TOTAL_SIZE)
+    if (len < V2_HEADER_SIZE + CRC_SIZE)
         return false;
 
-    const uint8_t *p = buf;
-
-    /* Check magic */
-    if (get_u32(p) != CONFIG_MAGIC)
+    size_t n = get_u16(buf + 6);
+    if (len < V2_HEADER_SIZE + n + CRC_SIZE)
         return false;
-    p += 4;
 
-    /* Check version */
-    uint16_t ver = get_u16(p);
-    if (ver != CONFIG_VERSION)
-        return false;
-    p += 2;
-
-    /* Verify CRC */
-    uint32_t expected_crc = get_u32(buf + HEADER_SIZE + PAYLOAD_SIZE);
-    uint32_t actual_crc = crc32_update(0, buf, HEADER_SIZE + PAYLOAD_SIZE);
+    uint32_t expected_crc = get_u32(buf + V2_HEADER_SIZE + n);
+    uint32_t actual_crc = crc32_update(0, buf, V2_HEADER_SIZE + n);
     if (actual_crc != expected_crc)
         return false;
 
-    /* Deserialize payload into a temporary so we can validate before
-     * committing to the output struct */
-    device_config_t tmp;
-    memset(&tmp, 0, sizeof(tmp));
-
-    memcpy(tmp.wifi_ssid, p, DEVICE_CONFIG_WIFI_SSID_MAX + 1);
-    p += DEVICE_CONFIG_WIFI_SSID_MAX + 1;
+    const uint8_t *p   = buf + V2_HEADER_SIZE;
+    const uint8_t *end = p + n;
+    while (p < end) {
+        if (end - p < 2 || end - p - 2 < p[1])
+            return false;       /* record overruns the payload */
+
+        uint8_t tag = p[0], rlen = p[1];
+        if (tag < DEVICE_CONFIG_FIELD_COUNT)
+            apply_record(&device_config_fields[tag], tmp, p + 2, rlen);
+        /* else: written by newer firmware — skip */
+        p += 2 + rlen;
+    }
 
-    memcpy(tmp.wifi_password, p, DEVICE_CONFIG_WIFI_PASSWORD_MAX + 1);
-    p += DEVICE_CONFIG_WIFI_PASSWORD_MAX + 1;
+    return device_config_validate(tmp);
+}
 
-    tmp.power_pulse_ms  = get_u16(p); p += 2;
-    tmp.boot_timeout_ms = get_u16(p); p += 2;
+bool device_config_deserialize(device_config_t *cfg,
+                               const uint8_t *buf, size_t len)
+{
+    if (!cfg || !buf || len < HEADER_SIZE + CRC_SIZE)
+        return false;
 
-    memcpy(tmp.device_name, p, DEVICE_CONFIG_DEVICE_NAME_MAX + 1);
+    /* Check magic */
+    if (get_u32(buf) != CONFIG_MAGIC)
+        return false;
 
-    if (!device_config_validate(&tmp))
+    /* Decode into a temporary, starting from defaults so fields the blob
+     * does not mention (added since, or stored as default) get them */
+    device_config_t tmp;
+    device_config_init(&tmp);
+
+    uint16_t ver = get_u16(buf + 4);
+    bool ok;
+    if (ver == 1)
+        ok = deserialize_v1(&tmp, buf, len);
+    else if (ver >= 2)
+        ok = deserialize_tlv(&tmp, buf, len);
+    else
+        ok = false;
+
+    if (!ok)
         return false;
 
     *cfg = tmp;
@@ -0,0 +1,234 @@
+#include "dlog.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ── Ring ───────────────────────────────────────────────────────────── */
+
+#define RING_MASK (DLOG_RING_SIZE - 1u)
+
+/*
+ * Each slot carries its own sequence tag: 0 while a writer is filling
+ * it, entry seq + 1 once complete.  Readers check the tag before and
+ * after copying, so an entry overwritten mid-read is detected and
+ * counted as lost instead of being returned torn.
+ */
+typedef struct {
+    atomic_uint_fast32_t tag;
+    const char *fmt;
+    uint32_t    time_us;
+    uint8_t     level;
+    uint8_t     nargs;
+    uintptr_t   args[DLOG_MAX_ARGS];
+} slot_t;
+
+static slot_t               s_ring[DLOG_RING_SIZE];
+static atomic_uint_fast32_t s_head;        /* next sequence number */
+static dlog_clock_us_t      s_clock_us;
+
+/* ── Writer ─────────────────────────────────────────────────────────── */
+
+void dlog_init(dlog_clock_us_t clock_us)
+{
+    for (unsigned i = 0; i < DLOG_RING_SIZE; i++)
+        atomic_store_explicit(&s_ring[i].tag, 0, memory_order_relaxed);
+    atomic_store_explicit(&s_head, 0, memory_order_release);
+    s_clock_us = clock_us;
+}
+
+void dlog_push(uint8_t level, const char *fmt, uint8_t nargs,
+               uintptr_t a0, uintptr_t a1, uintptr_t a2, uintptr_t a3)
+{
+    uint32_t seq = (uint32_t)atomic_fetch_add_explicit(&s_head, 1,
+                                                       memory_order_relaxed);
+    slot_t *s = &s_ring[seq & RING_MASK];
+
+    atomic_store_explicit(&s->tag, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    s->fmt     = fmt;
+    s->time_us = s_clock_us ? s_clock_us() : 0;
+    s->level   = level;
+    s->nargs   = nargs > DLOG_MAX_ARGS ? DLOG_MAX_ARGS : nargs;
+    s->args[0] = a0;
+    s->args[1] = a1;
+    s->args[2] = a2;
+    s->args[3] = a3;
+
+    atomic_store_explicit(&s->tag, seq + 1u, memory_order_release);
+}
+
+uint32_t dlog_written(void)
+{
+    return (uint32_t)atomic_load_explicit(&s_head, memory_order_acquire);
+}
+
+/* ── Readers ────────────────────────────────────────────────────────── */
+
+void dlog_cursor_oldest(dlog_cursor_t *c)
+{
+    uint32_t head = dlog_written();
+    c->next = head > DLOG_RING_SIZE ? head - DLOG_RING_SIZE : 0;
+    c->lost = 0;
+}
+
+bool dlog_read(dlog_cursor_t *c, dlog_entry_t *out)
+{
+    for (;;) {
+        uint32_t head = dlog_written();
+        if (c->next == head)
+            return false;
+
+        /* Lapped: everything older than one ring is gone */
+        uint32_t behind = head - c->next;
+        if (behind > DLOG_RING_SIZE) {
+            c->lost += behind - DLOG_RING_SIZE;
+            c->next  = head - DLOG_RING_SIZE;
+        }
+
+        const slot_t *s = &s_ring[c->next & RING_MASK];
+        uint32_t want = c->next + 1u;
+        uint32_t tag  = (uint32_t)atomic_load_explicit(&s->tag,
+                                                       memory_order_acquire);
+        if (tag != want) {
+            if ((int32_t)(tag - want) > 0) {
+                /* Already reused for a newer entry */
+                c->lost++;
+                c->next++;
+                continue;
+            }
+            return false;   /* writer still filling it */
+        }
+
+        out->fmt     = s->fmt;
+        out->time_us = s->time_us;
+        out->level   = s->level;
+        out->nargs   = s->nargs;
+        memcpy(out->args, s->args, sizeof(out->args));
+
+        atomic_thread_fence(memory_order_acquire);
+        if ((uint32_t)atomic_load_explicit(&s->tag,
+                                           memory_order_relaxed) != want) {
+            c->lost++;
+            c->next++;
+            continue;
+        }
+
+        out->seq = c->next++;
+        return true;
+    }
+}
+
+/* ── Formatting ─────────────────────────────────────────────────────── */
+
+typedef struct {
+    char  *buf;
+    size_t size;
+    size_t len;
+} out_t;
+
+static void out_advance(out_t *o, int n)
+{
+    if (n < 0)
+        return;
+    o->len += (size_t)n;
+    if (o->len >= o->size)
+        o->len = o->size - 1;
+}
+
+static void out_char(out_t *o, char ch)
+{
+    if (o->len + 1 < o->size) {
+        o->buf[o->len++] = ch;
+        o->buf[o->len] = '\0';
+    }
+}
+
+/**
+ * Render one conversion.  The spec (flags, width, precision, minus any
+ * length modifier) is handed to snprintf with the argument cast back to
+ * the type the conversion expects.
+ */
+static void out_conv(out_t *o, const char *spec, char conv, uintptr_t arg)
+{
+    char  *dst  = o->buf + o->len;
+    size_t room = o->size - o->len;
+
+    switch (conv) {
+    case 'd': case 'i': case 'c':
+        out_advance(o, snprintf(dst, room, spec, (int)arg));
+        break;
+    case 'u': case 'x': case 'X': case 'o':
+        out_advance(o, snprintf(dst, room, spec, (unsigned)arg));
+        break;
+    case 's':
+        out_advance(o, snprintf(dst, room, spec,
+                                arg ? (const char *)arg : "(null)"));
+        break;
+    case 'p':
+        out_advance(o, snprintf(dst, room, spec, (void *)arg));
+        break;
+    default:
+        break;
+    }
+}
+
+static const char s_level_char[] = "EWID";
+
+int dlog_format(const dlog_entry_t *e, char *buf, size_t size)
+{
+    if (!buf || size == 0)
+        return 0;
+
+    out_t o = { buf, size, 0 };
+    buf[0] = '\0';
+
+    char lvl = e->level < sizeof(s_level_char) - 1 ? s_level_char[e->level]
+                                                   : '?';
+    out_advance(&o, snprintf(buf, size, "%u.%06u %c ",
+                             (unsigned)(e->time_us / 1000000u),
+                             (unsigned)(e->time_us % 1000000u), lvl));
+
+    const char *p = e->fmt ? e->fmt : "";
+    unsigned argi = 0;
+
+    while (*p && o.len + 1 < o.size) {
+        if (*p != '%') {
+            out_char(&o, *p++);
+            continue;
+        }
+
+        /* Collect "%[flags][width][.prec]" and skip length modifiers */
+        char spec[16];
+        size_t n = 0;
+        const char *start = p;
+        spec[n++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && n < sizeof(spec) - 2)
+            spec[n++] = *p++;
+        while (*p && strchr("hljzt", *p))
+            p++;
+
+        char conv = *p;
+        if (conv == '%') {
+            out_char(&o, '%');
+            p++;
+            continue;
+        }
+        if (!conv || !strchr("diucxXosp", conv)) {
+            /* Not a conversion we know: print it literally */
+            while (start < p && o.len + 1 < o.size)
+                out_char(&o, *start++);
+            continue;
+        }
+        p++;
+        spec[n++] = conv;
+        spec[n]   = '\0';
+
+        if (argi < e->nargs)
+            out_conv(&o, spec, conv, e->args[argi++]);
+        else
+            out_char(&o, '?');
+    }
+
+    return (int)o.len;
+}
@@ -0,0 +1,253 @@
+#include "ds4_report.h"
+
+#include <string.h>
+
+#define DS4_PAYLOAD_LEN (DS4_REPORT_LEN - 1)
+
+/*
+ * Fields the host parses (sticks, hat, 14 buttons, triggers) are
+ * declared; status, IMU and touchpad bytes are one vendor-defined block,
+ * as Sony's own descriptor does.
+ */
+const uint8_t ds4_report_descriptor[DS4_REPORT_DESCRIPTOR_LEN] = {
+    0x05, 0x01,        /* Usage Page (Generic Desktop) */
+    0x09, 0x05,        /* Usage (Gamepad) */
+    0xA1, 0x01,        /* Collection (Application) */
+    0x85, 0x01,        /*   Report ID (1) */
+
+    /* ── Sticks ─────────────────────────────────────────── */
+    0x09, 0x30,        /*   Usage (X) */
+    0x09, 0x31,        /*   Usage (Y) */
+    0x09, 0x32,        /*   Usage (Z) */
+    0x09, 0x35,        /*   Usage (Rz) */
+    0x15, 0x00,        /*   Logical Minimum (0) */
+    0x26, 0xFF, 0x00,  /*   Logical Maximum (255) */
+    0x75, 0x08,        /*   Report Size (8) */
+    0x95, 0x04,        /*   Report Count (4) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+
+    /* ── Hat switch ─────────────────────────────────────── */
+    0x09, 0x39,        /*   Usage (Hat Switch) */
+    0x25, 0x07,        /*   Logical Maximum (7) */
+    0x35, 0x00,        /*   Physical Minimum (0) */
+    0x46, 0x3B, 0x01,  /*   Physical Maximum (315) */
+    0x65, 0x14,        /*   Unit (Degrees) */
+    0x75, 0x04,        /*   Report Size (4) */
+    0x95, 0x01,        /*   Report Count (1) */
+    0x81, 0x42,        /*   Input (Data, Variable, Absolute, Null) */
+    0x65, 0x00,        /*   Unit (None) */
+    0x45, 0x00,        /*   Physical Maximum (0) */
+
+    /* ── Buttons ────────────────────────────────────────── */
+    0x05, 0x09,        /*   Usage Page (Button) */
+    0x19, 0x01,        /*   Usage Minimum (Button 1) */
+    0x29, 0x0E,        /*   Usage Maximum (Button 14) */
+    0x25, 0x01,        /*   Logical Maximum (1) */
+    0x75, 0x01,        /*   Report Size (1) */
+    0x95, 0x0E,        /*   Report Count (14) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+
+    /* ── Report counter ─────────────────────────────────── */
+    0x06, 0x00, 0xFF,  /*   Usage Page (Vendor Defined 0xFF00) */
+    0x09, 0x20,        /*   Usage (0x20) */
+    0x25, 0x3F,        /*   Logical Maximum (63) */
+    0x75, 0x06,        /*   Report Size (6) */
+    0x95, 0x01,        /*   Report Count (1) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+
+    /* ── Triggers ───────────────────────────────────────── */
+    0x05, 0x01,        /*   Usage Page (Generic Desktop) */
+    0x09, 0x33,        /*   Usage (Rx) */
+    0x09, 0x34,        /*   Usage (Ry) */
+    0x26, 0xFF, 0x00,  /*   Logical Maximum (255) */
+    0x75, 0x08,        /*   Report Size (8) */
+    0x95, 0x02,        /*   Report Count (2) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+
+    /* ── Timestamp, IMU, status, touchpad ───────────────── */
+    0x06, 0x00, 0xFF,  /*   Usage Page (Vendor Defined 0xFF00) */
+    0x09, 0x21,        /*   Usage (0x21) */
+    0x95, 0x36,        /*   Report Count (54) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+
+    /* ── Output: motors, lightbar ───────────────────────── */
+    0x85, 0x05,        /*   Report ID (5) */
+    0x09, 0x22,        /*   Usage (0x22) */
+    0x95, 0x1F,        /*   Report Count (31) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+
+    /* ── Features ───────────────────────────────────────── */
+    0x85, 0x02,        /*   Report ID (2) - IMU calibration */
+    0x09, 0x24,        /*   Usage (0x24) */
+    0x95, 0x24,        /*   Report Count (36) */
+    0xB1, 0x02,        /*   Feature (Data, Variable, Absolute) */
+    0x85, 0x81,        /*   Report ID (0x81) - MAC address */
+    0x09, 0x25,        /*   Usage (0x25) */
+    0x95, 0x06,        /*   Report Count (6) */
+    0xB1, 0x02,        /*   Feature (Data, Variable, Absolute) */
+    0x85, 0xA3,        /*   Report ID (0xA3) - firmware info */
+    0x09, 0x26,        /*   Usage (0x26) */
+    0x95, 0x30,        /*   Report Count (48) */
+    0xB1, 0x02,        /*   Feature (Data, Variable, Absolute) */
+
+    0xC0,              /* End Collection */
+};
+
+/* Input report offsets */
+#define DS4_LX          1
+#define DS4_BTN_HAT     5
+#define DS4_BTN_MISC    6
+#define DS4_BTN_PS      7
+#define DS4_L2          8
+#define DS4_R2          9
+#define DS4_STATUS      30
+#define DS4_TOUCH_0     35
+#define DS4_TOUCH_1     39
+
+#define DS4_STATUS_CABLE_FULL  0x1B     /* cable in, battery full */
+#define DS4_TOUCH_IDLE         0x80     /* finger not touching    */
+
+/* Output report 0x05 */
+#define DS4_OUT_FLAGS       1
+#define DS4_OUT_FLAG_MOTOR  0x01
+#define DS4_OUT_WEAK        4
+#define DS4_OUT_STRONG      5
+
+/** Full-range axis to DS4's 0..255, centre 0x80. */
+static inline uint8_t axis8(int16_t v)
+{
+    return (uint8_t)((v >> 8) + 0x80);
+}
+
+static void put_le16(uint8_t *p, int16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+bool ds4_report_from_bt(const uint8_t *bt, uint16_t len,
+                        uint8_t out[DS4_REPORT_LEN])
+{
+    if (len >= DS4_BT_HEADER_LEN + DS4_PAYLOAD_LEN &&
+        bt[0] == DS4_BT_REPORT_ID) {
+        out[0] = DS4_REPORT_ID;
+        memcpy(&out[1], &bt[DS4_BT_HEADER_LEN], DS4_PAYLOAD_LEN);
+        return true;
+    }
+
+    if (len >= DS4_BT_BASIC_LEN && bt[0] == DS4_REPORT_ID) {
+        memcpy(out, bt, DS4_BT_BASIC_LEN);
+        memset(&out[DS4_BT_BASIC_LEN], 0, DS4_REPORT_LEN - DS4_BT_BASIC_LEN);
+        return true;
+    }
+
+    return false;
+}
+
+uint8_t ds4_report_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                uint8_t out[DS4_REPORT_LEN])
+{
+    uint16_t b = in->buttons;
+    uint8_t lt = (uint8_t)(in->lt >> 2);
+    uint8_t rt = (uint8_t)(in->rt >> 2);
+
+    memset(out, 0, DS4_REPORT_LEN);
+    out[0] = DS4_REPORT_ID;
+    out[DS4_LX + 0] = axis8(in->lx);
+    out[DS4_LX + 1] = axis8(in->ly);
+    out[DS4_LX + 2] = axis8(in->rx);
+    out[DS4_LX + 3] = axis8(in->ry);
+
+    /* Same hat encoding as ours: 0 = N clockwise, 8 = centred */
+    out[DS4_BTN_HAT] = (uint8_t)((in->dpad & 0x0F) |
+                                 (b & GAMEPAD_BTN_X ? 0x10 : 0) |  /* square   */
+                                 (b & GAMEPAD_BTN_A ? 0x20 : 0) |  /* cross    */
+                                 (b & GAMEPAD_BTN_B ? 0x40 : 0) |  /* circle   */
+                                 (b & GAMEPAD_BTN_Y ? 0x80 : 0));  /* triangle */
+    out[DS4_BTN_MISC] = (uint8_t)((b & GAMEPAD_BTN_L1     ? 0x01 : 0) |
+                                  (b & GAMEPAD_BTN_R1     ? 0x02 : 0) |
+                                  (lt                     ? 0x04 : 0) |
+                                  (rt                     ? 0x08 : 0) |
+                                  (b & GAMEPAD_BTN_SELECT ? 0x10 : 0) |
+                                  (b & GAMEPAD_BTN_START  ? 0x20 : 0) |
+                                  (b & GAMEPAD_BTN_L3     ? 0x40 : 0) |
+                                  (b & GAMEPAD_BTN_R3     ? 0x80 : 0));
+    out[DS4_BTN_PS] = (uint8_t)((b & GAMEPAD_BTN_GUIDE ? 0x01 : 0) |
+                                (b & GAMEPAD_BTN_MISC  ? 0x02 : 0) |
+                                (seq << 2));
+    out[DS4_L2] = lt;
+    out[DS4_R2] = rt;
+
+    out[DS4_STATUS]  = DS4_STATUS_CABLE_FULL;
+    out[DS4_TOUCH_0] = DS4_TOUCH_IDLE;
+    out[DS4_TOUCH_1] = DS4_TOUCH_IDLE;
+    return DS4_REPORT_LEN;
+}
+
+bool ds4_report_to_output(const uint8_t *buf, uint16_t len,
+                          gamepad_output_t *out)
+{
+    if (len <= DS4_OUT_STRONG || buf[0] != DS4_OUTPUT_ID ||
+        !(buf[DS4_OUT_FLAGS] & DS4_OUT_FLAG_MOTOR))
+        return false;
+
+    out->strong = buf[DS4_OUT_STRONG];
+    out->weak   = buf[DS4_OUT_WEAK];
+    return true;
+}
+
+/*
+ * IMU calibration for a controller without one: zero bias, symmetric
+ * ranges.  Hosts divide by (plus - minus), so neither range may be zero.
+ */
+#define DS4_CALIB_LEN       36
+#define DS4_CALIB_RANGE     8192
+#define DS4_CALIB_SPEED     540
+
+static void calibration(uint8_t c[DS4_CALIB_LEN])
+{
+    memset(c, 0, DS4_CALIB_LEN);
+    /* 0-5: gyro bias; 6-17: gyro pitch/yaw/roll plus, minus */
+    for (int i = 0; i < 3; i++) {
+        put_le16(&c[6 + 4 * i], DS4_CALIB_RANGE);
+        put_le16(&c[8 + 4 * i], -DS4_CALIB_RANGE);
+    }
+    put_le16(&c[18], DS4_CALIB_SPEED);
+    put_le16(&c[20], DS4_CALIB_SPEED);
+    /* 22-33: accel X/Y/Z plus, minus */
+    for (int i = 0; i < 3; i++) {
+        put_le16(&c[22 + 4 * i], DS4_CALIB_RANGE);
+        put_le16(&c[24 + 4 * i], -DS4_CALIB_RANGE);
+    }
+}
+
+uint16_t ds4_report_feature(uint8_t id, uint8_t *buf, uint16_t len)
+{
+    uint8_t report[48];
+    uint16_t n;
+
+    memset(report, 0, sizeof(report));
+    switch (id) {
+    case DS4_FEATURE_CALIB:
+        calibration(report);
+        n = DS4_CALIB_LEN;
+        break;
+    case DS4_FEATURE_MAC: {
+        /* Locally administered, so it never collides with a real pad */
+        static const uint8_t mac[6] = { 0x01, 0x00, 0x00, 0x50, 0x50, 0x02 };
+        memcpy(report, mac, sizeof(mac));
+        n = sizeof(mac);
+        break;
+    }
+    case DS4_FEATURE_FW:
+        n = sizeof(report);
+        break;
+    default:
+        return 0;
+    }
+
+    if (n > len)
+        n = len;
+    memcpy(buf, report, n);
+    return n;
+}
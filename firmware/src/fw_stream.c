@@ -0,0 +1,182 @@
+#include "fw_stream.h"
+#include "crc32.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* ── Helpers ────────────────────────────────────────────────────────── */
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static fw_stream_status_t fail(fw_stream_t *s, fw_stream_status_t status,
+                               uint32_t now_ms)
+{
+    s->status = status;
+    s->end_ms = now_ms;
+    s->ack_pending = false;
+    return status;
+}
+
+/** Payload length the next frame must carry. */
+static uint32_t expected_frame_len(const fw_stream_t *s)
+{
+    uint32_t remaining = s->total_size - s->received;
+    return remaining < FW_STREAM_CHUNK_MAX ? remaining : FW_STREAM_CHUNK_MAX;
+}
+
+/** Called once the header of a frame has been collected. */
+static bool accept_header(fw_stream_t *s)
+{
+    uint16_t seq = get_u16(&s->hdr[0]);
+    uint16_t len = get_u16(&s->hdr[2]);
+
+    if (seq != s->next_seq)
+        return false;
+    if (len == 0 || len != expected_frame_len(s))
+        return false;
+
+    s->frame_len = len;
+    s->frame_pos = 0;
+    return true;
+}
+
+/** Called once all payload bytes of a frame have been consumed. */
+static void complete_frame(fw_stream_t *s)
+{
+    uint16_t seq = s->next_seq++;
+    s->hdr_pos = 0;
+    s->frame_len = 0;
+    s->frame_pos = 0;
+
+    bool last = (s->received == s->total_size);
+    if (last || ((uint16_t)(seq + 1) % FW_STREAM_ACK_EVERY) == 0) {
+        s->ack_pending = true;
+        s->ack_seq = seq;
+    }
+}
+
+/* ── Public API ─────────────────────────────────────────────────────── */
+
+void fw_stream_begin(fw_stream_t *s, uint32_t total_size,
+                     uint32_t expected_crc, fw_stream_sink_t sink,
+                     void *sink_ctx, uint32_t now_ms)
+{
+    memset(s, 0, sizeof(*s));
+    s->total_size   = total_size;
+    s->expected_crc = expected_crc;
+    s->sink         = sink;
+    s->sink_ctx     = sink_ctx;
+    s->start_ms     = now_ms;
+    s->last_rx_ms   = now_ms;
+    s->status = (total_size == 0 || !sink) ? FW_STREAM_ERROR_PROTOCOL
+                                           : FW_STREAM_ACTIVE;
+}
+
+fw_stream_status_t fw_stream_feed(fw_stream_t *s, const uint8_t *data,
+                                  size_t len, uint32_t now_ms)
+{
+    if (s->status != FW_STREAM_ACTIVE)
+        return s->status;
+
+    if (len > 0)
+        s->last_rx_ms = now_ms;
+
+    size_t off = 0;
+    while (off < len) {
+        if (s->hdr_pos < FW_STREAM_HEADER_SIZE) {
+            s->hdr[s->hdr_pos++] = data[off++];
+            if (s->hdr_pos == FW_STREAM_HEADER_SIZE && !accept_header(s))
+                return fail(s, FW_STREAM_ERROR_PROTOCOL, now_ms);
+            continue;
+        }
+
+        /* Payload: hand the largest contiguous run straight to the sink */
+        size_t want = (size_t)(s->frame_len - s->frame_pos);
+        size_t run  = (len - off < want) ? (len - off) : want;
+
+        if (!s->sink(data + off, run, s->sink_ctx))
+            return fail(s, FW_STREAM_ERROR_SINK, now_ms);
+
+        s->crc = crc32_update(s->crc, data + off, run);
+        s->frame_pos += (uint16_t)run;
+        s->received  += (uint32_t)run;
+        off += run;
+
+        if (s->frame_pos == s->frame_len) {
+            complete_frame(s);
+            if (s->received == s->total_size) {
+                s->end_ms = now_ms;
+                s->status = (s->crc == s->expected_crc)
+                          ? FW_STREAM_DONE : FW_STREAM_ERROR_CRC;
+                return s->status;
+            }
+        }
+    }
+
+    return s->status;
+}
+
+fw_stream_status_t fw_stream_poll(fw_stream_t *s, uint32_t now_ms)
+{
+    if (s->status == FW_STREAM_ACTIVE &&
+        (now_ms - s->last_rx_ms) >= FW_STREAM_IDLE_TIMEOUT_MS)
+        return fail(s, FW_STREAM_ERROR_TIMEOUT, now_ms);
+    return s->status;
+}
+
+bool fw_stream_take_ack(fw_stream_t *s, uint8_t out[FW_STREAM_ACK_SIZE])
+{
+    if (!s->ack_pending)
+        return false;
+
+    out[0] = FW_STREAM_ACK_BYTE;
+    out[1] = (uint8_t)(s->ack_seq & 0xFF);
+    out[2] = (uint8_t)(s->ack_seq >> 8);
+    s->ack_pending = false;
+    return true;
+}
+
+bool fw_stream_active(const fw_stream_t *s)
+{
+    return s->status == FW_STREAM_ACTIVE;
+}
+
+int fw_stream_format_result(const fw_stream_t *s, char *buf, size_t size)
+{
+    int n;
+
+    if (s->status == FW_STREAM_DONE) {
+        uint32_t ms = s->end_ms - s->start_ms;
+        /* bytes/ms == KB/s (decimal kilobytes) */
+        uint32_t kbps = ms ? s->received / ms : s->received;
+        n = snprintf(buf, size, "OK %u %u %u\n", (unsigned)s->received,
+                     (unsigned)ms, (unsigned)kbps);
+    } else if (s->status == FW_STREAM_ERROR_CRC) {
+        n = snprintf(buf, size, "ERR crc mismatch (got %08x, expected %08x)\n",
+                     (unsigned)s->crc, (unsigned)s->expected_crc);
+    } else {
+        n = snprintf(buf, size, "ERR firmware %s at byte %u\n",
+                     fw_stream_status_name(s->status),
+                     (unsigned)s->received);
+    }
+
+    if (n < 0) return 0;
+    return (n >= (int)size) ? (int)size - 1 : n;
+}
+
+const char *fw_stream_status_name(fw_stream_status_t status)
+{
+    switch (status) {
+    case FW_STREAM_IDLE:           return "idle";
+    case FW_STREAM_ACTIVE:         return "active";
+    case FW_STREAM_DONE:           return "done";
+    case FW_STREAM_ERROR_PROTOCOL: return "protocol error";
+    case FW_STREAM_ERROR_SINK:     return "write error";
+    case FW_STREAM_ERROR_CRC:      return "crc mismatch";
+    case FW_STREAM_ERROR_TIMEOUT:  return "timeout";
+    default:                       return "unknown";
+    }
+}
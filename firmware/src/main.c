@@ -10,9 +10,22 @@
 #include "usb_hid_gamepad.h"
 #include "pc_power_state.h"
 #include "pc_power_hal.h"
+#include "pc_power_fusion.h"
+#include "pc_power_trace.h"
+#include "power_led.h"
+#include "button_latch.h"
+#include "report_filter.h"
+#include "axis_curve.h"
+#include "output_coalesce.h"
 #include "ota_update.h"
+#include "wifi_sta.h"
 #include "device_config.h"
 #include "setup_cmd.h"
+#include "setup_bin.h"
+#include "fw_stream.h"
+#include "metrics.h"
+#include "sched.h"
+#include "dlog.h"
 
 /* ── Compile-time WiFi fallback ──────────────────────────────────────── */
 
@@ -28,13 +41,290 @@
 static pc_power_sm_t s_power_sm;
 static device_config_t s_config;
 
+/** Power-LED pattern classifier, fed from the HAL's IRQ edge ring. */
+static power_led_t s_led;
+static uint32_t    s_led_edges_dropped;
+
+/** Weighs LED, USB and VBUS into the events the power SM sees. */
+static pc_fusion_t s_fusion;
+
+/**
+ * Previous report per player, used to detect edges (e.g. guide button
+ * press).  Sending the same unchanged report repeatedly is fine for USB
+ * HID, but we only want to fire a wake event on the *press* edge, not
+ * every poll.
+ */
+static gamepad_report_t s_prev_report[BT_GAMEPAD_MAX];
+static bool s_prev_report_valid[BT_GAMEPAD_MAX];
+
+/** Per-player taps latched until a USB report carried them. */
+static button_latch_t s_latch[BT_GAMEPAD_MAX];
+
+/** Per-player send-on-change filter; settings follow s_config. */
+static report_filter_t s_filter[BT_GAMEPAD_MAX];
+
+/**
+ * Stick and trigger response curves, shared by all players.  Rebuilt by
+ * the gamepad task when their settings change; building samples the
+ * curves into tables so applying them per report stays cheap.
+ */
+static axis_curve_set_t s_curves;
+static axis_curve_cfg_t s_curves_cfg[3];    /* lstick, rstick, trigger */
+static bool             s_curves_built;
+
 /**
- * Previous gamepad report, used to detect edges (e.g. guide button press).
- * Sending the same unchanged report repeatedly is fine for USB HID, but
- * we only want to fire a wake event on the *press* edge, not every poll.
+ * Shortest time between two rumble/LED updates to one controller.  Games
+ * may rewrite rumble every frame; each update is an outgoing BT packet,
+ * and a backlog of them in the controller's few ACL buffers delays
+ * everything else on the link.  25 ms still follows any rumble effect.
+ */
+#define OUTPUT_INTERVAL_MS 25
+
+/** Per-player rumble/LED state from the host, rate-bounded. */
+static output_coalesce_t s_output[BT_GAMEPAD_MAX];
+
+/* ── Scheduler ───────────────────────────────────────────────────────── */
+
+/*
+ * Main-loop tasks, most urgent first.  Gamepad forwarding and the
+ * hardware task (on a power-LED edge) also run whenever an event
+ * notifies them; their periods are only a fallback.  The CDC task keeps
+ * itself notified while a firmware stream is in flight so the transfer
+ * runs at full speed.
+ */
+#define TASK_USB_PERIOD_MS      1
+#define TASK_GAMEPAD_PERIOD_MS  8
+#define TASK_HW_PERIOD_MS       20
+#define TASK_CDC_PERIOD_MS      10
+#define TASK_WIFI_PERIOD_MS     500
+
+/*
+ * The deferred log drains to the UART only in idle time, a few lines
+ * per pass, so printing never delays USB or gamepad forwarding.
  */
-static gamepad_report_t s_prev_report;
-static bool s_prev_report_valid;
+#define TASK_LOG_PERIOD_MS      10
+#define LOG_DRAIN_PER_PASS      2
+
+static sched_t s_sched;
+static int     s_task_gamepad = -1;
+static int     s_task_hw      = -1;
+static int     s_task_cdc     = -1;
+
+/* ── Metrics ─────────────────────────────────────────────────────────── */
+
+/* Counters are plain increments; metrics.c reads them only when the
+ * "status"/"stats" commands ask. */
+static uint32_t s_reports_forwarded;
+static uint32_t s_reports_native;
+static uint32_t s_wake_requests;
+static uint32_t s_setup_commands;
+
+/** Latency of the last completed wake from sleep (request to PC_ON), per
+ *  method: USB remote wakeup, power-button pulse, or pulse after remote
+ *  wakeup timed out.  0 until that method has woken the PC once. */
+static uint32_t s_wake_usb_ms;
+static uint32_t s_wake_button_ms;
+static uint32_t s_wake_fallback_ms;
+static uint32_t s_wake_fallbacks;
+static uint32_t s_wol_sent;
+static uint32_t s_wol_failed;
+
+/** UART reader of the deferred log; .lost counts lines it never printed. */
+static dlog_cursor_t s_log_uart;
+
+static const char *metric_pc_state(void *ctx)
+{
+    (void)ctx;
+    return pc_power_state_name(pc_power_sm_get_state(&s_power_sm));
+}
+
+static const char *metric_bt_connected(void *ctx)
+{
+    (void)ctx;
+    return bt_gamepad_connected_count() > 0 ? "true" : "false";
+}
+
+static uint32_t metric_bt_pads(void *ctx)
+{
+    (void)ctx;
+    return bt_gamepad_connected_count();
+}
+
+static uint32_t metric_reports_suppressed(void *ctx)
+{
+    (void)ctx;
+    uint32_t n = 0;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += s_filter[i].suppressed;
+    return n;
+}
+
+/* USB report pipe counters, summed over all players. */
+#define HID_PIPE_METRIC(field)                                  \
+    static uint32_t metric_hid_##field(void *ctx)               \
+    {                                                           \
+        (void)ctx;                                              \
+        uint32_t n = 0;                                         \
+        for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)            \
+            n += usb_hid_gamepad_pipe(i)->field;                \
+        return n;                                               \
+    }
+
+HID_PIPE_METRIC(deferred)
+HID_PIPE_METRIC(replaced)
+HID_PIPE_METRIC(refusals)
+HID_PIPE_METRIC(retries)
+
+static uint32_t metric_rumble_updates(void *ctx)
+{
+    (void)ctx;
+    uint32_t n = 0;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += s_output[i].updates;
+    return n;
+}
+
+static uint32_t metric_rumble_coalesced(void *ctx)
+{
+    (void)ctx;
+    uint32_t n = 0;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += s_output[i].coalesced;
+    return n;
+}
+
+static uint32_t metric_motion_reports(void *ctx)
+{
+    (void)ctx;
+    return usb_hid_gamepad_motion()->sent;
+}
+
+static uint32_t metric_motion_drops(void *ctx)
+{
+    (void)ctx;
+    return usb_hid_gamepad_motion()->replaced;
+}
+
+static uint32_t metric_taps_latched(void *ctx)
+{
+    (void)ctx;
+    uint32_t n = 0;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += s_latch[i].latched;
+    return n;
+}
+
+static uint32_t metric_uptime_s(void *ctx)
+{
+    (void)ctx;
+    return pc_power_hal_millis() / 1000;
+}
+
+static const char *metric_led_pattern(void *ctx)
+{
+    return power_led_pattern_name(power_led_pattern(ctx));
+}
+
+static uint32_t metric_led_blink_ms(void *ctx)
+{
+    return power_led_blink_period_ms(ctx);
+}
+
+static uint32_t metric_led_duty_pct(void *ctx)
+{
+    return power_led_blink_duty_pct(ctx);
+}
+
+static const char *metric_pc_verdict(void *ctx)
+{
+    return pc_fusion_verdict_name(pc_fusion_verdict(ctx));
+}
+
+static uint32_t metric_boot_eta_ms(void *ctx)
+{
+    (void)ctx;
+    return pc_power_sm_boot_eta_ms(&s_power_sm, pc_power_hal_millis());
+}
+
+static uint32_t metric_boot_cold_ms(void *ctx)
+{
+    (void)ctx;
+    return pc_power_sm_boot_typical_ms(&s_power_sm, PC_BOOT_COLD);
+}
+
+static uint32_t metric_boot_resume_ms(void *ctx)
+{
+    (void)ctx;
+    return pc_power_sm_boot_typical_ms(&s_power_sm, PC_BOOT_RESUME);
+}
+
+static const char *metric_usb_mode(void *ctx)
+{
+    (void)ctx;
+    return usb_hid_gamepad_mode_name();
+}
+
+static const char *metric_wifi(void *ctx)
+{
+    (void)ctx;
+    return wifi_sta_state_name(wifi_sta_state());
+}
+
+static bool register_metrics(void)
+{
+    bool ok = true;
+
+    ok &= metrics_register_text("pc_state", metric_pc_state, NULL,
+                                METRICS_F_STATUS);
+    ok &= metrics_register_text("bt_connected", metric_bt_connected, NULL,
+                                METRICS_F_STATUS);
+    ok &= metrics_register_u32("bt_pads", metric_bt_pads, NULL,
+                               METRICS_F_STATUS);
+    ok &= metrics_register_text("usb_mode", metric_usb_mode, NULL,
+                                METRICS_F_STATUS);
+    ok &= metrics_register_u32("uptime_s", metric_uptime_s, NULL, 0);
+    ok &= metrics_register_u32("boot_eta_ms", metric_boot_eta_ms, NULL,
+                               METRICS_F_STATUS);
+    ok &= metrics_register_u32("boot_cold_ms", metric_boot_cold_ms, NULL, 0);
+    ok &= metrics_register_u32("boot_resume_ms", metric_boot_resume_ms,
+                               NULL, 0);
+    ok &= metrics_register_text("pc_verdict", metric_pc_verdict, &s_fusion, 0);
+    ok &= metrics_register_counter("pc_verdicts", &s_fusion.verdicts, 0);
+    ok &= metrics_register_counter("reports_forwarded", &s_reports_forwarded,
+                                   0);
+    ok &= metrics_register_counter("reports_native", &s_reports_native, 0);
+    ok &= metrics_register_u32("reports_suppressed", metric_reports_suppressed,
+                               NULL, 0);
+    ok &= metrics_register_u32("hid_deferred", metric_hid_deferred, NULL, 0);
+    ok &= metrics_register_u32("hid_drops", metric_hid_replaced, NULL, 0);
+    ok &= metrics_register_u32("hid_refusals", metric_hid_refusals, NULL, 0);
+    ok &= metrics_register_u32("hid_retries", metric_hid_retries, NULL, 0);
+    ok &= metrics_register_u32("taps_latched", metric_taps_latched, NULL, 0);
+    ok &= metrics_register_u32("rumble_updates", metric_rumble_updates,
+                               NULL, 0);
+    ok &= metrics_register_u32("rumble_coalesced", metric_rumble_coalesced,
+                               NULL, 0);
+    ok &= metrics_register_u32("motion_reports", metric_motion_reports,
+                               NULL, 0);
+    ok &= metrics_register_u32("motion_drops", metric_motion_drops, NULL, 0);
+    ok &= metrics_register_counter("wake_requests", &s_wake_requests, 0);
+    ok &= metrics_register_counter("wake_usb_ms", &s_wake_usb_ms, 0);
+    ok &= metrics_register_counter("wake_button_ms", &s_wake_button_ms, 0);
+    ok &= metrics_register_counter("wake_fallback_ms", &s_wake_fallback_ms, 0);
+    ok &= metrics_register_counter("wake_fallbacks", &s_wake_fallbacks, 0);
+    ok &= metrics_register_text("wifi", metric_wifi, NULL, 0);
+    ok &= metrics_register_counter("wol_sent", &s_wol_sent, 0);
+    ok &= metrics_register_counter("wol_failed", &s_wol_failed, 0);
+    ok &= metrics_register_text("led_pattern", metric_led_pattern, &s_led, 0);
+    ok &= metrics_register_u32("led_blink_ms", metric_led_blink_ms, &s_led, 0);
+    ok &= metrics_register_u32("led_duty_pct", metric_led_duty_pct, &s_led, 0);
+    ok &= metrics_register_counter("led_edges", &s_led.edges, 0);
+    ok &= metrics_register_counter("led_glitches", &s_led.glitches, 0);
+    ok &= metrics_register_counter("setup_commands", &s_setup_commands, 0);
+    ok &= metrics_register_counter("log_lost", &s_log_uart.lost, 0);
+
+    return ok;
+}
 
 /* ── CDC setup serial ───────────────────────────────────────────────── */
 
@@ -43,58 +333,192 @@ static bool s_prev_report_valid;
 static char    s_cdc_line[CDC_LINE_MAX];
 static uint8_t s_cdc_line_pos;
 
+/** Binary setup frame being collected (see setup_bin.h).  Active from a
+ *  SETUP_BIN_MAGIC byte at the start of a line until the 0x00 terminator,
+ *  or until it idles or overflows. */
+static setup_bin_rx_t s_cdc_rx;
+
+/** Binary firmware-streaming session; while active the CDC port carries
+ *  fw_stream frames instead of text lines. */
+static fw_stream_t s_fw_stream;
+
 /* ── Action dispatch ─────────────────────────────────────────────────── */
 
 /**
  * How long the power LED must remain in a new state (on or off) before
- * the state machine sees the change.  Filters out motherboard sleep-mode
- * LED blinking so it doesn't destabilise the power state machine.
- * Increase this value for boards with very slow blink patterns.
+ * the state machine sees the change, until the board's sleep blink has
+ * been learned (see power_led.h); afterwards the hold follows the learned
+ * blink phases.  Increase this value for boards with blink phases longer
+ * than 1.5 s to avoid on/off reports before the first blink is learned.
  */
-#define POWER_LED_STABLE_MS 3000
+#define POWER_LED_HOLD_MS 1500
+
+/**
+ * How long PC_WAKING waits for the host to resume after USB remote
+ * wakeup before pulsing the power button.  S3 resume takes a few seconds
+ * before the OS resumes the bus, but the power LED normally shows the
+ * wake well before this and moves the SM on without a pulse.
+ */
+#define REMOTE_WAKEUP_TIMEOUT_MS 5000
+
+typedef enum {
+    WAKE_NONE,
+    WAKE_USB,           /* USB remote wakeup */
+    WAKE_BUTTON,        /* power-button pulse */
+    WAKE_FALLBACK,      /* pulse after remote wakeup timed out */
+} wake_method_t;
+
+/** Wake from SLEEPING in progress, timed from the wake request. */
+static wake_method_t s_wake_method;
+static uint32_t      s_wake_start_ms;
+
+/** Close out a wake once the SM settles: record latency on PC_ON. */
+static void track_wake(pc_power_state_t state, uint32_t now_ms)
+{
+    if (s_wake_method == WAKE_NONE)
+        return;
+
+    if (state == PC_STATE_ON) {
+        uint32_t ms = now_ms - s_wake_start_ms;
+        static const char *const names[] = {
+            [WAKE_USB] = "USB remote wakeup",
+            [WAKE_BUTTON] = "power button",
+            [WAKE_FALLBACK] = "power button (fallback)",
+        };
+        DLOG_INFO("[padproxy] Woke by %s in %u ms", names[s_wake_method], ms);
+        if (s_wake_method == WAKE_USB)
+            s_wake_usb_ms = ms;
+        else if (s_wake_method == WAKE_BUTTON)
+            s_wake_button_ms = ms;
+        else
+            s_wake_fallback_ms = ms;
+        s_wake_method = WAKE_NONE;
+    } else if (state == PC_STATE_OFF || state == PC_STATE_SLEEPING) {
+        s_wake_method = WAKE_NONE;
+    }
+}
+
+/**
+ * Broadcast Wake-on-LAN to the configured wol_mac (read at send time, so
+ * a "set" takes effect without a reboot).  No-op when it is empty.
+ */
+static void send_wol(void)
+{
+    uint8_t mac[WOL_MAC_LEN];
+    if (!wol_parse_mac(s_config.wol_mac, mac))
+        return;
+
+    if (wifi_sta_send_wol(mac)) {
+        DLOG_INFO("[padproxy] Wake-on-LAN sent to %s", s_config.wol_mac);
+        s_wol_sent++;
+    } else {
+        DLOG_INFO("[padproxy] Wake-on-LAN not sent (WiFi %s)",
+                  wifi_sta_state_name(wifi_sta_state()));
+        s_wol_failed++;
+    }
+}
 
 /**
  * Execute hardware actions requested by a power state machine transition.
  * Timing values come from the runtime device config.
  */
-static void dispatch_actions(uint32_t actions)
+static void dispatch_actions(const pc_power_result_t *r, uint32_t now_ms)
 {
-    if (actions & PC_ACTION_TRIGGER_POWER) {
-        printf("[padproxy] Triggering power button (%u ms)\n",
-               s_config.power_pulse_ms);
+    /* Learned from past boots once there are enough of them */
+    uint32_t timeout_ms = pc_power_sm_boot_timeout(&s_power_sm,
+                                                   s_config.boot_timeout_ms);
+
+    if (r->actions & PC_ACTION_USB_REMOTE_WAKEUP) {
+        /* Failing to signal leaves a zero timeout: fall back next poll */
+        bool sent = usb_hid_gamepad_remote_wakeup();
+        DLOG_INFO("[padproxy] USB remote wakeup %s",
+                  sent ? "signalled" : "failed");
+        timeout_ms = sent ? REMOTE_WAKEUP_TIMEOUT_MS : 0;
+    }
+    if (r->actions & PC_ACTION_TRIGGER_POWER) {
+        DLOG_INFO("[padproxy] Triggering power button (%u ms)",
+                  s_config.power_pulse_ms);
         pc_power_hal_trigger_power_button(s_config.power_pulse_ms);
+        if (s_wake_method == WAKE_USB) {
+            s_wake_method = WAKE_FALLBACK;
+            s_wake_fallbacks++;
+        }
+    }
+    if (r->actions & PC_ACTION_SEND_WOL) {
+        send_wol();
     }
-    if (actions & PC_ACTION_START_BOOT_TIMER) {
-        pc_power_hal_start_boot_timer(s_config.boot_timeout_ms);
+    if (r->actions & PC_ACTION_START_BOOT_TIMER) {
+        pc_power_hal_start_boot_timer(timeout_ms);
     }
-    if (actions & PC_ACTION_CANCEL_BOOT_TIMER) {
+    if (r->actions & PC_ACTION_CANCEL_BOOT_TIMER) {
         pc_power_hal_cancel_boot_timer();
     }
+    if (r->transitioned)
+        track_wake(r->new_state, now_ms);
+}
+
+/**
+ * Feed an event to the power SM, recording the call in the trace.
+ */
+static pc_power_result_t power_sm_process(pc_power_event_t event,
+                                          uint32_t now_ms)
+{
+    return pc_power_trace_process(&s_power_sm, event, now_ms);
+}
+
+/**
+ * Re-score the fused power signals and forward a new verdict to the
+ * power SM.
+ */
+static void fuse_power_signals(uint32_t now_ms)
+{
+    pc_power_event_t event;
+    if (!pc_fusion_update(&s_fusion, now_ms, &event))
+        return;
+
+    DLOG_INFO("[padproxy] PC %s -> %s",
+              pc_fusion_verdict_name(pc_fusion_verdict(&s_fusion)),
+              pc_power_event_name(event));
+    pc_power_result_t r = power_sm_process(event, now_ms);
+    dispatch_actions(&r, now_ms);
 }
 
 /* ── Callbacks ───────────────────────────────────────────────────────── */
 
 /**
- * USB state change → power state machine events.
+ * USB state change → signal fusion (mounted is decisive on its own, so
+ * enumeration still reaches the SM immediately).
  */
 static void on_usb_state_change(usb_hid_state_t state)
 {
     uint32_t now = pc_power_hal_millis();
-    pc_power_result_t r;
 
     switch (state) {
     case USB_HID_MOUNTED:
-        printf("[padproxy] USB mounted -> PC_EVENT_USB_ENUMERATED\n");
-        r = pc_power_sm_process(&s_power_sm, PC_EVENT_USB_ENUMERATED, now);
-        dispatch_actions(r.actions);
+        DLOG_INFO("[padproxy] USB mounted");
+        /* The host's view of every gamepad is unknown again */
+        for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+            report_filter_reset(&s_filter[i]);
+        pc_fusion_set_usb(&s_fusion, PC_FUSION_USB_MOUNTED, now);
         break;
     case USB_HID_SUSPENDED:
+        DLOG_INFO("[padproxy] USB suspended");
+        pc_fusion_set_usb(&s_fusion, PC_FUSION_USB_SUSPENDED, now);
+        break;
     case USB_HID_NOT_MOUNTED:
-        printf("[padproxy] USB suspended/unmounted -> PC_EVENT_USB_SUSPENDED\n");
-        r = pc_power_sm_process(&s_power_sm, PC_EVENT_USB_SUSPENDED, now);
-        dispatch_actions(r.actions);
+        DLOG_INFO("[padproxy] USB unmounted");
+        pc_fusion_set_usb(&s_fusion, PC_FUSION_USB_DETACHED, now);
         break;
     }
+    if (state != USB_HID_MOUNTED) {
+        /* Nobody left to stop the motors: stop them now */
+        const gamepad_output_t off = { 0, 0, 0 };
+        for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+            output_coalesce_set(&s_output[i], &off);
+    }
+    pc_power_sm_set_remote_wakeup(&s_power_sm,
+                                  usb_hid_gamepad_remote_wakeup_armed());
+    fuse_power_signals(now);
 }
 
 /**
@@ -103,97 +527,309 @@ static void on_usb_state_change(usb_hid_state_t state)
 static void on_bt_event(uint8_t idx, bt_gamepad_state_t state)
 {
     if (state == BT_GAMEPAD_CONNECTED) {
-        printf("[padproxy] Gamepad %d connected\n", idx);
+        DLOG_INFO("[padproxy] Gamepad %d connected", idx);
     } else {
-        printf("[padproxy] Gamepad %d disconnected\n", idx);
-        s_prev_report_valid = false;
+        DLOG_INFO("[padproxy] Gamepad %d disconnected", idx);
+        s_prev_report_valid[idx] = false;
+        button_latch_reset(&s_latch[idx]);
+        report_filter_reset(&s_filter[idx]);
+        output_coalesce_reset(&s_output[idx]);
     }
 }
 
 /* ── Hardware polling ────────────────────────────────────────────────── */
 
-/** Debounced power-LED state. */
-static bool     s_led_reading;     /* latest raw GPIO sample             */
-static bool     s_led_debounced;   /* accepted (stable) LED state        */
-static uint32_t s_led_changed_ms;  /* when s_led_reading last changed    */
-
 /**
- * Poll GPIO inputs and timers, feed edge-triggered events into the power SM.
+ * Drain captured power-LED edges, sample VBUS and check timers, then
+ * let the signal fusion decide what the power SM sees.
  *
- * The power LED is debounced: a new reading must persist for at least
- * POWER_LED_STABLE_MS before the state machine is notified.  This
- * prevents motherboard sleep-blink patterns from bouncing the SM.
+ * The power LED is classified from the edge timestamps (steady on,
+ * steady off, or sleep blink; see POWER_LED_HOLD_MS).  The fusion layer
+ * weighs that pattern together with the raw LED level, USB state and
+ * VBUS, so no single signal arriving first can move the SM on its own.
  */
 static void poll_hardware(uint32_t now_ms)
 {
-    bool led = pc_power_hal_read_power_led();
+    pc_power_led_edge_t edge;
     pc_power_result_t r;
 
-    /* Reset debounce timer whenever the raw reading changes */
-    if (led != s_led_reading) {
-        s_led_reading   = led;
-        s_led_changed_ms = now_ms;
+    /* Edges are timed on the microsecond clock; the trace uses ms */
+    while (pc_power_hal_pop_led_edge(&edge)) {
+        uint32_t age_us = pc_power_hal_micros() - edge.time_us;
+        power_led_edge(&s_led, edge.on, edge.time_us);
+        pc_power_trace_led(edge.on, now_ms - age_us / 1000);
     }
 
-    /* Emit an edge event only after the reading has been stable */
-    if (s_led_reading != s_led_debounced &&
-        (now_ms - s_led_changed_ms) >= POWER_LED_STABLE_MS) {
-        s_led_debounced = s_led_reading;
-        if (s_led_debounced) {
-            r = pc_power_sm_process(&s_power_sm, PC_EVENT_POWER_LED_ON,
-                                    now_ms);
-        } else {
-            r = pc_power_sm_process(&s_power_sm, PC_EVENT_POWER_LED_OFF,
-                                    now_ms);
-        }
-        dispatch_actions(r.actions);
+    /* Ring overflowed: the pin itself is the only trustworthy level */
+    uint32_t dropped = pc_power_hal_led_edges_dropped();
+    if (dropped != s_led_edges_dropped) {
+        bool on = pc_power_hal_read_power_led();
+        s_led_edges_dropped = dropped;
+        power_led_edge(&s_led, on, pc_power_hal_micros());
+        pc_power_trace_led(on, now_ms);
+    }
+
+    if (power_led_update(&s_led, pc_power_hal_micros()) ==
+        POWER_LED_BECAME_BLINKING) {
+        DLOG_INFO("[padproxy] Power LED blink %u ms, %u%% on",
+                  power_led_blink_period_ms(&s_led),
+                  power_led_blink_duty_pct(&s_led));
     }
+    pc_fusion_set_led(&s_fusion, power_led_pattern(&s_led), s_led.level,
+                      now_ms);
+    if (s_fusion.has_vbus)
+        pc_fusion_set_vbus(&s_fusion, pc_power_hal_read_vbus(), now_ms);
+    fuse_power_signals(now_ms);
 
     /* Boot timer expiry */
     if (pc_power_hal_boot_timer_expired()) {
-        r = pc_power_sm_process(&s_power_sm, PC_EVENT_BOOT_TIMEOUT, now_ms);
-        dispatch_actions(r.actions);
+        r = power_sm_process(PC_EVENT_BOOT_TIMEOUT, now_ms);
+        dispatch_actions(&r, now_ms);
     }
 }
 
 /* ── CDC setup serial ─────────────────────────────────────────────── */
 
+/**
+ * Service an active firmware-streaming session: drain the CDC RX FIFO
+ * in bulk into fw_stream (which writes flash through the OTA writer),
+ * send ACKs as frames complete, and finish or abort the session.
+ */
+static void poll_cdc_firmware(uint32_t now_ms)
+{
+    static uint8_t rx[CFG_TUD_CDC_RX_BUFSIZE];
+    fw_stream_status_t st = fw_stream_poll(&s_fw_stream, now_ms);
+
+    while (st == FW_STREAM_ACTIVE && tud_cdc_available()) {
+        uint32_t n = tud_cdc_read(rx, sizeof(rx));
+        st = fw_stream_feed(&s_fw_stream, rx, n, pc_power_hal_millis());
+
+        uint8_t ack[FW_STREAM_ACK_SIZE];
+        if (fw_stream_take_ack(&s_fw_stream, ack)) {
+            tud_cdc_write(ack, sizeof(ack));
+            tud_cdc_write_flush();
+        }
+    }
+
+    if (st == FW_STREAM_ACTIVE)
+        return;
+
+    if (st == FW_STREAM_DONE &&
+        !ota_update_stream_finish(s_fw_stream.expected_crc)) {
+        static const char msg[] = "ERR flash verify failed\n";
+        tud_cdc_write(msg, sizeof(msg) - 1);
+        tud_cdc_write_flush();
+        s_fw_stream.status = FW_STREAM_IDLE;
+        return;
+    }
+
+    char response[64];
+    int len = fw_stream_format_result(&s_fw_stream, response,
+                                      sizeof(response));
+    tud_cdc_write(response, (uint32_t)len);
+    tud_cdc_write_flush();
+    printf("[setup] Firmware stream: %s", response);
+
+    if (st == FW_STREAM_DONE) {
+        /* Give the host a moment to read the result, then boot the new
+         * image in TBYB mode; main() accepts it on the next boot. */
+        for (int i = 0; i < 20; i++) {
+            tud_task();
+            sleep_ms(5);
+        }
+        ota_update_stream_reboot();
+    }
+    s_fw_stream.status = FW_STREAM_IDLE;
+}
+
+/**
+ * Write a whole buffer to the CDC port.  Responses (a "list", or a
+ * binary frame) can exceed the TX FIFO, so keep servicing USB until
+ * everything is queued or the host stops reading.
+ */
+static void cdc_write_all(const void *data, uint32_t len)
+{
+    const uint8_t *p = data;
+    uint32_t idle = 0;
+
+    while (len > 0 && tud_cdc_connected()) {
+        uint32_t n = tud_cdc_write(p, len);
+        p += n;
+        len -= n;
+        if (len == 0)
+            break;
+        tud_cdc_write_flush();
+        tud_task();
+        idle = n ? 0 : idle + 1;
+        if (idle > 1000)
+            break;  /* host not draining; drop the rest */
+    }
+    tud_cdc_write_flush();
+}
+
+/**
+ * Stream the retained deferred log to the host, oldest first, as
+ * "OK <line>" lines like "list".
+ */
+static void cdc_dump_log(void)
+{
+    dlog_cursor_t c;
+    dlog_entry_t e;
+    char line[DLOG_LINE_MAX + 4];
+    bool any = false;
+
+    dlog_cursor_oldest(&c);
+    while (dlog_read(&c, &e)) {
+        int n = snprintf(line, sizeof(line), "OK ");
+        n += dlog_format(&e, line + n, sizeof(line) - (size_t)n - 1);
+        line[n++] = '\n';
+        cdc_write_all(line, (uint32_t)n);
+        any = true;
+    }
+    if (!any)
+        cdc_write_all("OK\n", 3);
+}
+
+/**
+ * Stream the power-state trace to the host, oldest first, as "OK <line>"
+ * lines.  Entries written meanwhile (USB callbacks run inside
+ * cdc_write_all) are included; overwritten ones are skipped.
+ */
+static void cdc_dump_trace(void)
+{
+    pc_power_trace_entry_t e;
+    char line[PC_TRACE_LINE_MAX + 4];
+    bool any = false;
+
+    for (uint32_t seq = pc_power_trace_oldest();
+         seq != pc_power_trace_written(); seq++) {
+        if (!pc_power_trace_read(seq, &e))
+            continue;
+        int n = snprintf(line, sizeof(line), "OK ");
+        n += pc_power_trace_format(&e, line + n, sizeof(line) - (size_t)n - 1);
+        line[n++] = '\n';
+        cdc_write_all(line, (uint32_t)n);
+        any = true;
+    }
+    if (!any)
+        cdc_write_all("OK\n", 3);
+}
+
+/**
+ * Perform the side effect requested by a text or binary setup command.
+ * Returns true if the port switched to firmware streaming.
+ */
+static bool handle_setup_action(setup_cmd_result_t r, int ch)
+{
+    if (r.action == SETUP_ACTION_SAVE) {
+        DLOG_INFO("[setup] Saving config to flash");
+        /* TODO: persist s_config to flash sector */
+    } else if (r.action == SETUP_ACTION_REBOOT) {
+        printf("[setup] Rebooting...\n");
+        tud_cdc_write_flush();
+        sleep_ms(100);
+        /* TODO: watchdog_reboot() or rom reboot */
+    } else if (r.action == SETUP_ACTION_LOG_DUMP) {
+        cdc_dump_log();
+    } else if (r.action == SETUP_ACTION_TRACE_DUMP) {
+        cdc_dump_trace();
+    } else if (r.action == SETUP_ACTION_FIRMWARE) {
+        /* A CRLF terminator leaves the LF queued ahead of frame 0 */
+        uint8_t next;
+        if (ch == '\r' && tud_cdc_peek(&next) && next == '\n')
+            tud_cdc_read_char();
+        DLOG_INFO("[setup] Streaming %u byte firmware image",
+                  (unsigned)r.fw_size);
+        fw_stream_begin(&s_fw_stream, r.fw_size, r.fw_crc32,
+                        ota_update_stream_write, NULL,
+                        pc_power_hal_millis());
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Collect one byte of a binary setup frame; process the frame when its
+ * 0x00 terminator arrives.
+ */
+static void cdc_frame_byte(uint8_t b, uint32_t now_ms)
+{
+    static uint8_t response[SETUP_BIN_FRAME_MAX];
+
+    switch (setup_bin_rx_byte(&s_cdc_rx, b, now_ms)) {
+    case SETUP_BIN_RX_MORE:
+        return;
+    case SETUP_BIN_RX_DROPPED:
+        DLOG_WARN("[padproxy] Setup frame overflowed, back to text");
+        return;
+    case SETUP_BIN_RX_FRAME:
+        break;
+    }
+
+    setup_cmd_result_t r = setup_bin_process(s_cdc_rx.buf, s_cdc_rx.len,
+                                             &s_config, response,
+                                             sizeof(response));
+    setup_bin_rx_done(&s_cdc_rx);
+    s_setup_commands++;
+
+    if (r.out_len > 0)
+        cdc_write_all(response, (uint32_t)r.out_len);
+    handle_setup_action(r, 0);
+}
+
 /**
  * Poll the CDC serial interface for complete lines and process them
- * through the setup command handler.
+ * through the setup command handler.  A SETUP_BIN_MAGIC byte at the
+ * start of a line switches to the binary framed protocol until the
+ * frame ends.
  */
 static void poll_cdc_setup(void)
 {
+    if (s_fw_stream.status != FW_STREAM_IDLE) {
+        poll_cdc_firmware(pc_power_hal_millis());
+        return;
+    }
+
+    uint32_t now = pc_power_hal_millis();
+    if (setup_bin_rx_expire(&s_cdc_rx, now))
+        DLOG_WARN("[padproxy] Setup frame timed out, back to text");
+
     while (tud_cdc_available()) {
         int ch = tud_cdc_read_char();
         if (ch < 0) break;
 
-        if (ch == '\n' || ch == '\r') {
+        if (s_cdc_rx.active) {
+            cdc_frame_byte((uint8_t)ch, now);
+        } else if (ch == SETUP_BIN_MAGIC && s_cdc_line_pos == 0) {
+            setup_bin_rx_start(&s_cdc_rx, now);
+        } else if (ch == '\n' || ch == '\r') {
             if (s_cdc_line_pos == 0)
                 continue;  /* skip empty lines / lone CR or LF */
 
             s_cdc_line[s_cdc_line_pos] = '\0';
 
-            char response[512];
+            static char response[SETUP_CMD_STATS_SIZE];
             setup_cmd_result_t r = setup_cmd_process(
                 s_cdc_line, &s_config, response, sizeof(response));
+            s_setup_commands++;
 
-            if (r.out_len > 0) {
-                tud_cdc_write(response, (uint32_t)r.out_len);
-                tud_cdc_write_flush();
+            if (r.action == SETUP_ACTION_FIRMWARE &&
+                !ota_update_stream_begin(r.fw_size)) {
+                r.action  = SETUP_ACTION_NONE;
+                r.out_len = snprintf(response, sizeof(response),
+                                     "ERR no update partition for %u bytes\n",
+                                     (unsigned)r.fw_size);
             }
 
-            if (r.action == SETUP_ACTION_SAVE) {
-                printf("[setup] Saving config to flash\n");
-                /* TODO: persist s_config to flash sector */
-            } else if (r.action == SETUP_ACTION_REBOOT) {
-                printf("[setup] Rebooting...\n");
-                tud_cdc_write_flush();
-                sleep_ms(100);
-                /* TODO: watchdog_reboot() or rom reboot */
-            }
+            if (r.out_len > 0)
+                cdc_write_all(response, (uint32_t)r.out_len);
 
             s_cdc_line_pos = 0;
+            if (handle_setup_action(r, ch)) {
+                /* Remaining bytes in the FIFO are already frame data */
+                poll_cdc_firmware(pc_power_hal_millis());
+                return;
+            }
         } else if (s_cdc_line_pos < CDC_LINE_MAX - 1) {
             s_cdc_line[s_cdc_line_pos++] = (char)ch;
         }
@@ -204,42 +840,238 @@ static void poll_cdc_setup(void)
 /* ── Main loop ───────────────────────────────────────────────────────── */
 
 /**
- * Process one gamepad report: check for wake triggers, forward to USB.
+ * Process one player's report: check for wake triggers, forward to that
+ * player's USB HID interface.  Any player's guide button wakes the PC.
+ *
+ * Buttons pressed since the last sample (even if already released) are
+ * latched into the report until USB has sent it, so quick taps are not
+ * lost while the main loop is busy.
+ *
+ * Sticks and triggers then go through the response curves.
+ *
+ * @p raw is the controller's native report when the USB personality
+ * speaks its format (else NULL).  It goes out as is unless a latched tap
+ * changed the buttons or the curves reshape the axes, which only the
+ * converted report can carry.
  */
-static void process_gamepad(const gamepad_report_t *report, uint32_t now_ms)
+static void process_gamepad(uint8_t idx, const gamepad_report_t *sample,
+                            const bt_gamepad_raw_t *raw, uint16_t pressed,
+                            uint32_t now_ms)
 {
     pc_power_state_t pc_state = pc_power_sm_get_state(&s_power_sm);
+    gamepad_report_t report = *sample;
+    report.buttons = button_latch_merge(&s_latch[idx], sample->buttons,
+                                        pressed);
+    axis_curve_set_apply(&s_curves, &report);
 
     /*
      * Wake-on-controller: fire WAKE_REQUESTED on the *rising edge* of
      * the guide button when the PC is off or sleeping.
      */
-    bool guide_now  = gamepad_report_guide_pressed(report);
-    bool guide_prev = s_prev_report_valid &&
-                      gamepad_report_guide_pressed(&s_prev_report);
+    bool guide_now  = gamepad_report_guide_pressed(&report);
+    bool guide_prev = s_prev_report_valid[idx] &&
+                      gamepad_report_guide_pressed(&s_prev_report[idx]);
 
     if (guide_now && !guide_prev) {
         if (pc_state == PC_STATE_OFF || pc_state == PC_STATE_SLEEPING) {
-            printf("[padproxy] Guide button -> wake request (PC %s)\n",
-                     pc_power_state_name(pc_state));
-            pc_power_result_t r = pc_power_sm_process(
-                &s_power_sm, PC_EVENT_WAKE_REQUESTED, now_ms);
-            dispatch_actions(r.actions);
+            DLOG_INFO("[padproxy] Guide button -> wake request (PC %s)",
+                      pc_power_state_name(pc_state));
+            s_wake_requests++;
+            pc_power_result_t r = power_sm_process(PC_EVENT_WAKE_REQUESTED,
+                                                   now_ms);
+            if (pc_state == PC_STATE_SLEEPING) {
+                s_wake_method = r.new_state == PC_STATE_WAKING ? WAKE_USB
+                                                               : WAKE_BUTTON;
+                s_wake_start_ms = now_ms;
+            }
+            dispatch_actions(&r, now_ms);
         }
     }
 
-    /* Forward to USB only when the PC is on and USB is enumerated. */
-    if (pc_state == PC_STATE_ON) {
-        usb_hid_gamepad_send_report(report);
+    /*
+     * Forward to USB only when the PC is on and USB is enumerated, and
+     * only what the host has not seen yet (plus a periodic keepalive).
+     * A report USB could not take keeps its latched taps for the next
+     * try; otherwise they have been seen (by the host or the wake check).
+     */
+    bool consumed = true;
+    if (pc_state == PC_STATE_ON &&
+        report_filter_check(&s_filter[idx], &report, now_ms)) {
+        bool native = raw && report.buttons == sample->buttons &&
+                      s_curves.identity;
+        consumed = native ? usb_hid_gamepad_send_raw(idx, &report, raw)
+                          : usb_hid_gamepad_send_report(idx, &report);
+        if (consumed && native)
+            s_reports_native++;
+        if (consumed) {
+            report_filter_sent(&s_filter[idx], &report, now_ms);
+            s_reports_forwarded++;
+        }
     }
+    if (consumed)
+        button_latch_sent(&s_latch[idx], report.buttons);
+
+    s_prev_report[idx] = report;
+    s_prev_report_valid[idx] = true;
+}
+
+/* ── Tasks ───────────────────────────────────────────────────────────── */
 
-    s_prev_report = *report;
-    s_prev_report_valid = true;
+static void task_usb(uint32_t now_ms, void *ctx)
+{
+    (void)now_ms;
+    (void)ctx;
+    usb_hid_gamepad_set_mode(s_config.usb_mode);
+    usb_hid_gamepad_task();
+}
+
+/** Rebuild the response curves if their settings changed. */
+static void update_curves(void)
+{
+    const axis_curve_cfg_t cfg[3] = {
+        { s_config.lstick_deadzone, s_config.lstick_outer,
+          s_config.lstick_anti, s_config.lstick_expo },
+        { s_config.rstick_deadzone, s_config.rstick_outer,
+          s_config.rstick_anti, s_config.rstick_expo },
+        { s_config.trigger_deadzone, s_config.trigger_outer,
+          s_config.trigger_anti, s_config.trigger_expo },
+    };
+    if (s_curves_built && memcmp(cfg, s_curves_cfg, sizeof(cfg)) == 0)
+        return;
+    memcpy(s_curves_cfg, cfg, sizeof(cfg));
+    axis_curve_set_init(&s_curves, &cfg[0], &cfg[1], &cfg[2]);
+    s_curves_built = true;
+}
+
+static void task_gamepad(uint32_t now_ms, void *ctx)
+{
+    (void)ctx;
+    report_filter_config_t filter = {
+        .threshold = {
+            [REPORT_FILTER_LX] = s_config.stick_threshold,
+            [REPORT_FILTER_LY] = s_config.stick_threshold,
+            [REPORT_FILTER_RX] = s_config.stick_threshold,
+            [REPORT_FILTER_RY] = s_config.stick_threshold,
+            [REPORT_FILTER_LT] = s_config.trigger_threshold,
+            [REPORT_FILTER_RT] = s_config.trigger_threshold,
+        },
+        .keepalive_ms = s_config.usb_keepalive_ms,
+    };
+    gamepad_report_t report;
+    gamepad_motion_t motion;
+    gamepad_output_t output;
+    bt_gamepad_raw_t raw;
+    uint16_t pressed;
+    update_curves();
+    bt_gamepad_set_button_map(s_config.button_map);
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        s_filter[i].cfg = filter;
+        if (bt_gamepad_get_report(i, &report, &pressed)) {
+            bool native = usb_hid_gamepad_takes_raw(bt_gamepad_raw_kind(i)) &&
+                          bt_gamepad_get_raw(i, &raw);
+            process_gamepad(i, &report, native ? &raw : NULL, pressed,
+                            now_ms);
+        }
+        if (s_config.motion_report && bt_gamepad_get_motion(i, &motion))
+            usb_hid_gamepad_send_motion(i, &motion);
+        if (bt_gamepad_is_connected(i) &&
+            output_coalesce_take(&s_output[i], now_ms, &output))
+            bt_gamepad_set_output(i, &output);
+    }
+}
+
+static void task_hardware(uint32_t now_ms, void *ctx)
+{
+    (void)ctx;
+    poll_hardware(now_ms);
+}
+
+static void task_cdc(uint32_t now_ms, void *ctx)
+{
+    (void)now_ms;
+    (void)ctx;
+    poll_cdc_setup();
+    if (s_fw_stream.status != FW_STREAM_IDLE)
+        sched_notify(&s_sched, s_task_cdc);
+}
+
+static void task_wifi(uint32_t now_ms, void *ctx)
+{
+    (void)ctx;
+    wifi_sta_task(now_ms);
+}
+
+/** Idle time: print a few deferred log lines to the UART. */
+static void task_log(uint32_t now_ms, void *ctx)
+{
+    (void)now_ms;
+    (void)ctx;
+    dlog_entry_t e;
+    char line[DLOG_LINE_MAX];
+
+    for (int i = 0; i < LOG_DRAIN_PER_PASS && dlog_read(&s_log_uart, &e); i++) {
+        dlog_format(&e, line, sizeof(line));
+        printf("%s\n", line);
+    }
+}
+
+/** New BT report stored (Bluepad32 context): forward it on the next pass. */
+static void on_bt_data(uint8_t idx)
+{
+    (void)idx;
+    sched_notify(&s_sched, s_task_gamepad);
+}
+
+/** A refused USB report can go out now: offer it again without waiting. */
+static void on_usb_ready(uint8_t idx)
+{
+    (void)idx;
+    sched_notify(&s_sched, s_task_gamepad);
+}
+
+/** Rumble/LED output report from the host (tud_task context). */
+static void on_usb_output(uint8_t idx, const gamepad_output_t *out)
+{
+    output_coalesce_set(&s_output[idx], out);
+    sched_notify(&s_sched, s_task_gamepad);
+}
+
+/** Power-LED edge captured (GPIO IRQ context): debounce it promptly. */
+static void on_led_edge(void)
+{
+    sched_notify(&s_sched, s_task_hw);
+}
+
+/** TinyUSB: CDC data received (called from tud_task). */
+void tud_cdc_rx_cb(uint8_t itf)
+{
+    (void)itf;
+    sched_notify(&s_sched, s_task_cdc);
+}
+
+static void sched_setup(void)
+{
+    sched_init(&s_sched, time_us_32);
+    sched_add(&s_sched, "usb", task_usb, NULL, TASK_USB_PERIOD_MS, 0);
+    s_task_gamepad = sched_add(&s_sched, "gamepad", task_gamepad, NULL,
+                               TASK_GAMEPAD_PERIOD_MS, 1);
+    s_task_hw = sched_add(&s_sched, "hw", task_hardware, NULL,
+                          TASK_HW_PERIOD_MS, 2);
+    s_task_cdc = sched_add(&s_sched, "cdc", task_cdc, NULL,
+                           TASK_CDC_PERIOD_MS, 3);
+    sched_add(&s_sched, "wifi", task_wifi, NULL, TASK_WIFI_PERIOD_MS, 4);
+    sched_add(&s_sched, "log", task_log, NULL, TASK_LOG_PERIOD_MS,
+              SCHED_PRIO_IDLE);
+    if (!sched_register_metrics(&s_sched))
+        DLOG_ERROR("[padproxy] Metrics registry full (%d): task stats missing",
+                   METRICS_MAX);
 }
 
 int main(void)
 {
     stdio_init_all();
+    dlog_init(time_us_32);
+    pc_power_trace_init();
     printf("[padproxy] PadProxy starting\n");
 
     /* Accept this image immediately so the boot ROM does not roll back
@@ -270,26 +1102,15 @@ int main(void)
     ota_update_result_t ota = ota_update_check_and_apply(&wifi_creds);
     printf("[padproxy] OTA check result: %s\n", ota_update_result_name(ota));
 
+    /* Stay associated from here on so Wake-on-LAN needs no join at wake
+     * time.  Brings the radio up before Bluepad32 shares it. */
+    wifi_sta_init(wifi_creds.ssid, wifi_creds.password);
+
     /*
-     * TODO: USB firmware update support
-     *
-     * In addition to WiFi OTA, support firmware updates over the CDC
-     * serial interface.  This would let users flash new firmware via
-     * the Web Serial setup page without needing WiFi configured.
-     *
-     * Approach: add a "firmware" command to setup_cmd that:
-     *   1. Accepts a binary size ("firmware <nbytes>")
-     *   2. Switches CDC to binary receive mode
-     *   3. Streams the .bin payload into the inactive flash partition
-     *      (reusing the flash_writer from ota_update.c)
-     *   4. On completion, verifies CRC and issues a TBYB reboot
-     *
-     * The Web Serial page would read a local .bin file and stream it
-     * over the CDC serial port using the Web Serial API's WritableStream.
-     *
-     * This makes the device fully configurable and updatable over USB
-     * with zero WiFi dependency — WiFi becomes optional (for automatic
-     * background OTA checks only).
+     * USB firmware update: the "firmware <nbytes> <crc32>" setup command
+     * switches the CDC port to fw_stream's windowed binary framing and
+     * streams the .bin into the inactive partition (see poll_cdc_setup).
+     * WiFi is only needed for automatic background OTA checks.
      */
 
     /* Setup command handler version string */
@@ -298,49 +1119,40 @@ int main(void)
              PADPROXY_VERSION_MAJOR, PADPROXY_VERSION_MINOR,
              PADPROXY_VERSION_PATCH);
     setup_cmd_set_version(version_str);
+    if (!register_metrics())
+        DLOG_ERROR("[padproxy] Metrics registry full (%d)", METRICS_MAX);
 
     /* Initialize power management */
     pc_power_hal_init();
     pc_power_sm_init(&s_power_sm);
-    s_led_reading   = pc_power_hal_read_power_led();
-    s_led_debounced = s_led_reading;
-    s_led_changed_ms = 0;
+    power_led_init(&s_led, pc_power_hal_read_power_led(),
+                   POWER_LED_HOLD_MS);
+    pc_fusion_init(&s_fusion, power_led_pattern(&s_led), s_led.level,
+                   pc_power_hal_has_vbus_sense(), pc_power_hal_read_vbus(),
+                   pc_power_hal_millis());
 
-    /* Initialize USB HID gamepad + CDC setup serial */
-    usb_hid_gamepad_init(on_usb_state_change);
+    /* Initialize USB HID gamepad + CDC setup serial.  A running motor
+     * is refreshed well before its BT rumble command runs out. */
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        output_coalesce_init(&s_output[i], OUTPUT_INTERVAL_MS,
+                             BT_GAMEPAD_RUMBLE_MS / 2);
+    usb_hid_gamepad_init(on_usb_state_change, s_config.usb_mode);
 
     /* Initialize Bluetooth gamepad */
+    sched_setup();
+    bt_gamepad_set_data_cb(on_bt_data);
+    usb_hid_gamepad_set_ready_cb(on_usb_ready);
+    usb_hid_gamepad_set_output_cb(on_usb_output);
+    pc_power_hal_set_led_edge_cb(on_led_edge);
     bt_gamepad_init(on_bt_event);
 
     printf("[padproxy] Initialization complete, entering main loop\n");
 
-    /* Update status string for setup command handler */
-    static char status_buf[64];
-
-    /* Main loop: poll BT → proxy to USB, poll hardware → power SM */
+    /* Main loop: run due tasks, then sleep until the next deadline or
+     * an interrupt (USB, BT) wakes the core */
     for (;;) {
-        uint32_t now_ms = pc_power_hal_millis();
-
-        /* Service USB stack */
-        usb_hid_gamepad_task();
-
-        /* Poll CDC setup serial */
-        snprintf(status_buf, sizeof(status_buf), "pc_state=%s bt_connected=%s",
-                 pc_power_state_name(pc_power_sm_get_state(&s_power_sm)),
-                 bt_gamepad_get_report(0, NULL) ? "true" : "false");
-        setup_cmd_set_status(status_buf);
-        poll_cdc_setup();
-
-        /* Poll hardware inputs (power LED, boot timer) */
-        poll_hardware(now_ms);
-
-        /* Read BT gamepad and forward */
-        gamepad_report_t report;
-        if (bt_gamepad_get_report(0, &report)) {
-            process_gamepad(&report, now_ms);
-        }
-
-        /* ~1ms loop period for responsive input */
-        sleep_ms(1);
+        uint32_t wait_ms = sched_run(&s_sched, pc_power_hal_millis());
+        if (wait_ms > 0)
+            best_effort_wfe_or_timeout(make_timeout_time_ms(wait_ms));
     }
 }
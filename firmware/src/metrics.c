@@ -0,0 +1,146 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ── Registry ───────────────────────────────────────────────────────── */
+
+typedef enum {
+    KIND_COUNTER,
+    KIND_U32,
+    KIND_TEXT,
+} metric_kind_t;
+
+typedef struct {
+    const char   *name;
+    metric_kind_t kind;
+    uint8_t       flags;
+    union {
+        const volatile uint32_t *counter;
+        metrics_u32_fn           u32;
+        metrics_text_fn          text;
+    } src;
+    void *ctx;
+} metric_t;
+
+static metric_t s_metrics[METRICS_MAX];
+static int      s_count;
+
+static metric_t *add(const char *name, metric_kind_t kind, uint8_t flags)
+{
+    if (!name || s_count >= METRICS_MAX)
+        return NULL;
+
+    metric_t *m = &s_metrics[s_count++];
+    memset(m, 0, sizeof(*m));
+    m->name  = name;
+    m->kind  = kind;
+    m->flags = flags;
+    return m;
+}
+
+/* ── Public API ─────────────────────────────────────────────────────── */
+
+void metrics_reset(void)
+{
+    s_count = 0;
+}
+
+bool metrics_register_counter(const char *name, const volatile uint32_t *counter,
+                              uint8_t flags)
+{
+    if (!counter) return false;
+    metric_t *m = add(name, KIND_COUNTER, flags);
+    if (!m) return false;
+    m->src.counter = counter;
+    return true;
+}
+
+bool metrics_register_u32(const char *name, metrics_u32_fn fn, void *ctx,
+                          uint8_t flags)
+{
+    if (!fn) return false;
+    metric_t *m = add(name, KIND_U32, flags);
+    if (!m) return false;
+    m->src.u32 = fn;
+    m->ctx = ctx;
+    return true;
+}
+
+bool metrics_register_text(const char *name, metrics_text_fn fn, void *ctx,
+                           uint8_t flags)
+{
+    if (!fn) return false;
+    metric_t *m = add(name, KIND_TEXT, flags);
+    if (!m) return false;
+    m->src.text = fn;
+    m->ctx = ctx;
+    return true;
+}
+
+int metrics_count(void)
+{
+    return s_count;
+}
+
+const char *metrics_name(int index)
+{
+    if (index < 0 || index >= s_count)
+        return NULL;
+    return s_metrics[index].name;
+}
+
+int metrics_format_value(int index, char *buf, size_t size)
+{
+    if (index < 0 || index >= s_count || size == 0)
+        return -1;
+
+    const metric_t *m = &s_metrics[index];
+    int n;
+
+    switch (m->kind) {
+    case KIND_COUNTER:
+        n = snprintf(buf, size, "%u", (unsigned)*m->src.counter);
+        break;
+    case KIND_U32:
+        n = snprintf(buf, size, "%u", (unsigned)m->src.u32(m->ctx));
+        break;
+    case KIND_TEXT: {
+        const char *s = m->src.text(m->ctx);
+        n = snprintf(buf, size, "%s", s ? s : "");
+        break;
+    }
+    default:
+        n = 0;
+        break;
+    }
+
+    if (n < 0) return 0;
+    return (n >= (int)size) ? (int)size - 1 : n;
+}
+
+int metrics_format(uint8_t flags, const char *sep, char *buf, size_t size)
+{
+    if (!buf || size == 0)
+        return 0;
+
+    size_t total = 0;
+    bool first = true;
+    buf[0] = '\0';
+
+    for (int i = 0; i < s_count && total + 1 < size; i++) {
+        if ((s_metrics[i].flags & flags) != flags)
+            continue;
+
+        int n = snprintf(buf + total, size - total, "%s%s=",
+                         first ? "" : (sep ? sep : ""), s_metrics[i].name);
+        if (n < 0 || (size_t)n >= size - total) {
+            total = size - 1;
+            break;
+        }
+        total += (size_t)n;
+        total += (size_t)metrics_format_value(i, buf + total, size - total);
+        first = false;
+    }
+
+    return (int)total;
+}
@@ -0,0 +1,37 @@
+#include "motion_mux.h"
+
+void motion_mux_reset(motion_mux_t *m)
+{
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        m->pending[i] = false;
+    m->next = 0;
+}
+
+void motion_mux_push(motion_mux_t *m, uint8_t idx, const gamepad_motion_t *s)
+{
+    if (idx >= BT_GAMEPAD_MAX)
+        return;
+
+    m->pushed++;
+    if (m->pending[idx])
+        m->replaced++;
+    m->latest[idx]  = *s;
+    m->pending[idx] = true;
+}
+
+bool motion_mux_take(motion_mux_t *m, uint8_t *idx, gamepad_motion_t *out)
+{
+    for (int n = 0; n < BT_GAMEPAD_MAX; n++) {
+        uint8_t i = (uint8_t)((m->next + n) % BT_GAMEPAD_MAX);
+        if (!m->pending[i])
+            continue;
+
+        *idx = i;
+        *out = m->latest[i];
+        m->pending[i] = false;
+        m->next = (uint8_t)((i + 1) % BT_GAMEPAD_MAX);
+        m->sent++;
+        return true;
+    }
+    return false;
+}
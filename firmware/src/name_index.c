@@ -0,0 +1,65 @@
+#include "name_index.h"
+
+#include <string.h>
+
+static uint32_t hash(const char *s, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ seed;
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    /* FNV's low bits see only the low bits of each byte: fold high in */
+    return (h ^ (h >> 16)) & (NAME_INDEX_SLOTS - 1);
+}
+
+/** Fill the slots for @p seed; false on the first collision. */
+static bool try_seed(name_index_t *idx, uint32_t seed)
+{
+    memset(idx->slot, -1, sizeof(idx->slot));
+    for (int i = 0; i < idx->count; i++) {
+        uint32_t h = hash(idx->names[i], seed);
+        if (idx->slot[h] >= 0)
+            return false;
+        idx->slot[h] = (int8_t)i;
+    }
+    return true;
+}
+
+bool name_index_build(name_index_t *idx, const char *const *names,
+                      int count)
+{
+    idx->names   = names;
+    idx->count   = count;
+    idx->perfect = false;
+    idx->seed    = 0;
+
+    if (count <= NAME_INDEX_MAX) {
+        for (uint32_t seed = 0; seed < NAME_INDEX_SEED_TRIES; seed++) {
+            if (try_seed(idx, seed)) {
+                idx->seed    = seed;
+                idx->perfect = true;
+                return true;
+            }
+        }
+    }
+
+    /* No seed: leave no half-filled table behind */
+    memset(idx->slot, -1, sizeof(idx->slot));
+    return false;
+}
+
+int name_index_find(const name_index_t *idx, const char *name)
+{
+    if (!name) return -1;
+
+    if (idx->perfect) {
+        int i = idx->slot[hash(name, idx->seed)];
+        return (i >= 0 && strcmp(name, idx->names[i]) == 0) ? i : -1;
+    }
+
+    for (int i = 0; i < idx->count; i++)
+        if (strcmp(name, idx->names[i]) == 0)
+            return i;
+    return -1;
+}
@@ -1,5 +1,6 @@
 #include "ota_update.h"
 #include "ota_version.h"
+#include "crc32.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -622,6 +623,24 @@ static bool flash_write_cb(const uint8_t *data, int len, void *ctx)
     return true;
 }
 
+/**
+ * Reboot into a freshly written partition via FLASH_UPDATE.
+ *
+ * The boot ROM will execute the new partition in TBYB mode.
+ * On next boot, rom_explicit_buy() in main() accepts it.
+ * If the new image crashes, the boot ROM falls back to this
+ * partition automatically.
+ */
+static void reboot_into_partition(uint32_t target_offset)
+{
+    printf("[ota] Rebooting into new firmware (TBYB)...\n");
+    sleep_ms(100); /* Let UART drain */
+
+    rom_reboot(BOOT_TYPE_FLASH_UPDATE,
+               200, /* delay ms */
+               XIP_BASE + target_offset, 0);
+}
+
 /* ── WiFi helpers ────────────────────────────────────────────────────── */
 
 static bool wifi_connect(const ota_wifi_creds_t *creds)
@@ -781,19 +800,8 @@ ota_update_result_t ota_update_check_and_apply(const ota_wifi_creds_t *creds)
     wifi_disconnect();
     cyw43_arch_deinit();
 
-    /* Step 6: Reboot into the new image via FLASH_UPDATE.
-     *
-     * The boot ROM will execute the new partition in TBYB mode.
-     * On next boot, rom_explicit_buy() in main() accepts it.
-     * If the new image crashes, the boot ROM falls back to this
-     * partition automatically.
-     */
-    printf("[ota] Rebooting into new firmware (TBYB)...\n");
-    sleep_ms(100); /* Let UART drain */
-
-    rom_reboot(BOOT_TYPE_FLASH_UPDATE,
-               200, /* delay ms */
-               XIP_BASE + target_offset, 0);
+    /* Step 6: Reboot into the new image via FLASH_UPDATE. */
+    reboot_into_partition(target_offset);
 
     /* Should not reach here */
     return OTA_RESULT_UPDATE_APPLIED;
@@ -804,6 +812,85 @@ cleanup:
     return result;
 }
 
+/* ── USB firmware update ─────────────────────────────────────────────── */
+
+/*
+ * The image arrives over CDC through fw_stream, which calls
+ * ota_update_stream_write() for every payload run.  The same sector
+ * buffering flash_writer_t used for the WiFi download applies; it lives
+ * in static storage here because a session spans many main-loop
+ * iterations.
+ */
+static flash_writer_t s_usb_writer;
+static uint32_t       s_usb_target_offset;
+static uint32_t       s_usb_image_size;
+static bool           s_usb_ready;
+
+bool ota_update_stream_begin(uint32_t image_size)
+{
+    s_usb_ready = false;
+
+    uint32_t target_offset, target_size;
+    if (!find_target_partition(&target_offset, &target_size)) {
+        printf("[ota] No A/B partition table found\n");
+        return false;
+    }
+    if (image_size == 0 || image_size > target_size) {
+        printf("[ota] Image of %u bytes does not fit partition (%u)\n",
+               (unsigned)image_size, (unsigned)target_size);
+        return false;
+    }
+
+    flash_writer_init(&s_usb_writer, target_offset, target_size);
+    s_usb_target_offset = target_offset;
+    s_usb_image_size    = image_size;
+    printf("[ota] Receiving %u bytes over USB\n", (unsigned)image_size);
+    return true;
+}
+
+bool ota_update_stream_write(const uint8_t *data, size_t len, void *ctx)
+{
+    (void)ctx;
+    return flash_write_cb(data, (int)len, &s_usb_writer);
+}
+
+bool ota_update_stream_finish(uint32_t expected_crc)
+{
+    if (!flash_writer_flush(&s_usb_writer) || s_usb_writer.error) {
+        printf("[ota] Flash write failed\n");
+        return false;
+    }
+    if (s_usb_writer.total_written != s_usb_image_size) {
+        printf("[ota] Short image: %u of %u bytes\n",
+               (unsigned)s_usb_writer.total_written,
+               (unsigned)s_usb_image_size);
+        return false;
+    }
+
+    /* Read back through XIP: proves the bytes actually landed in flash,
+     * not just that the stream was intact. flash_range_program()
+     * invalidates the XIP cache, so this sees the new contents. */
+    const uint8_t *image = (const uint8_t *)(XIP_BASE + s_usb_target_offset);
+    uint32_t crc = crc32_update(0, image, s_usb_image_size);
+    if (crc != expected_crc) {
+        printf("[ota] Flash verify failed: crc %08x, expected %08x\n",
+               (unsigned)crc, (unsigned)expected_crc);
+        return false;
+    }
+
+    printf("[ota] Flash verified: %u bytes at 0x%08x\n",
+           (unsigned)s_usb_image_size, (unsigned)s_usb_target_offset);
+    s_usb_ready = true;
+    return true;
+}
+
+void ota_update_stream_reboot(void)
+{
+    if (!s_usb_ready)
+        return;
+    reboot_into_partition(s_usb_target_offset);
+}
+
 const char *ota_update_result_name(ota_update_result_t result)
 {
     switch (result) {
@@ -0,0 +1,64 @@
+#include "output_coalesce.h"
+
+#include <string.h>
+
+void output_coalesce_init(output_coalesce_t *c, uint32_t min_interval_ms,
+                          uint32_t refresh_ms)
+{
+    memset(c, 0, sizeof(*c));
+    c->min_interval_ms = min_interval_ms;
+    c->refresh_ms      = refresh_ms;
+}
+
+void output_coalesce_reset(output_coalesce_t *c)
+{
+    memset(&c->want, 0, sizeof(c->want));
+    memset(&c->sent, 0, sizeof(c->sent));
+    c->dirty   = false;
+    c->primed  = false;
+    c->last_ms = 0;
+}
+
+static bool same(const gamepad_output_t *a, const gamepad_output_t *b)
+{
+    return a->strong == b->strong && a->weak == b->weak && a->leds == b->leds;
+}
+
+void output_coalesce_set(output_coalesce_t *c, const gamepad_output_t *o)
+{
+    c->requests++;
+    if (c->dirty)
+        c->coalesced++;
+
+    c->want = *o;
+    if (c->primed) {
+        c->dirty = !same(&c->want, &c->sent);
+    } else {
+        /* Nothing sent yet: the controller's motors are off */
+        gamepad_output_t off = { 0, 0, 0 };
+        c->dirty = !same(&c->want, &off);
+    }
+}
+
+bool output_coalesce_take(output_coalesce_t *c, uint32_t now_ms,
+                          gamepad_output_t *out)
+{
+    uint32_t since = now_ms - c->last_ms;
+    bool running   = c->sent.strong || c->sent.weak;
+
+    bool update  = c->dirty && (!c->primed || since >= c->min_interval_ms);
+    bool refresh = c->primed && running && c->refresh_ms &&
+                   since >= c->refresh_ms;
+    if (!update && !refresh)
+        return false;
+
+    if (update) {
+        c->sent  = c->want;
+        c->dirty = false;
+    }
+    *out       = c->sent;
+    c->primed  = true;
+    c->last_ms = now_ms;
+    c->updates++;
+    return true;
+}
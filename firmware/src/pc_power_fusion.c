@@ -0,0 +1,188 @@
+#include "pc_power_fusion.h"
+
+#include <stddef.h>
+
+/* ── Evidence weights ─────────────────────────────────────────────────
+ *
+ * Points each signal value adds to {S0, S3, S5}.  Negative points make a
+ * hypothesis less likely.  Tuned against the orderings in
+ * test_pc_power_fusion.c: a single decisive signal (LED blink, LED off,
+ * USB mounted) reaches PC_FUSION_DECIDE on its own; ambiguous ones (USB
+ * suspend or detach, raw LED level, VBUS) need a second opinion.
+ */
+
+static const int16_t k_led[][PC_FUSION_HYP_COUNT] = {
+    [POWER_LED_PATTERN_OFF]   = {   0,   0, 100 },
+    [POWER_LED_PATTERN_ON]    = {  70,  10,   0 },
+    [POWER_LED_PATTERN_BLINK] = {   0, 120,   0 },
+};
+
+/* Raw level that the classifier has not confirmed yet */
+static const int16_t k_led_pending_off[PC_FUSION_HYP_COUNT] = { -30,   0,  25 };
+static const int16_t k_led_pending_on[PC_FUSION_HYP_COUNT]  = {  30,   0, -30 };
+
+static const int16_t k_usb[][PC_FUSION_HYP_COUNT] = {
+    [PC_FUSION_USB_DETACHED]  = {   0,  10,  30 },
+    [PC_FUSION_USB_SUSPENDED] = {   0,  40,   0 },
+    [PC_FUSION_USB_MOUNTED]   = {  80,   0,   0 },
+};
+static const int16_t k_usb_suspend_confirmed[PC_FUSION_HYP_COUNT] = { 0, 70, 0 };
+
+/* 5 V standby usually keeps VBUS up in S3 and often drops it in S5 */
+static const int16_t k_vbus[][PC_FUSION_HYP_COUNT] = {
+    [false] = { -40, -10,  50 },
+    [true]  = {  40,  20, -30 },
+};
+
+/* ── Helpers ────────────────────────────────────────────────────────── */
+
+static void set_signal(pc_fusion_signal_t *s, uint8_t value, uint32_t now_ms)
+{
+    if (s->value == value)
+        return;
+    s->value    = value;
+    s->since_ms = now_ms;
+}
+
+static bool led_pending(const pc_fusion_t *f)
+{
+    if (f->led.value == POWER_LED_PATTERN_BLINK)
+        return false;
+    return f->led_raw != (f->led.value == POWER_LED_PATTERN_ON);
+}
+
+/** Add w to the scores, halved if signal s (optional) is stale. */
+static void add(pc_fusion_t *f, const int16_t *w, const pc_fusion_signal_t *s,
+                uint32_t newest_ms)
+{
+    bool stale = s && (int32_t)(newest_ms - s->since_ms) > PC_FUSION_STALE_MS;
+    for (int h = 0; h < PC_FUSION_HYP_COUNT; h++)
+        f->score[h] += stale ? w[h] / 2 : w[h];
+}
+
+static uint32_t newest_change(const pc_fusion_t *f)
+{
+    uint32_t newest = f->led.since_ms;
+    if ((int32_t)(f->usb.since_ms - newest) > 0)
+        newest = f->usb.since_ms;
+    if (f->has_vbus && (int32_t)(f->vbus.since_ms - newest) > 0)
+        newest = f->vbus.since_ms;
+    return newest;
+}
+
+static void score(pc_fusion_t *f, uint32_t now_ms)
+{
+    uint32_t newest = newest_change(f);
+
+    for (int h = 0; h < PC_FUSION_HYP_COUNT; h++)
+        f->score[h] = 0;
+
+    add(f, k_led[f->led.value], &f->led, newest);
+    if (led_pending(f))
+        add(f, f->led_raw ? k_led_pending_on : k_led_pending_off, NULL, newest);
+
+    if (f->usb.value == PC_FUSION_USB_SUSPENDED && !led_pending(f) &&
+        now_ms - f->usb.since_ms >= PC_FUSION_SUSPEND_CONFIRM_MS)
+        add(f, k_usb_suspend_confirmed, &f->usb, newest);
+    else
+        add(f, k_usb[f->usb.value], &f->usb, newest);
+
+    /* VBUS measures power directly, so its weight never goes stale */
+    if (f->has_vbus)
+        add(f, k_vbus[f->vbus.value], NULL, newest);
+}
+
+static pc_fusion_verdict_t decide(const pc_fusion_t *f)
+{
+    int best = 0;
+    for (int h = 1; h < PC_FUSION_HYP_COUNT; h++)
+        if (f->score[h] > f->score[best])
+            best = h;
+
+    for (int h = 0; h < PC_FUSION_HYP_COUNT; h++) {
+        if (h == best)
+            continue;
+        if (f->score[best] - f->score[h] < PC_FUSION_MARGIN)
+            return f->verdict;
+    }
+    if (f->score[best] < PC_FUSION_DECIDE)
+        return f->verdict;
+
+    switch (best) {
+    case PC_FUSION_S0:
+        return f->usb.value == PC_FUSION_USB_MOUNTED ? PC_FUSION_RUNNING
+                                                     : PC_FUSION_POWERED;
+    case PC_FUSION_S3:
+        return PC_FUSION_SLEEPING;
+    default:
+        return PC_FUSION_OFF;
+    }
+}
+
+/* ── Public API ─────────────────────────────────────────────────────── */
+
+void pc_fusion_init(pc_fusion_t *f, power_led_pattern_t led, bool led_raw,
+                    bool has_vbus, bool vbus, uint32_t now_ms)
+{
+    *f = (pc_fusion_t){
+        .has_vbus = has_vbus,
+        .led      = { .value = (uint8_t)led, .since_ms = now_ms },
+        .usb      = { .value = PC_FUSION_USB_DETACHED, .since_ms = now_ms },
+        .vbus     = { .value = vbus, .since_ms = now_ms },
+        .led_raw  = led_raw,
+        .verdict  = PC_FUSION_UNKNOWN,
+    };
+}
+
+void pc_fusion_set_led(pc_fusion_t *f, power_led_pattern_t pattern,
+                       bool raw, uint32_t now_ms)
+{
+    set_signal(&f->led, (uint8_t)pattern, now_ms);
+    f->led_raw = raw;
+}
+
+void pc_fusion_set_usb(pc_fusion_t *f, pc_fusion_usb_t usb, uint32_t now_ms)
+{
+    set_signal(&f->usb, (uint8_t)usb, now_ms);
+}
+
+void pc_fusion_set_vbus(pc_fusion_t *f, bool present, uint32_t now_ms)
+{
+    set_signal(&f->vbus, present, now_ms);
+}
+
+bool pc_fusion_update(pc_fusion_t *f, uint32_t now_ms, pc_power_event_t *event)
+{
+    score(f, now_ms);
+
+    pc_fusion_verdict_t v = decide(f);
+    if (v == f->verdict)
+        return false;
+
+    f->verdict = v;
+    f->verdicts++;
+    switch (v) {
+    case PC_FUSION_RUNNING:  *event = PC_EVENT_USB_ENUMERATED;  break;
+    case PC_FUSION_POWERED:  *event = PC_EVENT_POWER_LED_ON;    break;
+    case PC_FUSION_SLEEPING: *event = PC_EVENT_POWER_LED_BLINK; break;
+    default:                 *event = PC_EVENT_POWER_LED_OFF;   break;
+    }
+    return true;
+}
+
+pc_fusion_verdict_t pc_fusion_verdict(const pc_fusion_t *f)
+{
+    return f->verdict;
+}
+
+const char *pc_fusion_verdict_name(pc_fusion_verdict_t verdict)
+{
+    switch (verdict) {
+    case PC_FUSION_UNKNOWN:  return "unknown";
+    case PC_FUSION_OFF:      return "off";
+    case PC_FUSION_SLEEPING: return "sleeping";
+    case PC_FUSION_POWERED:  return "powered";
+    case PC_FUSION_RUNNING:  return "running";
+    default:                 return "unknown";
+    }
+}
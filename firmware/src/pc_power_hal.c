@@ -1,6 +1,8 @@
 #include "pc_power_hal.h"
 
+#include "hardware/adc.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 #include "pico/time.h"
 
 /* ── GPIO assignments (from hardware design) ─────────────────────────── */
@@ -8,12 +10,54 @@
 #define GPIO_PWR_BTN_TRIGGER  2   /* Output: drives TLP222A photo-MOSFET  */
 #define GPIO_PWR_LED_SENSE    3   /* Input: PC817 optocoupler, active LOW  */
 
+/* USB_NATIVE VBUS sense ADC channel (GPIO 26 + n); -1 if not routed */
+#ifndef PADPROXY_VBUS_SENSE_ADC
+#define PADPROXY_VBUS_SENSE_ADC (-1)
+#endif
+
+/* 4.0 V through the ÷3.13 divider is 1.28 V: 1587 of 4095 at 3.3 V */
+#define VBUS_PRESENT_COUNTS  1587
+
 /* ── Internal state ──────────────────────────────────────────────────── */
 
 static alarm_id_t    s_power_btn_alarm;
 static alarm_id_t    s_boot_timer_alarm;
 static volatile bool s_boot_timer_expired;
 
+/* Power-LED edge ring: written by the GPIO IRQ, read by the main loop */
+static pc_power_led_edge_t s_led_edges[PC_POWER_LED_EDGE_RING];
+static volatile uint32_t   s_led_edge_head;     /* IRQ writes   */
+static volatile uint32_t   s_led_edge_tail;     /* main reads   */
+static volatile uint32_t   s_led_edges_dropped;
+static void              (*s_led_edge_cb)(void);
+
+/* ── GPIO IRQ (power LED edges) ──────────────────────────────────────── */
+
+static void led_sense_irq_cb(uint gpio, uint32_t events)
+{
+    if (gpio != GPIO_PWR_LED_SENSE)
+        return;
+    (void)events;
+
+    uint32_t head = s_led_edge_head;
+    if (head - s_led_edge_tail >= PC_POWER_LED_EDGE_RING) {
+        s_led_edges_dropped++;
+        return;
+    }
+
+    /* Record the level now rather than decoding the event bits, so a
+     * rise and fall latched together still leave the ring correct.
+     * Active LOW: see pc_power_hal_read_power_led(). */
+    pc_power_led_edge_t *e = &s_led_edges[head % PC_POWER_LED_EDGE_RING];
+    e->time_us = time_us_32();
+    e->on      = !gpio_get(GPIO_PWR_LED_SENSE);
+    __compiler_memory_barrier();
+    s_led_edge_head = head + 1;
+
+    if (s_led_edge_cb)
+        s_led_edge_cb();
+}
+
 /* ── Alarm callbacks (run from timer IRQ context) ────────────────────── */
 
 static int64_t power_btn_alarm_cb(alarm_id_t id, void *user_data)
@@ -48,6 +92,18 @@ void pc_power_hal_init(void)
     gpio_set_dir(GPIO_PWR_LED_SENSE, GPIO_IN);
     gpio_pull_up(GPIO_PWR_LED_SENSE);
 
+    s_led_edge_head = 0;
+    s_led_edge_tail = 0;
+    s_led_edges_dropped = 0;
+    gpio_set_irq_enabled_with_callback(GPIO_PWR_LED_SENSE,
+                                       GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                                       true, led_sense_irq_cb);
+
+#if PADPROXY_VBUS_SENSE_ADC >= 0
+    adc_init();
+    adc_gpio_init(26 + PADPROXY_VBUS_SENSE_ADC);
+#endif
+
     s_power_btn_alarm = 0;
     s_boot_timer_alarm = 0;
     s_boot_timer_expired = false;
@@ -60,6 +116,43 @@ bool pc_power_hal_read_power_led(void)
     return !gpio_get(GPIO_PWR_LED_SENSE);
 }
 
+bool pc_power_hal_pop_led_edge(pc_power_led_edge_t *edge)
+{
+    uint32_t tail = s_led_edge_tail;
+    if (tail == s_led_edge_head)
+        return false;
+
+    __compiler_memory_barrier();
+    *edge = s_led_edges[tail % PC_POWER_LED_EDGE_RING];
+    s_led_edge_tail = tail + 1;
+    return true;
+}
+
+uint32_t pc_power_hal_led_edges_dropped(void)
+{
+    return s_led_edges_dropped;
+}
+
+void pc_power_hal_set_led_edge_cb(void (*cb)(void))
+{
+    s_led_edge_cb = cb;
+}
+
+bool pc_power_hal_has_vbus_sense(void)
+{
+    return PADPROXY_VBUS_SENSE_ADC >= 0;
+}
+
+bool pc_power_hal_read_vbus(void)
+{
+#if PADPROXY_VBUS_SENSE_ADC >= 0
+    adc_select_input(PADPROXY_VBUS_SENSE_ADC);
+    return adc_read() >= VBUS_PRESENT_COUNTS;
+#else
+    return false;
+#endif
+}
+
 void pc_power_hal_trigger_power_button(uint32_t duration_ms)
 {
     /* Cancel any in-flight pulse so we don't stack up */
@@ -78,6 +171,11 @@ uint32_t pc_power_hal_millis(void)
     return (uint32_t)(time_us_64() / 1000);
 }
 
+uint32_t pc_power_hal_micros(void)
+{
+    return time_us_32();
+}
+
 void pc_power_hal_start_boot_timer(uint32_t timeout_ms)
 {
     pc_power_hal_cancel_boot_timer();
@@ -4,6 +4,17 @@ void pc_power_sm_init(pc_power_sm_t *sm)
 {
     sm->state = PC_STATE_OFF;
     sm->last_transition_ms = 0;
+    sm->remote_wakeup_armed = false;
+    sm->boot_source = PC_BOOT_COLD;
+    sm->boot_start_ms = 0;
+    sm->boot_timed_out = false;
+    for (int i = 0; i < PC_BOOT_SOURCE_COUNT; i++)
+        sm->boot_history[i] = (pc_boot_history_t){0};
+}
+
+void pc_power_sm_set_remote_wakeup(pc_power_sm_t *sm, bool armed)
+{
+    sm->remote_wakeup_armed = armed;
 }
 
 pc_power_state_t pc_power_sm_get_state(const pc_power_sm_t *sm)
@@ -11,192 +22,231 @@ pc_power_state_t pc_power_sm_get_state(const pc_power_sm_t *sm)
     return sm->state;
 }
 
+static void record_boot(pc_boot_history_t *h, uint32_t ms)
+{
+    h->ms[h->next] = ms;
+    h->next = (uint8_t)((h->next + 1) % PC_BOOT_HISTORY);
+    if (h->count < PC_BOOT_HISTORY)
+        h->count++;
+}
+
 /**
- * Helper: build a result that transitions to a new state.
+ * Nearest-rank percentile of a boot history (0 if empty).  At most
+ * PC_BOOT_HISTORY samples, so an insertion sort of a copy is cheap.
  */
-static pc_power_result_t transition(pc_power_sm_t *sm,
-                                     pc_power_state_t new_state,
-                                     uint32_t actions,
-                                     uint32_t now_ms)
+static uint32_t boot_percentile(const pc_boot_history_t *h, uint32_t pct)
 {
-    sm->state = new_state;
-    sm->last_transition_ms = now_ms;
-    return (pc_power_result_t){
-        .new_state = new_state,
-        .actions = actions,
-        .transitioned = true,
-    };
+    uint32_t sorted[PC_BOOT_HISTORY];
+    uint32_t n = h->count;
+
+    if (n == 0)
+        return 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = h->ms[i];
+        uint32_t j = i;
+        for (; j > 0 && sorted[j - 1] > v; j--)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = v;
+    }
+
+    uint32_t rank = (pct * n + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
 }
 
 /**
- * Helper: build a result with no state change.
+ * Time boots across a transition out of sm->state.  Entering BOOTING
+ * starts a boot; reaching ON from BOOTING (or from OFF shortly after a
+ * boot timeout) records it.
  */
-static pc_power_result_t no_change(const pc_power_sm_t *sm)
+static void track_boot(pc_power_sm_t *sm, pc_power_event_t event,
+                       pc_power_state_t new_state, uint32_t now_ms)
 {
-    return (pc_power_result_t){
-        .new_state = sm->state,
-        .actions = PC_ACTION_NONE,
-        .transitioned = false,
-    };
+    bool late = sm->boot_timed_out && sm->state == PC_STATE_OFF;
+    sm->boot_timed_out = sm->state == PC_STATE_BOOTING &&
+                         event == PC_EVENT_BOOT_TIMEOUT;
+
+    if (new_state == PC_STATE_BOOTING) {
+        sm->boot_source = sm->state == PC_STATE_OFF ? PC_BOOT_COLD
+                                                    : PC_BOOT_RESUME;
+        sm->boot_start_ms = now_ms;
+    } else if (new_state == PC_STATE_ON) {
+        uint32_t ms = now_ms - sm->boot_start_ms;
+        if (sm->state == PC_STATE_BOOTING ||
+            (late && ms <= PC_BOOT_LATE_MAX_MS))
+            record_boot(&sm->boot_history[sm->boot_source], ms);
+    }
 }
 
-static pc_power_result_t handle_off(pc_power_sm_t *sm,
-                                     pc_power_event_t event,
-                                     uint32_t now_ms)
+/* ── Transition table ─────────────────────────────────────────────────
+ *
+ * One entry per (state, event); cells left out ignore the event.  An
+ * entry with a guard applies only while the guard holds, otherwise the
+ * guard's k_otherwise entry does.  Wake pulses always pair the power
+ * button with Wake-on-LAN (for PCs without the front-panel header wired).
+ */
+
+typedef enum {
+    GUARD_NONE = 0,
+    /** Host suspended the bus with remote wakeup enabled */
+    GUARD_REMOTE_WAKEUP_ARMED,
+    GUARD_COUNT
+} pc_power_guard_t;
+
+typedef struct {
+    uint8_t valid;      /* 0: event ignored in this state */
+    uint8_t next;       /* pc_power_state_t */
+    uint8_t actions;    /* pc_power_action_t bits */
+    uint8_t guard;      /* pc_power_guard_t */
+} pc_power_transition_t;
+
+#define GO(next_, actions_)             { 1, (next_), (actions_), GUARD_NONE }
+#define GO_IF(guard_, next_, actions_)  { 1, (next_), (actions_), (guard_) }
+
+#define WAKE_PULSE  (PC_ACTION_TRIGGER_POWER | PC_ACTION_SEND_WOL | \
+                     PC_ACTION_START_BOOT_TIMER)
+
+static const pc_power_transition_t
+k_transitions[PC_STATE_COUNT][PC_EVENT_COUNT] = {
+    [PC_STATE_OFF] = {
+        /* HOME pressed: press the power button, wait for USB */
+        [PC_EVENT_WAKE_REQUESTED]  = GO(PC_STATE_BOOTING, WAKE_PULSE),
+        /* Powered on without us (WoL, BIOS auto-power-on, missed press) */
+        [PC_EVENT_POWER_LED_ON]    = GO(PC_STATE_BOOTING,
+                                        PC_ACTION_START_BOOT_TIMER),
+        /* Missed the boot sequence */
+        [PC_EVENT_USB_ENUMERATED]  = GO(PC_STATE_ON, PC_ACTION_NONE),
+        /* We powered up while the PC was already in S3 */
+        [PC_EVENT_POWER_LED_BLINK] = GO(PC_STATE_SLEEPING, PC_ACTION_NONE),
+    },
+    [PC_STATE_BOOTING] = {
+        /* OS is running: boot successful */
+        [PC_EVENT_USB_ENUMERATED]  = GO(PC_STATE_ON,
+                                        PC_ACTION_CANCEL_BOOT_TIMER),
+        /* Shut down before finishing boot (second tap, PSU issue) */
+        [PC_EVENT_POWER_LED_OFF]   = GO(PC_STATE_OFF,
+                                        PC_ACTION_CANCEL_BOOT_TIMER),
+        /* Fell back asleep, or the wake never took */
+        [PC_EVENT_POWER_LED_BLINK] = GO(PC_STATE_SLEEPING,
+                                        PC_ACTION_CANCEL_BOOT_TIMER),
+        /* Stuck in BIOS or failed: let the user try again (a late USB
+         * enumeration is still recorded as a slow boot) */
+        [PC_EVENT_BOOT_TIMEOUT]    = GO(PC_STATE_OFF, PC_ACTION_NONE),
+    },
+    [PC_STATE_ON] = {
+        /* Entering sleep */
+        [PC_EVENT_USB_SUSPENDED]   = GO(PC_STATE_SLEEPING, PC_ACTION_NONE),
+        /* Shutdown */
+        [PC_EVENT_POWER_LED_OFF]   = GO(PC_STATE_OFF, PC_ACTION_NONE),
+        /* S3 even without a USB suspend (e.g. hub kept powered) */
+        [PC_EVENT_POWER_LED_BLINK] = GO(PC_STATE_SLEEPING, PC_ACTION_NONE),
+    },
+    [PC_STATE_SLEEPING] = {
+        /* HOME pressed: try USB remote wakeup if the host armed it,
+         * keeping the power button as the fallback (k_otherwise) */
+        [PC_EVENT_WAKE_REQUESTED]  = GO_IF(GUARD_REMOTE_WAKEUP_ARMED,
+                                           PC_STATE_WAKING,
+                                           PC_ACTION_USB_REMOTE_WAKEUP |
+                                           PC_ACTION_START_BOOT_TIMER),
+        /* Woke by itself (keyboard, scheduled wake, WoL) */
+        [PC_EVENT_USB_ENUMERATED]  = GO(PC_STATE_ON, PC_ACTION_NONE),
+        /* Waking: wait for USB to confirm the OS is back */
+        [PC_EVENT_POWER_LED_ON]    = GO(PC_STATE_BOOTING,
+                                        PC_ACTION_START_BOOT_TIMER),
+        /* Sleep to full shutdown (hibernate timeout, power loss) */
+        [PC_EVENT_POWER_LED_OFF]   = GO(PC_STATE_OFF, PC_ACTION_NONE),
+    },
+    [PC_STATE_WAKING] = {
+        /* Host resumed the bus: remote wakeup worked */
+        [PC_EVENT_USB_ENUMERATED]  = GO(PC_STATE_ON,
+                                        PC_ACTION_CANCEL_BOOT_TIMER),
+        /* Waking but USB not resumed yet: never pulse now (it could send
+         * the PC straight back to sleep), wait the normal boot timeout */
+        [PC_EVENT_POWER_LED_ON]    = GO(PC_STATE_BOOTING,
+                                        PC_ACTION_START_BOOT_TIMER),
+        /* Went from sleep to off (e.g. hibernate) before resuming */
+        [PC_EVENT_POWER_LED_OFF]   = GO(PC_STATE_OFF,
+                                        PC_ACTION_CANCEL_BOOT_TIMER),
+        /* Motherboard ignored the wakeup: fall back to the button */
+        [PC_EVENT_BOOT_TIMEOUT]    = GO(PC_STATE_BOOTING, WAKE_PULSE),
+    },
+};
+
+/** Taken instead of a guarded entry whose guard does not hold. */
+static const pc_power_transition_t k_otherwise[GUARD_COUNT] = {
+    [GUARD_REMOTE_WAKEUP_ARMED] = GO(PC_STATE_BOOTING, WAKE_PULSE),
+};
+
+static bool guard_holds(const pc_power_sm_t *sm, uint8_t guard)
 {
-    switch (event) {
-    case PC_EVENT_WAKE_REQUESTED:
-        /*
-         * Controller HOME button pressed while PC is off.
-         * Trigger the power button and start waiting for USB enumeration.
-         */
-        return transition(sm, PC_STATE_BOOTING,
-                          PC_ACTION_TRIGGER_POWER | PC_ACTION_START_BOOT_TIMER,
-                          now_ms);
-
-    case PC_EVENT_POWER_LED_ON:
-        /*
-         * Power LED came on without us seeing a button press (e.g., WoL,
-         * BIOS auto-power-on, or we missed the button event). Transition
-         * to BOOTING and wait for USB.
-         */
-        return transition(sm, PC_STATE_BOOTING,
-                          PC_ACTION_START_BOOT_TIMER,
-                          now_ms);
-
-    case PC_EVENT_USB_ENUMERATED:
-        /*
-         * USB enumerated while we thought PC was off. Likely we missed
-         * the boot sequence. Jump straight to ON.
-         */
-        return transition(sm, PC_STATE_ON,
-                          PC_ACTION_NONE,
-                          now_ms);
-
-    default:
-        return no_change(sm);
+    switch (guard) {
+    case GUARD_REMOTE_WAKEUP_ARMED: return sm->remote_wakeup_armed;
+    default:                        return true;
     }
 }
 
-static pc_power_result_t handle_booting(pc_power_sm_t *sm,
-                                         pc_power_event_t event,
-                                         uint32_t now_ms)
+pc_power_result_t pc_power_sm_process(pc_power_sm_t *sm,
+                                       pc_power_event_t event,
+                                       uint32_t now_ms)
 {
-    switch (event) {
-    case PC_EVENT_USB_ENUMERATED:
-        /*
-         * USB host detected - OS is running. Boot successful.
-         */
-        return transition(sm, PC_STATE_ON,
-                          PC_ACTION_CANCEL_BOOT_TIMER,
-                          now_ms);
-
-    case PC_EVENT_POWER_LED_OFF:
-        /*
-         * LED turned off during boot. The PC shut down before finishing
-         * boot (e.g., user tapped power button again, or PSU issue).
-         */
-        return transition(sm, PC_STATE_OFF,
-                          PC_ACTION_CANCEL_BOOT_TIMER,
-                          now_ms);
-
-    case PC_EVENT_BOOT_TIMEOUT:
-        /*
-         * Timed out waiting for USB enumeration. The PC may have booted
-         * into BIOS or failed. Return to OFF so the user can try again.
-         */
-        return transition(sm, PC_STATE_OFF,
-                          PC_ACTION_NONE,
-                          now_ms);
-
-    default:
-        return no_change(sm);
-    }
+    pc_power_result_t r = {
+        .new_state = sm->state,
+        .actions = PC_ACTION_NONE,
+        .transitioned = false,
+    };
+
+    if ((unsigned)sm->state >= PC_STATE_COUNT ||
+        (unsigned)event >= PC_EVENT_COUNT)
+        return r;
+
+    const pc_power_transition_t *t = &k_transitions[sm->state][event];
+    if (!t->valid)
+        return r;
+    if (!guard_holds(sm, t->guard))
+        t = &k_otherwise[t->guard];
+
+    track_boot(sm, event, (pc_power_state_t)t->next, now_ms);
+    sm->state = (pc_power_state_t)t->next;
+    sm->last_transition_ms = now_ms;
+
+    r.new_state = sm->state;
+    r.actions = t->actions;
+    r.transitioned = true;
+    return r;
 }
 
-static pc_power_result_t handle_on(pc_power_sm_t *sm,
-                                    pc_power_event_t event,
-                                    uint32_t now_ms)
+uint32_t pc_power_sm_boot_timeout(const pc_power_sm_t *sm,
+                                  uint32_t default_ms)
 {
-    switch (event) {
-    case PC_EVENT_USB_SUSPENDED:
-        /*
-         * USB suspended. PC is likely entering sleep.
-         */
-        return transition(sm, PC_STATE_SLEEPING,
-                          PC_ACTION_NONE,
-                          now_ms);
-
-    case PC_EVENT_POWER_LED_OFF:
-        /*
-         * Power LED went off while PC was on. This means shutdown.
-         */
-        return transition(sm, PC_STATE_OFF,
-                          PC_ACTION_NONE,
-                          now_ms);
-
-    default:
-        return no_change(sm);
-    }
+    const pc_boot_history_t *h = &sm->boot_history[sm->boot_source];
+    if (h->count < PC_BOOT_MIN_SAMPLES)
+        return default_ms;
+
+    uint32_t ms = boot_percentile(h, PC_BOOT_TIMEOUT_PCT) *
+                  PC_BOOT_TIMEOUT_HEADROOM / 100;
+    if (ms < PC_BOOT_TIMEOUT_MIN_MS)
+        return PC_BOOT_TIMEOUT_MIN_MS;
+    if (ms > PC_BOOT_TIMEOUT_MAX_MS)
+        return PC_BOOT_TIMEOUT_MAX_MS;
+    return ms;
 }
 
-static pc_power_result_t handle_sleeping(pc_power_sm_t *sm,
-                                          pc_power_event_t event,
-                                          uint32_t now_ms)
+uint32_t pc_power_sm_boot_typical_ms(const pc_power_sm_t *sm,
+                                     pc_boot_source_t source)
 {
-    switch (event) {
-    case PC_EVENT_WAKE_REQUESTED:
-        /*
-         * Controller button pressed while PC is sleeping.
-         * Trigger power button to wake from sleep.
-         */
-        return transition(sm, PC_STATE_BOOTING,
-                          PC_ACTION_TRIGGER_POWER | PC_ACTION_START_BOOT_TIMER,
-                          now_ms);
-
-    case PC_EVENT_USB_ENUMERATED:
-        /*
-         * USB re-enumerated. PC woke up (e.g., keyboard/mouse wake,
-         * scheduled wake, or WoL).
-         */
-        return transition(sm, PC_STATE_ON,
-                          PC_ACTION_NONE,
-                          now_ms);
-
-    case PC_EVENT_POWER_LED_ON:
-        /*
-         * LED came back on. PC is waking up. Go to BOOTING until
-         * USB confirms OS is running.
-         */
-        return transition(sm, PC_STATE_BOOTING,
-                          PC_ACTION_START_BOOT_TIMER,
-                          now_ms);
-
-    case PC_EVENT_POWER_LED_OFF:
-        /*
-         * LED off while sleeping - PC transitioned from sleep to full
-         * shutdown (e.g., hibernate timeout, or power loss).
-         */
-        return transition(sm, PC_STATE_OFF,
-                          PC_ACTION_NONE,
-                          now_ms);
-
-    default:
-        return no_change(sm);
-    }
+    if (source >= PC_BOOT_SOURCE_COUNT)
+        return 0;
+    return boot_percentile(&sm->boot_history[source], 50);
 }
 
-pc_power_result_t pc_power_sm_process(pc_power_sm_t *sm,
-                                       pc_power_event_t event,
-                                       uint32_t now_ms)
+uint32_t pc_power_sm_boot_eta_ms(const pc_power_sm_t *sm, uint32_t now_ms)
 {
-    switch (sm->state) {
-    case PC_STATE_OFF:      return handle_off(sm, event, now_ms);
-    case PC_STATE_BOOTING:  return handle_booting(sm, event, now_ms);
-    case PC_STATE_ON:       return handle_on(sm, event, now_ms);
-    case PC_STATE_SLEEPING: return handle_sleeping(sm, event, now_ms);
-    default:                return no_change(sm);
-    }
+    if (sm->state != PC_STATE_BOOTING)
+        return 0;
+
+    uint32_t typical = pc_power_sm_boot_typical_ms(sm, sm->boot_source);
+    uint32_t elapsed = now_ms - sm->boot_start_ms;
+    return elapsed < typical ? typical - elapsed : 0;
 }
 
 const char *pc_power_state_name(pc_power_state_t state)
@@ -206,6 +256,7 @@ const char *pc_power_state_name(pc_power_state_t state)
     case PC_STATE_BOOTING:  return "PC_BOOTING";
     case PC_STATE_ON:       return "PC_ON";
     case PC_STATE_SLEEPING: return "PC_SLEEPING";
+    case PC_STATE_WAKING:   return "PC_WAKING";
     default:                return "UNKNOWN";
     }
 }
@@ -219,6 +270,7 @@ const char *pc_power_event_name(pc_power_event_t event)
     case PC_EVENT_POWER_LED_ON:       return "POWER_LED_ON";
     case PC_EVENT_POWER_LED_OFF:      return "POWER_LED_OFF";
     case PC_EVENT_BOOT_TIMEOUT:       return "BOOT_TIMEOUT";
+    case PC_EVENT_POWER_LED_BLINK:    return "POWER_LED_BLINK";
     default:                          return "UNKNOWN";
     }
 }
@@ -0,0 +1,139 @@
+#include "pc_power_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define RING_MASK (PC_TRACE_SIZE - 1u)
+
+static pc_power_trace_entry_t s_ring[PC_TRACE_SIZE];
+static uint32_t s_head;         /* entries written */
+static uint32_t s_led_run;      /* LED edges since the last SM entry */
+static pc_power_trace_entry_t *s_skip;  /* counting entry of this run */
+
+/* ── Writer ─────────────────────────────────────────────────────────── */
+
+static pc_power_trace_entry_t *push(uint8_t kind, uint32_t time_ms)
+{
+    pc_power_trace_entry_t *e = &s_ring[s_head++ & RING_MASK];
+    e->time_ms = time_ms;
+    e->kind    = kind;
+    e->event   = 0;
+    return e;
+}
+
+void pc_power_trace_init(void)
+{
+    memset(s_ring, 0, sizeof(s_ring));
+    s_head    = 0;
+    s_led_run = 0;
+    s_skip    = NULL;
+}
+
+void pc_power_trace_sm(pc_power_event_t event, pc_power_state_t old_state,
+                       const pc_power_result_t *r, uint32_t now_ms)
+{
+    pc_power_trace_entry_t *e = push(PC_TRACE_SM, now_ms);
+    e->event        = (uint8_t)event;
+    e->u.sm.states  = (uint8_t)((old_state << 4) | (r->new_state & 0x0F));
+    e->u.sm.actions = (uint8_t)(r->actions |
+                                (r->transitioned ? PC_TRACE_TRANSITIONED : 0));
+    s_led_run = 0;
+    s_skip    = NULL;
+}
+
+pc_power_result_t pc_power_trace_process(pc_power_sm_t *sm,
+                                         pc_power_event_t event,
+                                         uint32_t now_ms)
+{
+    pc_power_state_t old_state = pc_power_sm_get_state(sm);
+    pc_power_result_t r = pc_power_sm_process(sm, event, now_ms);
+    pc_power_trace_sm(event, old_state, &r, now_ms);
+    return r;
+}
+
+void pc_power_trace_led(bool on, uint32_t at_ms)
+{
+    if (s_led_run < PC_TRACE_LED_BURST) {
+        s_led_run++;
+        push(PC_TRACE_LED, at_ms)->u.led_on = on;
+        return;
+    }
+
+    /* Nothing else is written until the next SM entry, so the counting
+     * entry cannot have been overwritten */
+    if (!s_skip) {
+        s_skip = push(PC_TRACE_LED_SKIPPED, at_ms);
+        s_skip->u.skipped = 0;
+    }
+    s_skip->time_ms = at_ms;
+    if (s_skip->u.skipped < UINT16_MAX)
+        s_skip->u.skipped++;
+}
+
+/* ── Reader ─────────────────────────────────────────────────────────── */
+
+uint32_t pc_power_trace_written(void)
+{
+    return s_head;
+}
+
+uint32_t pc_power_trace_oldest(void)
+{
+    return s_head > PC_TRACE_SIZE ? s_head - PC_TRACE_SIZE : 0;
+}
+
+bool pc_power_trace_read(uint32_t seq, pc_power_trace_entry_t *out)
+{
+    if (seq - pc_power_trace_oldest() >= s_head - pc_power_trace_oldest())
+        return false;
+    *out = s_ring[seq & RING_MASK];
+    return true;
+}
+
+/** State name without the "PC_" prefix. */
+static const char *short_state(unsigned state)
+{
+    const char *name = pc_power_state_name((pc_power_state_t)state);
+    return strncmp(name, "PC_", 3) == 0 ? name + 3 : name;
+}
+
+int pc_power_trace_format(const pc_power_trace_entry_t *e, char *buf,
+                          size_t size)
+{
+    unsigned s  = (unsigned)(e->time_ms / 1000);
+    unsigned ms = (unsigned)(e->time_ms % 1000);
+    int n;
+
+    switch (e->kind) {
+    case PC_TRACE_SM: {
+        unsigned from = e->u.sm.states >> 4;
+        unsigned to   = e->u.sm.states & 0x0F;
+        const char *event =
+            pc_power_event_name((pc_power_event_t)e->event);
+
+        if (e->u.sm.actions & PC_TRACE_TRANSITIONED)
+            n = snprintf(buf, size, "%u.%03u %s %s>%s %02x", s, ms, event,
+                         short_state(from), short_state(to),
+                         (unsigned)(e->u.sm.actions & ~PC_TRACE_TRANSITIONED));
+        else
+            n = snprintf(buf, size, "%u.%03u %s %s -", s, ms, event,
+                         short_state(from));
+        break;
+    }
+    case PC_TRACE_LED:
+        n = snprintf(buf, size, "%u.%03u LED %u", s, ms,
+                     (unsigned)e->u.led_on);
+        break;
+    case PC_TRACE_LED_SKIPPED:
+        n = snprintf(buf, size, "%u.%03u LED +%u", s, ms,
+                     (unsigned)e->u.skipped);
+        break;
+    default:
+        n = snprintf(buf, size, "%u.%03u ?", s, ms);
+        break;
+    }
+
+    if (n < 0)
+        return 0;
+    return (size_t)n < size ? n : (int)size - 1;
+}
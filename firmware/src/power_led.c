@@ -0,0 +1,156 @@
+#include "power_led.h"
+
+#define MS_TO_US(ms) ((uint32_t)(ms) * 1000u)
+
+/* ── Helpers ────────────────────────────────────────────────────────── */
+
+static bool period_ok(uint32_t period_us)
+{
+    return period_us >= MS_TO_US(POWER_LED_BLINK_MIN_MS) &&
+           period_us <= MS_TO_US(POWER_LED_BLINK_MAX_MS);
+}
+
+static void hist_push(power_led_t *p, uint32_t at_us)
+{
+    if (p->hist_count == POWER_LED_HISTORY) {
+        for (int i = 1; i < POWER_LED_HISTORY; i++)
+            p->hist_us[i - 1] = p->hist_us[i];
+        p->hist_count--;
+    }
+    p->hist_us[p->hist_count++] = at_us;
+}
+
+/**
+ * Check the last four edges for a periodic blink and learn its period
+ * and on-time.  With edges t0..t3 the phases are [t0,t1) and [t2,t3) at
+ * one level and [t1,t2) at the current level.
+ */
+static void detect_blink(power_led_t *p)
+{
+    if (p->hist_count < 4)
+        return;
+
+    const uint32_t *t = &p->hist_us[p->hist_count - 4];
+    uint32_t p1 = t[2] - t[0];
+    uint32_t p2 = t[3] - t[1];
+    if (!period_ok(p1) || !period_ok(p2))
+        return;
+
+    uint32_t avg  = p1 / 2 + p2 / 2;
+    uint32_t diff = p1 > p2 ? p1 - p2 : p2 - p1;
+    if (diff > avg / 4)
+        return;
+
+    uint32_t on_us = p->level ? t[2] - t[1]
+                              : (t[1] - t[0]) / 2 + (t[3] - t[2]) / 2;
+
+    p->blink_period_us = avg;
+    p->blink_on_us     = on_us;
+    p->blinking        = true;
+}
+
+/** How long `level` must be held to count as steady. */
+static uint32_t hold_for(const power_led_t *p, bool level)
+{
+    if (p->blink_period_us == 0)
+        return p->hold_us;
+
+    uint32_t phase = level ? p->blink_on_us
+                           : p->blink_period_us - p->blink_on_us;
+    uint32_t hold  = phase + phase / 2;
+    return hold < MS_TO_US(POWER_LED_HOLD_MIN_MS) ? MS_TO_US(POWER_LED_HOLD_MIN_MS)
+                                                  : hold;
+}
+
+/* ── Public API ─────────────────────────────────────────────────────── */
+
+void power_led_init(power_led_t *p, bool level, uint32_t hold_ms)
+{
+    *p = (power_led_t){
+        .hold_us = MS_TO_US(hold_ms),
+        .level   = level,
+        .pattern = level ? POWER_LED_PATTERN_ON : POWER_LED_PATTERN_OFF,
+    };
+}
+
+void power_led_edge(power_led_t *p, bool on, uint32_t at_us)
+{
+    if (on == p->level)
+        return;
+    p->edges++;
+
+    /* A pulse shorter than the glitch limit: undo its opening edge */
+    if (p->hist_count > 0 &&
+        (int32_t)(at_us - p->changed_us) < (int32_t)MS_TO_US(POWER_LED_GLITCH_MS)) {
+        p->glitches++;
+        p->level      = on;
+        p->changed_us = p->prev_changed_us;
+        p->hist_count--;
+        return;
+    }
+
+    p->prev_changed_us = p->changed_us;
+    p->level      = on;
+    p->changed_us = at_us;
+    hist_push(p, at_us);
+    detect_blink(p);
+}
+
+power_led_change_t power_led_update(power_led_t *p, uint32_t now_us)
+{
+    /* An edge stamped after now (read race with the IRQ) is not held */
+    int32_t held = (int32_t)(now_us - p->changed_us);
+    if (held < 0)
+        return POWER_LED_UNCHANGED;
+
+    bool steady = (uint32_t)held >= hold_for(p, p->level);
+
+    /* A level outlasting its blink phase ends the blink */
+    if (p->blinking && steady)
+        p->blinking = false;
+
+    if (p->blinking) {
+        if (p->pattern == POWER_LED_PATTERN_BLINK)
+            return POWER_LED_UNCHANGED;
+        p->pattern = POWER_LED_PATTERN_BLINK;
+        return POWER_LED_BECAME_BLINKING;
+    }
+
+    if (!steady)
+        return POWER_LED_UNCHANGED;
+
+    power_led_pattern_t target = p->level ? POWER_LED_PATTERN_ON
+                                          : POWER_LED_PATTERN_OFF;
+    if (p->pattern == target)
+        return POWER_LED_UNCHANGED;
+
+    p->pattern = target;
+    return p->level ? POWER_LED_BECAME_ON : POWER_LED_BECAME_OFF;
+}
+
+power_led_pattern_t power_led_pattern(const power_led_t *p)
+{
+    return p->pattern;
+}
+
+const char *power_led_pattern_name(power_led_pattern_t pattern)
+{
+    switch (pattern) {
+    case POWER_LED_PATTERN_OFF:   return "off";
+    case POWER_LED_PATTERN_ON:    return "on";
+    case POWER_LED_PATTERN_BLINK: return "blink";
+    default:                      return "unknown";
+    }
+}
+
+uint32_t power_led_blink_period_ms(const power_led_t *p)
+{
+    return p->blink_period_us / 1000u;
+}
+
+uint32_t power_led_blink_duty_pct(const power_led_t *p)
+{
+    if (p->blink_period_us == 0)
+        return 0;
+    return (uint32_t)((uint64_t)p->blink_on_us * 100u / p->blink_period_us);
+}
@@ -0,0 +1,58 @@
+#include "report_filter.h"
+
+void report_filter_init(report_filter_t *f, const report_filter_config_t *cfg)
+{
+    f->cfg        = *cfg;
+    f->sent       = 0;
+    f->suppressed = 0;
+    report_filter_reset(f);
+}
+
+void report_filter_reset(report_filter_t *f)
+{
+    f->primed  = false;
+    f->last_ms = 0;
+}
+
+static bool moved(int32_t now, int32_t last, uint16_t threshold)
+{
+    int32_t d = now - last;
+    if (d < 0)
+        d = -d;
+    return d != 0 && d >= threshold;
+}
+
+static bool changed(const report_filter_t *f, const gamepad_report_t *r)
+{
+    const gamepad_report_t *l = &f->last;
+    const uint16_t *t = f->cfg.threshold;
+
+    return r->buttons != l->buttons || r->dpad != l->dpad ||
+           moved(r->lx, l->lx, t[REPORT_FILTER_LX]) ||
+           moved(r->ly, l->ly, t[REPORT_FILTER_LY]) ||
+           moved(r->rx, l->rx, t[REPORT_FILTER_RX]) ||
+           moved(r->ry, l->ry, t[REPORT_FILTER_RY]) ||
+           moved(r->lt, l->lt, t[REPORT_FILTER_LT]) ||
+           moved(r->rt, l->rt, t[REPORT_FILTER_RT]);
+}
+
+bool report_filter_check(report_filter_t *f, const gamepad_report_t *r,
+                         uint32_t now_ms)
+{
+    if (!f->primed || changed(f, r))
+        return true;
+    if (f->cfg.keepalive_ms && now_ms - f->last_ms >= f->cfg.keepalive_ms)
+        return true;
+
+    f->suppressed++;
+    return false;
+}
+
+void report_filter_sent(report_filter_t *f, const gamepad_report_t *r,
+                        uint32_t now_ms)
+{
+    f->last    = *r;
+    f->last_ms = now_ms;
+    f->primed  = true;
+    f->sent++;
+}
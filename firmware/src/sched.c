@@ -0,0 +1,163 @@
+#include "sched.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ── Helpers ────────────────────────────────────────────────────────── */
+
+/** Signed difference a - b, correct across uint32 wrap-around. */
+static int32_t diff_ms(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b);
+}
+
+static bool is_due(const sched_task_t *t, uint32_t now_ms)
+{
+    if (t->notified)
+        return true;
+    return t->period_ms != 0 && diff_ms(now_ms, t->next_ms) >= 0;
+}
+
+static void run_task(sched_t *s, sched_task_t *t, uint32_t now_ms)
+{
+    /* Clear first so a notify raised while running is not lost */
+    t->notified = false;
+
+    if (t->period_ms != 0) {
+        if (t->runs == 0) {
+            /* First run anchors the deadlines */
+            t->next_ms = now_ms + t->period_ms;
+        } else if (diff_ms(now_ms, t->next_ms) >= (int32_t)t->period_ms) {
+            /* Missed a whole period: count it and re-anchor rather than
+             * running back-to-back to catch up */
+            t->late++;
+            t->next_ms = now_ms + t->period_ms;
+        } else if (diff_ms(now_ms, t->next_ms) >= 0) {
+            t->next_ms += t->period_ms;
+        } else {
+            /* Early run on notify: restart the period from now */
+            t->next_ms = now_ms + t->period_ms;
+        }
+    }
+
+    uint32_t start = s->clock_us ? s->clock_us() : 0;
+    t->fn(now_ms, t->ctx);
+    uint32_t elapsed = s->clock_us ? s->clock_us() - start : 0;
+
+    t->runs++;
+    t->total_us += elapsed;
+    if (elapsed > t->max_us)
+        t->max_us = elapsed;
+}
+
+/* ── Public API ─────────────────────────────────────────────────────── */
+
+void sched_init(sched_t *s, sched_clock_us_t clock_us)
+{
+    memset(s, 0, sizeof(*s));
+    s->clock_us = clock_us;
+}
+
+int sched_add(sched_t *s, const char *name, sched_fn_t fn, void *ctx,
+              uint32_t period_ms, uint8_t priority)
+{
+    if (!fn || s->count >= SCHED_MAX_TASKS)
+        return -1;
+
+    int id = s->count;
+    sched_task_t *t = &s->tasks[id];
+    memset(t, 0, sizeof(*t));
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "task");
+    t->fn        = fn;
+    t->ctx       = ctx;
+    t->period_ms = period_ms;
+    t->priority  = priority;
+    t->notified  = (period_ms != 0);   /* first periodic run on first pass */
+
+    /* Insertion sort into the run order; equal priorities keep the
+     * order they were added in */
+    int pos = s->count;
+    while (pos > 0 && s->tasks[s->order[pos - 1]].priority > priority) {
+        s->order[pos] = s->order[pos - 1];
+        pos--;
+    }
+    s->order[pos] = (uint8_t)id;
+    s->count++;
+    return id;
+}
+
+void sched_notify(sched_t *s, int task_id)
+{
+    if (task_id >= 0 && task_id < s->count)
+        s->tasks[task_id].notified = true;
+}
+
+uint32_t sched_run(sched_t *s, uint32_t now_ms)
+{
+    bool ran = false;
+
+    s->passes++;
+
+    for (int i = 0; i < s->count; i++) {
+        sched_task_t *t = &s->tasks[s->order[i]];
+        if (t->priority == SCHED_PRIO_IDLE)
+            break;      /* idle tasks are sorted last */
+        if (is_due(t, now_ms)) {
+            run_task(s, t, now_ms);
+            ran = true;
+        }
+    }
+
+    if (!ran) {
+        s->idle_passes++;
+        for (int i = 0; i < s->count; i++) {
+            sched_task_t *t = &s->tasks[s->order[i]];
+            if (t->priority == SCHED_PRIO_IDLE && is_due(t, now_ms))
+                run_task(s, t, now_ms);
+        }
+    }
+
+    /* How long until something is due? */
+    uint32_t sleep = SCHED_MAX_SLEEP_MS;
+    for (int i = 0; i < s->count; i++) {
+        const sched_task_t *t = &s->tasks[i];
+        if (t->notified)
+            return 0;
+        if (t->period_ms == 0)
+            continue;
+        int32_t until = diff_ms(t->next_ms, now_ms);
+        if (until <= 0)
+            return 0;
+        if ((uint32_t)until < sleep)
+            sleep = (uint32_t)until;
+    }
+    return sleep;
+}
+
+const sched_task_t *sched_task(const sched_t *s, int task_id)
+{
+    if (task_id < 0 || task_id >= s->count)
+        return NULL;
+    return &s->tasks[task_id];
+}
+
+bool sched_register_metrics(sched_t *s)
+{
+    static const char *const suffix[4] = { "runs", "late", "max_us", "total_us" };
+    bool ok = true;
+
+    for (int i = 0; i < s->count; i++) {
+        sched_task_t *t = &s->tasks[i];
+        const uint32_t *src[4] = { &t->runs, &t->late, &t->max_us, &t->total_us };
+
+        for (int k = 0; k < 4; k++) {
+            char *dst = t->metric_names[k];
+            size_t n = strlen(t->name);
+            memcpy(dst, t->name, n);
+            dst[n++] = '.';
+            strcpy(dst + n, suffix[k]);     /* sized for the longest suffix */
+            ok &= metrics_register_counter(dst, src[k], 0);
+        }
+    }
+    return ok;
+}
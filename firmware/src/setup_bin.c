@@ -0,0 +1,322 @@
+#include "setup_bin.h"
+#include <string.h>
+
+/* ── COBS ───────────────────────────────────────────────────────────── */
+
+size_t setup_bin_cobs_encode(const uint8_t *in, size_t len,
+                             uint8_t *out, size_t out_size)
+{
+    if (out_size == 0)
+        return 0;
+
+    size_t code_pos = 0;    /* where the current block's code byte goes */
+    size_t o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] != 0) {
+            if (o >= out_size) return 0;
+            out[o++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[code_pos] = code;
+            code = 1;
+            code_pos = o;
+            if (o >= out_size) return 0;
+            o++;
+        }
+    }
+    out[code_pos] = code;
+    return o;
+}
+
+int setup_bin_cobs_decode(const uint8_t *in, size_t len,
+                          uint8_t *out, size_t out_size)
+{
+    size_t i = 0, o = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len)
+            return -1;
+        for (uint8_t k = 1; k < code; k++) {
+            if (o >= out_size || in[i] == 0) return -1;
+            out[o++] = in[i++];
+        }
+        /* A zero follows every block except a full one or the last */
+        if (code != 0xFF && i < len) {
+            if (o >= out_size) return -1;
+            out[o++] = 0;
+        }
+    }
+    return (int)o;
+}
+
+/* ── Frame collection ───────────────────────────────────────────────── */
+
+void setup_bin_rx_start(setup_bin_rx_t *rx, uint32_t now_ms)
+{
+    rx->len     = 0;
+    rx->active  = true;
+    rx->last_ms = now_ms;
+}
+
+static void rx_drop(setup_bin_rx_t *rx)
+{
+    rx->len    = 0;
+    rx->active = false;
+    rx->dropped++;
+}
+
+setup_bin_rx_status_t setup_bin_rx_byte(setup_bin_rx_t *rx, uint8_t b,
+                                        uint32_t now_ms)
+{
+    rx->last_ms = now_ms;
+    if (b == 0x00)
+        return SETUP_BIN_RX_FRAME;
+
+    if (rx->len >= sizeof(rx->buf)) {
+        rx_drop(rx);
+        return SETUP_BIN_RX_DROPPED;
+    }
+    rx->buf[rx->len++] = b;
+    return SETUP_BIN_RX_MORE;
+}
+
+void setup_bin_rx_done(setup_bin_rx_t *rx)
+{
+    rx->len    = 0;
+    rx->active = false;
+}
+
+bool setup_bin_rx_expire(setup_bin_rx_t *rx, uint32_t now_ms)
+{
+    if (!rx->active || now_ms - rx->last_ms < SETUP_BIN_IDLE_MS)
+        return false;
+    rx_drop(rx);
+    return true;
+}
+
+/* ── Response builder ───────────────────────────────────────────────── */
+
+typedef struct {
+    uint8_t *buf;
+    size_t   cap;
+    size_t   len;
+    bool     overflow;
+} body_t;
+
+static void put(body_t *b, const void *data, size_t n)
+{
+    if (b->overflow || b->len + n > b->cap) {
+        b->overflow = true;
+        return;
+    }
+    memcpy(b->buf + b->len, data, n);
+    b->len += n;
+}
+
+static void put_u8(body_t *b, uint8_t v)
+{
+    put(b, &v, 1);
+}
+
+/** Append a length-prefixed string (truncated to 255 bytes). */
+static void put_str(body_t *b, const char *s)
+{
+    size_t n = strlen(s);
+    if (n > 255) n = 255;
+    put_u8(b, (uint8_t)n);
+    put(b, s, n);
+}
+
+/* ── Op handlers ────────────────────────────────────────────────────── */
+
+static setup_bin_status_t op_get(const uint8_t *p, size_t n,
+                                 const device_config_t *cfg, body_t *b)
+{
+    char value[SETUP_CMD_VALUE_MAX];
+
+    for (size_t i = 0; i < n; i++) {
+        if (setup_cmd_get_value(p[i], cfg, value, sizeof(value)) < 0) {
+            b->len = 0;
+            put_u8(b, p[i]);
+            return SETUP_BIN_ERR_KEY;
+        }
+        put_u8(b, p[i]);
+        put_str(b, value);
+    }
+    return SETUP_BIN_OK;
+}
+
+static setup_bin_status_t op_list(const device_config_t *cfg, body_t *b)
+{
+    char value[SETUP_CMD_VALUE_MAX];
+
+    for (int k = 0; k < setup_cmd_key_count(); k++) {
+        setup_cmd_get_value(k, cfg, value, sizeof(value));
+        put_u8(b, (uint8_t)k);
+        put_str(b, setup_cmd_key_name(k));
+        put_str(b, value);
+    }
+    return SETUP_BIN_OK;
+}
+
+static setup_bin_status_t op_set(const uint8_t *p, size_t n,
+                                 device_config_t *cfg, body_t *b,
+                                 setup_cmd_result_t *result)
+{
+    if (n < 1)
+        return SETUP_BIN_ERR_MALFORMED;
+
+    uint8_t flags = p[0];
+    size_t i = 1;
+
+    /* Apply everything to a scratch copy; commit only if all succeed */
+    device_config_t scratch = *cfg;
+    char value[SETUP_CMD_VALUE_MAX];
+    char err[64];
+
+    while (i < n) {
+        if (n - i < 2)
+            return SETUP_BIN_ERR_MALFORMED;
+        uint8_t key = p[i];
+        uint8_t vlen = p[i + 1];
+        i += 2;
+        if (vlen > n - i)
+            return SETUP_BIN_ERR_MALFORMED;
+
+        if (setup_cmd_key_name(key) == NULL) {
+            put_u8(b, key);
+            return SETUP_BIN_ERR_KEY;
+        }
+        if (vlen >= sizeof(value) || memchr(p + i, '\0', vlen)) {
+            put_u8(b, key);
+            put(b, "value too long", 14);
+            return SETUP_BIN_ERR_VALUE;
+        }
+        memcpy(value, p + i, vlen);
+        value[vlen] = '\0';
+        i += vlen;
+
+        if (!setup_cmd_set_value(key, value, &scratch, err, sizeof(err))) {
+            put_u8(b, key);
+            put(b, err, strlen(err));
+            return SETUP_BIN_ERR_VALUE;
+        }
+    }
+
+    *cfg = scratch;
+    if (flags & SETUP_BIN_SET_SAVE)
+        result->action = SETUP_ACTION_SAVE;
+    return SETUP_BIN_OK;
+}
+
+/** Run a text command and return its response as the payload. */
+static setup_bin_status_t op_text(const char *line, device_config_t *cfg,
+                                  body_t *b, setup_cmd_result_t *result)
+{
+    size_t room = b->cap - b->len;
+    setup_cmd_result_t r = setup_cmd_process(line, cfg,
+                                             (char *)b->buf + b->len, room);
+    b->len += (size_t)r.out_len;
+
+    /* Binary firmware streaming can only be started from text mode */
+    if (r.action == SETUP_ACTION_FIRMWARE) {
+        b->len = 0;
+        put(b, "firmware needs text mode", 24);
+        return SETUP_BIN_ERR_OP;
+    }
+    /* The log is streamed line by line; it does not fit one frame */
+    if (r.action == SETUP_ACTION_LOG_DUMP) {
+        b->len = 0;
+        put(b, "log dump needs text mode", 24);
+        return SETUP_BIN_ERR_OP;
+    }
+    if (r.action == SETUP_ACTION_TRACE_DUMP) {
+        b->len = 0;
+        put(b, "trace needs text mode", 21);
+        return SETUP_BIN_ERR_OP;
+    }
+    result->action = r.action;
+    return SETUP_BIN_OK;
+}
+
+/* ── Main dispatch ──────────────────────────────────────────────────── */
+
+setup_cmd_result_t setup_bin_process(const uint8_t *frame, size_t len,
+                                     device_config_t *cfg,
+                                     uint8_t *out_buf, size_t out_size)
+{
+    setup_cmd_result_t result = { .action = SETUP_ACTION_NONE, .out_len = 0 };
+    static uint8_t req[SETUP_BIN_BODY_MAX + 1];
+    static uint8_t rsp[SETUP_BIN_BODY_MAX];
+
+    if (!frame || !cfg || !out_buf || out_size < 2)
+        return result;
+
+    int req_len = setup_bin_cobs_decode(frame, len, req, SETUP_BIN_BODY_MAX);
+    uint8_t op  = (req_len >= 1) ? req[0] : 0;
+    uint8_t tag = (req_len >= 2) ? req[1] : 0;
+
+    body_t b = { .buf = rsp, .cap = sizeof(rsp) };
+    put_u8(&b, (uint8_t)(op | 0x80));
+    put_u8(&b, tag);
+    put_u8(&b, SETUP_BIN_OK);
+    const size_t hdr = b.len;
+
+    body_t payload = { .buf = rsp + hdr, .cap = sizeof(rsp) - hdr };
+    setup_bin_status_t status;
+
+    if (req_len < 2) {
+        status = SETUP_BIN_ERR_MALFORMED;
+    } else {
+        const uint8_t *p = req + 2;
+        size_t n = (size_t)req_len - 2;
+
+        switch (op) {
+        case SETUP_BIN_OP_GET:
+            status = op_get(p, n, cfg, &payload);
+            break;
+        case SETUP_BIN_OP_SET:
+            status = op_set(p, n, cfg, &payload, &result);
+            break;
+        case SETUP_BIN_OP_LIST:
+            status = op_list(cfg, &payload);
+            break;
+        case SETUP_BIN_OP_STATUS:
+            status = op_text("status", cfg, &payload, &result);
+            break;
+        case SETUP_BIN_OP_TEXT:
+            req[req_len] = '\0';
+            status = op_text((const char *)p, cfg, &payload, &result);
+            break;
+        default:
+            status = SETUP_BIN_ERR_OP;
+            break;
+        }
+    }
+
+    if (payload.overflow) {
+        status = SETUP_BIN_ERR_OVERFLOW;
+        payload.len = 0;
+    }
+    rsp[2] = (uint8_t)status;
+    size_t body_len = hdr + payload.len;
+
+    out_buf[0] = SETUP_BIN_MAGIC;
+    size_t enc = setup_bin_cobs_encode(rsp, body_len, out_buf + 1,
+                                       out_size - 2);
+    if (enc == 0) {
+        /* Caller's buffer too small: report overflow with no payload */
+        rsp[2] = SETUP_BIN_ERR_OVERFLOW;
+        enc = setup_bin_cobs_encode(rsp, hdr, out_buf + 1, out_size - 2);
+        result.action = SETUP_ACTION_NONE;
+        if (enc == 0)
+            return result;
+    }
+    out_buf[1 + enc] = 0x00;
+    result.out_len = (int)(1 + enc + 1);
+    return result;
+}
@@ -1,4 +1,6 @@
 #include "setup_cmd.h"
+#include "fw_stream.h"
+#include "metrics.h"
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -8,18 +10,12 @@
 /* ── Module state ───────────────────────────────────────────────────── */
 
 static const char *s_version = "0.0.0";
-static const char *s_status  = "";
 
 void setup_cmd_set_version(const char *version_str)
 {
     s_version = version_str ? version_str : "0.0.0";
 }
 
-void setup_cmd_set_status(const char *status_str)
-{
-    s_status = status_str ? status_str : "";
-}
-
 /* ── Helpers ────────────────────────────────────────────────────────── */
 
 /** Write formatted response, respecting buffer limits. */
@@ -50,113 +46,135 @@ static bool parse_u16(const char *s, uint16_t *out)
     return true;
 }
 
-/* ── Config key table ───────────────────────────────────────────────── */
-
-typedef enum {
-    KEY_WIFI_SSID,
-    KEY_WIFI_PASSWORD,
-    KEY_POWER_PULSE_MS,
-    KEY_BOOT_TIMEOUT_MS,
-    KEY_DEVICE_NAME,
-    KEY_COUNT,
-    KEY_UNKNOWN = -1,
-} config_key_t;
-
-static const char *key_names[KEY_COUNT] = {
-    [KEY_WIFI_SSID]       = "wifi_ssid",
-    [KEY_WIFI_PASSWORD]   = "wifi_password",
-    [KEY_POWER_PULSE_MS]  = "power_pulse_ms",
-    [KEY_BOOT_TIMEOUT_MS] = "boot_timeout_ms",
-    [KEY_DEVICE_NAME]     = "device_name",
-};
-
-static config_key_t find_key(const char *name)
+/** Parse a uint32 in the given base. Returns false on invalid input. */
+static bool parse_u32(const char *s, int base, uint32_t *out)
+{
+    char *end;
+    unsigned long long v = strtoull(s, &end, base);
+    if (end == s || *end != '\0' || *s == '-' || v > 0xFFFFFFFFull)
+        return false;
+    *out = (uint32_t)v;
+    return true;
+}
+
+/* ── Key access (shared with the binary protocol) ───────────────────── */
+
+/*
+ * Keys are the device_config schema fields: names, types, limits and
+ * secrecy all come from device_config_fields[], so new settings need no
+ * changes here.
+ */
+
+#define KEY_UNKNOWN (-1)
+
+#define X_VALUE_FITS(name, type, lo, hi, def, flags)                      \
+    _Static_assert(DEVICE_CONFIG_SIZE_##type(hi) <= SETUP_CMD_VALUE_MAX,  \
+                   #name " does not fit SETUP_CMD_VALUE_MAX");
+DEVICE_CONFIG_FIELDS(X_VALUE_FITS)
+
+int setup_cmd_key_count(void)
 {
-    for (int i = 0; i < KEY_COUNT; i++) {
-        if (strcmp(name, key_names[i]) == 0)
-            return (config_key_t)i;
+    return DEVICE_CONFIG_FIELD_COUNT;
+}
+
+const char *setup_cmd_key_name(int key)
+{
+    if (key < 0 || key >= DEVICE_CONFIG_FIELD_COUNT)
+        return NULL;
+    return device_config_fields[key].name;
+}
+
+int setup_cmd_find_key(const char *name)
+{
+    return device_config_find(name);
+}
+
+int setup_cmd_get_value(int key, const device_config_t *cfg,
+                        char *buf, size_t size)
+{
+    if (key < 0 || key >= DEVICE_CONFIG_FIELD_COUNT)
+        return -1;
+
+    const device_config_field_t *f = &device_config_fields[key];
+    const uint8_t *v = (const uint8_t *)cfg + f->offset;
+
+    if (f->flags & DEVICE_CONFIG_F_SECRET)
+        return out_printf(buf, size, "********");
+
+    if (f->type == DEVICE_CONFIG_TYPE_U16) {
+        uint16_t n;
+        memcpy(&n, v, sizeof(n));
+        return out_printf(buf, size, "%u", n);
     }
-    return KEY_UNKNOWN;
+    return out_printf(buf, size, "%s", (const char *)v);
+}
+
+bool setup_cmd_set_value(int key, const char *value, device_config_t *cfg,
+                         char *err, size_t err_size)
+{
+    if (key < 0 || key >= DEVICE_CONFIG_FIELD_COUNT) {
+        out_printf(err, err_size, "unknown key");
+        return false;
+    }
+
+    const device_config_field_t *f = &device_config_fields[key];
+    uint8_t *v = (uint8_t *)cfg + f->offset;
+
+    if (f->type == DEVICE_CONFIG_TYPE_U16) {
+        uint16_t n;
+        if (!parse_u16(value, &n)) {
+            out_printf(err, err_size, "invalid number");
+            return false;
+        }
+        if (n < f->lo || n > f->hi) {
+            out_printf(err, err_size, "out of range (%u-%u)", f->lo, f->hi);
+            return false;
+        }
+        memcpy(v, &n, sizeof(n));
+        return true;
+    }
+
+    size_t len = strlen(value);
+    if (len < f->lo) {
+        out_printf(err, err_size, "%s cannot be empty", f->name);
+        return false;
+    }
+    if (len > f->hi) {
+        out_printf(err, err_size, "value too long (max %u)", f->hi);
+        return false;
+    }
+    if ((f->flags & DEVICE_CONFIG_F_MAC) && len > 0 &&
+        !wol_parse_mac(value, NULL)) {
+        out_printf(err, err_size, "invalid MAC address");
+        return false;
+    }
+    if ((f->flags & DEVICE_CONFIG_F_BUTTON_MAP) &&
+        !button_map_parse(value, BUTTON_MAP_PAD_OTHER, NULL)) {
+        out_printf(err, err_size, "invalid button map");
+        return false;
+    }
+    memcpy(v, value, len + 1);
+    return true;
 }
 
 /* ── Get/Set handlers ───────────────────────────────────────────────── */
 
-static int cmd_get(config_key_t key, const device_config_t *cfg,
+static int cmd_get(int key, const device_config_t *cfg,
                    char *out, size_t size)
 {
-    switch (key) {
-    case KEY_WIFI_SSID:
-        return out_printf(out, size, "OK %s\n", cfg->wifi_ssid);
-    case KEY_WIFI_PASSWORD:
-        return out_printf(out, size, "OK ********\n");
-    case KEY_POWER_PULSE_MS:
-        return out_printf(out, size, "OK %u\n", cfg->power_pulse_ms);
-    case KEY_BOOT_TIMEOUT_MS:
-        return out_printf(out, size, "OK %u\n", cfg->boot_timeout_ms);
-    case KEY_DEVICE_NAME:
-        return out_printf(out, size, "OK %s\n", cfg->device_name);
-    default:
+    char value[SETUP_CMD_VALUE_MAX];
+    if (setup_cmd_get_value(key, cfg, value, sizeof(value)) < 0)
         return out_printf(out, size, "ERR unknown key\n");
-    }
+    return out_printf(out, size, "OK %s\n", value);
 }
 
-static int cmd_set(config_key_t key, const char *value,
+static int cmd_set(int key, const char *value,
                    device_config_t *cfg, char *out, size_t size)
 {
-    uint16_t u16val;
-
-    switch (key) {
-    case KEY_WIFI_SSID:
-        if (strlen(value) > DEVICE_CONFIG_WIFI_SSID_MAX)
-            return out_printf(out, size, "ERR value too long (max %d)\n",
-                              DEVICE_CONFIG_WIFI_SSID_MAX);
-        strncpy(cfg->wifi_ssid, value, DEVICE_CONFIG_WIFI_SSID_MAX);
-        cfg->wifi_ssid[DEVICE_CONFIG_WIFI_SSID_MAX] = '\0';
-        return out_printf(out, size, "OK\n");
-
-    case KEY_WIFI_PASSWORD:
-        if (strlen(value) > DEVICE_CONFIG_WIFI_PASSWORD_MAX)
-            return out_printf(out, size, "ERR value too long (max %d)\n",
-                              DEVICE_CONFIG_WIFI_PASSWORD_MAX);
-        strncpy(cfg->wifi_password, value, DEVICE_CONFIG_WIFI_PASSWORD_MAX);
-        cfg->wifi_password[DEVICE_CONFIG_WIFI_PASSWORD_MAX] = '\0';
-        return out_printf(out, size, "OK\n");
-
-    case KEY_POWER_PULSE_MS:
-        if (!parse_u16(value, &u16val))
-            return out_printf(out, size, "ERR invalid number\n");
-        if (u16val < DEVICE_CONFIG_POWER_PULSE_MIN ||
-            u16val > DEVICE_CONFIG_POWER_PULSE_MAX)
-            return out_printf(out, size, "ERR out of range (%d-%d)\n",
-                              DEVICE_CONFIG_POWER_PULSE_MIN,
-                              DEVICE_CONFIG_POWER_PULSE_MAX);
-        cfg->power_pulse_ms = u16val;
-        return out_printf(out, size, "OK\n");
-
-    case KEY_BOOT_TIMEOUT_MS:
-        if (!parse_u16(value, &u16val))
-            return out_printf(out, size, "ERR invalid number\n");
-        if (u16val < DEVICE_CONFIG_BOOT_TIMEOUT_MIN ||
-            u16val > DEVICE_CONFIG_BOOT_TIMEOUT_MAX)
-            return out_printf(out, size, "ERR out of range (%d-%d)\n",
-                              DEVICE_CONFIG_BOOT_TIMEOUT_MIN,
-                              DEVICE_CONFIG_BOOT_TIMEOUT_MAX);
-        cfg->boot_timeout_ms = u16val;
-        return out_printf(out, size, "OK\n");
-
-    case KEY_DEVICE_NAME:
-        if (strlen(value) == 0)
-            return out_printf(out, size, "ERR device name cannot be empty\n");
-        if (strlen(value) > DEVICE_CONFIG_DEVICE_NAME_MAX)
-            return out_printf(out, size, "ERR value too long (max %d)\n",
-                              DEVICE_CONFIG_DEVICE_NAME_MAX);
-        strncpy(cfg->device_name, value, DEVICE_CONFIG_DEVICE_NAME_MAX);
-        cfg->device_name[DEVICE_CONFIG_DEVICE_NAME_MAX] = '\0';
-        return out_printf(out, size, "OK\n");
-
-    default:
-        return out_printf(out, size, "ERR unknown key\n");
-    }
+    char err[64];
+    if (!setup_cmd_set_value(key, value, cfg, err, sizeof(err)))
+        return out_printf(out, size, "ERR %s\n", err);
+    return out_printf(out, size, "OK\n");
 }
 
 /* ── List command ───────────────────────────────────────────────────── */
@@ -164,31 +182,72 @@ static int cmd_set(config_key_t key, const char *value,
 static int cmd_list(const device_config_t *cfg, char *out, size_t size)
 {
     int total = 0;
-    int n;
+    char value[SETUP_CMD_VALUE_MAX];
 
-    n = out_printf(out + total, size - total,
-                   "OK wifi_ssid=%s\n", cfg->wifi_ssid);
-    total += n;
+    for (int i = 0; i < DEVICE_CONFIG_FIELD_COUNT; i++) {
+        setup_cmd_get_value(i, cfg, value, sizeof(value));
+        total += out_printf(out + total, size - total,
+                            "OK %s=%s\n", device_config_fields[i].name, value);
+    }
 
-    n = out_printf(out + total, size - total,
-                   "OK wifi_password=********\n");
-    total += n;
+    return total;
+}
 
-    n = out_printf(out + total, size - total,
-                   "OK power_pulse_ms=%u\n", cfg->power_pulse_ms);
-    total += n;
+/* ── Status / stats commands ────────────────────────────────────────── */
 
-    n = out_printf(out + total, size - total,
-                   "OK boot_timeout_ms=%u\n", cfg->boot_timeout_ms);
-    total += n;
+/** One line: the METRICS_F_STATUS metrics, evaluated now. */
+static int cmd_status(char *out, size_t size)
+{
+    int total = out_printf(out, size, "OK ");
+    total += metrics_format(METRICS_F_STATUS, " ", out + total, size - total);
+    total += out_printf(out + total, size - total, "\n");
+    return total;
+}
 
-    n = out_printf(out + total, size - total,
-                   "OK device_name=%s\n", cfg->device_name);
-    total += n;
+/** Every registered metric, one per line like "list". */
+static int cmd_stats(char *out, size_t size)
+{
+    int total = 0;
+    char value[SETUP_CMD_VALUE_MAX];
 
+    for (int i = 0; i < metrics_count(); i++) {
+        metrics_format_value(i, value, sizeof(value));
+        total += out_printf(out + total, size - total,
+                            "OK %s=%s\n", metrics_name(i), value);
+    }
+    if (total == 0)
+        total = out_printf(out, size, "OK\n");
     return total;
 }
 
+/* ── Firmware command ───────────────────────────────────────────────── */
+
+/** Largest image accepted; the flash writer re-checks the real partition. */
+#define FIRMWARE_SIZE_MAX (4u * 1024u * 1024u)
+
+static int cmd_firmware(char *arg, setup_cmd_result_t *result,
+                        char *out, size_t size)
+{
+    char *crc_str = arg ? strchr(arg, ' ') : NULL;
+    if (!crc_str)
+        return out_printf(out, size, "ERR usage: firmware <nbytes> <crc32>\n");
+    *crc_str++ = '\0';
+    while (*crc_str && isspace((unsigned char)*crc_str)) crc_str++;
+
+    uint32_t nbytes, crc;
+    if (!parse_u32(arg, 10, &nbytes) || nbytes == 0 ||
+        nbytes > FIRMWARE_SIZE_MAX)
+        return out_printf(out, size, "ERR invalid size\n");
+    if (!parse_u32(crc_str, 16, &crc))
+        return out_printf(out, size, "ERR invalid crc32\n");
+
+    result->action   = SETUP_ACTION_FIRMWARE;
+    result->fw_size  = nbytes;
+    result->fw_crc32 = crc;
+    return out_printf(out, size, "OK %d %d\n",
+                      FW_STREAM_WINDOW, FW_STREAM_CHUNK_MAX);
+}
+
 /* ── Main dispatch ──────────────────────────────────────────────────── */
 
 setup_cmd_result_t setup_cmd_process(const char *line,
@@ -235,7 +294,7 @@ setup_cmd_result_t setup_cmd_process(const char *line,
                                         "ERR usage: get <key>\n");
             return result;
         }
-        config_key_t key = find_key(arg);
+        int key = setup_cmd_find_key(arg);
         if (key == KEY_UNKNOWN) {
             result.out_len = out_printf(out_buf, out_size,
                                         "ERR unknown key: %s\n", arg);
@@ -260,7 +319,7 @@ setup_cmd_result_t setup_cmd_process(const char *line,
         char *value = val_sep + 1;
         while (*value && isspace((unsigned char)*value)) value++;
 
-        config_key_t key = find_key(arg);
+        int key = setup_cmd_find_key(arg);
         if (key == KEY_UNKNOWN) {
             result.out_len = out_printf(out_buf, out_size,
                                         "ERR unknown key: %s\n", arg);
@@ -283,12 +342,29 @@ setup_cmd_result_t setup_cmd_process(const char *line,
         result.out_len = out_printf(out_buf, out_size, "OK %s\n", s_version);
 
     } else if (strcmp(cmd, "status") == 0) {
-        result.out_len = out_printf(out_buf, out_size, "OK %s\n", s_status);
+        result.out_len = cmd_status(out_buf, out_size);
+
+    } else if (strcmp(cmd, "stats") == 0) {
+        result.out_len = cmd_stats(out_buf, out_size);
 
     } else if (strcmp(cmd, "reboot") == 0) {
         result.out_len = out_printf(out_buf, out_size, "OK\n");
         result.action = SETUP_ACTION_REBOOT;
 
+    } else if (strcmp(cmd, "firmware") == 0) {
+        result.out_len = cmd_firmware(arg, &result, out_buf, out_size);
+
+    } else if (strcmp(cmd, "log") == 0) {
+        if (!arg || strcmp(arg, "dump") != 0) {
+            result.out_len = out_printf(out_buf, out_size,
+                                        "ERR usage: log dump\n");
+            return result;
+        }
+        result.action = SETUP_ACTION_LOG_DUMP;
+
+    } else if (strcmp(cmd, "trace") == 0) {
+        result.action = SETUP_ACTION_TRACE_DUMP;
+
     } else {
         result.out_len = out_printf(out_buf, out_size,
                                     "ERR unknown command: %s\n", cmd);
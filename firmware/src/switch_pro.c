@@ -0,0 +1,317 @@
+#include "switch_pro.h"
+
+#include <string.h>
+
+/*
+ * Only the report layout matters to hosts that drive a Pro Controller
+ * (they parse the bytes themselves), so every report is one vendor-
+ * defined 63-byte block after its ID.
+ */
+const uint8_t switch_pro_report_descriptor[SWITCH_PRO_REPORT_DESCRIPTOR_LEN] = {
+    0x05, 0x01,        /* Usage Page (Generic Desktop) */
+    0x15, 0x00,        /* Logical Minimum (0) */
+    0x09, 0x04,        /* Usage (Joystick) */
+    0xA1, 0x01,        /* Collection (Application) */
+    0x06, 0x01, 0xFF,  /*   Usage Page (Vendor Defined 0xFF01) */
+    0x26, 0xFF, 0x00,  /*   Logical Maximum (255) */
+    0x75, 0x08,        /*   Report Size (8) */
+    0x95, 0x3F,        /*   Report Count (63) */
+
+    0x85, 0x30,        /*   Report ID (0x30) - full input */
+    0x09, 0x30,        /*   Usage (0x30) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+    0x85, 0x21,        /*   Report ID (0x21) - subcommand reply */
+    0x09, 0x21,        /*   Usage (0x21) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+    0x85, 0x81,        /*   Report ID (0x81) - USB command reply */
+    0x09, 0x81,        /*   Usage (0x81) */
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
+
+    0x85, 0x01,        /*   Report ID (0x01) - rumble + subcommand */
+    0x09, 0x01,        /*   Usage (0x01) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+    0x85, 0x10,        /*   Report ID (0x10) - rumble */
+    0x09, 0x10,        /*   Usage (0x10) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+    0x85, 0x80,        /*   Report ID (0x80) - USB command */
+    0x09, 0x80,        /*   Usage (0x80) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+    0x85, 0x82,        /*   Report ID (0x82) - USB pass-through */
+    0x09, 0x82,        /*   Usage (0x82) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+
+    0xC0,              /* End Collection */
+};
+
+/* Report offsets */
+#define SW_TIMER        1
+#define SW_BATTERY      2
+#define SW_BUTTONS      3
+#define SW_LSTICK       6
+#define SW_RSTICK       9
+#define SW_ACK          13
+#define SW_SUBCMD_ID    14
+#define SW_SUBCMD_DATA  15
+
+#define SW_BATTERY_USB  0x91    /* full, charging, USB powered */
+
+/* Output report 0x01: rumble at 2-9, subcommand at 10, arguments 11+ */
+#define SW_OUT_RUMBLE   2
+#define SW_OUT_SUBCMD   10
+#define SW_OUT_ARGS     11
+
+#define SW_OUT_SUBCMD_RUMBLE    0x01
+#define SW_OUT_RUMBLE_ONLY      0x10
+#define SW_OUT_USB_CMD          0x80
+
+#define SW_USB_STATUS           0x01
+
+#define SW_SUB_DEVICE_INFO      0x02
+#define SW_SUB_SPI_READ         0x10
+#define SW_SUB_PLAYER_LIGHTS    0x30
+
+#define SW_SPI_READ_MAX         0x1D
+
+/** A trigger counts as ZL/ZR past a quarter of its travel (of 1023). */
+#define SW_TRIGGER_PRESSED      256
+
+/* Locally administered, so it never collides with a real controller */
+static const uint8_t s_mac[6] = { 0x02, 0x50, 0x50, 0x00, 0x00, 0x01 };
+
+/* ── Input ───────────────────────────────────────────────────────────── */
+
+static inline uint16_t stick(int16_t v)
+{
+    return (uint16_t)(SWITCH_STICK_CENTER +
+                      (int32_t)v * SWITCH_STICK_RANGE / 32768);
+}
+
+/** Two 12-bit values in three bytes, X first. */
+static void put_stick(uint8_t *p, uint16_t x, uint16_t y)
+{
+    p[0] = (uint8_t)x;
+    p[1] = (uint8_t)((x >> 8) | (y << 4));
+    p[2] = (uint8_t)(y >> 4);
+}
+
+uint8_t switch_pro_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                uint8_t out[SWITCH_PRO_REPORT_LEN])
+{
+    /* Indexed by hat value: 0 = N clockwise, 8 = centred */
+    static const uint8_t dpad[16] = {
+        SWITCH_BTN_UP,
+        SWITCH_BTN_UP | SWITCH_BTN_RIGHT,
+        SWITCH_BTN_RIGHT,
+        SWITCH_BTN_DOWN | SWITCH_BTN_RIGHT,
+        SWITCH_BTN_DOWN,
+        SWITCH_BTN_DOWN | SWITCH_BTN_LEFT,
+        SWITCH_BTN_LEFT,
+        SWITCH_BTN_UP | SWITCH_BTN_LEFT,
+    };
+    uint16_t b = in->buttons;
+
+    memset(out, 0, SWITCH_PRO_REPORT_LEN);
+    out[0]          = SWITCH_PRO_INPUT_ID;
+    out[SW_TIMER]   = seq;
+    out[SW_BATTERY] = SW_BATTERY_USB;
+
+    out[SW_BUTTONS + 0] = (uint8_t)(
+        (b & GAMEPAD_BTN_X ? SWITCH_BTN_Y : 0) |
+        (b & GAMEPAD_BTN_Y ? SWITCH_BTN_X : 0) |
+        (b & GAMEPAD_BTN_A ? SWITCH_BTN_B : 0) |
+        (b & GAMEPAD_BTN_B ? SWITCH_BTN_A : 0) |
+        (b & GAMEPAD_BTN_R1 ? SWITCH_BTN_R : 0) |
+        (in->rt >= SW_TRIGGER_PRESSED ? SWITCH_BTN_ZR : 0));
+    out[SW_BUTTONS + 1] = (uint8_t)(
+        (b & GAMEPAD_BTN_SELECT ? SWITCH_BTN_MINUS : 0) |
+        (b & GAMEPAD_BTN_START  ? SWITCH_BTN_PLUS : 0) |
+        (b & GAMEPAD_BTN_R3     ? SWITCH_BTN_RSTICK : 0) |
+        (b & GAMEPAD_BTN_L3     ? SWITCH_BTN_LSTICK : 0) |
+        (b & GAMEPAD_BTN_GUIDE  ? SWITCH_BTN_HOME : 0) |
+        (b & GAMEPAD_BTN_MISC   ? SWITCH_BTN_CAPTURE : 0));
+    out[SW_BUTTONS + 2] = (uint8_t)(
+        dpad[in->dpad & 0x0F] |
+        (b & GAMEPAD_BTN_L1 ? SWITCH_BTN_L : 0) |
+        (in->lt >= SW_TRIGGER_PRESSED ? SWITCH_BTN_ZL : 0));
+
+    /* Our Y axes point down, Nintendo's up */
+    put_stick(&out[SW_LSTICK], stick(in->lx), stick((int16_t)~in->ly));
+    put_stick(&out[SW_RSTICK], stick(in->rx), stick((int16_t)~in->ry));
+    return SWITCH_PRO_REPORT_LEN;
+}
+
+/* ── Emulated SPI flash ──────────────────────────────────────────────── */
+
+/*
+ * Factory calibration matching stick(): centre 2048, 1536 either way.
+ * Left stick stores above-centre, centre, below-centre; right stick
+ * centre, below, above.  IMU: zero offsets, nominal sensitivities.
+ */
+static const uint8_t s_spi_imu_cal[24] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     /* accel origin      */
+    0x00, 0x40, 0x00, 0x40, 0x00, 0x40,     /* accel sensitivity */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00,     /* gyro origin       */
+    0x3B, 0x34, 0x3B, 0x34, 0x3B, 0x34,     /* gyro sensitivity  */
+};
+static const uint8_t s_spi_stick_cal[18] = {
+    0x00, 0x06, 0x60,  0x00, 0x08, 0x80,  0x00, 0x06, 0x60,   /* left  */
+    0x00, 0x08, 0x80,  0x00, 0x06, 0x60,  0x00, 0x06, 0x60,   /* right */
+};
+static const uint8_t s_spi_colors[12] = {
+    0x32, 0x32, 0x32,  0xFF, 0xFF, 0xFF,    /* body, buttons   */
+    0x32, 0x32, 0x32,  0x32, 0x32, 0x32,    /* left/right grip */
+};
+
+static const struct {
+    uint32_t       addr;
+    uint8_t        len;
+    const uint8_t *data;
+} s_spi[] = {
+    { 0x6020, sizeof(s_spi_imu_cal),   s_spi_imu_cal },
+    { 0x603D, sizeof(s_spi_stick_cal), s_spi_stick_cal },
+    { 0x6050, sizeof(s_spi_colors),    s_spi_colors },
+};
+
+void switch_pro_spi_read(uint32_t addr, uint8_t *buf, uint8_t len)
+{
+    memset(buf, 0xFF, len);
+    for (size_t i = 0; i < sizeof(s_spi) / sizeof(s_spi[0]); i++) {
+        for (uint8_t k = 0; k < len; k++) {
+            uint32_t a = addr + k;
+            if (a >= s_spi[i].addr && a < s_spi[i].addr + s_spi[i].len)
+                buf[k] = s_spi[i].data[a - s_spi[i].addr];
+        }
+    }
+}
+
+/* ── Host requests ───────────────────────────────────────────────────── */
+
+/**
+ * Rough strength of one HD rumble motor (4 bytes): the larger of its
+ * high-band (0..0x64 after the shift) and low-band (0x40..0x72)
+ * amplitudes, scaled to 0..255.  The encoding is logarithmic; the
+ * controllers PadProxy drives only take a level.
+ */
+static uint8_t rumble_level(const uint8_t m[4])
+{
+    int hf = (m[1] & 0xFE) >> 1;
+    int lf = ((m[3] & 0x7F) - 0x40) * 2;
+    int a  = hf > lf ? hf : lf;
+    if (a < 0)   a = 0;
+    if (a > 100) a = 100;
+    return (uint8_t)(a * 255 / 100);
+}
+
+static void rumble(const uint8_t *buf, gamepad_output_t *out)
+{
+    out->strong = rumble_level(&buf[SW_OUT_RUMBLE]);
+    out->weak   = rumble_level(&buf[SW_OUT_RUMBLE + 4]);
+}
+
+/** Subcommand reply: neutral input state, then ack, id and data. */
+static uint8_t subcmd_reply(uint8_t seq, uint8_t ack, uint8_t id,
+                            uint8_t reply[SWITCH_PRO_REPORT_LEN])
+{
+    memset(reply, 0, SWITCH_PRO_REPORT_LEN);
+    reply[0]          = SWITCH_PRO_REPLY_ID;
+    reply[SW_TIMER]   = seq;
+    reply[SW_BATTERY] = SW_BATTERY_USB;
+    put_stick(&reply[SW_LSTICK], SWITCH_STICK_CENTER, SWITCH_STICK_CENTER);
+    put_stick(&reply[SW_RSTICK], SWITCH_STICK_CENTER, SWITCH_STICK_CENTER);
+    reply[SW_ACK]       = ack;
+    reply[SW_SUBCMD_ID] = id;
+    return SWITCH_PRO_REPORT_LEN;
+}
+
+static uint8_t subcommand(const uint8_t *buf, uint16_t len, uint8_t seq,
+                          gamepad_output_t *out, bool *has_output,
+                          uint8_t reply[SWITCH_PRO_REPORT_LEN])
+{
+    uint8_t id = buf[SW_OUT_SUBCMD];
+    const uint8_t *arg = &buf[SW_OUT_ARGS];
+    uint8_t *data = &reply[SW_SUBCMD_DATA];
+
+    switch (id) {
+    case SW_SUB_DEVICE_INFO:
+        subcmd_reply(seq, 0x82, id, reply);
+        data[0] = 0x03;                 /* firmware 3.139 */
+        data[1] = 0x8B;
+        data[2] = 0x03;                 /* Pro Controller */
+        data[3] = 0x02;
+        memcpy(&data[4], s_mac, sizeof(s_mac));
+        data[10] = 0x01;
+        data[11] = 0x01;                /* colours from SPI */
+        break;
+
+    case SW_SUB_SPI_READ: {
+        if (len < SW_OUT_ARGS + 5)
+            return 0;
+        uint32_t addr = (uint32_t)arg[0] | (uint32_t)arg[1] << 8 |
+                        (uint32_t)arg[2] << 16 | (uint32_t)arg[3] << 24;
+        uint8_t n = arg[4] < SW_SPI_READ_MAX ? arg[4] : SW_SPI_READ_MAX;
+        subcmd_reply(seq, 0x90, id, reply);
+        memcpy(data, arg, 4);
+        data[4] = n;
+        switch_pro_spi_read(addr, &data[5], n);
+        break;
+    }
+
+    case SW_SUB_PLAYER_LIGHTS:
+        /* Low nibble lit, high nibble flashing: show both as lit */
+        if (len > SW_OUT_ARGS) {
+            out->leds   = (uint8_t)((arg[0] | arg[0] >> 4) & 0x0F);
+            *has_output = true;
+        }
+        subcmd_reply(seq, 0x80, id, reply);
+        break;
+
+    default:
+        /* Input mode, IMU and vibration enables...: acknowledge */
+        subcmd_reply(seq, 0x80, id, reply);
+        break;
+    }
+    return SWITCH_PRO_REPORT_LEN;
+}
+
+uint8_t switch_pro_from_host(const uint8_t *buf, uint16_t len, uint8_t seq,
+                             gamepad_output_t *out, bool *has_output,
+                             uint8_t reply[SWITCH_PRO_REPORT_LEN])
+{
+    *has_output = false;
+    if (len < 2)
+        return 0;
+
+    switch (buf[0]) {
+    case SW_OUT_USB_CMD:
+        /* Handshake, baud rate and the like: echo the command.  Only
+         * the status request carries data.  0x04/0x05 take no reply. */
+        if (buf[1] == 0x04 || buf[1] == 0x05)
+            return 0;
+        memset(reply, 0, SWITCH_PRO_REPORT_LEN);
+        reply[0] = SWITCH_PRO_USB_REPLY_ID;
+        reply[1] = buf[1];
+        if (buf[1] == SW_USB_STATUS) {
+            reply[3] = 0x03;            /* Pro Controller */
+            for (int i = 0; i < 6; i++)
+                reply[4 + i] = s_mac[5 - i];
+        }
+        return SWITCH_PRO_REPORT_LEN;
+
+    case SW_OUT_SUBCMD_RUMBLE:
+        if (len <= SW_OUT_SUBCMD)
+            return 0;
+        rumble(buf, out);
+        *has_output = true;
+        return subcommand(buf, len, seq, out, has_output, reply);
+
+    case SW_OUT_RUMBLE_ONLY:
+        if (len < SW_OUT_RUMBLE + 8)
+            return 0;
+        rumble(buf, out);
+        *has_output = true;
+        return 0;
+
+    default:
+        return 0;
+    }
+}
@@ -1,8 +1,11 @@
 /*
  * TinyUSB configuration for PadProxy on Raspberry Pi Pico 2 W.
  *
- * USB composite device: HID gamepad + CDC serial (setup interface).
- * The HID interface presents a gamepad to the host PC.
+ * USB composite device: HID gamepads + CDC serial (setup interface).
+ * Each HID interface presents one player's gamepad to the host PC; one
+ * more carries all players' motion sensor samples.  In XInput mode the
+ * player interfaces are vendor class instead, served by the application
+ * class driver in usb_hid_gamepad.c (not CFG_TUD_VENDOR).
  * The CDC interface provides a virtual serial port for device setup
  * via Chrome Web Serial or any terminal emulator.
  */
@@ -17,7 +20,7 @@
 #define CFG_TUSB_RHPORT0_MODE    OPT_MODE_DEVICE
 
 /* ── Device class enables ────────────────────────────────────────────── */
-#define CFG_TUD_HID     1
+#define CFG_TUD_HID     5   /* one per player (BT_GAMEPAD_MAX) + motion */
 #define CFG_TUD_CDC     1
 #define CFG_TUD_MSC     0
 #define CFG_TUD_MIDI    0
@@ -26,7 +29,9 @@
 /* ── Endpoint / buffer sizes ─────────────────────────────────────────── */
 #define CFG_TUD_ENDPOINT0_SIZE   64
 #define CFG_TUD_HID_EP_BUFSIZE   64
-#define CFG_TUD_CDC_RX_BUFSIZE   256
+/* RX is sized for firmware streaming: a full fw_stream frame (1 KB) can
+ * sit in the FIFO while the previous one is being written to flash. */
+#define CFG_TUD_CDC_RX_BUFSIZE   1024
 #define CFG_TUD_CDC_TX_BUFSIZE   256
 
 #endif /* TUSB_CONFIG_H */
@@ -1,37 +1,244 @@
 #include "usb_hid_gamepad.h"
 #include "usb_hid_report.h"
+#include "usb_personality.h"
+#include "bt_gamepad.h"
+#include "ds4_report.h"
+#include "switch_pro.h"
+#include "dlog.h"
 
-#include <stdio.h>
 #include <string.h>
+#include "pico/time.h"
 #include "tusb.h"
 #include "class/hid/hid_device.h"
+#include "device/usbd_pvt.h"
 
 /* ── State ───────────────────────────────────────────────────────────── */
 
 static usb_hid_state_cb_t s_state_cb;
+static usb_hid_ready_cb_t s_ready_cb;
+static usb_hid_output_cb_t s_output_cb;
 static usb_hid_state_t    s_state = USB_HID_NOT_MOUNTED;
+static bool               s_remote_wakeup_en;
+static usb_report_pipe_t  s_pipe[BT_GAMEPAD_MAX];
+static motion_mux_t       s_motion;
 
-/* ── USB Descriptors ─────────────────────────────────────────────────── */
+/* Active personality; changes only while detached from the bus */
+static uint16_t                 s_mode;
+static const usb_personality_t *s_pers;
+
+/* Last report each way, for the host's GET_REPORT requests */
+static usb_report_t s_last_input[BT_GAMEPAD_MAX];
+static uint8_t      s_last_output[BT_GAMEPAD_MAX][USB_REPORT_MAX];
+static uint8_t      s_last_output_len[BT_GAMEPAD_MAX];
+
+/* Output state as the host last set it; partial updates apply on top */
+static gamepad_output_t s_output_state[BT_GAMEPAD_MAX];
+
+/* Per-player report counter, for formats that carry one */
+static uint8_t s_seq[BT_GAMEPAD_MAX];
+
+/* Answer to the host's last request (Switch handshake), sent ahead of
+ * the next gamepad report.  One slot: the host waits for each reply. */
+static uint8_t s_reply[BT_GAMEPAD_MAX][USB_REPORT_MAX];
+static uint8_t s_reply_len[BT_GAMEPAD_MAX];
+
+/* HID instances 0 .. BT_GAMEPAD_MAX-1 are the players; then motion */
+#define HID_MOTION  BT_GAMEPAD_MAX
 
 /*
- * VID 0x1209 is the pid.codes shared VID for open-source hardware.
- * PID 0x0001 is a placeholder; register at https://pid.codes for production.
+ * Personality switch: wait for the setup reply to drain over CDC, detach,
+ * swap descriptors, and re-attach once the host has seen the unplug.
  */
-#define USB_VID   0x1209
-#define USB_PID   0x0001
+#define USB_MODE_SWITCH_DELAY_MS   150
+#define USB_MODE_DETACH_MS         100
+
+typedef enum {
+    MODE_SWITCH_IDLE,
+    MODE_SWITCH_PENDING,        /* waiting to detach   */
+    MODE_SWITCH_DETACHED,       /* waiting to attach   */
+} mode_switch_t;
+
+static mode_switch_t s_switch;
+static uint16_t      s_next_mode;
+static uint32_t      s_switch_at_ms;
+
+/* ── Transports ──────────────────────────────────────────────────────── */
+
+/*
+ * How a player's reports reach its IN endpoint: HID with or without a
+ * leading report ID, or XInput's vendor interface.  Picked with the
+ * personality, like its converters.
+ */
+typedef struct {
+    bool (*send)(uint8_t idx, const uint8_t *data, uint8_t len);
+} usb_transport_t;
+
+static bool hid_send(uint8_t idx, const uint8_t *data, uint8_t len)
+{
+    return tud_hid_n_report(idx, 0, data, len);
+}
+
+static bool hid_send_with_id(uint8_t idx, const uint8_t *data, uint8_t len)
+{
+    /* tud_hid_n_report() writes the ID itself */
+    return len > 0 && tud_hid_n_report(idx, data[0], data + 1, len - 1);
+}
+
+/* XInput: one vendor interface per player, IN and OUT interrupt */
+#define XINPUT_EP_SIZE  32
+
+typedef struct {
+    uint8_t ep_in;              /* 0 while not configured */
+    uint8_t ep_out;
+    CFG_TUSB_MEM_ALIGN uint8_t in_buf[USB_REPORT_MAX];
+    CFG_TUSB_MEM_ALIGN uint8_t out_buf[XINPUT_EP_SIZE];
+} xinput_itf_t;
+
+CFG_TUSB_MEM_SECTION static xinput_itf_t s_xinput[BT_GAMEPAD_MAX];
 
+static bool xinput_send(uint8_t idx, const uint8_t *data, uint8_t len)
+{
+    xinput_itf_t *x = &s_xinput[idx];
+    if (x->ep_in == 0 || !usbd_edpt_claim(0, x->ep_in))
+        return false;
+
+    memcpy(x->in_buf, data, len);
+    if (!usbd_edpt_xfer(0, x->ep_in, x->in_buf, len)) {
+        usbd_edpt_release(0, x->ep_in);
+        return false;
+    }
+    return true;
+}
+
+static const usb_transport_t s_tx_hid         = { hid_send };
+static const usb_transport_t s_tx_hid_with_id = { hid_send_with_id };
+static const usb_transport_t s_tx_xinput      = { xinput_send };
+
+static const usb_transport_t *s_tx;
+
+/* ── Report path ─────────────────────────────────────────────────────── */
+
+/** Submit the player's pending reply, else its waiting report, if its
+ *  endpoint is free. */
+static void pump(uint8_t idx)
+{
+    if (s_switch != MODE_SWITCH_IDLE)
+        return;
+
+    if (s_reply_len[idx]) {
+        if (s_tx->send(idx, s_reply[idx], s_reply_len[idx]))
+            s_reply_len[idx] = 0;
+        return;
+    }
+
+    usb_report_t report;
+    if (!usb_report_pipe_next(&s_pipe[idx], &report))
+        return;
+    if (s_tx->send(idx, report.data, report.len))
+        s_last_input[idx] = report;
+    else
+        usb_report_pipe_failed(&s_pipe[idx], &report);
+}
+
+/** The player's IN transfer finished: the waiting report goes out now,
+ *  not next loop. */
+static void complete(uint8_t idx)
+{
+    bool refused = usb_report_pipe_complete(&s_pipe[idx]);
+    pump(idx);
+    if (refused && s_ready_cb)
+        s_ready_cb(idx);
+}
+
+/** Send the next player's newest motion sample if the endpoint is free.
+ *  A rejected sample is dropped: a newer one follows within a frame. */
+static void pump_motion(void)
+{
+    uint8_t idx;
+    gamepad_motion_t sample;
+    usb_motion_report_t report;
+
+    if (!s_pers->motion || s_switch != MODE_SWITCH_IDLE ||
+        !tud_hid_n_ready(HID_MOTION) ||
+        !motion_mux_take(&s_motion, &idx, &sample))
+        return;
+    usb_hid_report_from_motion(&sample, &report);
+    tud_hid_n_report(HID_MOTION, (uint8_t)(idx + 1), &report, sizeof(report));
+}
+
+/** A report from the host, report ID first if the personality uses IDs. */
+static void host_report(uint8_t idx, const uint8_t *buf, uint16_t len)
+{
+    usb_host_result_t res;
+    res.has_output = false;
+    res.output     = s_output_state[idx];
+    res.reply_len  = 0;
+    s_pers->from_host(buf, len, s_seq[idx]++, &res);
+
+    uint8_t n = (uint8_t)(len < USB_REPORT_MAX ? len : USB_REPORT_MAX);
+    memcpy(s_last_output[idx], buf, n);
+    s_last_output_len[idx] = n;
+
+    if (res.reply_len) {
+        memcpy(s_reply[idx], res.reply, res.reply_len);
+        s_reply_len[idx] = res.reply_len;
+        pump(idx);
+    }
+    if (res.has_output) {
+        s_output_state[idx] = res.output;
+        if (s_output_cb)
+            s_output_cb(idx, &res.output);
+    }
+}
+
+static void reset_pipes(void)
+{
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        usb_report_pipe_reset(&s_pipe[i]);
+        s_reply_len[i] = 0;
+    }
+    motion_mux_reset(&s_motion);
+}
+
+/* ── USB Descriptors ─────────────────────────────────────────────────── */
+
+_Static_assert(CFG_TUD_HID == BT_GAMEPAD_MAX + 1,
+               "one HID interface per Bluetooth gamepad slot, plus motion");
+_Static_assert(USB_HID_PERIODIC_BYTES(BT_GAMEPAD_MAX) <=
+                   USB_FS_PERIODIC_FRAME_BYTES,
+               "every HID endpoint must fit in each 1 ms frame");
+_Static_assert(2 * BT_GAMEPAD_MAX *
+                   (USB_REPORT_MAX + USB_FS_INTERRUPT_OVERHEAD) <=
+                   USB_FS_PERIODIC_FRAME_BYTES,
+               "every player's IN and OUT endpoint must fit in each frame");
+
+/*
+ * One interface (and interrupt IN endpoint) per player, so the host sees
+ * BT_GAMEPAD_MAX independent gamepads and each polls its own 1 ms
+ * endpoint.  The configuration is fixed: unconnected players are present
+ * but idle.  Player interface n is player n + 1.
+ *
+ * In HID mode motion samples go out on one more HID interface with its
+ * own endpoint, shared by all players (report ID = player).  It comes
+ * after CDC so the other interface numbers stay put in every mode.
+ */
 enum {
-    ITF_NUM_HID,
+    ITF_NUM_PLAYER0,
+    ITF_NUM_PLAYER1,
+    ITF_NUM_PLAYER2,
+    ITF_NUM_PLAYER3,
     ITF_NUM_CDC,
     ITF_NUM_CDC_DATA,
+    ITF_NUM_MOTION,
     ITF_NUM_TOTAL,
 };
 
 /*
  * Composite device: use the Interface Association Descriptor (IAD) class
- * codes so the OS groups the CDC interfaces correctly.
+ * codes so the OS groups the CDC interfaces correctly.  VID, PID and
+ * bcdDevice come from the personality.
  */
-static const tusb_desc_device_t desc_device = {
+static tusb_desc_device_t s_desc_device = {
     .bLength            = sizeof(tusb_desc_device_t),
     .bDescriptorType    = TUSB_DESC_DEVICE,
     .bcdUSB             = 0x0200,
@@ -39,52 +246,204 @@ static const tusb_desc_device_t desc_device = {
     .bDeviceSubClass    = MISC_SUBCLASS_COMMON,
     .bDeviceProtocol    = MISC_PROTOCOL_IAD,
     .bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
-    .idVendor           = USB_VID,
-    .idProduct          = USB_PID,
-    .bcdDevice          = 0x0100,
     .iManufacturer      = 1,
     .iProduct           = 2,
     .iSerialNumber      = 3,
     .bNumConfigurations = 1,
 };
 
-#define EPNUM_HID         0x81
-#define EPNUM_CDC_NOTIF   0x82
-#define EPNUM_CDC_OUT     0x03
-#define EPNUM_CDC_IN      0x83
+#define EPNUM_HID(n)      (0x81 + (n))
+#define EPNUM_OUT(n)      (0x01 + (n))
+#define EPNUM_CDC_NOTIF   0x85
+#define EPNUM_CDC_OUT     0x06
+#define EPNUM_CDC_IN      0x86
+#define EPNUM_MOTION      0x87
 
-#define CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_HID_DESC_LEN + \
-                           TUD_CDC_DESC_LEN)
+#define CDC_FUNCTION \
+    TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, 4, EPNUM_CDC_NOTIF, 8, \
+                       EPNUM_CDC_OUT, EPNUM_CDC_IN, 64)
 
-static const uint8_t desc_configuration[] = {
-    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN,
+/* Generic HID: IN only, rumble and LEDs over SET_REPORT */
+#define CONFIG_HID_LEN  (TUD_CONFIG_DESC_LEN + \
+                         CFG_TUD_HID * TUD_HID_DESC_LEN + TUD_CDC_DESC_LEN)
+
+#define HID_PLAYER(n) \
+    TUD_HID_DESCRIPTOR(ITF_NUM_PLAYER0 + (n), 5 + (n), HID_ITF_PROTOCOL_NONE, \
+                       USB_HID_REPORT_DESCRIPTOR_LEN, EPNUM_HID(n), \
+                       CFG_TUD_HID_EP_BUFSIZE, 1)
+
+static const uint8_t desc_config_hid[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_HID_LEN,
                           TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
-    TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_NONE,
-                       USB_HID_REPORT_DESCRIPTOR_LEN, EPNUM_HID,
+    HID_PLAYER(0),
+    HID_PLAYER(1),
+    HID_PLAYER(2),
+    HID_PLAYER(3),
+    CDC_FUNCTION,
+    TUD_HID_DESCRIPTOR(ITF_NUM_MOTION, 9, HID_ITF_PROTOCOL_NONE,
+                       USB_HID_MOTION_DESCRIPTOR_LEN, EPNUM_MOTION,
                        CFG_TUD_HID_EP_BUFSIZE, 1),
-    TUD_CDC_DESCRIPTOR(ITF_NUM_CDC, 4, EPNUM_CDC_NOTIF, 8,
-                       EPNUM_CDC_OUT, EPNUM_CDC_IN, 64),
+};
+
+/* DualShock 4 and Switch Pro: HID with an interrupt OUT endpoint, which
+ * both consoles' drivers write their output reports to */
+#define CONFIG_INOUT_LEN  (TUD_CONFIG_DESC_LEN + \
+                           BT_GAMEPAD_MAX * TUD_HID_INOUT_DESC_LEN + \
+                           TUD_CDC_DESC_LEN)
+
+#define HID_INOUT_PLAYER(n, desc_len) \
+    TUD_HID_INOUT_DESCRIPTOR(ITF_NUM_PLAYER0 + (n), 5 + (n), \
+                             HID_ITF_PROTOCOL_NONE, desc_len, EPNUM_OUT(n), \
+                             EPNUM_HID(n), CFG_TUD_HID_EP_BUFSIZE, 1)
+
+static const uint8_t desc_config_ds4[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_MOTION, 0, CONFIG_INOUT_LEN,
+                          TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+    HID_INOUT_PLAYER(0, DS4_REPORT_DESCRIPTOR_LEN),
+    HID_INOUT_PLAYER(1, DS4_REPORT_DESCRIPTOR_LEN),
+    HID_INOUT_PLAYER(2, DS4_REPORT_DESCRIPTOR_LEN),
+    HID_INOUT_PLAYER(3, DS4_REPORT_DESCRIPTOR_LEN),
+    CDC_FUNCTION,
+};
+
+static const uint8_t desc_config_switch[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_MOTION, 0, CONFIG_INOUT_LEN,
+                          TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+    HID_INOUT_PLAYER(0, SWITCH_PRO_REPORT_DESCRIPTOR_LEN),
+    HID_INOUT_PLAYER(1, SWITCH_PRO_REPORT_DESCRIPTOR_LEN),
+    HID_INOUT_PLAYER(2, SWITCH_PRO_REPORT_DESCRIPTOR_LEN),
+    HID_INOUT_PLAYER(3, SWITCH_PRO_REPORT_DESCRIPTOR_LEN),
+    CDC_FUNCTION,
+};
+
+/*
+ * XInput: the wired Xbox 360 controller's vendor interface (class 0xFF,
+ * subclass 0x5D, protocol 0x01) and the undocumented 0x21 descriptor
+ * the Windows driver expects after it, naming the two endpoints.
+ */
+#define XINPUT_SUBCLASS   0x5D
+#define XINPUT_PROTOCOL   0x01
+#define XINPUT_DESC_LEN   (9 + 17 + 7 + 7)
+
+#define XINPUT_PLAYER(n) \
+    9, TUSB_DESC_INTERFACE, ITF_NUM_PLAYER0 + (n), 0, 2, \
+    TUSB_CLASS_VENDOR_SPECIFIC, XINPUT_SUBCLASS, XINPUT_PROTOCOL, 5 + (n), \
+    17, 0x21, 0x00, 0x01, 0x01, 0x25, EPNUM_HID(n), 0x14, 0x00, 0x00, \
+    0x00, 0x00, 0x13, EPNUM_OUT(n), 0x08, 0x00, 0x00, \
+    7, TUSB_DESC_ENDPOINT, EPNUM_HID(n), TUSB_XFER_INTERRUPT, \
+    U16_TO_U8S_LE(XINPUT_EP_SIZE), 1, \
+    7, TUSB_DESC_ENDPOINT, EPNUM_OUT(n), TUSB_XFER_INTERRUPT, \
+    U16_TO_U8S_LE(XINPUT_EP_SIZE), 8
+
+#define CONFIG_XINPUT_LEN  (TUD_CONFIG_DESC_LEN + \
+                            BT_GAMEPAD_MAX * XINPUT_DESC_LEN + TUD_CDC_DESC_LEN)
+
+static const uint8_t desc_config_xinput[] = {
+    TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_MOTION, 0, CONFIG_XINPUT_LEN,
+                          TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
+    XINPUT_PLAYER(0),
+    XINPUT_PLAYER(1),
+    XINPUT_PLAYER(2),
+    XINPUT_PLAYER(3),
+    CDC_FUNCTION,
+};
+
+_Static_assert(sizeof(desc_config_hid) == CONFIG_HID_LEN &&
+               sizeof(desc_config_ds4) == CONFIG_INOUT_LEN &&
+               sizeof(desc_config_switch) == CONFIG_INOUT_LEN &&
+               sizeof(desc_config_xinput) == CONFIG_XINPUT_LEN,
+               "configuration descriptor lengths");
+
+static const uint8_t *const s_desc_configs[USB_MODE_COUNT] = {
+    [USB_MODE_HID]    = desc_config_hid,
+    [USB_MODE_XINPUT] = desc_config_xinput,
+    [USB_MODE_DS4]    = desc_config_ds4,
+    [USB_MODE_SWITCH] = desc_config_switch,
 };
 
 static const char *desc_strings[] = {
     [0] = "",                   /* Language (handled by TinyUSB) */
-    [1] = "PadProxy",          /* Manufacturer */
-    [2] = "PadProxy Gamepad",  /* Product */
+    [1] = "",                   /* Manufacturer (personality) */
+    [2] = "",                   /* Product (personality) */
     [3] = "000001",            /* Serial */
     [4] = "PadProxy Setup",    /* CDC interface name */
+    [5] = "PadProxy Player 1", /* Player interface names */
+    [6] = "PadProxy Player 2",
+    [7] = "PadProxy Player 3",
+    [8] = "PadProxy Player 4",
+    [9] = "PadProxy Motion",   /* Motion interface name */
 };
 
+/* ── Personality ─────────────────────────────────────────────────────── */
+
+/** Bind descriptors, transport and converters.  Only while detached. */
+static void apply_mode(uint16_t mode)
+{
+    if (mode >= USB_MODE_COUNT)
+        mode = USB_MODE_HID;
+    s_mode = mode;
+    s_pers = usb_personality_get(mode);
+    s_tx   = s_pers->report_desc == NULL ? &s_tx_xinput
+           : s_pers->report_ids          ? &s_tx_hid_with_id
+           :                               &s_tx_hid;
+
+    s_desc_device.idVendor  = s_pers->vid;
+    s_desc_device.idProduct = s_pers->pid;
+    s_desc_device.bcdDevice = s_pers->bcd_device;
+    desc_strings[1] = s_pers->manufacturer;
+    desc_strings[2] = s_pers->product;
+
+    /* GET_REPORT before the first report gets an idle one */
+    gamepad_report_t idle;
+    memset(&idle, 0, sizeof(idle));
+    idle.dpad = GAMEPAD_DPAD_CENTERED;
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        s_seq[i] = 0;
+        s_last_input[i].buttons = 0;
+        s_last_input[i].dpad    = GAMEPAD_DPAD_CENTERED;
+        s_last_input[i].len     = s_pers->from_gamepad(&idle, 0,
+                                                       s_last_input[i].data);
+        s_last_output_len[i] = 0;
+        memset(&s_output_state[i], 0, sizeof(s_output_state[i]));
+    }
+    reset_pipes();
+}
+
+static uint32_t now_ms(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+/** Advance a pending personality switch. */
+static void mode_switch_task(void)
+{
+    if (s_switch == MODE_SWITCH_IDLE ||
+        (int32_t)(now_ms() - s_switch_at_ms) < 0)
+        return;
+
+    if (s_switch == MODE_SWITCH_PENDING) {
+        tud_disconnect();
+        apply_mode(s_next_mode);
+        s_switch       = MODE_SWITCH_DETACHED;
+        s_switch_at_ms = now_ms() + USB_MODE_DETACH_MS;
+    } else {
+        tud_connect();
+        s_switch = MODE_SWITCH_IDLE;
+        DLOG_INFO("[usb_hid] Re-attached as %s", s_pers->name);
+    }
+}
+
 /* ── TinyUSB descriptor callbacks ────────────────────────────────────── */
 
 uint8_t const *tud_descriptor_device_cb(void)
 {
-    return (uint8_t const *)&desc_device;
+    return (uint8_t const *)&s_desc_device;
 }
 
 uint8_t const *tud_descriptor_configuration_cb(uint8_t index)
 {
     (void)index;
-    return desc_configuration;
+    return s_desc_configs[s_mode];
 }
 
 uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid)
@@ -121,8 +480,9 @@ uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid)
 
 uint8_t const *tud_hid_descriptor_report_cb(uint8_t instance)
 {
-    (void)instance;
-    return usb_hid_report_descriptor;
+    if (instance == HID_MOTION)
+        return usb_hid_motion_descriptor;
+    return s_pers->report_desc;
 }
 
 /* ── TinyUSB HID callbacks ───────────────────────────────────────────── */
@@ -131,30 +491,160 @@ uint16_t tud_hid_get_report_cb(uint8_t instance, uint8_t report_id,
                                 hid_report_type_t report_type,
                                 uint8_t *buffer, uint16_t reqlen)
 {
-    (void)instance;
-    (void)report_id;
-    (void)report_type;
-    (void)buffer;
-    (void)reqlen;
-    return 0;
+    if (instance >= BT_GAMEPAD_MAX)
+        return 0;
+
+    if (report_type == HID_REPORT_TYPE_FEATURE)
+        return s_pers->feature ? s_pers->feature(report_id, buffer, reqlen)
+                               : 0;   /* no feature reports: STALL */
+
+    const uint8_t *src;
+    uint16_t len;
+    if (report_type == HID_REPORT_TYPE_INPUT) {
+        src = s_last_input[instance].data;
+        len = s_last_input[instance].len;
+    } else if (report_type == HID_REPORT_TYPE_OUTPUT) {
+        src = s_last_output[instance];
+        len = s_last_output_len[instance];
+    } else {
+        return 0;
+    }
+
+    /* TinyUSB has already written the report ID */
+    if (s_pers->report_ids && len > 0) {
+        src++;
+        len--;
+    }
+    if (len > reqlen)
+        len = reqlen;
+    memcpy(buffer, src, len);
+    return len;
+}
+
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report,
+                                uint16_t len)
+{
+    (void)report;
+    (void)len;
+    if (instance == HID_MOTION) {
+        pump_motion();
+        return;
+    }
+    if (instance < BT_GAMEPAD_MAX)
+        complete(instance);
 }
 
 void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id,
                             hid_report_type_t report_type,
                             uint8_t const *buffer, uint16_t bufsize)
 {
-    (void)instance;
-    (void)report_id;
-    (void)report_type;
-    (void)buffer;
-    (void)bufsize;
+    /* Reports on the OUT endpoint arrive as report ID 0 with the ID still
+     * in the buffer, typed OUTPUT or INVALID depending on TinyUSB version */
+    if (instance >= BT_GAMEPAD_MAX ||
+        (report_type != HID_REPORT_TYPE_OUTPUT &&
+         report_type != HID_REPORT_TYPE_INVALID))
+        return;
+
+    if (s_pers->report_ids && report_id != 0) {
+        /* SET_REPORT over control: TinyUSB stripped the ID, put it back */
+        uint8_t buf[USB_REPORT_MAX];
+        uint16_t n = bufsize < USB_REPORT_MAX - 1 ? bufsize
+                                                  : USB_REPORT_MAX - 1;
+        buf[0] = report_id;
+        memcpy(buf + 1, buffer, n);
+        host_report(instance, buf, (uint16_t)(n + 1));
+        return;
+    }
+    host_report(instance, buffer, bufsize);
+}
+
+/* ── XInput class driver ─────────────────────────────────────────────── */
+
+static void xinput_init(void)
+{
+    memset(s_xinput, 0, sizeof(s_xinput));
+}
+
+static void xinput_reset(uint8_t rhport)
+{
+    (void)rhport;
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        s_xinput[i].ep_in = s_xinput[i].ep_out = 0;
+}
+
+static uint16_t xinput_open(uint8_t rhport, tusb_desc_interface_t const *itf,
+                            uint16_t max_len)
+{
+    if (itf->bInterfaceClass != TUSB_CLASS_VENDOR_SPECIFIC ||
+        itf->bInterfaceSubClass != XINPUT_SUBCLASS ||
+        itf->bInterfaceProtocol != XINPUT_PROTOCOL ||
+        itf->bInterfaceNumber >= ITF_NUM_PLAYER0 + BT_GAMEPAD_MAX ||
+        max_len < XINPUT_DESC_LEN)
+        return 0;
+
+    xinput_itf_t *x = &s_xinput[itf->bInterfaceNumber - ITF_NUM_PLAYER0];
+    uint8_t const *ep_desc = tu_desc_next(tu_desc_next(itf));
+    TU_ASSERT(usbd_open_edpt_pair(rhport, ep_desc, 2, TUSB_XFER_INTERRUPT,
+                                  &x->ep_out, &x->ep_in), 0);
+    TU_ASSERT(usbd_edpt_xfer(rhport, x->ep_out, x->out_buf,
+                             sizeof(x->out_buf)), 0);
+    return XINPUT_DESC_LEN;
+}
+
+static bool xinput_control_xfer(uint8_t rhport, uint8_t stage,
+                                tusb_control_request_t const *request)
+{
+    /* The 360 controller's vendor requests (serial, security handshake)
+     * are optional for the Windows driver: STALL them */
+    (void)rhport;
+    (void)stage;
+    (void)request;
+    return false;
+}
+
+static bool xinput_xfer(uint8_t rhport, uint8_t ep_addr, xfer_result_t result,
+                        uint32_t xferred_bytes)
+{
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        xinput_itf_t *x = &s_xinput[i];
+        if (ep_addr == x->ep_in) {
+            complete(i);
+            return true;
+        }
+        if (ep_addr == x->ep_out) {
+            if (result == XFER_RESULT_SUCCESS)
+                host_report(i, x->out_buf, (uint16_t)xferred_bytes);
+            TU_ASSERT(usbd_edpt_xfer(rhport, x->ep_out, x->out_buf,
+                                     sizeof(x->out_buf)));
+            return true;
+        }
+    }
+    return false;
+}
+
+static const usbd_class_driver_t s_xinput_driver = {
+    .init            = xinput_init,
+    .reset           = xinput_reset,
+    .open            = xinput_open,
+    .control_xfer_cb = xinput_control_xfer,
+    .xfer_cb         = xinput_xfer,
+    .sof             = NULL,
+};
+
+/* Offered every interface before the built-in drivers; claims only the
+ * XInput ones, so it can stay registered in every mode */
+usbd_class_driver_t const *usbd_app_driver_get_cb(uint8_t *driver_count)
+{
+    *driver_count = 1;
+    return &s_xinput_driver;
 }
 
 /* ── TinyUSB device callbacks ────────────────────────────────────────── */
 
 void tud_mount_cb(void)
 {
-    printf("[usb_hid] USB mounted\n");
+    DLOG_INFO("[usb_hid] USB mounted as %s", s_pers->name);
+    reset_pipes();
     s_state = USB_HID_MOUNTED;
     if (s_state_cb) {
         s_state_cb(USB_HID_MOUNTED);
@@ -163,7 +653,8 @@ void tud_mount_cb(void)
 
 void tud_umount_cb(void)
 {
-    printf("[usb_hid] USB unmounted\n");
+    DLOG_INFO("[usb_hid] USB unmounted");
+    reset_pipes();
     s_state = USB_HID_NOT_MOUNTED;
     if (s_state_cb) {
         s_state_cb(USB_HID_NOT_MOUNTED);
@@ -172,9 +663,10 @@ void tud_umount_cb(void)
 
 void tud_suspend_cb(bool remote_wakeup_en)
 {
-    (void)remote_wakeup_en;
-    printf("[usb_hid] USB suspended\n");
+    DLOG_INFO("[usb_hid] USB suspended (remote wakeup %s)",
+              remote_wakeup_en ? "armed" : "off");
     s_state = USB_HID_SUSPENDED;
+    s_remote_wakeup_en = remote_wakeup_en;
     if (s_state_cb) {
         s_state_cb(USB_HID_SUSPENDED);
     }
@@ -182,7 +674,7 @@ void tud_suspend_cb(bool remote_wakeup_en)
 
 void tud_resume_cb(void)
 {
-    printf("[usb_hid] USB resumed\n");
+    DLOG_INFO("[usb_hid] USB resumed");
     s_state = USB_HID_MOUNTED;
     if (s_state_cb) {
         s_state_cb(USB_HID_MOUNTED);
@@ -191,32 +683,138 @@ void tud_resume_cb(void)
 
 /* ── Public API ──────────────────────────────────────────────────────── */
 
-void usb_hid_gamepad_init(usb_hid_state_cb_t state_cb)
+void usb_hid_gamepad_init(usb_hid_state_cb_t state_cb, uint16_t mode)
 {
     s_state_cb = state_cb;
     s_state = USB_HID_NOT_MOUNTED;
+    s_switch = MODE_SWITCH_IDLE;
+    apply_mode(mode);
 
     tusb_init();
-    printf("[usb_hid] USB HID gamepad initialized\n");
+    DLOG_INFO("[usb_hid] USB gamepad initialized as %s", s_pers->name);
 }
 
 void usb_hid_gamepad_task(void)
 {
+    mode_switch_task();
     tud_task();
+
+    /* Retry submissions the stack rejected */
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        pump(i);
+    pump_motion();
 }
 
-bool usb_hid_gamepad_send_report(const gamepad_report_t *report)
+void usb_hid_gamepad_set_mode(uint16_t mode)
 {
-    if (!tud_mounted() || !tud_hid_ready())
+    if (mode >= USB_MODE_COUNT)
+        mode = USB_MODE_HID;
+    uint16_t target = s_switch == MODE_SWITCH_PENDING ? s_next_mode : s_mode;
+    if (mode == target)
+        return;
+
+    DLOG_INFO("[usb_hid] USB mode %s -> %s, re-enumerating",
+              s_pers->name, usb_personality_get(mode)->name);
+    s_next_mode = mode;
+    if (s_switch == MODE_SWITCH_IDLE) {
+        s_switch       = MODE_SWITCH_PENDING;
+        s_switch_at_ms = now_ms() + USB_MODE_SWITCH_DELAY_MS;
+    } else if (s_switch == MODE_SWITCH_DETACHED) {
+        /* Still off the bus: rebind now, the attach timer stands */
+        apply_mode(mode);
+    }
+}
+
+const char *usb_hid_gamepad_mode_name(void)
+{
+    return s_pers->name;
+}
+
+void usb_hid_gamepad_set_ready_cb(usb_hid_ready_cb_t ready_cb)
+{
+    s_ready_cb = ready_cb;
+}
+
+void usb_hid_gamepad_set_output_cb(usb_hid_output_cb_t output_cb)
+{
+    s_output_cb = output_cb;
+}
+
+const usb_report_pipe_t *usb_hid_gamepad_pipe(uint8_t idx)
+{
+    return &s_pipe[idx < BT_GAMEPAD_MAX ? idx : 0];
+}
+
+const motion_mux_t *usb_hid_gamepad_motion(void)
+{
+    return &s_motion;
+}
+
+bool usb_hid_gamepad_send_motion(uint8_t idx, const gamepad_motion_t *motion)
+{
+    if (idx >= BT_GAMEPAD_MAX || !s_pers->motion || !tud_mounted())
         return false;
 
-    usb_gamepad_report_t usb_report;
-    usb_hid_report_from_gamepad(report, &usb_report);
+    motion_mux_push(&s_motion, idx, motion);
+    pump_motion();
+    return true;
+}
 
-    return tud_hid_report(0, &usb_report, sizeof(usb_report));
+/** Queue a converted report and submit it if the endpoint is free. */
+static bool submit(uint8_t idx, usb_report_t *r, const gamepad_report_t *report)
+{
+    r->buttons = report->buttons;
+    r->dpad    = report->dpad;
+    if (r->len == 0)
+        r->len = s_pers->from_gamepad(report, s_seq[idx]++, r->data);
+
+    if (!usb_report_pipe_push(&s_pipe[idx], r))
+        return false;
+    pump(idx);
+    return true;
+}
+
+bool usb_hid_gamepad_send_report(uint8_t idx, const gamepad_report_t *report)
+{
+    if (idx >= BT_GAMEPAD_MAX || s_switch != MODE_SWITCH_IDLE ||
+        !tud_mounted())
+        return false;
+
+    usb_report_t r;
+    r.len = 0;
+    return submit(idx, &r, report);
+}
+
+bool usb_hid_gamepad_send_raw(uint8_t idx, const gamepad_report_t *report,
+                              const bt_gamepad_raw_t *raw)
+{
+    if (idx >= BT_GAMEPAD_MAX || s_switch != MODE_SWITCH_IDLE ||
+        !tud_mounted())
+        return false;
+
+    usb_report_t r;
+    r.len = s_pers->from_raw ? s_pers->from_raw(raw, r.data) : 0;
+    return submit(idx, &r, report);
+}
+
+bool usb_hid_gamepad_takes_raw(bt_gamepad_raw_kind_t kind)
+{
+    return kind != BT_GAMEPAD_RAW_NONE && kind == s_pers->raw_kind;
 }
 
 usb_hid_state_t usb_hid_gamepad_get_state(void)
 {
     return s_state;
 }
+
+bool usb_hid_gamepad_remote_wakeup_armed(void)
+{
+    return s_state == USB_HID_SUSPENDED && s_remote_wakeup_en;
+}
+
+bool usb_hid_gamepad_remote_wakeup(void)
+{
+    if (!usb_hid_gamepad_remote_wakeup_armed())
+        return false;
+    return tud_remote_wakeup();
+}
@@ -9,6 +9,7 @@
  *   - 2 analog triggers (Z/Rz), 8-bit unsigned
  *   - 1 hat switch (d-pad), 4-bit
  *   - 16 buttons
+ *   - Output: 2 rumble motors (vendor usages), 8-bit; Player 1-4 LEDs
  *
  * This descriptor is designed for broad OS compatibility (Windows DirectInput,
  * Linux evdev, macOS IOKit) without requiring custom drivers.
@@ -70,6 +71,66 @@ const uint8_t usb_hid_report_descriptor[USB_HID_REPORT_DESCRIPTOR_LEN] = {
     0x95, 0x10,        /*   Report Count (16) */
     0x81, 0x02,        /*   Input (Data, Variable, Absolute) */
 
+    /* ── Output: rumble motors ──────────────────────────── */
+    0x06, 0x00, 0xFF,  /*   Usage Page (Vendor Defined 0xFF00) */
+    0x09, 0x01,        /*   Usage (0x01) - strong motor */
+    0x09, 0x02,        /*   Usage (0x02) - weak motor */
+    0x15, 0x00,        /*   Logical Minimum (0) */
+    0x26, 0xFF, 0x00,  /*   Logical Maximum (255) */
+    0x75, 0x08,        /*   Report Size (8) */
+    0x95, 0x02,        /*   Report Count (2) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+
+    /* ── Output: player LEDs ────────────────────────────── */
+    0x05, 0x08,        /*   Usage Page (LED) */
+    0x19, 0x61,        /*   Usage Minimum (Player 1) */
+    0x29, 0x64,        /*   Usage Maximum (Player 4) */
+    0x25, 0x01,        /*   Logical Maximum (1) */
+    0x75, 0x01,        /*   Report Size (1) */
+    0x95, 0x04,        /*   Report Count (4) */
+    0x91, 0x02,        /*   Output (Data, Variable, Absolute) */
+
+    /* ── LED padding ────────────────────────────────────── */
+    0x75, 0x04,        /*   Report Size (4) */
+    0x95, 0x01,        /*   Report Count (1) */
+    0x91, 0x01,        /*   Output (Constant) */
+
+    0xC0,              /* End Collection */
+};
+
+/*
+ * Motion interface: a vendor-defined collection with one report per
+ * player, told apart by report ID (player number).  Gyro and accel are
+ * raw 16-bit counts; the timestamp is a wrapping 32-bit microsecond
+ * counter, declared signed because HID logical ranges are.
+ */
+#define MOTION_REPORT(id)                                                  \
+    0x85, (id),        /*   Report ID (player) */                          \
+    0x19, 0x10,        /*   Usage Minimum (0x10) - gyro X */               \
+    0x29, 0x12,        /*   Usage Maximum (0x12) - gyro Z */               \
+    0x16, 0x00, 0x80,  /*   Logical Minimum (-32768) */                    \
+    0x26, 0xFF, 0x7F,  /*   Logical Maximum (32767) */                     \
+    0x75, 0x10,        /*   Report Size (16) */                            \
+    0x95, 0x03,        /*   Report Count (3) */                            \
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */            \
+    0x19, 0x20,        /*   Usage Minimum (0x20) - accel X */              \
+    0x29, 0x22,        /*   Usage Maximum (0x22) - accel Z */              \
+    0x81, 0x02,        /*   Input (Data, Variable, Absolute) */            \
+    0x09, 0x30,        /*   Usage (0x30) - timestamp */                    \
+    0x17, 0x00, 0x00, 0x00, 0x80,  /* Logical Minimum (-2^31) */           \
+    0x27, 0xFF, 0xFF, 0xFF, 0x7F,  /* Logical Maximum (2^31 - 1) */        \
+    0x75, 0x20,        /*   Report Size (32) */                            \
+    0x95, 0x01,        /*   Report Count (1) */                            \
+    0x81, 0x02         /*   Input (Data, Variable, Absolute) */
+
+const uint8_t usb_hid_motion_descriptor[USB_HID_MOTION_DESCRIPTOR_LEN] = {
+    0x06, 0x01, 0xFF,  /* Usage Page (Vendor Defined 0xFF01) */
+    0x09, 0x01,        /* Usage (0x01) - motion */
+    0xA1, 0x01,        /* Collection (Application) */
+    MOTION_REPORT(1),
+    MOTION_REPORT(2),
+    MOTION_REPORT(3),
+    MOTION_REPORT(4),
     0xC0,              /* End Collection */
 };
 
@@ -104,3 +165,25 @@ void usb_hid_report_from_gamepad(const gamepad_report_t *in,
     /* Buttons: 1:1 */
     out->buttons = in->buttons;
 }
+
+bool usb_hid_report_to_output(const uint8_t *buf, uint16_t len,
+                              gamepad_output_t *out)
+{
+    if (len < sizeof(usb_gamepad_output_t))
+        return false;
+
+    out->strong = buf[0];
+    out->weak   = buf[1];
+    out->leds   = buf[2] & 0x0F;
+    return true;
+}
+
+void usb_hid_report_from_motion(const gamepad_motion_t *in,
+                                usb_motion_report_t *out)
+{
+    for (int i = 0; i < 3; i++) {
+        out->gyro[i]  = in->gyro[i];
+        out->accel[i] = in->accel[i];
+    }
+    out->timestamp_us = in->timestamp_us;
+}
@@ -0,0 +1,161 @@
+#include "usb_personality.h"
+
+#include <string.h>
+
+#include "device_config.h"
+#include "ds4_report.h"
+#include "switch_pro.h"
+#include "xinput_report.h"
+
+_Static_assert(DEVICE_CONFIG_USB_MODE_MAX == USB_MODE_COUNT - 1,
+               "usb_mode setting range must cover every personality");
+_Static_assert(DS4_REPORT_LEN <= USB_REPORT_MAX &&
+               SWITCH_PRO_REPORT_LEN <= USB_REPORT_MAX &&
+               XINPUT_REPORT_LEN <= USB_REPORT_MAX,
+               "every report must fit USB_REPORT_MAX");
+
+/* ── Generic HID ─────────────────────────────────────────────────────── */
+
+static uint8_t hid_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                uint8_t out[USB_REPORT_MAX])
+{
+    (void)seq;
+    usb_gamepad_report_t r;
+    usb_hid_report_from_gamepad(in, &r);
+    memcpy(out, &r, sizeof(r));
+    return sizeof(r);
+}
+
+static void hid_from_host(const uint8_t *buf, uint16_t len, uint8_t seq,
+                          usb_host_result_t *res)
+{
+    (void)seq;
+    res->has_output = usb_hid_report_to_output(buf, len, &res->output);
+}
+
+/* ── XInput ──────────────────────────────────────────────────────────── */
+
+static uint8_t xinput_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                   uint8_t out[USB_REPORT_MAX])
+{
+    (void)seq;
+    return xinput_report_from_gamepad(in, out);
+}
+
+static void xinput_from_host(const uint8_t *buf, uint16_t len, uint8_t seq,
+                             usb_host_result_t *res)
+{
+    (void)seq;
+    res->has_output = xinput_report_to_output(buf, len, &res->output);
+}
+
+/* ── DualShock 4 ─────────────────────────────────────────────────────── */
+
+static uint8_t ds4_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                uint8_t out[USB_REPORT_MAX])
+{
+    return ds4_report_from_gamepad(in, seq, out);
+}
+
+static uint8_t ds4_from_raw(const bt_gamepad_raw_t *raw,
+                            uint8_t out[USB_REPORT_MAX])
+{
+    if (raw->kind != BT_GAMEPAD_RAW_DS4 ||
+        !ds4_report_from_bt(raw->data, raw->len, out))
+        return 0;
+    return DS4_REPORT_LEN;
+}
+
+static void ds4_from_host(const uint8_t *buf, uint16_t len, uint8_t seq,
+                          usb_host_result_t *res)
+{
+    (void)seq;
+    res->has_output = ds4_report_to_output(buf, len, &res->output);
+}
+
+/* ── Switch Pro ──────────────────────────────────────────────────────── */
+
+static uint8_t switch_from_gamepad(const gamepad_report_t *in, uint8_t seq,
+                                   uint8_t out[USB_REPORT_MAX])
+{
+    return switch_pro_from_gamepad(in, seq, out);
+}
+
+static void switch_from_host(const uint8_t *buf, uint16_t len, uint8_t seq,
+                             usb_host_result_t *res)
+{
+    res->reply_len = switch_pro_from_host(buf, len, seq, &res->output,
+                                          &res->has_output, res->reply);
+}
+
+/* ── Table ───────────────────────────────────────────────────────────── */
+
+/*
+ * VID 0x1209 is the pid.codes shared VID for open-source hardware; PID
+ * 0x0001 is a placeholder.  The others are the emulated controllers' own
+ * IDs, which host drivers match on.
+ */
+static const usb_personality_t s_personalities[USB_MODE_COUNT] = {
+    [USB_MODE_HID] = {
+        .name            = "hid",
+        .vid             = 0x1209,
+        .pid             = 0x0001,
+        .bcd_device      = 0x0100,
+        .manufacturer    = "PadProxy",
+        .product         = "PadProxy Gamepad",
+        .report_desc     = usb_hid_report_descriptor,
+        .report_desc_len = USB_HID_REPORT_DESCRIPTOR_LEN,
+        .motion          = true,
+        .raw_kind        = BT_GAMEPAD_RAW_NONE,
+        .from_gamepad    = hid_from_gamepad,
+        .from_host       = hid_from_host,
+    },
+    [USB_MODE_XINPUT] = {
+        .name            = "xinput",
+        .vid             = 0x045E,
+        .pid             = 0x028E,
+        .bcd_device      = 0x0114,
+        .manufacturer    = "Microsoft Corporation",
+        .product         = "Controller",
+        .raw_kind        = BT_GAMEPAD_RAW_NONE,
+        .from_gamepad    = xinput_from_gamepad,
+        .from_host       = xinput_from_host,
+    },
+    [USB_MODE_DS4] = {
+        .name            = "ds4",
+        .vid             = 0x054C,
+        .pid             = 0x09CC,
+        .bcd_device      = 0x0100,
+        .manufacturer    = "Sony Interactive Entertainment",
+        .product         = "Wireless Controller",
+        .report_desc     = ds4_report_descriptor,
+        .report_desc_len = DS4_REPORT_DESCRIPTOR_LEN,
+        .report_ids      = true,
+        .raw_kind        = BT_GAMEPAD_RAW_DS4,
+        .from_gamepad    = ds4_from_gamepad,
+        .from_raw        = ds4_from_raw,
+        .from_host       = ds4_from_host,
+        .feature         = ds4_report_feature,
+    },
+    [USB_MODE_SWITCH] = {
+        .name            = "switch",
+        .vid             = 0x057E,
+        .pid             = 0x2009,
+        .bcd_device      = 0x0210,
+        .manufacturer    = "Nintendo Co., Ltd.",
+        .product         = "Pro Controller",
+        .report_desc     = switch_pro_report_descriptor,
+        .report_desc_len = SWITCH_PRO_REPORT_DESCRIPTOR_LEN,
+        .report_ids      = true,
+        .raw_kind        = BT_GAMEPAD_RAW_NONE,
+        .from_gamepad    = switch_from_gamepad,
+        .from_host       = switch_from_host,
+    },
+};
+
+const usb_personality_t *usb_personality_get(uint16_t mode)
+{
+    if (mode >= USB_MODE_COUNT)
+        mode = USB_MODE_HID;
+    return &s_personalities[mode];
+}
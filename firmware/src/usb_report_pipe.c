@@ -0,0 +1,57 @@
+#include "usb_report_pipe.h"
+
+void usb_report_pipe_reset(usb_report_pipe_t *p)
+{
+    p->has_pending = false;
+    p->in_flight   = false;
+    p->refused     = false;
+}
+
+bool usb_report_pipe_push(usb_report_pipe_t *p, const usb_report_t *r)
+{
+    if (p->has_pending) {
+        if (p->pending.buttons != r->buttons || p->pending.dpad != r->dpad) {
+            p->refused = true;
+            p->refusals++;
+            return false;
+        }
+        p->replaced++;
+    } else if (p->in_flight) {
+        p->deferred++;
+    }
+
+    p->pending     = *r;
+    p->has_pending = true;
+    return true;
+}
+
+bool usb_report_pipe_next(usb_report_pipe_t *p, usb_report_t *out)
+{
+    if (p->in_flight || !p->has_pending)
+        return false;
+
+    *out = p->pending;
+    p->has_pending = false;
+    p->in_flight   = true;
+    p->submitted++;
+    return true;
+}
+
+void usb_report_pipe_failed(usb_report_pipe_t *p, const usb_report_t *r)
+{
+    p->in_flight = false;
+    p->submitted--;
+    p->retries++;
+    if (!p->has_pending) {
+        p->pending     = *r;
+        p->has_pending = true;
+    }
+}
+
+bool usb_report_pipe_complete(usb_report_pipe_t *p)
+{
+    bool refused = p->refused;
+    p->in_flight = false;
+    p->refused   = false;
+    return refused;
+}
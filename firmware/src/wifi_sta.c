@@ -0,0 +1,137 @@
+#include "wifi_sta.h"
+#include "dlog.h"
+
+#include <string.h>
+
+#include "pico/cyw43_arch.h"
+
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+
+/* Rejoin backoff after a failed join or a dropped link */
+#define RETRY_MIN_MS   5000
+#define RETRY_MAX_MS  60000
+
+/* ── State ───────────────────────────────────────────────────────────── */
+
+static const char      *s_ssid;
+static const char      *s_password;
+static wifi_sta_state_t s_state = WIFI_STA_OFF;
+static bool             s_retry_pending;
+static uint32_t         s_retry_at_ms;
+static uint32_t         s_retry_ms = RETRY_MIN_MS;
+static struct udp_pcb  *s_udp;
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static void join(void)
+{
+    int err = cyw43_arch_wifi_connect_async(s_ssid, s_password,
+                                            CYW43_AUTH_WPA2_AES_PSK);
+    if (err != 0) {
+        DLOG_INFO("[wifi] Join '%s' failed to start: %d", s_ssid, err);
+        s_state = WIFI_STA_DOWN;
+        return;
+    }
+    s_state = WIFI_STA_JOINING;
+}
+
+/* ── Public API ──────────────────────────────────────────────────────── */
+
+void wifi_sta_init(const char *ssid, const char *password)
+{
+    if (!ssid || ssid[0] == '\0')
+        return;
+
+    if (cyw43_arch_init()) {
+        DLOG_INFO("[wifi] CYW43 init failed");
+        return;
+    }
+    cyw43_arch_enable_sta_mode();
+
+    s_ssid     = ssid;
+    s_password = password;
+
+    cyw43_arch_lwip_begin();
+    s_udp = udp_new();
+    cyw43_arch_lwip_end();
+
+    DLOG_INFO("[wifi] Joining '%s' in the background", ssid);
+    join();
+}
+
+void wifi_sta_task(uint32_t now_ms)
+{
+    if (s_state == WIFI_STA_OFF)
+        return;
+
+    int link = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+
+    switch (s_state) {
+    case WIFI_STA_JOINING:
+        if (link == CYW43_LINK_UP) {
+            DLOG_INFO("[wifi] Up");
+            s_state    = WIFI_STA_UP;
+            s_retry_ms = RETRY_MIN_MS;
+        } else if (link < 0) {
+            DLOG_INFO("[wifi] Join failed: %d", link);
+            s_state = WIFI_STA_DOWN;
+        }
+        break;
+
+    case WIFI_STA_UP:
+        if (link != CYW43_LINK_UP) {
+            DLOG_INFO("[wifi] Link lost: %d", link);
+            s_state = WIFI_STA_DOWN;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (s_state == WIFI_STA_DOWN) {
+        if (!s_retry_pending) {
+            s_retry_pending = true;
+            s_retry_at_ms   = now_ms + s_retry_ms;
+        } else if ((int32_t)(now_ms - s_retry_at_ms) >= 0) {
+            s_retry_pending = false;
+            if (s_retry_ms < RETRY_MAX_MS)
+                s_retry_ms *= 2;
+            join();
+        }
+    }
+}
+
+wifi_sta_state_t wifi_sta_state(void)
+{
+    return s_state;
+}
+
+const char *wifi_sta_state_name(wifi_sta_state_t state)
+{
+    switch (state) {
+    case WIFI_STA_OFF:     return "off";
+    case WIFI_STA_JOINING: return "joining";
+    case WIFI_STA_UP:      return "up";
+    case WIFI_STA_DOWN:    return "down";
+    default:               return "unknown";
+    }
+}
+
+bool wifi_sta_send_wol(const uint8_t mac[WOL_MAC_LEN])
+{
+    if (s_state != WIFI_STA_UP || !s_udp)
+        return false;
+
+    bool ok = false;
+    cyw43_arch_lwip_begin();
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, WOL_PACKET_SIZE, PBUF_RAM);
+    if (p) {
+        wol_packet_build(mac, (uint8_t *)p->payload);
+        ok = udp_sendto(s_udp, p, IP_ADDR_BROADCAST, WOL_PORT) == ERR_OK;
+        pbuf_free(p);
+    }
+    cyw43_arch_lwip_end();
+    return ok;
+}
@@ -0,0 +1,56 @@
+#include "wol_packet.h"
+
+#include <string.h>
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool wol_parse_mac(const char *str, uint8_t mac[WOL_MAC_LEN])
+{
+    if (!str)
+        return false;
+
+    size_t len = strlen(str);
+    char sep;
+    if (len == 2 * WOL_MAC_LEN)
+        sep = '\0';
+    else if (len == WOL_MAC_STR_MAX && (str[2] == ':' || str[2] == '-'))
+        sep = str[2];
+    else
+        return false;
+
+    uint8_t out[WOL_MAC_LEN];
+    const char *p = str;
+    for (int i = 0; i < WOL_MAC_LEN; i++) {
+        if (i > 0 && sep && *p++ != sep)
+            return false;
+        int hi = hex_digit(p[0]);
+        int lo = hex_digit(p[1]);
+        if (hi < 0 || lo < 0)
+            return false;
+        out[i] = (uint8_t)(hi << 4 | lo);
+        p += 2;
+    }
+
+    /* A NIC only answers to its own (unicast, non-zero) address */
+    static const uint8_t zero[WOL_MAC_LEN];
+    if ((out[0] & 0x01) || memcmp(out, zero, WOL_MAC_LEN) == 0)
+        return false;
+
+    if (mac)
+        memcpy(mac, out, WOL_MAC_LEN);
+    return true;
+}
+
+void wol_packet_build(const uint8_t mac[WOL_MAC_LEN],
+                      uint8_t out[WOL_PACKET_SIZE])
+{
+    memset(out, 0xFF, 6);
+    for (int i = 0; i < 16; i++)
+        memcpy(out + 6 + i * WOL_MAC_LEN, mac, WOL_MAC_LEN);
+}
@@ -0,0 +1,89 @@
+#include "xinput_report.h"
+
+#include <string.h>
+
+#define XINPUT_MSG_INPUT    0x00
+#define XINPUT_MSG_RUMBLE   0x00
+#define XINPUT_MSG_LED      0x01
+
+/*
+ * LED animations 0x02-0x05 flash then light player 1-4, 0x06-0x09 light
+ * it at once; the rest (off, blink, rotate) name no player.
+ */
+#define XINPUT_LED_FLASH_P1 0x02
+#define XINPUT_LED_ON_P1    0x06
+#define XINPUT_LED_ON_P4    0x09
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/** Flip a Y axis, saturating: -(-32768) does not fit. */
+static inline int16_t flip(int16_t v)
+{
+    return v == INT16_MIN ? INT16_MAX : (int16_t)-v;
+}
+
+uint8_t xinput_report_from_gamepad(const gamepad_report_t *in,
+                                   uint8_t out[XINPUT_REPORT_LEN])
+{
+    /* Indexed by hat value: 0 = N clockwise, 8 = centred */
+    static const uint16_t dpad[16] = {
+        XINPUT_BTN_UP,
+        XINPUT_BTN_UP | XINPUT_BTN_RIGHT,
+        XINPUT_BTN_RIGHT,
+        XINPUT_BTN_DOWN | XINPUT_BTN_RIGHT,
+        XINPUT_BTN_DOWN,
+        XINPUT_BTN_DOWN | XINPUT_BTN_LEFT,
+        XINPUT_BTN_LEFT,
+        XINPUT_BTN_UP | XINPUT_BTN_LEFT,
+    };
+    uint16_t b = in->buttons;
+    uint16_t x = dpad[in->dpad & 0x0F];
+
+    x |= b & GAMEPAD_BTN_START  ? XINPUT_BTN_START : 0;
+    x |= b & GAMEPAD_BTN_SELECT ? XINPUT_BTN_BACK  : 0;
+    x |= b & GAMEPAD_BTN_L3     ? XINPUT_BTN_LS    : 0;
+    x |= b & GAMEPAD_BTN_R3     ? XINPUT_BTN_RS    : 0;
+    x |= b & GAMEPAD_BTN_L1     ? XINPUT_BTN_LB    : 0;
+    x |= b & GAMEPAD_BTN_R1     ? XINPUT_BTN_RB    : 0;
+    x |= b & GAMEPAD_BTN_GUIDE  ? XINPUT_BTN_GUIDE : 0;
+    x |= b & GAMEPAD_BTN_A      ? XINPUT_BTN_A     : 0;
+    x |= b & GAMEPAD_BTN_B      ? XINPUT_BTN_B     : 0;
+    x |= b & GAMEPAD_BTN_X      ? XINPUT_BTN_X     : 0;
+    x |= b & GAMEPAD_BTN_Y      ? XINPUT_BTN_Y     : 0;
+
+    memset(out, 0, XINPUT_REPORT_LEN);
+    out[0] = XINPUT_MSG_INPUT;
+    out[1] = XINPUT_REPORT_LEN;
+    put_le16(&out[2], x);
+    out[4] = (uint8_t)(in->lt >> 2);
+    out[5] = (uint8_t)(in->rt >> 2);
+    put_le16(&out[6],  (uint16_t)in->lx);
+    put_le16(&out[8],  (uint16_t)flip(in->ly));
+    put_le16(&out[10], (uint16_t)in->rx);
+    put_le16(&out[12], (uint16_t)flip(in->ry));
+    return XINPUT_REPORT_LEN;
+}
+
+bool xinput_report_to_output(const uint8_t *buf, uint16_t len,
+                             gamepad_output_t *out)
+{
+    if (len >= 5 && buf[0] == XINPUT_MSG_RUMBLE && buf[1] == 0x08) {
+        out->strong = buf[3];
+        out->weak   = buf[4];
+        return true;
+    }
+
+    if (len >= 3 && buf[0] == XINPUT_MSG_LED && buf[1] == 0x03) {
+        uint8_t p = buf[2];
+        if (p >= XINPUT_LED_FLASH_P1 && p <= XINPUT_LED_ON_P4) {
+            uint8_t player = (uint8_t)((p - XINPUT_LED_FLASH_P1) % 4 + 1);
+            out->leds = (uint8_t)GAMEPAD_LED_PLAYER(player);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,347 @@
+#include "unity.h"
+#include "axis_curve.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static axis_curve_t c;
+
+static const axis_curve_cfg_t linear = { 0, 0, 0, 0 };
+
+void setUp(void)
+{
+    memset(&c, 0, sizeof(c));
+}
+
+void tearDown(void)
+{
+}
+
+/* The curve in floating point, straight from the formula in the header */
+static double reference(const axis_curve_cfg_t *cfg, uint16_t full,
+                        uint32_t r)
+{
+    double top = full - cfg->outer;
+    if (r <= cfg->deadzone)
+        return 0;
+    if (r >= top)
+        return full;
+    double t = (r - cfg->deadzone) / (top - cfg->deadzone);
+    double s = t + cfg->expo / 100.0 * (t * t * t - t);
+    return cfg->anti + s * (full - cfg->anti);
+}
+
+static void assert_matches_reference(const axis_curve_cfg_t *cfg,
+                                     uint16_t full)
+{
+    axis_curve_init(&c, cfg, full);
+    for (uint32_t r = 0; r <= full; r++) {
+        double want = reference(cfg, full, r);
+        double got  = axis_curve_eval(&c, r);
+        char msg[48];
+        snprintf(msg, sizeof(msg), "r=%u want=%.1f", (unsigned)r, want);
+        TEST_ASSERT_TRUE_MESSAGE(got - want < 2.0 && want - got < 2.0, msg);
+    }
+}
+
+/* ── Integer square root ──────────────────────────────────────────────── */
+
+static void assert_isqrt(uint32_t v)
+{
+    uint64_t r = axis_curve_isqrt(v);
+    TEST_ASSERT_TRUE(r * r <= v);
+    TEST_ASSERT_TRUE((r + 1) * (r + 1) > v);
+}
+
+void test_isqrt_small_values_exact(void)
+{
+    for (uint32_t v = 0; v < (1u << 20); v++)
+        assert_isqrt(v);
+}
+
+void test_isqrt_around_every_square(void)
+{
+    for (uint32_t k = 1; k < 65536; k++) {
+        assert_isqrt(k * k - 1);
+        assert_isqrt(k * k);
+        assert_isqrt(k * k + 1);
+    }
+    assert_isqrt(0xFFFFFFFFu);
+}
+
+void test_isqrt_sweep(void)
+{
+    for (uint64_t v = 1u << 20; v <= 0xFFFFFFFFu; v += 4099)
+        assert_isqrt((uint32_t)v);
+}
+
+/* ── Single axis ──────────────────────────────────────────────────────── */
+
+void test_all_zero_settings_are_identity(void)
+{
+    axis_curve_init(&c, &linear, AXIS_CURVE_TRIGGER_FULL);
+    TEST_ASSERT_TRUE(c.identity);
+    for (uint32_t r = 0; r <= AXIS_CURVE_TRIGGER_FULL; r++)
+        TEST_ASSERT_EQUAL_UINT16(r, axis_curve_eval(&c, r));
+    TEST_ASSERT_EQUAL_UINT16(AXIS_CURVE_TRIGGER_FULL,
+                             axis_curve_eval(&c, 5000));
+}
+
+void test_deadzone_is_exact(void)
+{
+    const axis_curve_cfg_t cfg = { 3000, 0, 0, 0 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+    TEST_ASSERT_FALSE(c.identity);
+    TEST_ASSERT_EQUAL_UINT16(0, axis_curve_eval(&c, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, axis_curve_eval(&c, 3000));
+    TEST_ASSERT_TRUE(axis_curve_eval(&c, 3001) > 0);
+    TEST_ASSERT_TRUE(axis_curve_eval(&c, 3001) < 4);
+    TEST_ASSERT_EQUAL_UINT16(AXIS_CURVE_STICK_FULL,
+                             axis_curve_eval(&c, AXIS_CURVE_STICK_FULL));
+}
+
+void test_outer_deadzone_reaches_full_early(void)
+{
+    const axis_curve_cfg_t cfg = { 0, 2000, 0, 0 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+    TEST_ASSERT_EQUAL_UINT16(AXIS_CURVE_STICK_FULL,
+                             axis_curve_eval(&c, AXIS_CURVE_STICK_FULL - 2000));
+    TEST_ASSERT_TRUE(axis_curve_eval(&c, AXIS_CURVE_STICK_FULL - 2001) <
+                     AXIS_CURVE_STICK_FULL);
+}
+
+void test_anti_deadzone_starts_output_at_anti(void)
+{
+    const axis_curve_cfg_t cfg = { 2000, 0, 5000, 0 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+    TEST_ASSERT_EQUAL_UINT16(0, axis_curve_eval(&c, 2000));
+    uint16_t first = axis_curve_eval(&c, 2001);
+    TEST_ASSERT_TRUE(first >= 5000 && first < 5003);
+}
+
+void test_expo_below_linear_with_same_ends(void)
+{
+    const axis_curve_cfg_t cfg = { 0, 0, 0, 100 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+    TEST_ASSERT_EQUAL_UINT16(0, axis_curve_eval(&c, 0));
+    TEST_ASSERT_EQUAL_UINT16(AXIS_CURVE_STICK_FULL,
+                             axis_curve_eval(&c, AXIS_CURVE_STICK_FULL));
+    /* Pure cubic: half deflection gives an eighth */
+    uint16_t half = axis_curve_eval(&c, 16384);
+    TEST_ASSERT_UINT16_WITHIN(2, 4096, half);
+}
+
+void test_curves_match_reference(void)
+{
+    static const axis_curve_cfg_t sticks[] = {
+        { 3000, 0, 0, 0 },
+        { 0, 2500, 0, 0 },
+        { 1500, 1000, 6000, 0 },
+        { 0, 0, 0, 35 },
+        { 4000, 3000, 2000, 100 },
+        { 16000, 16000, 16000, 100 },
+    };
+    static const axis_curve_cfg_t triggers[] = {
+        { 50, 0, 0, 0 },
+        { 30, 100, 0, 60 },
+        { 400, 400, 400, 100 },
+    };
+    for (size_t i = 0; i < sizeof(sticks) / sizeof(sticks[0]); i++)
+        assert_matches_reference(&sticks[i], AXIS_CURVE_STICK_FULL);
+    for (size_t i = 0; i < sizeof(triggers) / sizeof(triggers[0]); i++)
+        assert_matches_reference(&triggers[i], AXIS_CURVE_TRIGGER_FULL);
+}
+
+void test_curve_is_monotonic(void)
+{
+    static const axis_curve_cfg_t cfgs[] = {
+        { 0, 0, 0, 100 },
+        { 1000, 500, 8000, 70 },
+        { 16000, 16000, 16000, 100 },
+    };
+    for (size_t i = 0; i < sizeof(cfgs) / sizeof(cfgs[0]); i++) {
+        axis_curve_init(&c, &cfgs[i], AXIS_CURVE_STICK_FULL);
+        uint16_t prev = 0;
+        for (uint32_t r = 0; r <= 46341; r++) {
+            uint16_t v = axis_curve_eval(&c, r);
+            TEST_ASSERT_TRUE(v >= prev);
+            TEST_ASSERT_TRUE(v <= AXIS_CURVE_STICK_FULL);
+            prev = v;
+        }
+    }
+}
+
+void test_out_of_range_settings_clamped(void)
+{
+    const axis_curve_cfg_t cfg = { 2000, 2000, 5000, 500 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_TRIGGER_FULL);
+    TEST_ASSERT_EQUAL_UINT16(0, axis_curve_eval(&c, 1021));
+    TEST_ASSERT_EQUAL_UINT16(AXIS_CURVE_TRIGGER_FULL,
+                             axis_curve_eval(&c, AXIS_CURVE_TRIGGER_FULL));
+    TEST_ASSERT_TRUE(c.top > c.dz);
+}
+
+/* ── Sticks ───────────────────────────────────────────────────────────── */
+
+void test_identity_stick_untouched(void)
+{
+    axis_curve_init(&c, &linear, AXIS_CURVE_STICK_FULL);
+    int16_t x = -32768, y = 32767;
+    axis_curve_stick(&c, &x, &y);
+    TEST_ASSERT_EQUAL_INT16(-32768, x);
+    TEST_ASSERT_EQUAL_INT16(32767, y);
+}
+
+void test_stick_deadzone_is_round(void)
+{
+    const axis_curve_cfg_t cfg = { 3000, 0, 0, 0 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+
+    /* Each axis inside, but a square deadzone would keep the corner */
+    int16_t x = 2100, y = -2100;            /* r = 2970 */
+    axis_curve_stick(&c, &x, &y);
+    TEST_ASSERT_EQUAL_INT16(0, x);
+    TEST_ASSERT_EQUAL_INT16(0, y);
+
+    /* Each axis inside, but the vector is out */
+    x = 2200;
+    y = -2200;                              /* r = 3111 */
+    axis_curve_stick(&c, &x, &y);
+    TEST_ASSERT_TRUE(x > 0);
+    TEST_ASSERT_EQUAL_INT16(-x, y);
+}
+
+void test_stick_keeps_direction(void)
+{
+    const axis_curve_cfg_t cfg = { 4000, 1000, 3000, 50 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+
+    static const int16_t in[][2] = {
+        { 20000, 0 }, { 0, -20000 }, { 12000, 9000 }, { -5000, 15000 },
+        { -32768, -32768 }, { 32767, -1 },
+    };
+    for (size_t i = 0; i < sizeof(in) / sizeof(in[0]); i++) {
+        int16_t x = in[i][0], y = in[i][1];
+        axis_curve_stick(&c, &x, &y);
+        /* Same direction: the cross product stays ~0 */
+        int64_t cross = (int64_t)x * in[i][1] - (int64_t)y * in[i][0];
+        int64_t scale = (int64_t)(in[i][0] < 0 ? -in[i][0] : in[i][0]) +
+                        (in[i][1] < 0 ? -in[i][1] : in[i][1]);
+        TEST_ASSERT_TRUE(cross < 2 * scale && cross > -2 * scale);
+        TEST_ASSERT_TRUE((int32_t)x * in[i][0] >= 0);
+        TEST_ASSERT_TRUE((int32_t)y * in[i][1] >= 0);
+    }
+}
+
+void test_stick_saturates_on_circle(void)
+{
+    const axis_curve_cfg_t cfg = { 1000, 1000, 0, 0 };
+    axis_curve_init(&c, &cfg, AXIS_CURVE_STICK_FULL);
+
+    int16_t x = -32768, y = 0;
+    axis_curve_stick(&c, &x, &y);
+    TEST_ASSERT_INT16_WITHIN(1, -32767, x);
+    TEST_ASSERT_EQUAL_INT16(0, y);
+
+    /* A square gate's corner lands on the circle */
+    x = 32767;
+    y = 32767;
+    axis_curve_stick(&c, &x, &y);
+    TEST_ASSERT_INT16_WITHIN(2, 23170, x);
+    TEST_ASSERT_INT16_WITHIN(2, 23170, y);
+}
+
+/* ── Report ───────────────────────────────────────────────────────────── */
+
+void test_identity_set_leaves_report_alone(void)
+{
+    axis_curve_set_t set;
+    axis_curve_set_init(&set, &linear, &linear, &linear);
+    TEST_ASSERT_TRUE(set.identity);
+
+    gamepad_report_t r = { 123, -456, 32767, -32768, 7, 1023, 0x55, 3 };
+    gamepad_report_t before = r;
+    axis_curve_set_apply(&set, &r);
+    TEST_ASSERT_EQUAL_MEMORY(&before, &r, sizeof(r));
+}
+
+void test_set_shapes_each_axis_with_its_curve(void)
+{
+    const axis_curve_cfg_t ls = { 5000, 0, 0, 0 };
+    const axis_curve_cfg_t tr = { 100, 0, 0, 0 };
+    axis_curve_set_t set;
+    axis_curve_set_init(&set, &ls, &linear, &tr);
+    TEST_ASSERT_FALSE(set.identity);
+
+    gamepad_report_t r = { 4000, 0, 4000, 0, 90, 1023, 0, 8 };
+    axis_curve_set_apply(&set, &r);
+    TEST_ASSERT_EQUAL_INT16(0, r.lx);
+    TEST_ASSERT_EQUAL_INT16(4000, r.rx);    /* right stick is linear */
+    TEST_ASSERT_EQUAL_UINT16(0, r.lt);
+    TEST_ASSERT_EQUAL_UINT16(1023, r.rt);
+}
+
+/* ── Benchmark ────────────────────────────────────────────────────────── */
+
+void test_benchmark_apply(void)
+{
+    const axis_curve_cfg_t stick = { 2500, 1500, 3000, 40 };
+    const axis_curve_cfg_t trig  = { 40, 20, 0, 30 };
+    axis_curve_set_t set;
+    axis_curve_set_init(&set, &stick, &stick, &trig);
+
+    const int n = 1000000;
+    uint32_t check = 0;
+    gamepad_report_t r;
+    memset(&r, 0, sizeof(r));
+
+    clock_t start = clock();
+    for (int i = 0; i < n; i++) {
+        r.lx = (int16_t)(i * 7);
+        r.ly = (int16_t)(i * 13);
+        r.rx = (int16_t)(i * 29);
+        r.ry = (int16_t)(i * 3);
+        r.lt = (uint16_t)(i & 1023);
+        r.rt = (uint16_t)((i >> 3) & 1023);
+        axis_curve_set_apply(&set, &r);
+        check += (uint32_t)(r.lx + r.ry + r.lt + r.rt);
+    }
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+
+    printf("axis_curve_set_apply: %.1f ns per report (host)\n", ns);
+    TEST_ASSERT_NOT_EQUAL(0, check);
+    TEST_ASSERT_TRUE(ns < 1000.0);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_isqrt_small_values_exact);
+    RUN_TEST(test_isqrt_around_every_square);
+    RUN_TEST(test_isqrt_sweep);
+
+    RUN_TEST(test_all_zero_settings_are_identity);
+    RUN_TEST(test_deadzone_is_exact);
+    RUN_TEST(test_outer_deadzone_reaches_full_early);
+    RUN_TEST(test_anti_deadzone_starts_output_at_anti);
+    RUN_TEST(test_expo_below_linear_with_same_ends);
+    RUN_TEST(test_curves_match_reference);
+    RUN_TEST(test_curve_is_monotonic);
+    RUN_TEST(test_out_of_range_settings_clamped);
+
+    RUN_TEST(test_identity_stick_untouched);
+    RUN_TEST(test_stick_deadzone_is_round);
+    RUN_TEST(test_stick_keeps_direction);
+    RUN_TEST(test_stick_saturates_on_circle);
+
+    RUN_TEST(test_identity_set_leaves_report_alone);
+    RUN_TEST(test_set_shapes_each_axis_with_its_curve);
+
+    RUN_TEST(test_benchmark_apply);
+
+    return UNITY_END();
+}
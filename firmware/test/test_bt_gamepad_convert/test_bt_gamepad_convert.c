@@ -114,6 +114,23 @@ void test_clamp_trigger_one_below_max(void)
     TEST_ASSERT_EQUAL_UINT16(1022, bt_gamepad_clamp_trigger(1022));
 }
 
+/* ── bt_gamepad_clamp_motion ─────────────────────────────────────────── */
+
+void test_clamp_motion_in_range_unchanged(void)
+{
+    TEST_ASSERT_EQUAL_INT16(0,      bt_gamepad_clamp_motion(0));
+    TEST_ASSERT_EQUAL_INT16(-8192,  bt_gamepad_clamp_motion(-8192));
+    TEST_ASSERT_EQUAL_INT16(32767,  bt_gamepad_clamp_motion(32767));
+    TEST_ASSERT_EQUAL_INT16(-32768, bt_gamepad_clamp_motion(-32768));
+}
+
+void test_clamp_motion_saturates(void)
+{
+    TEST_ASSERT_EQUAL_INT16(32767,  bt_gamepad_clamp_motion(32768));
+    TEST_ASSERT_EQUAL_INT16(-32768, bt_gamepad_clamp_motion(-32769));
+    TEST_ASSERT_EQUAL_INT16(32767,  bt_gamepad_clamp_motion(1 << 24));
+}
+
 /* ── Test runner ─────────────────────────────────────────────────────── */
 
 int main(void)
@@ -144,5 +161,9 @@ int main(void)
     RUN_TEST(test_clamp_trigger_one);
     RUN_TEST(test_clamp_trigger_one_below_max);
 
+    /* clamp_motion */
+    RUN_TEST(test_clamp_motion_in_range_unchanged);
+    RUN_TEST(test_clamp_motion_saturates);
+
     return UNITY_END();
 }
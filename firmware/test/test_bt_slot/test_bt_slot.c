@@ -0,0 +1,128 @@
+#include "unity.h"
+#include "bt_slot.h"
+
+static bt_slot_table_t t;
+
+static const uint8_t PAD_A[BT_SLOT_ADDR_LEN] = { 0xA0, 1, 2, 3, 4, 5 };
+static const uint8_t PAD_B[BT_SLOT_ADDR_LEN] = { 0xB0, 1, 2, 3, 4, 5 };
+static const uint8_t PAD_C[BT_SLOT_ADDR_LEN] = { 0xC0, 1, 2, 3, 4, 5 };
+static const uint8_t PAD_D[BT_SLOT_ADDR_LEN] = { 0xD0, 1, 2, 3, 4, 5 };
+static const uint8_t PAD_E[BT_SLOT_ADDR_LEN] = { 0xE0, 1, 2, 3, 4, 5 };
+static const uint8_t PAD_F[BT_SLOT_ADDR_LEN] = { 0xF0, 1, 2, 3, 4, 5 };
+
+void setUp(void)
+{
+    bt_slot_init(&t);
+}
+
+void tearDown(void)
+{
+}
+
+/** Connect A, B, C, D into slots 0-3. */
+static void fill(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, bt_slot_assign(&t, PAD_A));
+    TEST_ASSERT_EQUAL_INT(1, bt_slot_assign(&t, PAD_B));
+    TEST_ASSERT_EQUAL_INT(2, bt_slot_assign(&t, PAD_C));
+    TEST_ASSERT_EQUAL_INT(3, bt_slot_assign(&t, PAD_D));
+}
+
+/* ── Assignment ───────────────────────────────────────────────────────── */
+
+void test_first_controllers_fill_in_order(void)
+{
+    fill();
+    TEST_ASSERT_EQUAL_INT(4, bt_slot_connected_count(&t));
+}
+
+void test_full_table_refuses(void)
+{
+    fill();
+    TEST_ASSERT_EQUAL_INT(BT_SLOT_NONE, bt_slot_assign(&t, PAD_E));
+    TEST_ASSERT_EQUAL_INT(4, bt_slot_connected_count(&t));
+}
+
+void test_connected_controller_keeps_slot(void)
+{
+    fill();
+    TEST_ASSERT_EQUAL_INT(2, bt_slot_assign(&t, PAD_C));
+    TEST_ASSERT_EQUAL_INT(4, bt_slot_connected_count(&t));
+}
+
+/* ── Reconnects ───────────────────────────────────────────────────────── */
+
+void test_reconnect_gets_same_slot(void)
+{
+    fill();
+    bt_slot_release(&t, 1);
+    bt_slot_release(&t, 2);
+    TEST_ASSERT_EQUAL_INT(2, bt_slot_connected_count(&t));
+
+    /* Come back in the other order */
+    TEST_ASSERT_EQUAL_INT(2, bt_slot_assign(&t, PAD_C));
+    TEST_ASSERT_EQUAL_INT(1, bt_slot_assign(&t, PAD_B));
+}
+
+void test_new_controller_prefers_unused_slot(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, bt_slot_assign(&t, PAD_A));
+    bt_slot_release(&t, 0);
+
+    /* Slot 0 stays reserved for A while never-used slots remain */
+    TEST_ASSERT_EQUAL_INT(1, bt_slot_assign(&t, PAD_B));
+    TEST_ASSERT_EQUAL_INT(0, bt_slot_assign(&t, PAD_A));
+}
+
+void test_new_controller_evicts_oldest_release(void)
+{
+    fill();
+    bt_slot_release(&t, 3);
+    bt_slot_release(&t, 1);
+
+    /* D left first, so E takes its slot; F then takes B's */
+    TEST_ASSERT_EQUAL_INT(3, bt_slot_assign(&t, PAD_E));
+    TEST_ASSERT_EQUAL_INT(1, bt_slot_assign(&t, PAD_F));
+
+    /* The evicted controllers are strangers now */
+    TEST_ASSERT_EQUAL_INT(BT_SLOT_NONE, bt_slot_assign(&t, PAD_D));
+    TEST_ASSERT_EQUAL_INT(BT_SLOT_NONE, bt_slot_assign(&t, PAD_B));
+}
+
+void test_evicted_controller_gets_a_free_slot(void)
+{
+    fill();
+    bt_slot_release(&t, 0);
+    TEST_ASSERT_EQUAL_INT(0, bt_slot_assign(&t, PAD_E));  /* evicts A */
+    bt_slot_release(&t, 2);
+
+    TEST_ASSERT_EQUAL_INT(2, bt_slot_assign(&t, PAD_A));
+    TEST_ASSERT_EQUAL_INT(BT_SLOT_NONE, bt_slot_assign(&t, PAD_C));
+}
+
+void test_release_out_of_range_ignored(void)
+{
+    fill();
+    bt_slot_release(&t, BT_SLOT_NONE);
+    bt_slot_release(&t, BT_GAMEPAD_MAX);
+    TEST_ASSERT_EQUAL_INT(4, bt_slot_connected_count(&t));
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_controllers_fill_in_order);
+    RUN_TEST(test_full_table_refuses);
+    RUN_TEST(test_connected_controller_keeps_slot);
+
+    RUN_TEST(test_reconnect_gets_same_slot);
+    RUN_TEST(test_new_controller_prefers_unused_slot);
+    RUN_TEST(test_new_controller_evicts_oldest_release);
+    RUN_TEST(test_evicted_controller_gets_a_free_slot);
+    RUN_TEST(test_release_out_of_range_ignored);
+
+    return UNITY_END();
+}
@@ -0,0 +1,179 @@
+#include "unity.h"
+#include "button_latch.h"
+#include "gamepad.h"
+
+#include <string.h>
+
+#define A GAMEPAD_BTN_A
+#define B GAMEPAD_BTN_B
+
+static button_latch_t l;
+
+void setUp(void)
+{
+    memset(&l, 0, sizeof(l));
+}
+
+void tearDown(void)
+{
+}
+
+/** Sample and send in one go, as the main loop does when USB is ready. */
+static uint16_t report(uint16_t held, uint16_t pressed)
+{
+    uint16_t out = button_latch_merge(&l, held, pressed);
+    button_latch_sent(&l, out);
+    return out;
+}
+
+/* ── Plain sampling ───────────────────────────────────────────────────── */
+
+void test_held_buttons_pass_through(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, 0));
+    TEST_ASSERT_EQUAL_HEX16(A, report(A, A));
+    TEST_ASSERT_EQUAL_HEX16(A | B, report(A | B, B));
+    TEST_ASSERT_EQUAL_HEX16(B, report(B, 0));
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, l.latched);
+}
+
+/* ── Lost edges ───────────────────────────────────────────────────────── */
+
+void test_tap_between_samples_reported_once(void)
+{
+    /* A went down and up before the sample */
+    TEST_ASSERT_EQUAL_HEX16(A, report(0, A));
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, l.latched);
+}
+
+void test_release_and_repress_shows_release(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(A, report(A, A));
+
+    /* Host still sees A held; A went up and down again in between */
+    TEST_ASSERT_EQUAL_HEX16(0, report(A, A));
+    TEST_ASSERT_EQUAL_HEX16(A, report(A, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, l.latched);
+}
+
+void test_second_tap_while_host_sees_first(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(A, report(0, A));   /* first tap */
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, A));   /* second: release first */
+    TEST_ASSERT_EQUAL_HEX16(A, report(0, 0));   /* ... then its press */
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, l.latched);
+}
+
+void test_other_buttons_unaffected_by_latch(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(A, report(A, A));
+    TEST_ASSERT_EQUAL_HEX16(A | B, report(A, B));   /* B tapped */
+    TEST_ASSERT_EQUAL_HEX16(A, report(A, 0));
+}
+
+/* ── Unsent reports ───────────────────────────────────────────────────── */
+
+void test_press_kept_until_sent(void)
+{
+    /* Endpoint busy: the tap must survive further samples */
+    TEST_ASSERT_EQUAL_HEX16(A, button_latch_merge(&l, 0, A));
+    TEST_ASSERT_EQUAL_HEX16(A, button_latch_merge(&l, 0, 0));
+    TEST_ASSERT_EQUAL_HEX16(A | B, button_latch_merge(&l, 0, B));
+    button_latch_sent(&l, A | B);
+
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, l.latched);
+}
+
+void test_reset_forgets_edges(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(A, report(A, A));
+    button_latch_merge(&l, 0, B);
+    button_latch_reset(&l);
+
+    TEST_ASSERT_EQUAL_HEX16(0, report(0, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, l.latched);
+}
+
+/* ── Exhaustive: every press reaches the host ─────────────────────────── */
+
+/*
+ * One button, every sequence of 7 samples where each sample period may
+ * hold a press and ends up or down.  Showing a re-press of a button the
+ * host sees held takes two reports (release, press), so presses closer
+ * together than that merge.  With presses at least 3 reports apart the
+ * host must see exactly one rising edge per press; in any case the last
+ * press must be followed by a rising edge, and the host must end up
+ * seeing the button's real state.
+ */
+void test_every_press_becomes_a_host_edge(void)
+{
+    enum { STEPS = 7, CHOICES = 4, DRAIN = 4 };
+    unsigned total = 1;
+    for (int i = 0; i < STEPS; i++)
+        total *= CHOICES;
+
+    for (unsigned seq = 0; seq < total; seq++) {
+        setUp();
+        unsigned code = seq;
+        unsigned presses = 0, host_edges = 0, min_gap = STEPS;
+        int last_press = -1, last_edge = -1;
+        uint16_t held = 0, prev = 0;
+
+        for (int i = 0; i < STEPS + DRAIN; i++) {
+            bool press = false, down = held != 0;
+            if (i < STEPS) {
+                unsigned c = code % CHOICES;
+                code /= CHOICES;
+                press = c & 1;
+                down  = c & 2;
+                /* Going down needs a press */
+                if (down && !held)
+                    press = true;
+            }
+            if (press) {
+                if (last_press >= 0 && (unsigned)(i - last_press) < min_gap)
+                    min_gap = (unsigned)(i - last_press);
+                presses++;
+                last_press = i;
+            }
+            held = down ? A : 0;
+
+            uint16_t out = report(held, press ? A : 0);
+            if ((out & A) && !(prev & A)) {
+                host_edges++;
+                last_edge = i;
+            }
+            prev = out;
+        }
+
+        if (min_gap >= 3)
+            TEST_ASSERT_EQUAL_UINT(presses, host_edges);
+        TEST_ASSERT_TRUE(last_edge >= last_press);
+        TEST_ASSERT_EQUAL_HEX16(held, prev);
+    }
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_held_buttons_pass_through);
+
+    RUN_TEST(test_tap_between_samples_reported_once);
+    RUN_TEST(test_release_and_repress_shows_release);
+    RUN_TEST(test_second_tap_while_host_sees_first);
+    RUN_TEST(test_other_buttons_unaffected_by_latch);
+
+    RUN_TEST(test_press_kept_until_sent);
+    RUN_TEST(test_reset_forgets_edges);
+
+    RUN_TEST(test_every_press_becomes_a_host_edge);
+
+    return UNITY_END();
+}
@@ -0,0 +1,379 @@
+#include "unity.h"
+#include "button_map.h"
+#include "gamepad.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SRC_ALL (1u << BUTTON_MAP_SRC_COUNT)
+
+static button_map_t      map;
+static button_map_spec_t spec;
+
+void setUp(void)
+{
+    memset(&map, 0xEE, sizeof(map));
+    memset(&spec, 0, sizeof(spec));
+}
+
+void tearDown(void)
+{
+}
+
+/* ── References ───────────────────────────────────────────────────────── */
+
+/* Bluepad32's bit values (uni_gamepad.h) */
+#define BP_A         (1 << 0)
+#define BP_B         (1 << 1)
+#define BP_X         (1 << 2)
+#define BP_Y         (1 << 3)
+#define BP_L1        (1 << 4)
+#define BP_R1        (1 << 5)
+#define BP_L3        (1 << 8)
+#define BP_R3        (1 << 9)
+#define BP_SYSTEM    (1 << 0)
+#define BP_SELECT    (1 << 1)
+#define BP_START     (1 << 2)
+#define BP_CAPTURE   (1 << 3)
+
+/* The conversion bt_gamepad.c used before button maps */
+static uint16_t legacy_map_buttons(uint32_t bp_buttons, uint32_t bp_misc)
+{
+    uint16_t out = 0;
+
+    if (bp_buttons & BP_A)          out |= GAMEPAD_BTN_A;
+    if (bp_buttons & BP_B)          out |= GAMEPAD_BTN_B;
+    if (bp_buttons & BP_X)          out |= GAMEPAD_BTN_X;
+    if (bp_buttons & BP_Y)          out |= GAMEPAD_BTN_Y;
+    if (bp_buttons & BP_L1)         out |= GAMEPAD_BTN_L1;
+    if (bp_buttons & BP_R1)         out |= GAMEPAD_BTN_R1;
+    if (bp_buttons & BP_L3)         out |= GAMEPAD_BTN_L3;
+    if (bp_buttons & BP_R3)         out |= GAMEPAD_BTN_R3;
+
+    if (bp_misc & BP_START)         out |= GAMEPAD_BTN_START;
+    if (bp_misc & BP_SELECT)        out |= GAMEPAD_BTN_SELECT;
+    if (bp_misc & BP_SYSTEM)        out |= GAMEPAD_BTN_GUIDE;
+
+    return out;
+}
+
+/* A spec applied one source at a time */
+static uint16_t reference(const button_map_spec_t *s, uint32_t src)
+{
+    uint16_t out = 0;
+    for (int i = 0; i < BUTTON_MAP_SRC_COUNT; i++)
+        if (src & (1u << i))
+            out |= s->dst[i];
+    return out;
+}
+
+static void assert_compiled_matches(const button_map_spec_t *s)
+{
+    button_map_compile(&map, s);
+    for (uint32_t src = 0; src < SRC_ALL; src++)
+        TEST_ASSERT_EQUAL_HEX16(reference(s, src),
+                                button_map_apply(&map, (uint16_t)src));
+}
+
+/* ── Packing ──────────────────────────────────────────────────────────── */
+
+void test_pack_places_misc_after_buttons(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(1u << BUTTON_MAP_SRC_A,
+                            button_map_pack(BP_A, 0));
+    TEST_ASSERT_EQUAL_HEX16(1u << BUTTON_MAP_SRC_R3,
+                            button_map_pack(BP_R3, 0));
+    TEST_ASSERT_EQUAL_HEX16(1u << BUTTON_MAP_SRC_GUIDE,
+                            button_map_pack(0, BP_SYSTEM));
+    TEST_ASSERT_EQUAL_HEX16(1u << BUTTON_MAP_SRC_CAPTURE,
+                            button_map_pack(0, BP_CAPTURE));
+}
+
+void test_pack_drops_unknown_bits(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(0, button_map_pack(0xFFFFFC00u, 0xFFFFFFF0u));
+}
+
+/* ── Compiled tables against the reference ────────────────────────────── */
+
+void test_defaults_match_legacy_chain_plus_misc(void)
+{
+    for (int pad = 0; pad < BUTTON_MAP_PAD_COUNT; pad++) {
+        button_map_build(&map, (button_map_pad_t)pad, "");
+        for (uint32_t b = 0; b < 1u << 10; b++) {
+            for (uint32_t m = 0; m < 1u << 4; m++) {
+                uint16_t want = legacy_map_buttons(b, m);
+                if (m & BP_CAPTURE)
+                    want |= GAMEPAD_BTN_MISC;
+                TEST_ASSERT_EQUAL_HEX16(want,
+                    button_map_apply(&map, button_map_pack(b, m)));
+            }
+        }
+    }
+}
+
+void test_every_default_compiles_exactly(void)
+{
+    for (int pad = 0; pad < BUTTON_MAP_PAD_COUNT; pad++) {
+        button_map_default((button_map_pad_t)pad, &spec);
+        assert_compiled_matches(&spec);
+    }
+}
+
+void test_every_single_source_mapping_compiles_exactly(void)
+{
+    /* Each source alone to each button, the rest dropped */
+    for (int src = 0; src < BUTTON_MAP_SRC_COUNT; src++) {
+        for (int bit = 0; bit < 12; bit++) {
+            memset(&spec, 0, sizeof(spec));
+            spec.dst[src] = (uint16_t)(1u << bit);
+            button_map_compile(&map, &spec);
+            for (uint32_t in = 0; in < SRC_ALL; in += 37)
+                TEST_ASSERT_EQUAL_HEX16(reference(&spec, in),
+                                        button_map_apply(&map, (uint16_t)in));
+        }
+    }
+}
+
+void test_scrambled_mapping_compiles_exactly(void)
+{
+    for (int i = 0; i < BUTTON_MAP_SRC_COUNT; i++)
+        spec.dst[i] = (i % 5 == 4) ? 0 : (uint16_t)(1u << ((i * 7) % 12));
+    assert_compiled_matches(&spec);
+}
+
+/* ── Overrides ────────────────────────────────────────────────────────── */
+
+void test_parse_empty_or_null_keeps_defaults(void)
+{
+    button_map_spec_t def;
+    button_map_default(BUTTON_MAP_PAD_PS, &def);
+
+    spec = def;
+    TEST_ASSERT_TRUE(button_map_parse("", BUTTON_MAP_PAD_PS, &spec));
+    TEST_ASSERT_TRUE(button_map_parse(NULL, BUTTON_MAP_PAD_PS, &spec));
+    TEST_ASSERT_TRUE(button_map_parse(" , ,", BUTTON_MAP_PAD_PS, &spec));
+    TEST_ASSERT_EQUAL_MEMORY(&def, &spec, sizeof(spec));
+}
+
+void test_nintendo_label_layout(void)
+{
+    const char *swap = "switch.a=b,switch.b=a switch.x=y,switch.y=x";
+
+    TEST_ASSERT_TRUE(button_map_build(&map, BUTTON_MAP_PAD_SWITCH, swap));
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_B,
+                            button_map_apply(&map, button_map_pack(BP_A, 0)));
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_A,
+                            button_map_apply(&map, button_map_pack(BP_B, 0)));
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_X,
+                            button_map_apply(&map, button_map_pack(BP_Y, 0)));
+
+    /* Other families are untouched */
+    TEST_ASSERT_FALSE(button_map_build(&map, BUTTON_MAP_PAD_XBOX, swap));
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_A,
+                            button_map_apply(&map, button_map_pack(BP_A, 0)));
+}
+
+void test_unprefixed_entries_apply_to_every_family(void)
+{
+    for (int pad = 0; pad < BUTTON_MAP_PAD_COUNT; pad++) {
+        TEST_ASSERT_TRUE(button_map_build(&map, (button_map_pad_t)pad,
+                                          "l2=l1,capture=none"));
+        TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_L1,
+            button_map_apply(&map, 1u << BUTTON_MAP_SRC_L2));
+        TEST_ASSERT_EQUAL_HEX16(0,
+            button_map_apply(&map, 1u << BUTTON_MAP_SRC_CAPTURE));
+    }
+}
+
+void test_later_entries_win(void)
+{
+    button_map_default(BUTTON_MAP_PAD_OTHER, &spec);
+    TEST_ASSERT_TRUE(button_map_parse("a=x,a=y", BUTTON_MAP_PAD_OTHER,
+                                      &spec));
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_Y, spec.dst[BUTTON_MAP_SRC_A]);
+}
+
+void test_override_equal_to_default_is_not_a_remap(void)
+{
+    TEST_ASSERT_FALSE(button_map_build(&map, BUTTON_MAP_PAD_PS,
+                                       "a=a,capture=misc"));
+}
+
+void test_malformed_entries_rejected(void)
+{
+    static const char *const bad[] = {
+        "a", "=a", "a=", "a=l2", "q=a", "a=q", "gc.a=b", ".a=b",
+        "A=b", "a=b=c", "switch.a", "a=b,oops",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+        TEST_ASSERT_FALSE_MESSAGE(button_map_parse(bad[i],
+                                                   BUTTON_MAP_PAD_OTHER, NULL),
+                                  bad[i]);
+}
+
+void test_malformed_overrides_build_the_default(void)
+{
+    TEST_ASSERT_FALSE(button_map_build(&map, BUTTON_MAP_PAD_OTHER,
+                                       "a=b,bogus"));
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_A,
+                            button_map_apply(&map, button_map_pack(BP_A, 0)));
+}
+
+/* ── Axes ─────────────────────────────────────────────────────────────── */
+
+static const gamepad_report_t s_sample = {
+    .lx = 100, .ly = -200, .rx = 300, .ry = INT16_MIN,
+    .lt = 500, .rt = 1023, .buttons = GAMEPAD_BTN_A, .dpad = 2,
+};
+
+void test_default_axes_stay_put(void)
+{
+    for (int pad = 0; pad < BUTTON_MAP_PAD_COUNT; pad++) {
+        button_map_build(&map, (button_map_pad_t)pad, "");
+        TEST_ASSERT_TRUE(map.axes_identity);
+
+        gamepad_report_t r = s_sample;
+        button_map_apply_axes(&map, &r);
+        TEST_ASSERT_EQUAL_MEMORY(&s_sample, &r, sizeof(r));
+    }
+}
+
+void test_swap_sticks(void)
+{
+    TEST_ASSERT_TRUE(button_map_build(&map, BUTTON_MAP_PAD_OTHER,
+                                      "lx=rx,ly=ry,rx=lx,ry=ly"));
+    gamepad_report_t r = s_sample;
+    button_map_apply_axes(&map, &r);
+
+    TEST_ASSERT_EQUAL_INT16(300, r.lx);
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, r.ly);
+    TEST_ASSERT_EQUAL_INT16(100, r.rx);
+    TEST_ASSERT_EQUAL_INT16(-200, r.ry);
+    TEST_ASSERT_EQUAL_UINT16(500, r.lt);
+    TEST_ASSERT_EQUAL_UINT16(1023, r.rt);
+    TEST_ASSERT_EQUAL_HEX16(GAMEPAD_BTN_A, r.buttons);
+    TEST_ASSERT_EQUAL_UINT8(2, r.dpad);
+}
+
+void test_invert_stick_axes(void)
+{
+    TEST_ASSERT_TRUE(button_map_build(&map, BUTTON_MAP_PAD_OTHER,
+                                      "ly=-ly ry=-ry"));
+    gamepad_report_t r = s_sample;
+    button_map_apply_axes(&map, &r);
+
+    TEST_ASSERT_EQUAL_INT16(100, r.lx);
+    TEST_ASSERT_EQUAL_INT16(200, r.ly);
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, r.ry);     /* -(-32768) saturates */
+    TEST_ASSERT_EQUAL_INT16(300, r.rx);
+}
+
+void test_swap_triggers_and_centre_unmapped(void)
+{
+    TEST_ASSERT_TRUE(button_map_build(&map, BUTTON_MAP_PAD_OTHER,
+                                      "lt=rt,rt=lt,rx=none"));
+    gamepad_report_t r = s_sample;
+    button_map_apply_axes(&map, &r);
+
+    TEST_ASSERT_EQUAL_UINT16(1023, r.lt);
+    TEST_ASSERT_EQUAL_UINT16(500, r.rt);
+    TEST_ASSERT_EQUAL_INT16(0, r.rx);
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, r.ry);
+}
+
+void test_two_sources_on_one_axis_take_the_later(void)
+{
+    /* ly and ry both drive ly; ry is later, and nothing drives ry */
+    TEST_ASSERT_TRUE(button_map_build(&map, BUTTON_MAP_PAD_OTHER, "ry=ly"));
+    gamepad_report_t r = s_sample;
+    button_map_apply_axes(&map, &r);
+
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, r.ly);
+    TEST_ASSERT_EQUAL_INT16(0, r.ry);
+}
+
+void test_axis_overrides_per_family(void)
+{
+    TEST_ASSERT_TRUE(button_map_build(&map, BUTTON_MAP_PAD_PS, "ps.ly=-ly"));
+    TEST_ASSERT_FALSE(map.axes_identity);
+
+    TEST_ASSERT_FALSE(button_map_build(&map, BUTTON_MAP_PAD_XBOX,
+                                       "ps.ly=-ly,lx=lx"));
+    TEST_ASSERT_TRUE(map.axes_identity);
+}
+
+void test_malformed_axis_entries_rejected(void)
+{
+    static const char *const bad[] = {
+        "lx=lt", "lt=lx", "lt=-rt", "lx=", "lx=-", "lx=--lx", "lx=a",
+        "a=lx", "lx=l2", "l2=lt", "LX=lx", "lz=lx",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+        TEST_ASSERT_FALSE_MESSAGE(button_map_parse(bad[i],
+                                                   BUTTON_MAP_PAD_OTHER, NULL),
+                                  bad[i]);
+}
+
+/* ── Benchmark ────────────────────────────────────────────────────────── */
+
+void test_benchmark_against_if_chain(void)
+{
+    const int n = 1000000;
+    uint32_t check_lut = 0, check_chain = 0;
+    button_map_build(&map, BUTTON_MAP_PAD_OTHER, "");
+
+    clock_t start = clock();
+    for (int i = 0; i < n; i++) {
+        uint32_t b = (uint32_t)i & 0x3FF, m = ((uint32_t)i >> 10) & 0x7;
+        check_chain += legacy_map_buttons(b, m);
+    }
+    double chain_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+
+    start = clock();
+    for (int i = 0; i < n; i++) {
+        uint32_t b = (uint32_t)i & 0x3FF, m = ((uint32_t)i >> 10) & 0x7;
+        check_lut += button_map_apply(&map, button_map_pack(b, m));
+    }
+    double lut_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+
+    printf("buttons: if chain %.1f ns, button map %.1f ns (host)\n",
+           chain_ns, lut_ns);
+    TEST_ASSERT_EQUAL_UINT32(check_chain, check_lut);   /* no capture */
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pack_places_misc_after_buttons);
+    RUN_TEST(test_pack_drops_unknown_bits);
+
+    RUN_TEST(test_defaults_match_legacy_chain_plus_misc);
+    RUN_TEST(test_every_default_compiles_exactly);
+    RUN_TEST(test_every_single_source_mapping_compiles_exactly);
+    RUN_TEST(test_scrambled_mapping_compiles_exactly);
+
+    RUN_TEST(test_parse_empty_or_null_keeps_defaults);
+    RUN_TEST(test_nintendo_label_layout);
+    RUN_TEST(test_unprefixed_entries_apply_to_every_family);
+    RUN_TEST(test_later_entries_win);
+    RUN_TEST(test_override_equal_to_default_is_not_a_remap);
+    RUN_TEST(test_malformed_entries_rejected);
+    RUN_TEST(test_malformed_overrides_build_the_default);
+
+    RUN_TEST(test_default_axes_stay_put);
+    RUN_TEST(test_swap_sticks);
+    RUN_TEST(test_invert_stick_axes);
+    RUN_TEST(test_swap_triggers_and_centre_unmapped);
+    RUN_TEST(test_two_sources_on_one_axis_take_the_later);
+    RUN_TEST(test_axis_overrides_per_family);
+    RUN_TEST(test_malformed_axis_entries_rejected);
+
+    RUN_TEST(test_benchmark_against_if_chain);
+
+    return UNITY_END();
+}
@@ -1,5 +1,6 @@
 #include "unity.h"
 #include "device_config.h"
+#include "crc32.h"
 #include <string.h>
 
 static device_config_t cfg;
@@ -107,6 +108,28 @@ void test_validate_empty_device_name(void)
     TEST_ASSERT_FALSE(device_config_validate(&cfg));
 }
 
+void test_validate_wol_mac(void)
+{
+    TEST_ASSERT_EQUAL_STRING("", cfg.wol_mac);      /* WoL off by default */
+
+    strcpy(cfg.wol_mac, "00:1a:2b:3c:4d:5e");
+    TEST_ASSERT_TRUE(device_config_validate(&cfg));
+
+    strcpy(cfg.wol_mac, "00:1a:2b:3c:4d");
+    TEST_ASSERT_FALSE(device_config_validate(&cfg));
+}
+
+void test_validate_button_map(void)
+{
+    TEST_ASSERT_EQUAL_STRING("", cfg.button_map);
+
+    strcpy(cfg.button_map, "switch.a=b,switch.b=a");
+    TEST_ASSERT_TRUE(device_config_validate(&cfg));
+
+    strcpy(cfg.button_map, "a=turbo");
+    TEST_ASSERT_FALSE(device_config_validate(&cfg));
+}
+
 /* ── Serialization roundtrip ─────────────────────────────────────────── */
 
 void test_serialize_returns_positive_length(void)
@@ -278,6 +301,170 @@ void test_serialize_buf_too_small(void)
     TEST_ASSERT_EQUAL_INT(-1, device_config_serialize(&cfg, buf, 10));
 }
 
+/* ── Schema ──────────────────────────────────────────────────────────── */
+
+void test_schema_find_every_field(void)
+{
+    /* Also proves the name hash found a collision-free seed */
+    for (int i = 0; i < DEVICE_CONFIG_FIELD_COUNT; i++)
+        TEST_ASSERT_EQUAL_INT(i, device_config_find(device_config_fields[i].name));
+}
+
+void test_schema_find_unknown(void)
+{
+    TEST_ASSERT_EQUAL_INT(-1, device_config_find("nonexistent"));
+    TEST_ASSERT_EQUAL_INT(-1, device_config_find(""));
+    TEST_ASSERT_EQUAL_INT(-1, device_config_find("device_nam"));
+    TEST_ASSERT_EQUAL_INT(-1, device_config_find("device_name_"));
+    TEST_ASSERT_EQUAL_INT(-1, device_config_find(NULL));
+}
+
+void test_schema_describes_struct(void)
+{
+    const device_config_field_t *f =
+        &device_config_fields[DEVICE_CONFIG_ID_boot_timeout_ms];
+    TEST_ASSERT_EQUAL_STRING("boot_timeout_ms", f->name);
+    TEST_ASSERT_EQUAL(DEVICE_CONFIG_TYPE_U16, f->type);
+    TEST_ASSERT_EQUAL_UINT(offsetof(device_config_t, boot_timeout_ms), f->offset);
+    TEST_ASSERT_EQUAL_UINT16(DEVICE_CONFIG_BOOT_TIMEOUT_MIN, f->lo);
+    TEST_ASSERT_EQUAL_UINT16(DEVICE_CONFIG_BOOT_TIMEOUT_MAX, f->hi);
+
+    f = &device_config_fields[DEVICE_CONFIG_ID_wifi_password];
+    TEST_ASSERT_EQUAL(DEVICE_CONFIG_TYPE_STR, f->type);
+    TEST_ASSERT_EQUAL_UINT(sizeof(cfg.wifi_password), f->size);
+    TEST_ASSERT_TRUE(f->flags & DEVICE_CONFIG_F_SECRET);
+}
+
+/* ── TLV format and migration ────────────────────────────────────────── */
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    put_le16(p, (uint16_t)v);
+    put_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+/** Wrap raw records in a v2+ header and CRC; returns total length. */
+static size_t make_tlv(uint16_t version, const uint8_t *records, size_t n)
+{
+    put_le32(buf, 0x50434647);
+    put_le16(buf + 4, version);
+    put_le16(buf + 6, (uint16_t)n);
+    memcpy(buf + 8, records, n);
+    put_le32(buf + 8 + n, crc32_update(0, buf, 8 + n));
+    return 8 + n + 4;
+}
+
+void test_serialize_defaults_is_header_only(void)
+{
+    TEST_ASSERT_EQUAL_INT(8 + 4, device_config_serialize(&cfg, buf, sizeof(buf)));
+}
+
+void test_serialize_stores_only_changed_fields(void)
+{
+    cfg.boot_timeout_ms = 0x5678;
+    int n = device_config_serialize(&cfg, buf, sizeof(buf));
+
+    const uint8_t expect[] = { DEVICE_CONFIG_ID_boot_timeout_ms, 2, 0x78, 0x56 };
+    TEST_ASSERT_EQUAL_INT(8 + 4 + 4, n);
+    TEST_ASSERT_EQUAL_HEX8(4, buf[6]);
+    TEST_ASSERT_EQUAL_MEMORY(expect, buf + 8, sizeof(expect));
+}
+
+void test_serialize_strings_without_padding(void)
+{
+    strcpy(cfg.device_name, "Den");
+    int n = device_config_serialize(&cfg, buf, sizeof(buf));
+
+    const uint8_t expect[] = { DEVICE_CONFIG_ID_device_name, 3, 'D', 'e', 'n' };
+    TEST_ASSERT_EQUAL_INT(8 + 5 + 4, n);
+    TEST_ASSERT_EQUAL_MEMORY(expect, buf + 8, sizeof(expect));
+}
+
+void test_migrate_v1_blob(void)
+{
+    /* Fixed layout written by v1 firmware */
+    memset(buf, 0, sizeof(buf));
+    put_le32(buf, 0x50434647);
+    put_le16(buf + 4, 1);
+    strcpy((char *)buf + 6, "OldNet");
+    strcpy((char *)buf + 6 + 33, "OldPass");
+    put_le16(buf + 6 + 33 + 64, 350);
+    put_le16(buf + 6 + 33 + 64 + 2, 20000);
+    strcpy((char *)buf + 6 + 33 + 64 + 4, "OldPad");
+    put_le32(buf + 6 + 134, crc32_update(0, buf, 6 + 134));
+
+    device_config_t loaded;
+    TEST_ASSERT_TRUE(device_config_deserialize(&loaded, buf, 6 + 134 + 4));
+    TEST_ASSERT_EQUAL_STRING("OldNet", loaded.wifi_ssid);
+    TEST_ASSERT_EQUAL_STRING("OldPass", loaded.wifi_password);
+    TEST_ASSERT_EQUAL_UINT16(350, loaded.power_pulse_ms);
+    TEST_ASSERT_EQUAL_UINT16(20000, loaded.boot_timeout_ms);
+    TEST_ASSERT_EQUAL_STRING("OldPad", loaded.device_name);
+}
+
+void test_tlv_skips_unknown_tags(void)
+{
+    const uint8_t rec[] = {
+        200, 3, 'x', 'y', 'z',                       /* from newer firmware */
+        DEVICE_CONFIG_ID_power_pulse_ms, 2, 0x2C, 0x01,  /* 300 */
+    };
+    size_t n = make_tlv(2, rec, sizeof(rec));
+
+    device_config_t loaded;
+    TEST_ASSERT_TRUE(device_config_deserialize(&loaded, buf, n));
+    TEST_ASSERT_EQUAL_UINT16(300, loaded.power_pulse_ms);
+    TEST_ASSERT_EQUAL_STRING(DEVICE_CONFIG_DEFAULT_DEVICE_NAME,
+                             loaded.device_name);
+}
+
+void test_tlv_unusable_value_keeps_default(void)
+{
+    const uint8_t rec[] = {
+        DEVICE_CONFIG_ID_power_pulse_ms, 2, 10, 0,        /* below minimum */
+        DEVICE_CONFIG_ID_boot_timeout_ms, 3, 1, 2, 3,     /* wrong width */
+        DEVICE_CONFIG_ID_device_name, 0,                  /* too short */
+        DEVICE_CONFIG_ID_wifi_ssid, 4, 'H', 'o', 'm', 'e',
+        DEVICE_CONFIG_ID_wol_mac, 4, 'n', 'o', 'p', 'e',  /* not a MAC */
+    };
+    size_t n = make_tlv(2, rec, sizeof(rec));
+
+    device_config_t loaded;
+    TEST_ASSERT_TRUE(device_config_deserialize(&loaded, buf, n));
+    TEST_ASSERT_EQUAL_UINT16(DEVICE_CONFIG_DEFAULT_POWER_PULSE_MS,
+                             loaded.power_pulse_ms);
+    TEST_ASSERT_EQUAL_UINT16(DEVICE_CONFIG_DEFAULT_BOOT_TIMEOUT_MS,
+                             loaded.boot_timeout_ms);
+    TEST_ASSERT_EQUAL_STRING(DEVICE_CONFIG_DEFAULT_DEVICE_NAME,
+                             loaded.device_name);
+    TEST_ASSERT_EQUAL_STRING("Home", loaded.wifi_ssid);
+    TEST_ASSERT_EQUAL_STRING("", loaded.wol_mac);
+}
+
+void test_tlv_truncated_record_rejected(void)
+{
+    const uint8_t rec[] = { DEVICE_CONFIG_ID_wifi_ssid, 9, 'a', 'b' };
+    size_t n = make_tlv(2, rec, sizeof(rec));
+
+    device_config_t loaded;
+    TEST_ASSERT_FALSE(device_config_deserialize(&loaded, buf, n));
+}
+
+void test_tlv_newer_version_is_readable(void)
+{
+    const uint8_t rec[] = { DEVICE_CONFIG_ID_device_name, 2, 'H', 'i' };
+    size_t n = make_tlv(7, rec, sizeof(rec));
+
+    device_config_t loaded;
+    TEST_ASSERT_TRUE(device_config_deserialize(&loaded, buf, n));
+    TEST_ASSERT_EQUAL_STRING("Hi", loaded.device_name);
+}
+
 /* ── Test runner ──────────────────────────────────────────────────────── */
 
 int main(void)
@@ -302,6 +489,8 @@ int main(void)
     RUN_TEST(test_validate_boot_timeout_at_min);
     RUN_TEST(test_validate_boot_timeout_at_max);
     RUN_TEST(test_validate_empty_device_name);
+    RUN_TEST(test_validate_wol_mac);
+    RUN_TEST(test_validate_button_map);
 
     /* Serialization roundtrip */
     RUN_TEST(test_serialize_returns_positive_length);
@@ -325,5 +514,20 @@ int main(void)
     RUN_TEST(test_serialize_null_buf);
     RUN_TEST(test_serialize_buf_too_small);
 
+    /* Schema */
+    RUN_TEST(test_schema_find_every_field);
+    RUN_TEST(test_schema_find_unknown);
+    RUN_TEST(test_schema_describes_struct);
+
+    /* TLV format and migration */
+    RUN_TEST(test_serialize_defaults_is_header_only);
+    RUN_TEST(test_serialize_stores_only_changed_fields);
+    RUN_TEST(test_serialize_strings_without_padding);
+    RUN_TEST(test_migrate_v1_blob);
+    RUN_TEST(test_tlv_skips_unknown_tags);
+    RUN_TEST(test_tlv_unusable_value_keeps_default);
+    RUN_TEST(test_tlv_truncated_record_rejected);
+    RUN_TEST(test_tlv_newer_version_is_readable);
+
     return UNITY_END();
 }
@@ -2,10 +2,16 @@
  * Device Integration Tests
  *
  * End-to-end tests for PadProxy with mocked hardware interfaces.
- * Exercises the full event pipeline: BT input → state machine → USB output.
+ * Exercises the full event pipeline: BT input → state machine → USB output,
+ * for up to BT_GAMEPAD_MAX controllers at once.
  *
- * Real modules:  pc_power_state.c, usb_hid_report.c, gamepad.h
+ * Real modules:  pc_power_state.c, pc_power_fusion.c, power_led.c,
+ *                button_latch.c, report_filter.c, usb_report_pipe.c,
+ *                output_coalesce.c, motion_mux.c, usb_hid_report.c,
+ *                axis_curve.c, gamepad.h
  * Mocked:        pc_power_hal, bt_gamepad, usb_hid_gamepad
+ *                (the mock USB device speaks generic HID; takes_raw
+ *                simulates a personality that forwards native reports)
  *
  * The test harness replicates main.c's orchestration logic so we can drive
  * realistic scenarios (controller connect, PC wake, gamepad input forwarding)
@@ -16,6 +22,12 @@
 #include "gamepad.h"
 #include "pc_power_state.h"
 #include "pc_power_hal.h"
+#include "pc_power_fusion.h"
+#include "power_led.h"
+#include "button_latch.h"
+#include "report_filter.h"
+#include "output_coalesce.h"
+#include "axis_curve.h"
 #include "usb_hid_gamepad.h"
 #include "bt_gamepad.h"
 #include "usb_hid_report.h"
@@ -24,9 +36,20 @@
 
 /* ── Mock: PC power HAL ─────────────────────────────────────────────── */
 
+/*
+ * LED edges: the mock "IRQ" reports a change of power_led as an edge
+ * stamped at the current tick, like a polled read would have seen it.
+ * Tests can also queue exact sub-tick edges with inject_led_edge().
+ */
+#define MOCK_LED_EDGES 16
+
 static struct {
     uint32_t millis;
     bool     power_led;
+    bool     led_reported;           /* level last returned as an edge */
+    pc_power_led_edge_t led_edges[MOCK_LED_EDGES];
+    int      led_edge_head;
+    int      led_edge_count;
     bool     boot_timer_running;
     uint32_t boot_timer_start_ms;
     uint32_t boot_timer_timeout_ms;
@@ -37,6 +60,27 @@ static struct {
 void pc_power_hal_init(void) { }
 bool pc_power_hal_read_power_led(void) { return s_hal.power_led; }
 uint32_t pc_power_hal_millis(void) { return s_hal.millis; }
+uint32_t pc_power_hal_micros(void) { return s_hal.millis * 1000u; }
+uint32_t pc_power_hal_led_edges_dropped(void) { return 0; }
+bool pc_power_hal_has_vbus_sense(void) { return false; }
+bool pc_power_hal_read_vbus(void) { return false; }
+void pc_power_hal_set_led_edge_cb(void (*cb)(void)) { (void)cb; }
+
+bool pc_power_hal_pop_led_edge(pc_power_led_edge_t *edge)
+{
+    if (s_hal.led_edge_head < s_hal.led_edge_count) {
+        *edge = s_hal.led_edges[s_hal.led_edge_head++];
+        s_hal.led_reported = edge->on;
+        return true;
+    }
+    if (s_hal.power_led != s_hal.led_reported) {
+        edge->on      = s_hal.power_led;
+        edge->time_us = pc_power_hal_micros();
+        s_hal.led_reported = s_hal.power_led;
+        return true;
+    }
+    return false;
+}
 
 void pc_power_hal_trigger_power_button(uint32_t duration_ms)
 {
@@ -70,49 +114,246 @@ bool pc_power_hal_boot_timer_expired(void)
 /* ── Mock: Bluetooth gamepad ────────────────────────────────────────── */
 
 static struct {
-    bool                  connected;
-    gamepad_report_t      report;
+    bool                  connected[BT_GAMEPAD_MAX];
+    gamepad_report_t      report[BT_GAMEPAD_MAX];
+    uint16_t              pressed[BT_GAMEPAD_MAX];  /* since last read */
+    gamepad_motion_t      motion[BT_GAMEPAD_MAX];
+    bool                  motion_new[BT_GAMEPAD_MAX];
+    gamepad_output_t      output[BT_GAMEPAD_MAX];   /* last rumble/LEDs */
+    bt_gamepad_raw_t      raw[BT_GAMEPAD_MAX];      /* native reports */
+    bool                  raw_new[BT_GAMEPAD_MAX];
+    int                   output_count[BT_GAMEPAD_MAX];
     bt_gamepad_event_cb_t event_cb;
 } s_bt;
 
 void bt_gamepad_init(bt_gamepad_event_cb_t cb) { s_bt.event_cb = cb; }
-bool bt_gamepad_is_connected(uint8_t idx)  { (void)idx; return s_bt.connected; }
 void bt_gamepad_set_pairing(bool enabled)  { (void)enabled; }
 
-bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report)
+bool bt_gamepad_is_connected(uint8_t idx)
 {
-    (void)idx;
-    if (!s_bt.connected) return false;
-    *report = s_bt.report;
+    return idx < BT_GAMEPAD_MAX && s_bt.connected[idx];
+}
+
+uint8_t bt_gamepad_connected_count(void)
+{
+    uint8_t n = 0;
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        n += s_bt.connected[i];
+    return n;
+}
+
+bool bt_gamepad_get_report(uint8_t idx, gamepad_report_t *report,
+                           uint16_t *pressed)
+{
+    if (!bt_gamepad_is_connected(idx)) return false;
+    *report = s_bt.report[idx];
+    if (pressed) *pressed = s_bt.pressed[idx];
+    s_bt.pressed[idx] = 0;
+    return true;
+}
+
+bool bt_gamepad_get_motion(uint8_t idx, gamepad_motion_t *motion)
+{
+    if (!bt_gamepad_is_connected(idx) || !s_bt.motion_new[idx]) return false;
+    *motion = s_bt.motion[idx];
+    s_bt.motion_new[idx] = false;
     return true;
 }
 
+bt_gamepad_raw_kind_t bt_gamepad_raw_kind(uint8_t idx)
+{
+    return bt_gamepad_is_connected(idx) ? s_bt.raw[idx].kind
+                                        : BT_GAMEPAD_RAW_NONE;
+}
+
+bool bt_gamepad_get_raw(uint8_t idx, bt_gamepad_raw_t *raw)
+{
+    if (!bt_gamepad_is_connected(idx) || !s_bt.raw_new[idx]) return false;
+    *raw = s_bt.raw[idx];
+    s_bt.raw_new[idx] = false;
+    return true;
+}
+
+void bt_gamepad_set_output(uint8_t idx, const gamepad_output_t *out)
+{
+    s_bt.output[idx] = *out;
+    s_bt.output_count[idx]++;
+}
+
 /* ── Mock: USB HID gamepad ──────────────────────────────────────────── */
 
+/*
+ * One interrupt IN endpoint per player, fed through a real usb_report_pipe
+ * as in usb_hid_gamepad.c.  With ep_interval_ms set, a submitted report
+ * stays in flight until the host's next poll, which usb_hid_gamepad_task()
+ * completes like tud_hid_report_complete_cb(); 0 means the host takes
+ * every report at once.  report_count counts submissions.  The motion
+ * endpoint is polled every tick and takes one motion_mux sample.
+ *
+ * Converted reports are generic HID; with takes_raw set, native reports
+ * go out as their first USB_REPORT_MAX bytes, counted in native_count.
+ */
 static struct {
     usb_hid_state_t      state;
     usb_hid_state_cb_t   state_cb;
-    usb_gamepad_report_t last_report;
+    usb_hid_ready_cb_t   ready_cb;
+    usb_hid_output_cb_t  output_cb;
+    int                  ready_count;
+    usb_report_pipe_t    pipe[BT_GAMEPAD_MAX];
+    motion_mux_t         motion;
+    bool                 motion_busy;
+    int                  motion_count[BT_GAMEPAD_MAX];
+    usb_motion_report_t  motion_report[BT_GAMEPAD_MAX];
+    usb_gamepad_report_t last_report;         /* any player */
     bool                 report_sent;
     int                  report_count;
+    usb_gamepad_report_t player_report[BT_GAMEPAD_MAX];
+    int                  player_count[BT_GAMEPAD_MAX];
+    bool                 takes_raw;
+    int                  native_count[BT_GAMEPAD_MAX];
+    uint8_t              native_report[BT_GAMEPAD_MAX][USB_REPORT_MAX];
+    uint16_t             mode;
+    uint32_t             ep_interval_ms;
+    uint32_t             ep_busy_until[BT_GAMEPAD_MAX];
+    bool                 remote_wakeup_en;    /* host arms at suspend */
+    bool                 remote_wakeup_fails; /* signalling fails     */
+    int                  remote_wakeup_count;
 } s_usb;
 
-void usb_hid_gamepad_init(usb_hid_state_cb_t cb)
+void usb_hid_gamepad_init(usb_hid_state_cb_t cb, uint16_t mode)
 {
     s_usb.state_cb = cb;
     s_usb.state    = USB_HID_NOT_MOUNTED;
+    s_usb.mode     = mode;
 }
 
-void usb_hid_gamepad_task(void) { }
+void usb_hid_gamepad_set_mode(uint16_t mode) { s_usb.mode = mode; }
+const char *usb_hid_gamepad_mode_name(void) { return "hid"; }
 
-usb_hid_state_t usb_hid_gamepad_get_state(void) { return s_usb.state; }
+bool usb_hid_gamepad_takes_raw(bt_gamepad_raw_kind_t kind)
+{
+    return s_usb.takes_raw && kind != BT_GAMEPAD_RAW_NONE;
+}
+
+void usb_hid_gamepad_set_ready_cb(usb_hid_ready_cb_t cb)
+{
+    s_usb.ready_cb = cb;
+}
+
+void usb_hid_gamepad_set_output_cb(usb_hid_output_cb_t cb)
+{
+    s_usb.output_cb = cb;
+}
+
+const usb_report_pipe_t *usb_hid_gamepad_pipe(uint8_t idx)
+{
+    return &s_usb.pipe[idx < BT_GAMEPAD_MAX ? idx : 0];
+}
 
-bool usb_hid_gamepad_send_report(const gamepad_report_t *report)
+static void mock_usb_pump_motion(void)
 {
-    if (s_usb.state != USB_HID_MOUNTED) return false;
-    usb_hid_report_from_gamepad(report, &s_usb.last_report);
+    uint8_t idx;
+    gamepad_motion_t sample;
+    if (s_usb.motion_busy || !motion_mux_take(&s_usb.motion, &idx, &sample))
+        return;
+    usb_hid_report_from_motion(&sample, &s_usb.motion_report[idx]);
+    s_usb.motion_count[idx]++;
+    s_usb.motion_busy = true;
+}
+
+const motion_mux_t *usb_hid_gamepad_motion(void) { return &s_usb.motion; }
+
+bool usb_hid_gamepad_send_motion(uint8_t idx, const gamepad_motion_t *motion)
+{
+    if (s_usb.state != USB_HID_MOUNTED || idx >= BT_GAMEPAD_MAX) return false;
+    motion_mux_push(&s_usb.motion, idx, motion);
+    mock_usb_pump_motion();
+    return true;
+}
+
+static void mock_usb_pump(uint8_t idx)
+{
+    usb_report_t r;
+    if (!usb_report_pipe_next(&s_usb.pipe[idx], &r))
+        return;
+
+    s_usb.ep_busy_until[idx]  = s_hal.millis + s_usb.ep_interval_ms;
+    if (r.len == sizeof(usb_gamepad_report_t)) {
+        memcpy(&s_usb.player_report[idx], r.data, r.len);
+        s_usb.last_report = s_usb.player_report[idx];
+    } else {
+        memcpy(s_usb.native_report[idx], r.data, r.len);
+        s_usb.native_count[idx]++;
+    }
+    s_usb.player_count[idx]++;
     s_usb.report_sent = true;
     s_usb.report_count++;
+
+    if (!s_usb.ep_interval_ms)
+        usb_report_pipe_complete(&s_usb.pipe[idx]);
+}
+
+void usb_hid_gamepad_task(void)
+{
+    s_usb.motion_busy = false;      /* host polled the motion endpoint */
+    mock_usb_pump_motion();
+
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        usb_report_pipe_t *p = &s_usb.pipe[i];
+        if (!p->in_flight ||
+            (int32_t)(s_hal.millis - s_usb.ep_busy_until[i]) < 0)
+            continue;
+
+        bool refused = usb_report_pipe_complete(p);
+        mock_usb_pump(i);
+        if (refused && s_usb.ready_cb)
+            s_usb.ready_cb(i);
+    }
+}
+
+usb_hid_state_t usb_hid_gamepad_get_state(void) { return s_usb.state; }
+
+bool usb_hid_gamepad_remote_wakeup_armed(void)
+{
+    return s_usb.state == USB_HID_SUSPENDED && s_usb.remote_wakeup_en;
+}
+
+bool usb_hid_gamepad_remote_wakeup(void)
+{
+    s_usb.remote_wakeup_count++;
+    return usb_hid_gamepad_remote_wakeup_armed() && !s_usb.remote_wakeup_fails;
+}
+
+bool usb_hid_gamepad_send_report(uint8_t idx, const gamepad_report_t *report)
+{
+    if (s_usb.state != USB_HID_MOUNTED || idx >= BT_GAMEPAD_MAX) return false;
+
+    usb_gamepad_report_t hid;
+    usb_report_t r;
+    usb_hid_report_from_gamepad(report, &hid);
+    r.buttons = report->buttons;
+    r.dpad    = report->dpad;
+    r.len     = sizeof(hid);
+    memcpy(r.data, &hid, sizeof(hid));
+    if (!usb_report_pipe_push(&s_usb.pipe[idx], &r))
+        return false;
+    mock_usb_pump(idx);
+    return true;
+}
+
+bool usb_hid_gamepad_send_raw(uint8_t idx, const gamepad_report_t *report,
+                              const bt_gamepad_raw_t *raw)
+{
+    if (s_usb.state != USB_HID_MOUNTED || idx >= BT_GAMEPAD_MAX) return false;
+
+    usb_report_t r;
+    r.buttons = report->buttons;
+    r.dpad    = report->dpad;
+    r.len     = USB_REPORT_MAX;
+    memcpy(r.data, raw->data, USB_REPORT_MAX);
+    if (!usb_report_pipe_push(&s_usb.pipe[idx], &r))
+        return false;
+    mock_usb_pump(idx);
     return true;
 }
 
@@ -120,103 +361,193 @@ bool usb_hid_gamepad_send_report(const gamepad_report_t *report)
 
 #define POWER_PULSE_MS      200
 #define BOOT_TIMEOUT_MS     30000
-#define POWER_LED_STABLE_MS 3000
+#define POWER_LED_HOLD_MS   1500
+#define REMOTE_WAKEUP_TIMEOUT_MS 5000
+#define USB_KEEPALIVE_MS    100
+#define OUTPUT_INTERVAL_MS  25
 
 static pc_power_sm_t    s_sm;
-static gamepad_report_t s_prev_report;
-static bool             s_prev_report_valid;
-
-/** Debounced power-LED state (mirrors main.c). */
-static bool     s_led_reading;
-static bool     s_led_debounced;
-static uint32_t s_led_changed_ms;
+static gamepad_report_t s_prev_report[BT_GAMEPAD_MAX];
+static bool             s_prev_report_valid[BT_GAMEPAD_MAX];
+static button_latch_t   s_latch[BT_GAMEPAD_MAX];
+static report_filter_t  s_filter[BT_GAMEPAD_MAX];
+static output_coalesce_t s_output[BT_GAMEPAD_MAX];
+static axis_curve_set_t s_curves;
+
+/** Power-LED pattern classifier and signal fusion (mirrors main.c). */
+static power_led_t s_led;
+static pc_fusion_t s_fusion;
+
+typedef enum {
+    WAKE_NONE,
+    WAKE_USB,
+    WAKE_BUTTON,
+    WAKE_FALLBACK,
+} wake_method_t;
+
+static wake_method_t s_wake_method;
+static uint32_t      s_wake_start_ms;
+static uint32_t      s_wake_ms[WAKE_FALLBACK + 1];  /* last latency */
+static uint32_t      s_wake_fallbacks;
+static int           s_wol_count;
+
+static void track_wake(pc_power_state_t state, uint32_t now_ms)
+{
+    if (s_wake_method == WAKE_NONE)
+        return;
+
+    if (state == PC_STATE_ON) {
+        s_wake_ms[s_wake_method] = now_ms - s_wake_start_ms;
+        s_wake_method = WAKE_NONE;
+    } else if (state == PC_STATE_OFF || state == PC_STATE_SLEEPING) {
+        s_wake_method = WAKE_NONE;
+    }
+}
 
-static void dispatch_actions(uint32_t actions)
+static void dispatch_actions(const pc_power_result_t *r, uint32_t now_ms)
 {
-    if (actions & PC_ACTION_TRIGGER_POWER)
+    uint32_t timeout_ms = pc_power_sm_boot_timeout(&s_sm, BOOT_TIMEOUT_MS);
+
+    if (r->actions & PC_ACTION_USB_REMOTE_WAKEUP)
+        timeout_ms = usb_hid_gamepad_remote_wakeup() ? REMOTE_WAKEUP_TIMEOUT_MS
+                                                     : 0;
+    if (r->actions & PC_ACTION_TRIGGER_POWER) {
         pc_power_hal_trigger_power_button(POWER_PULSE_MS);
-    if (actions & PC_ACTION_START_BOOT_TIMER)
-        pc_power_hal_start_boot_timer(BOOT_TIMEOUT_MS);
-    if (actions & PC_ACTION_CANCEL_BOOT_TIMER)
+        if (s_wake_method == WAKE_USB) {
+            s_wake_method = WAKE_FALLBACK;
+            s_wake_fallbacks++;
+        }
+    }
+    if (r->actions & PC_ACTION_SEND_WOL)
+        s_wol_count++;
+    if (r->actions & PC_ACTION_START_BOOT_TIMER)
+        pc_power_hal_start_boot_timer(timeout_ms);
+    if (r->actions & PC_ACTION_CANCEL_BOOT_TIMER)
         pc_power_hal_cancel_boot_timer();
+    if (r->transitioned)
+        track_wake(r->new_state, now_ms);
+}
+
+static void fuse_power_signals(uint32_t now_ms)
+{
+    pc_power_event_t event;
+    if (!pc_fusion_update(&s_fusion, now_ms, &event))
+        return;
+
+    pc_power_result_t r = pc_power_sm_process(&s_sm, event, now_ms);
+    dispatch_actions(&r, now_ms);
 }
 
 static void on_usb_state_change(usb_hid_state_t state)
 {
     uint32_t now = pc_power_hal_millis();
-    pc_power_result_t r;
 
     switch (state) {
     case USB_HID_MOUNTED:
-        r = pc_power_sm_process(&s_sm, PC_EVENT_USB_ENUMERATED, now);
-        dispatch_actions(r.actions);
+        for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+            report_filter_reset(&s_filter[i]);
+        pc_fusion_set_usb(&s_fusion, PC_FUSION_USB_MOUNTED, now);
         break;
     case USB_HID_SUSPENDED:
+        pc_fusion_set_usb(&s_fusion, PC_FUSION_USB_SUSPENDED, now);
+        break;
     case USB_HID_NOT_MOUNTED:
-        r = pc_power_sm_process(&s_sm, PC_EVENT_USB_SUSPENDED, now);
-        dispatch_actions(r.actions);
+        pc_fusion_set_usb(&s_fusion, PC_FUSION_USB_DETACHED, now);
         break;
     }
+    if (state != USB_HID_MOUNTED) {
+        const gamepad_output_t off = { 0, 0, 0 };
+        for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+            output_coalesce_set(&s_output[i], &off);
+    }
+    pc_power_sm_set_remote_wakeup(&s_sm, usb_hid_gamepad_remote_wakeup_armed());
+    fuse_power_signals(now);
 }
 
-static void on_bt_event(uint8_t idx, bt_gamepad_state_t state)
+/** A refused report can go now; main.c wakes the gamepad task here. */
+static void on_usb_ready(uint8_t idx)
 {
     (void)idx;
-    if (state == BT_GAMEPAD_DISCONNECTED)
-        s_prev_report_valid = false;
+    s_usb.ready_count++;
+}
+
+static void on_bt_event(uint8_t idx, bt_gamepad_state_t state)
+{
+    if (state == BT_GAMEPAD_DISCONNECTED) {
+        s_prev_report_valid[idx] = false;
+        button_latch_reset(&s_latch[idx]);
+        report_filter_reset(&s_filter[idx]);
+        output_coalesce_reset(&s_output[idx]);
+    }
+}
+
+static void on_usb_output(uint8_t idx, const gamepad_output_t *out)
+{
+    output_coalesce_set(&s_output[idx], out);
 }
 
 static void device_poll_hardware(uint32_t now_ms)
 {
-    bool led = pc_power_hal_read_power_led();
+    pc_power_led_edge_t edge;
     pc_power_result_t r;
 
-    /* Reset debounce timer whenever the raw reading changes */
-    if (led != s_led_reading) {
-        s_led_reading    = led;
-        s_led_changed_ms = now_ms;
-    }
+    while (pc_power_hal_pop_led_edge(&edge))
+        power_led_edge(&s_led, edge.on, edge.time_us);
 
-    /* Emit an edge event only after the reading has been stable */
-    if (s_led_reading != s_led_debounced &&
-        (now_ms - s_led_changed_ms) >= POWER_LED_STABLE_MS) {
-        s_led_debounced = s_led_reading;
-        if (s_led_debounced) {
-            r = pc_power_sm_process(&s_sm, PC_EVENT_POWER_LED_ON, now_ms);
-        } else {
-            r = pc_power_sm_process(&s_sm, PC_EVENT_POWER_LED_OFF, now_ms);
-        }
-        dispatch_actions(r.actions);
-    }
+    power_led_update(&s_led, pc_power_hal_micros());
+    pc_fusion_set_led(&s_fusion, power_led_pattern(&s_led), s_led.level,
+                      now_ms);
+    fuse_power_signals(now_ms);
 
     if (pc_power_hal_boot_timer_expired()) {
         r = pc_power_sm_process(&s_sm, PC_EVENT_BOOT_TIMEOUT, now_ms);
-        dispatch_actions(r.actions);
+        dispatch_actions(&r, now_ms);
     }
 }
 
-static void device_process_gamepad(const gamepad_report_t *report,
-                                   uint32_t now_ms)
+static void device_process_gamepad(uint8_t idx,
+                                   const gamepad_report_t *sample,
+                                   const bt_gamepad_raw_t *raw,
+                                   uint16_t pressed, uint32_t now_ms)
 {
     pc_power_state_t st = pc_power_sm_get_state(&s_sm);
+    gamepad_report_t report = *sample;
+    report.buttons = button_latch_merge(&s_latch[idx], sample->buttons,
+                                        pressed);
+    axis_curve_set_apply(&s_curves, &report);
 
-    bool guide_now  = gamepad_report_guide_pressed(report);
-    bool guide_prev = s_prev_report_valid &&
-                      gamepad_report_guide_pressed(&s_prev_report);
+    bool guide_now  = gamepad_report_guide_pressed(&report);
+    bool guide_prev = s_prev_report_valid[idx] &&
+                      gamepad_report_guide_pressed(&s_prev_report[idx]);
 
     if (guide_now && !guide_prev) {
         if (st == PC_STATE_OFF || st == PC_STATE_SLEEPING) {
             pc_power_result_t r = pc_power_sm_process(
                 &s_sm, PC_EVENT_WAKE_REQUESTED, now_ms);
-            dispatch_actions(r.actions);
+            if (st == PC_STATE_SLEEPING) {
+                s_wake_method = r.new_state == PC_STATE_WAKING ? WAKE_USB
+                                                               : WAKE_BUTTON;
+                s_wake_start_ms = now_ms;
+            }
+            dispatch_actions(&r, now_ms);
         }
     }
 
-    if (st == PC_STATE_ON)
-        usb_hid_gamepad_send_report(report);
+    bool consumed = true;
+    if (st == PC_STATE_ON &&
+        report_filter_check(&s_filter[idx], &report, now_ms)) {
+        bool native = raw && report.buttons == sample->buttons &&
+                      s_curves.identity;
+        consumed = native ? usb_hid_gamepad_send_raw(idx, &report, raw)
+                          : usb_hid_gamepad_send_report(idx, &report);
+        if (consumed)
+            report_filter_sent(&s_filter[idx], &report, now_ms);
+    }
+    if (consumed)
+        button_latch_sent(&s_latch[idx], report.buttons);
 
-    s_prev_report       = *report;
-    s_prev_report_valid = true;
+    s_prev_report[idx]       = report;
+    s_prev_report_valid[idx] = true;
 }
 
 /* ── Device lifecycle ───────────────────────────────────────────────── */
@@ -226,15 +557,33 @@ static void device_init(void)
     memset(&s_hal, 0, sizeof(s_hal));
     memset(&s_bt,  0, sizeof(s_bt));
     memset(&s_usb, 0, sizeof(s_usb));
-    memset(&s_prev_report, 0, sizeof(s_prev_report));
-    s_prev_report_valid = false;
+    memset(s_prev_report, 0, sizeof(s_prev_report));
+    memset(s_prev_report_valid, 0, sizeof(s_prev_report_valid));
+    memset(s_latch, 0, sizeof(s_latch));
+
+    report_filter_config_t filter = { { 0 }, USB_KEEPALIVE_MS };
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++) {
+        report_filter_init(&s_filter[i], &filter);
+        output_coalesce_init(&s_output[i], OUTPUT_INTERVAL_MS,
+                             BT_GAMEPAD_RUMBLE_MS / 2);
+    }
+    const axis_curve_cfg_t linear = { 0, 0, 0, 0 };
+    axis_curve_set_init(&s_curves, &linear, &linear, &linear);
+    s_wake_method = WAKE_NONE;
+    memset(s_wake_ms, 0, sizeof(s_wake_ms));
+    s_wake_fallbacks = 0;
+    s_wol_count = 0;
 
     pc_power_sm_init(&s_sm);
-    s_led_reading    = pc_power_hal_read_power_led();
-    s_led_debounced  = s_led_reading;
-    s_led_changed_ms = 0;
-
-    usb_hid_gamepad_init(on_usb_state_change);
+    power_led_init(&s_led, pc_power_hal_read_power_led(),
+                   POWER_LED_HOLD_MS);
+    pc_fusion_init(&s_fusion, power_led_pattern(&s_led), s_led.level,
+                   pc_power_hal_has_vbus_sense(), pc_power_hal_read_vbus(),
+                   pc_power_hal_millis());
+
+    usb_hid_gamepad_init(on_usb_state_change, 0);
+    usb_hid_gamepad_set_ready_cb(on_usb_ready);
+    usb_hid_gamepad_set_output_cb(on_usb_output);
     bt_gamepad_init(on_bt_event);
 }
 
@@ -246,33 +595,109 @@ static void device_tick(uint32_t now_ms)
     device_poll_hardware(now_ms);
 
     gamepad_report_t report;
-    if (bt_gamepad_get_report(0, &report))
-        device_process_gamepad(&report, now_ms);
+    gamepad_motion_t motion;
+    gamepad_output_t output;
+    bt_gamepad_raw_t raw;
+    uint16_t pressed;
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        if (bt_gamepad_get_report(i, &report, &pressed)) {
+            bool native = usb_hid_gamepad_takes_raw(bt_gamepad_raw_kind(i)) &&
+                          bt_gamepad_get_raw(i, &raw);
+            device_process_gamepad(i, &report, native ? &raw : NULL, pressed,
+                                   now_ms);
+        }
+        if (bt_gamepad_get_motion(i, &motion))
+            usb_hid_gamepad_send_motion(i, &motion);
+        if (bt_gamepad_is_connected(i) &&
+            output_coalesce_take(&s_output[i], now_ms, &output))
+            bt_gamepad_set_output(i, &output);
+    }
 }
 
 /* ── Test injection helpers ─────────────────────────────────────────── */
 
-static void inject_bt_connect(void)
+static void inject_pad_connect(uint8_t idx)
+{
+    s_bt.connected[idx] = true;
+    s_bt.pressed[idx]   = 0;
+    memset(&s_bt.report[idx], 0, sizeof(s_bt.report[idx]));
+    s_bt.report[idx].dpad = GAMEPAD_DPAD_CENTERED;
+    if (s_bt.event_cb) s_bt.event_cb(idx, BT_GAMEPAD_CONNECTED);
+}
+
+static void inject_pad_disconnect(uint8_t idx)
 {
-    s_bt.connected = true;
-    memset(&s_bt.report, 0, sizeof(s_bt.report));
-    s_bt.report.dpad = GAMEPAD_DPAD_CENTERED;
-    if (s_bt.event_cb) s_bt.event_cb(0, BT_GAMEPAD_CONNECTED);
+    s_bt.connected[idx] = false;
+    if (s_bt.event_cb) s_bt.event_cb(idx, BT_GAMEPAD_DISCONNECTED);
 }
 
-static void inject_bt_disconnect(void)
+/** A BT packet: accumulates press edges like bt_gamepad.c. */
+static void inject_pad_report(uint8_t idx, const gamepad_report_t *r)
 {
-    s_bt.connected = false;
-    if (s_bt.event_cb) s_bt.event_cb(0, BT_GAMEPAD_DISCONNECTED);
+    s_bt.pressed[idx] |= r->buttons & ~s_bt.report[idx].buttons;
+    s_bt.report[idx]   = *r;
 }
 
+/* Single-controller shorthands: player 1. */
+static void inject_bt_connect(void)    { inject_pad_connect(0); }
+static void inject_bt_disconnect(void) { inject_pad_disconnect(0); }
+
 static void inject_bt_report(const gamepad_report_t *r)
 {
-    s_bt.report = *r;
+    inject_pad_report(0, r);
+}
+
+/** Queue an edge captured between ticks at an exact time. */
+static void inject_led_edge(bool on, uint32_t at_us)
+{
+    TEST_ASSERT_TRUE(s_hal.led_edge_count < MOCK_LED_EDGES);
+    s_hal.led_edges[s_hal.led_edge_count].on      = on;
+    s_hal.led_edges[s_hal.led_edge_count].time_us = at_us;
+    s_hal.led_edge_count++;
+    s_hal.power_led = on;
+}
+
+/** Controller delivers a motion sample (only gyro X set). */
+static void inject_pad_motion(uint8_t idx, int16_t gyro_x, uint32_t t_us)
+{
+    memset(&s_bt.motion[idx], 0, sizeof(s_bt.motion[idx]));
+    s_bt.motion[idx].gyro[0]      = gyro_x;
+    s_bt.motion[idx].accel[2]     = 8192;   /* gravity */
+    s_bt.motion[idx].timestamp_us = t_us;
+    s_bt.motion_new[idx]          = true;
+}
+
+/** Controller's native (DualShock 4 Bluetooth) report, tagged at byte 3. */
+static void inject_pad_raw(uint8_t idx, uint8_t tag)
+{
+    memset(&s_bt.raw[idx], 0, sizeof(s_bt.raw[idx]));
+    s_bt.raw[idx].kind    = BT_GAMEPAD_RAW_DS4;
+    s_bt.raw[idx].len     = BT_GAMEPAD_RAW_MAX;
+    s_bt.raw[idx].data[0] = 0x11;
+    s_bt.raw[idx].data[3] = tag;
+    s_bt.raw_new[idx]     = true;
+}
+
+/** Host sends a player's output report (SET_REPORT). */
+static void inject_usb_output(uint8_t idx, uint8_t strong, uint8_t weak,
+                              uint8_t leds)
+{
+    const uint8_t buf[] = { strong, weak, leds };
+    gamepad_output_t out;
+    if (usb_hid_report_to_output(buf, sizeof(buf), &out) && s_usb.output_cb)
+        s_usb.output_cb(idx, &out);
+}
+
+static void mock_usb_reset_pipes(void)
+{
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        usb_report_pipe_reset(&s_usb.pipe[i]);
+    motion_mux_reset(&s_usb.motion);
 }
 
 static void inject_usb_mount(void)
 {
+    mock_usb_reset_pipes();
     s_usb.state = USB_HID_MOUNTED;
     if (s_usb.state_cb) s_usb.state_cb(USB_HID_MOUNTED);
 }
@@ -285,6 +710,7 @@ static void inject_usb_suspend(void)
 
 static void inject_usb_not_mounted(void)
 {
+    mock_usb_reset_pipes();
     s_usb.state = USB_HID_NOT_MOUNTED;
     if (s_usb.state_cb) s_usb.state_cb(USB_HID_NOT_MOUNTED);
 }
@@ -310,7 +736,7 @@ static gamepad_report_t make_guide_report(void)
 
 /**
  * Drive the device from OFF → ON via a stable power LED + USB mount.
- * The LED must remain on for POWER_LED_STABLE_MS before the state machine
+ * The LED must remain on for POWER_LED_HOLD_MS before the state machine
  * sees the event.
  */
 static void drive_to_on(uint32_t at_ms)
@@ -321,20 +747,27 @@ static void drive_to_on(uint32_t at_ms)
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* Advance past the debounce period */
-    device_tick(at_ms + POWER_LED_STABLE_MS);
+    device_tick(at_ms + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
 
-    s_hal.millis = at_ms + POWER_LED_STABLE_MS + 5000;
+    s_hal.millis = at_ms + POWER_LED_HOLD_MS + 5000;
     inject_usb_mount();
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
 }
 
-/** Drive the device from OFF → ON → SLEEPING. */
+/**
+ * Drive the device from OFF → ON → SLEEPING.  The LED stays lit, so
+ * only the sustained USB suspend shows the sleep.
+ */
 static void drive_to_sleeping(uint32_t at_ms)
 {
     drive_to_on(at_ms);
-    s_hal.millis = at_ms + POWER_LED_STABLE_MS + 10000;
+    uint32_t suspend_ms = at_ms + POWER_LED_HOLD_MS + 10000;
+    s_hal.millis = suspend_ms;
     inject_usb_suspend();
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+
+    device_tick(suspend_ms + PC_FUSION_SUSPEND_CONFIRM_MS);
     TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, pc_power_sm_get_state(&s_sm));
 }
 
@@ -375,6 +808,7 @@ void test_wake_from_off_triggers_power_button(void)
     TEST_ASSERT_EQUAL(1, s_hal.power_btn_trigger_count);
     TEST_ASSERT_EQUAL_UINT32(POWER_PULSE_MS, s_hal.power_btn_last_duration_ms);
     TEST_ASSERT_TRUE(s_hal.boot_timer_running);
+    TEST_ASSERT_EQUAL(1, s_wol_count);          /* Wake-on-LAN alongside */
 }
 
 void test_boot_sequence_completes_to_on(void)
@@ -450,6 +884,134 @@ void test_wake_from_sleep_completes_to_on(void)
     TEST_ASSERT_EQUAL_UINT16(GAMEPAD_BTN_A, s_usb.last_report.buttons);
 }
 
+/* ── USB remote wakeup ──────────────────────────────────────────────── */
+
+void test_wake_armed_sleeping_pc_by_remote_wakeup(void)
+{
+    inject_bt_connect();
+    s_usb.remote_wakeup_en = true;
+    drive_to_sleeping(0);
+
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    int triggers_before = s_hal.power_btn_trigger_count;
+    device_tick(20000);
+
+    /* Remote wakeup signalled instead of the power button */
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(1, s_usb.remote_wakeup_count);
+    TEST_ASSERT_EQUAL(triggers_before, s_hal.power_btn_trigger_count);
+    TEST_ASSERT_EQUAL(0, s_wol_count);
+    TEST_ASSERT_EQUAL_UINT32(REMOTE_WAKEUP_TIMEOUT_MS,
+                             s_hal.boot_timer_timeout_ms);
+
+    /* Host resumes the bus → ON, no pulse ever sent */
+    s_hal.millis = 20800;
+    inject_usb_mount();
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_FALSE(s_hal.boot_timer_running);
+    device_tick(20000 + REMOTE_WAKEUP_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(triggers_before, s_hal.power_btn_trigger_count);
+    TEST_ASSERT_EQUAL_UINT32(800, s_wake_ms[WAKE_USB]);
+}
+
+void test_remote_wakeup_without_resume_falls_back_to_power_button(void)
+{
+    inject_bt_connect();
+    s_usb.remote_wakeup_en = true;
+    drive_to_sleeping(0);
+
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    int triggers_before = s_hal.power_btn_trigger_count;
+    device_tick(20000);
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&s_sm));
+
+    device_tick(20000 + REMOTE_WAKEUP_TIMEOUT_MS - 20);
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(triggers_before, s_hal.power_btn_trigger_count);
+
+    /* Timeout → pulse, then wait the full boot timeout */
+    device_tick(20000 + REMOTE_WAKEUP_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(triggers_before + 1, s_hal.power_btn_trigger_count);
+    TEST_ASSERT_EQUAL_UINT32(BOOT_TIMEOUT_MS, s_hal.boot_timer_timeout_ms);
+    TEST_ASSERT_EQUAL_UINT32(1, s_wake_fallbacks);
+    TEST_ASSERT_EQUAL(1, s_wol_count);
+
+    s_hal.millis = 28000;
+    inject_usb_mount();
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL_UINT32(8000, s_wake_ms[WAKE_FALLBACK]);
+    TEST_ASSERT_EQUAL_UINT32(0, s_wake_ms[WAKE_USB]);
+}
+
+void test_remote_wakeup_signal_failure_falls_back_on_next_poll(void)
+{
+    inject_bt_connect();
+    s_usb.remote_wakeup_en    = true;
+    s_usb.remote_wakeup_fails = true;
+    drive_to_sleeping(0);
+
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    int triggers_before = s_hal.power_btn_trigger_count;
+    device_tick(20000);
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&s_sm));
+
+    device_tick(20020);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(triggers_before + 1, s_hal.power_btn_trigger_count);
+}
+
+void test_wake_without_remote_wakeup_records_button_latency(void)
+{
+    inject_bt_connect();
+    drive_to_sleeping(0);
+
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    device_tick(20000);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(0, s_usb.remote_wakeup_count);
+
+    s_hal.millis = 23500;
+    inject_usb_mount();
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL_UINT32(3500, s_wake_ms[WAKE_BUTTON]);
+}
+
+void test_power_led_during_remote_wakeup_cancels_fallback(void)
+{
+    /* PC visibly wakes (sleep blink → steady on) but USB resumes late */
+    inject_bt_connect();
+    s_usb.remote_wakeup_en = true;
+    drive_to_on(0);
+    s_hal.millis = 50000;
+    inject_usb_suspend();
+
+    uint32_t t = 60000;
+    for (int i = 0; i < 2; i++) {
+        inject_led_edge(false, t * 1000u);
+        inject_led_edge(true,  (t + 500) * 1000u);
+        t += 1000;
+    }
+
+    /* Blink seen and guide pressed in the same tick */
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    int triggers_before = s_hal.power_btn_trigger_count;
+    device_tick(t - 500);
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&s_sm));
+
+    /* LED stays on past the learned blink phase → BOOTING, no pulse */
+    device_tick(t + 300);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    device_tick(t + REMOTE_WAKEUP_TIMEOUT_MS + 1000);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(triggers_before, s_hal.power_btn_trigger_count);
+}
+
 /* ── Sleep with blinking LED (debounce) ─────────────────────────────── */
 
 void test_sleep_blinking_led_causes_no_state_transitions(void)
@@ -527,11 +1089,11 @@ void test_led_debounce_filters_brief_pulse(void)
 
     /* LED goes off before debounce completes */
     s_hal.power_led = false;
-    device_tick(100 + POWER_LED_STABLE_MS - 1);
+    device_tick(100 + POWER_LED_HOLD_MS - 1);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* Even well after the original change, no event since LED went back */
-    device_tick(100 + POWER_LED_STABLE_MS + 5000);
+    device_tick(100 + POWER_LED_HOLD_MS + 5000);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 }
 
@@ -543,11 +1105,11 @@ void test_led_on_after_stable_period_triggers_transition(void)
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* Just before the debounce threshold — no event */
-    device_tick(100 + POWER_LED_STABLE_MS - 1);
+    device_tick(100 + POWER_LED_HOLD_MS - 1);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* At the threshold — event fires */
-    device_tick(100 + POWER_LED_STABLE_MS);
+    device_tick(100 + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
 }
 
@@ -562,7 +1124,7 @@ void test_led_off_after_stable_period_triggers_transition(void)
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
 
     /* After debounce period — POWER_LED_OFF fires → ON → OFF */
-    device_tick(20000 + POWER_LED_STABLE_MS);
+    device_tick(20000 + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 }
 
@@ -573,28 +1135,64 @@ void test_led_debounce_resets_on_bounce(void)
     device_tick(100);
 
     /* Almost stable... */
-    device_tick(100 + POWER_LED_STABLE_MS - 100);
+    device_tick(100 + POWER_LED_HOLD_MS - 100);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* LED bounces off briefly — resets debounce timer */
     s_hal.power_led = false;
-    device_tick(100 + POWER_LED_STABLE_MS);
+    device_tick(100 + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* LED back on — new debounce period starts from here */
-    uint32_t restart = 100 + POWER_LED_STABLE_MS + 50;
+    uint32_t restart = 100 + POWER_LED_HOLD_MS + 50;
     s_hal.power_led = true;
     device_tick(restart);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* Must wait the full period from the restart */
-    device_tick(restart + POWER_LED_STABLE_MS - 1);
+    device_tick(restart + POWER_LED_HOLD_MS - 1);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
-    device_tick(restart + POWER_LED_STABLE_MS);
+    device_tick(restart + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
 }
 
+void test_led_glitch_between_ticks_ignored(void)
+{
+    /* LED on, seen at the 100 ms tick */
+    s_hal.power_led = true;
+    device_tick(100);
+
+    /* A 400 µs drop between ticks is captured but rejected as noise, so
+     * the hold still runs from the original edge */
+    inject_led_edge(false, 1000u * 1000u);
+    inject_led_edge(true,  1000u * 1000u + 400u);
+
+    device_tick(100 + POWER_LED_HOLD_MS - 1);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
+
+    device_tick(100 + POWER_LED_HOLD_MS);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL_UINT32(1, s_led.glitches);
+}
+
+void test_led_sleep_blink_reported_as_sleeping(void)
+{
+    drive_to_on(0);
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+
+    /* PC enters S3 and the board blinks the LED at 1 Hz */
+    uint32_t t = 60000;
+    for (int i = 0; i < 2; i++) {
+        inject_led_edge(false, t * 1000u);
+        inject_led_edge(true,  (t + 500) * 1000u);
+        t += 1000;
+    }
+    device_tick(t - 500);
+    TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(POWER_LED_PATTERN_BLINK, power_led_pattern(&s_led));
+}
+
 /* ── Gamepad input forwarding ───────────────────────────────────────── */
 
 void test_input_forwarded_when_pc_on(void)
@@ -665,7 +1263,7 @@ void test_input_not_forwarded_when_pc_booting(void)
     /* Get to BOOTING via stable LED */
     s_hal.power_led = true;
     device_tick(0);
-    device_tick(POWER_LED_STABLE_MS);
+    device_tick(POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
 
     /* Send non-guide input */
@@ -674,11 +1272,35 @@ void test_input_not_forwarded_when_pc_booting(void)
     inject_bt_report(&play);
 
     s_usb.report_count = 0;
-    device_tick(POWER_LED_STABLE_MS + 1000);
+    device_tick(POWER_LED_HOLD_MS + 1000);
 
     TEST_ASSERT_EQUAL(0, s_usb.report_count);
 }
 
+void test_unchanged_input_sent_only_as_keepalive(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+
+    /* Resting controller polled at 1 kHz for one second */
+    s_usb.report_count = 0;
+    for (uint32_t t = 0; t < 1000; t++)
+        device_tick(10000 + t);
+    /* First report, then one keepalive per USB_KEEPALIVE_MS */
+    TEST_ASSERT_EQUAL(1000 / USB_KEEPALIVE_MS, s_usb.report_count);
+    TEST_ASSERT_EQUAL_UINT32(1000 - s_usb.report_count,
+                             s_filter[0].suppressed);
+
+    /* Any change goes out on the next tick */
+    gamepad_report_t r = make_idle_report();
+    r.lx = 1;
+    inject_bt_report(&r);
+    s_usb.report_sent = false;
+    device_tick(11000);
+    TEST_ASSERT_TRUE(s_usb.report_sent);
+}
+
 /* ── Boot timeout ───────────────────────────────────────────────────── */
 
 void test_boot_timeout_returns_to_off(void)
@@ -733,6 +1355,75 @@ void test_boot_timeout_retry_succeeds(void)
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
 }
 
+/**
+ * Guide press from OFF; USB mounts boot_ms later (the boot timer may have
+ * fired first), then the PC shuts down.  Returns the time it is OFF.
+ */
+static uint32_t guide_boot_and_shutdown(uint32_t at_ms, uint32_t boot_ms)
+{
+    gamepad_report_t guide = make_guide_report();
+    gamepad_report_t idle = make_idle_report();
+
+    inject_bt_report(&guide);
+    device_tick(at_ms);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    inject_bt_report(&idle);
+    s_hal.power_led = true;
+    device_tick(at_ms + 100);
+    device_tick(at_ms + boot_ms - 1);
+
+    s_hal.millis = at_ms + boot_ms;
+    inject_usb_mount();
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+
+    uint32_t off_ms = at_ms + boot_ms + 5000;
+    s_hal.millis = off_ms;
+    inject_usb_not_mounted();
+    s_hal.power_led = false;
+    device_tick(off_ms);
+    device_tick(off_ms + POWER_LED_HOLD_MS);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
+    return off_ms + POWER_LED_HOLD_MS + 1000;
+}
+
+void test_boot_timeout_learned_from_fast_boots(void)
+{
+    inject_bt_connect();
+    uint32_t t = 0;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES; i++) {
+        t = guide_boot_and_shutdown(t, 10000);
+        TEST_ASSERT_EQUAL_UINT32(i < PC_BOOT_MIN_SAMPLES - 1 ? BOOT_TIMEOUT_MS
+                                                             : 15000,
+                                 pc_power_sm_boot_timeout(&s_sm, BOOT_TIMEOUT_MS));
+    }
+
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    device_tick(t);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL_UINT32(15000, s_hal.boot_timer_timeout_ms);
+    TEST_ASSERT_EQUAL_UINT32(10000, pc_power_sm_boot_eta_ms(&s_sm, t));
+}
+
+void test_boot_timeout_grows_for_slow_bios(void)
+{
+    inject_bt_connect();
+    uint32_t t = 0;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES; i++) {
+        /* Each boot outlasts the 30 s timer, yet is still learned */
+        t = guide_boot_and_shutdown(t, 45000);
+        TEST_ASSERT_FALSE(s_hal.boot_timer_running);
+        TEST_ASSERT_EQUAL(i + 1, s_sm.boot_history[PC_BOOT_COLD].count);
+    }
+    TEST_ASSERT_EQUAL_UINT32(45000,
+                             pc_power_sm_boot_typical_ms(&s_sm, PC_BOOT_COLD));
+
+    gamepad_report_t guide = make_guide_report();
+    inject_bt_report(&guide);
+    device_tick(t);
+    TEST_ASSERT_EQUAL_UINT32(PC_BOOT_TIMEOUT_MAX_MS, s_hal.boot_timer_timeout_ms);
+}
+
 /* ── Guide button edge detection ────────────────────────────────────── */
 
 void test_guide_held_does_not_retrigger_wake(void)
@@ -809,7 +1500,7 @@ void test_bt_disconnect_clears_prev_report(void)
 
     /* Reconnect with guide already held */
     inject_bt_connect();
-    s_bt.report = guide;
+    s_bt.report[0] = guide;
 
     /* Because prev_report was cleared, this is seen as a new rising edge */
     device_tick(35000);
@@ -817,6 +1508,404 @@ void test_bt_disconnect_clears_prev_report(void)
     TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
 }
 
+/* ── Multiple controllers ───────────────────────────────────────────── */
+
+void test_each_pad_forwards_to_own_interface(void)
+{
+    device_init();
+    drive_to_on(0);
+
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        inject_pad_connect(i);
+
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        gamepad_report_t r = make_idle_report();
+        r.lx = (int16_t)(1000 * (i + 1));
+        inject_pad_report(i, &r);
+    }
+    device_tick(10000);
+
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        TEST_ASSERT_EQUAL(1, s_usb.player_count[i]);
+        TEST_ASSERT_EQUAL_INT16(1000 * (i + 1), s_usb.player_report[i].lx);
+    }
+}
+
+void test_any_pad_guide_wakes_pc(void)
+{
+    device_init();
+    inject_pad_connect(0);
+    inject_pad_connect(2);
+
+    gamepad_report_t guide = make_guide_report();
+    inject_pad_report(2, &guide);
+    device_tick(100);
+
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+    TEST_ASSERT_EQUAL(1, s_hal.power_btn_trigger_count);
+}
+
+void test_pad_disconnect_clears_only_its_edge_state(void)
+{
+    device_init();
+    inject_pad_connect(0);
+    inject_pad_connect(1);
+
+    /* Player 1 holds guide through a boot timeout */
+    gamepad_report_t guide = make_guide_report();
+    inject_pad_report(0, &guide);
+    device_tick(0);
+    device_tick(31000);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
+
+    /* Player 2 drops out and returns: player 1's held guide is no edge */
+    inject_pad_disconnect(1);
+    inject_pad_connect(1);
+    device_tick(32000);
+    TEST_ASSERT_EQUAL(1, s_hal.power_btn_trigger_count);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
+}
+
+void test_four_pads_at_1khz_throughput(void)
+{
+    device_init();
+    drive_to_on(0);
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        inject_pad_connect(i);
+
+    /* Host polls each endpoint every 1 ms; every controller sends a new
+     * report every 1 ms for one second */
+    s_usb.ep_interval_ms = 1;
+    memset(s_usb.player_count, 0, sizeof(s_usb.player_count));
+
+    uint32_t start = 10000;
+    for (uint32_t t = 0; t < 1000; t++) {
+        for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+            gamepad_report_t r = make_idle_report();
+            r.lx = (int16_t)t;
+            r.ly = (int16_t)i;
+            inject_pad_report(i, &r);
+        }
+        device_tick(start + t);
+    }
+
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        TEST_ASSERT_EQUAL(1000, s_usb.player_count[i]);
+        TEST_ASSERT_EQUAL_INT16(999, s_usb.player_report[i].lx);
+        TEST_ASSERT_EQUAL_INT16(i, s_usb.player_report[i].ly);
+    }
+}
+
+/* ── Tap latching ───────────────────────────────────────────────────── */
+
+void test_tap_between_ticks_reaches_host(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+    device_tick(10000);
+
+    /* A pressed and released by two BT packets before the next tick */
+    gamepad_report_t r = make_idle_report();
+    r.buttons = GAMEPAD_BTN_A;
+    inject_bt_report(&r);
+    r.buttons = 0;
+    inject_bt_report(&r);
+
+    device_tick(10001);
+    TEST_ASSERT_EQUAL_UINT16(GAMEPAD_BTN_A, s_usb.last_report.buttons);
+    device_tick(10002);
+    TEST_ASSERT_EQUAL_UINT16(0, s_usb.last_report.buttons);
+    TEST_ASSERT_EQUAL_UINT32(1, s_latch[0].latched);
+}
+
+void test_tap_kept_while_endpoint_busy(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+    s_usb.ep_interval_ms = 4;       /* slow host poll */
+    device_tick(10000);             /* idle report occupies the endpoint */
+
+    gamepad_report_t r = make_idle_report();
+    r.buttons = GAMEPAD_BTN_B;
+    inject_bt_report(&r);
+    r.buttons = 0;
+    inject_bt_report(&r);
+
+    s_usb.report_count = 0;
+    device_tick(10001);             /* tap queued behind the endpoint */
+    device_tick(10002);             /* release refused: would replace it */
+    TEST_ASSERT_EQUAL(0, s_usb.report_count);
+
+    device_tick(10004);
+    TEST_ASSERT_EQUAL(1, s_usb.report_count);
+    TEST_ASSERT_EQUAL_UINT16(GAMEPAD_BTN_B, s_usb.last_report.buttons);
+    TEST_ASSERT_EQUAL(1, s_usb.ready_count);
+
+    device_tick(10008);
+    TEST_ASSERT_EQUAL(2, s_usb.report_count);
+    TEST_ASSERT_EQUAL_UINT16(0, s_usb.last_report.buttons);
+}
+
+void test_report_queued_while_busy_sent_on_completion(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+    s_usb.ep_interval_ms = 4;
+    device_tick(10000);
+
+    /* Two stick updates while the endpoint is busy: the newer replaces
+     * the older and goes out at the host's next poll */
+    gamepad_report_t r = make_idle_report();
+    r.lx = 100;
+    inject_bt_report(&r);
+    device_tick(10001);
+    r.lx = 200;
+    inject_bt_report(&r);
+    device_tick(10002);
+
+    s_usb.report_count = 0;
+    device_tick(10004);
+    TEST_ASSERT_EQUAL(1, s_usb.report_count);
+    TEST_ASSERT_EQUAL_INT16(200, s_usb.last_report.lx);
+    TEST_ASSERT_EQUAL_UINT32(1, usb_hid_gamepad_pipe(0)->replaced);
+}
+
+/* ── Rumble and player LEDs ─────────────────────────────────────────── */
+
+void test_rumble_reaches_controller(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+
+    inject_usb_output(0, 200, 50, 0x01);
+    device_tick(10000);
+    TEST_ASSERT_EQUAL(1, s_bt.output_count[0]);
+    TEST_ASSERT_EQUAL_UINT8(200, s_bt.output[0].strong);
+    TEST_ASSERT_EQUAL_UINT8(50,  s_bt.output[0].weak);
+    TEST_ASSERT_EQUAL_UINT8(GAMEPAD_LED_PLAYER(1), s_bt.output[0].leds);
+}
+
+void test_rumble_routed_per_player(void)
+{
+    device_init();
+    drive_to_on(0);
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        inject_pad_connect(i);
+
+    inject_usb_output(2, 99, 0, 0);
+    device_tick(10000);
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        TEST_ASSERT_EQUAL(i == 2, s_bt.output_count[i]);
+}
+
+void test_rumble_spam_coalesced(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+
+    /* Game rewrites rumble every 1 ms for a second */
+    for (uint32_t t = 0; t < 1000; t++) {
+        inject_usb_output(0, (uint8_t)(t / 4), 10, 0);
+        device_tick(10000 + t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, s_output[0].requests);
+    TEST_ASSERT_TRUE(s_bt.output_count[0] <= 1000 / OUTPUT_INTERVAL_MS);
+
+    /* The final state arrives once the interval allows */
+    device_tick(11000 + OUTPUT_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT8(999 / 4, s_bt.output[0].strong);
+}
+
+void test_rumble_held_then_stopped_on_usb_unmount(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+
+    inject_usb_output(0, 0, 128, 0);
+    device_tick(10000);
+    device_tick(10000 + BT_GAMEPAD_RUMBLE_MS / 2);
+    TEST_ASSERT_EQUAL(2, s_bt.output_count[0]);     /* refreshed */
+
+    inject_usb_not_mounted();
+    device_tick(10300);
+    TEST_ASSERT_EQUAL(3, s_bt.output_count[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, s_bt.output[0].weak);
+}
+
+/* ── Native report passthrough ──────────────────────────────────────── */
+
+void test_native_report_forwarded_as_is(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+    s_usb.takes_raw = true;
+
+    gamepad_report_t r = make_idle_report();
+    r.lx = 1000;
+    inject_bt_report(&r);
+    inject_pad_raw(0, 0x42);
+    device_tick(10000);
+
+    TEST_ASSERT_EQUAL(1, s_usb.native_count[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x42, s_usb.native_report[0][3]);
+}
+
+void test_native_report_ignored_by_other_personalities(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+
+    gamepad_report_t r = make_idle_report();
+    r.lx = 1000;
+    inject_bt_report(&r);
+    inject_pad_raw(0, 0x42);
+    device_tick(10000);
+
+    TEST_ASSERT_EQUAL(0, s_usb.native_count[0]);
+    TEST_ASSERT_EQUAL_INT16(1000, s_usb.last_report.lx);
+}
+
+void test_latched_tap_overrides_native_report(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+    s_usb.takes_raw = true;
+    device_tick(10000);
+
+    /* A tapped between ticks: the native report no longer shows it */
+    gamepad_report_t r = make_idle_report();
+    r.buttons = GAMEPAD_BTN_A;
+    inject_bt_report(&r);
+    r.buttons = 0;
+    inject_bt_report(&r);
+    inject_pad_raw(0, 0x01);
+
+    device_tick(10001);
+    TEST_ASSERT_EQUAL(0, s_usb.native_count[0]);
+    TEST_ASSERT_EQUAL_UINT16(GAMEPAD_BTN_A, s_usb.last_report.buttons);
+
+    /* With the tap delivered, native reports resume */
+    inject_pad_raw(0, 0x02);
+    device_tick(10002);
+    TEST_ASSERT_EQUAL(1, s_usb.native_count[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, s_usb.native_report[0][3]);
+}
+
+/* ── Response curves ────────────────────────────────────────────────── */
+
+void test_stick_drift_inside_deadzone_reported_centred(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+
+    const axis_curve_cfg_t dz = { 3000, 0, 0, 0 };
+    const axis_curve_cfg_t linear = { 0, 0, 0, 0 };
+    axis_curve_set_init(&s_curves, &dz, &linear, &linear);
+
+    gamepad_report_t r = make_idle_report();
+    r.lx = 1800;
+    r.ly = -1800;       /* drift: inside the circle, not the square */
+    r.rx = 1800;
+    inject_bt_report(&r);
+    device_tick(10000);
+
+    TEST_ASSERT_EQUAL_INT16(0, s_usb.last_report.lx);
+    TEST_ASSERT_EQUAL_INT16(0, s_usb.last_report.ly);
+    TEST_ASSERT_EQUAL_INT16(1800, s_usb.last_report.rx);
+}
+
+void test_curves_replace_native_report(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_bt_connect();
+    s_usb.takes_raw = true;
+
+    const axis_curve_cfg_t expo = { 0, 0, 0, 50 };
+    const axis_curve_cfg_t linear = { 0, 0, 0, 0 };
+    axis_curve_set_init(&s_curves, &expo, &linear, &linear);
+
+    gamepad_report_t r = make_idle_report();
+    r.lx = 16000;
+    inject_bt_report(&r);
+    inject_pad_raw(0, 0x42);
+    device_tick(10000);
+
+    TEST_ASSERT_EQUAL(0, s_usb.native_count[0]);
+    TEST_ASSERT_TRUE(s_usb.last_report.lx > 0 && s_usb.last_report.lx < 16000);
+}
+
+/* ── Motion passthrough ─────────────────────────────────────────────── */
+
+void test_motion_sample_forwarded(void)
+{
+    device_init();
+    drive_to_on(0);
+    inject_pad_connect(1);
+
+    inject_pad_motion(1, -1234, 777);
+    device_tick(10000);
+    TEST_ASSERT_EQUAL(1, s_usb.motion_count[1]);
+    TEST_ASSERT_EQUAL_INT16(-1234, s_usb.motion_report[1].gyro[0]);
+    TEST_ASSERT_EQUAL_INT16(8192, s_usb.motion_report[1].accel[2]);
+    TEST_ASSERT_EQUAL_UINT32(777, s_usb.motion_report[1].timestamp_us);
+}
+
+void test_motion_leaves_gamepad_reports_at_full_rate(void)
+{
+    device_init();
+    drive_to_on(0);
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+        inject_pad_connect(i);
+    s_usb.ep_interval_ms = 1;
+    memset(s_usb.player_count, 0, sizeof(s_usb.player_count));
+
+    /* Every controller streams input and motion at 1 kHz for a second */
+    for (uint32_t t = 0; t < 1000; t++) {
+        for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+            gamepad_report_t r = make_idle_report();
+            r.lx = (int16_t)t;
+            inject_pad_report(i, &r);
+            inject_pad_motion(i, (int16_t)t, t);
+        }
+        device_tick(10000 + t);
+    }
+
+    for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++) {
+        /* Gamepad endpoints unaffected: a report every frame */
+        TEST_ASSERT_EQUAL(1000, s_usb.player_count[i]);
+        /* Motion shares its one endpoint fairly, always the newest
+         * sample, so none is more than a round plus a frame old */
+        TEST_ASSERT_EQUAL(1000 / BT_GAMEPAD_MAX, s_usb.motion_count[i]);
+        TEST_ASSERT_TRUE(s_usb.motion_report[i].timestamp_us >=
+                         999 - BT_GAMEPAD_MAX);
+    }
+}
+
+void test_guide_tap_between_ticks_wakes_pc(void)
+{
+    device_init();
+    inject_bt_connect();
+
+    gamepad_report_t guide = make_guide_report();
+    gamepad_report_t idle  = make_idle_report();
+    inject_bt_report(&guide);
+    inject_bt_report(&idle);
+
+    device_tick(100);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
+}
+
 /* ── USB HID descriptor and report format ───────────────────────────── */
 
 void test_hid_descriptor_structure(void)
@@ -944,20 +2033,38 @@ void test_guide_press_no_op_when_booting(void)
 
 /* ── USB NOT_MOUNTED path ────────────────────────────────────────────── */
 
-void test_usb_not_mounted_acts_as_suspend(void)
+void test_usb_not_mounted_with_led_on_stays_on(void)
 {
     /*
-     * USB_HID_NOT_MOUNTED (cable unplugged while running) should be
-     * treated identically to USB_HID_SUSPENDED: the state machine
-     * moves ON → SLEEPING.
+     * USB_HID_NOT_MOUNTED while the power LED stays lit (OS reboot, or
+     * cable unplugged) is not a sleep: the fused signals keep the PC ON
+     * and re-enumeration needs no boot.
      */
     drive_to_on(0);
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
 
     s_hal.millis = 10000;
     inject_usb_not_mounted();
+    device_tick(20000);
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
 
-    TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, pc_power_sm_get_state(&s_sm));
+    s_hal.millis = 25000;
+    inject_usb_mount();
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+}
+
+void test_usb_not_mounted_then_led_off_is_shutdown(void)
+{
+    drive_to_on(0);
+
+    s_hal.millis = 10000;
+    inject_usb_not_mounted();
+    s_hal.power_led = false;
+    device_tick(11000);
+    TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
+
+    device_tick(11000 + POWER_LED_HOLD_MS);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 }
 
 /* ── PC shutdown ────────────────────────────────────────────────────── */
@@ -973,7 +2080,7 @@ void test_pc_shutdown_from_on_via_led_off(void)
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
 
     /* After debounce period → OFF */
-    device_tick(20000 + POWER_LED_STABLE_MS);
+    device_tick(20000 + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 }
 
@@ -987,7 +2094,7 @@ void test_pc_shutdown_from_sleep_via_led_off(void)
     TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, pc_power_sm_get_state(&s_sm));
 
     /* After debounce → OFF */
-    device_tick(21000 + POWER_LED_STABLE_MS);
+    device_tick(21000 + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 }
 
@@ -1027,21 +2134,22 @@ void test_full_lifecycle(void)
     TEST_ASSERT_EQUAL_INT16(10000, s_usb.last_report.lx);
     TEST_ASSERT_EQUAL_UINT8(200, s_usb.last_report.lt);  /* 800 / 4 */
 
-    /* 5. PC sleeps: USB suspends → SLEEPING */
+    /* 5. PC sleeps: USB stays suspended → SLEEPING */
     s_hal.millis = 60000;
     inject_usb_suspend();
+    device_tick(60000 + PC_FUSION_SUSPEND_CONFIRM_MS);
     TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, pc_power_sm_get_state(&s_sm));
 
     /* 6. Input NOT forwarded while sleeping */
     play.buttons = GAMEPAD_BTN_B;
     inject_bt_report(&play);
     s_usb.report_count = 0;
-    device_tick(61000);
+    device_tick(63500);
     TEST_ASSERT_EQUAL(0, s_usb.report_count);
 
     /* 7. Press guide → wake from sleep → BOOTING */
     inject_bt_report(&guide);
-    device_tick(62000);
+    device_tick(64000);
     TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&s_sm));
     TEST_ASSERT_EQUAL(2, s_hal.power_btn_trigger_count);
 
@@ -1063,7 +2171,7 @@ void test_full_lifecycle(void)
     s_hal.power_led = false;
     device_tick(120000);
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&s_sm));
-    device_tick(120000 + POWER_LED_STABLE_MS);
+    device_tick(120000 + POWER_LED_HOLD_MS);
     TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&s_sm));
 
     /* 11. No more input forwarded */
@@ -1089,6 +2197,13 @@ int main(void)
     RUN_TEST(test_wake_sleeping_pc_with_guide);
     RUN_TEST(test_wake_from_sleep_completes_to_on);
 
+    /* USB remote wakeup */
+    RUN_TEST(test_wake_armed_sleeping_pc_by_remote_wakeup);
+    RUN_TEST(test_remote_wakeup_without_resume_falls_back_to_power_button);
+    RUN_TEST(test_remote_wakeup_signal_failure_falls_back_on_next_poll);
+    RUN_TEST(test_wake_without_remote_wakeup_records_button_latency);
+    RUN_TEST(test_power_led_during_remote_wakeup_cancels_fallback);
+
     /* Sleep with blinking LED (debounce) */
     RUN_TEST(test_sleep_blinking_led_causes_no_state_transitions);
     RUN_TEST(test_sleep_blinking_led_wake_with_guide);
@@ -1098,16 +2213,21 @@ int main(void)
     RUN_TEST(test_led_on_after_stable_period_triggers_transition);
     RUN_TEST(test_led_off_after_stable_period_triggers_transition);
     RUN_TEST(test_led_debounce_resets_on_bounce);
+    RUN_TEST(test_led_glitch_between_ticks_ignored);
+    RUN_TEST(test_led_sleep_blink_reported_as_sleeping);
 
     /* Gamepad input forwarding */
     RUN_TEST(test_input_forwarded_when_pc_on);
     RUN_TEST(test_full_report_conversion);
     RUN_TEST(test_input_not_forwarded_when_pc_off);
     RUN_TEST(test_input_not_forwarded_when_pc_booting);
+    RUN_TEST(test_unchanged_input_sent_only_as_keepalive);
 
     /* Boot timeout */
     RUN_TEST(test_boot_timeout_returns_to_off);
     RUN_TEST(test_boot_timeout_retry_succeeds);
+    RUN_TEST(test_boot_timeout_learned_from_fast_boots);
+    RUN_TEST(test_boot_timeout_grows_for_slow_bios);
 
     /* Guide button edge detection */
     RUN_TEST(test_guide_held_does_not_retrigger_wake);
@@ -1116,6 +2236,37 @@ int main(void)
     /* BT disconnect behaviour */
     RUN_TEST(test_bt_disconnect_clears_prev_report);
 
+    /* Multiple controllers */
+    RUN_TEST(test_each_pad_forwards_to_own_interface);
+    RUN_TEST(test_any_pad_guide_wakes_pc);
+    RUN_TEST(test_pad_disconnect_clears_only_its_edge_state);
+    RUN_TEST(test_four_pads_at_1khz_throughput);
+
+    /* Tap latching */
+    RUN_TEST(test_tap_between_ticks_reaches_host);
+    RUN_TEST(test_tap_kept_while_endpoint_busy);
+    RUN_TEST(test_report_queued_while_busy_sent_on_completion);
+    RUN_TEST(test_guide_tap_between_ticks_wakes_pc);
+
+    /* Rumble and player LEDs */
+    RUN_TEST(test_rumble_reaches_controller);
+    RUN_TEST(test_rumble_routed_per_player);
+    RUN_TEST(test_rumble_spam_coalesced);
+    RUN_TEST(test_rumble_held_then_stopped_on_usb_unmount);
+
+    /* Native report passthrough */
+    RUN_TEST(test_native_report_forwarded_as_is);
+    RUN_TEST(test_native_report_ignored_by_other_personalities);
+    RUN_TEST(test_latched_tap_overrides_native_report);
+
+    /* Response curves */
+    RUN_TEST(test_stick_drift_inside_deadzone_reported_centred);
+    RUN_TEST(test_curves_replace_native_report);
+
+    /* Motion passthrough */
+    RUN_TEST(test_motion_sample_forwarded);
+    RUN_TEST(test_motion_leaves_gamepad_reports_at_full_rate);
+
     /* USB HID descriptor and report format */
     RUN_TEST(test_hid_descriptor_structure);
     RUN_TEST(test_usb_report_all_dpad_directions);
@@ -1127,7 +2278,8 @@ int main(void)
     RUN_TEST(test_guide_press_no_op_when_booting);
 
     /* USB NOT_MOUNTED path */
-    RUN_TEST(test_usb_not_mounted_acts_as_suspend);
+    RUN_TEST(test_usb_not_mounted_with_led_on_stays_on);
+    RUN_TEST(test_usb_not_mounted_then_led_off_is_shutdown);
 
     /* PC shutdown */
     RUN_TEST(test_pc_shutdown_from_on_via_led_off);
@@ -0,0 +1,218 @@
+/* Compile this file with debug messages filtered out */
+#define DLOG_LEVEL DLOG_LEVEL_INFO
+
+#include "unity.h"
+#include "dlog.h"
+#include <string.h>
+
+static uint32_t fake_us;
+static char line[DLOG_LINE_MAX];
+
+static uint32_t clock_us(void)
+{
+    return fake_us;
+}
+
+void setUp(void)
+{
+    fake_us = 0;
+    dlog_init(clock_us);
+    memset(line, 0, sizeof(line));
+}
+
+void tearDown(void)
+{
+}
+
+/** Read the next entry through c and format it into line. */
+static bool next_line(dlog_cursor_t *c)
+{
+    dlog_entry_t e;
+    if (!dlog_read(c, &e))
+        return false;
+    dlog_format(&e, line, sizeof(line));
+    return true;
+}
+
+/* ── Recording ───────────────────────────────────────────────────────── */
+
+void test_empty_ring_reads_nothing(void)
+{
+    dlog_cursor_t c = {0};
+    dlog_entry_t e;
+    TEST_ASSERT_FALSE(dlog_read(&c, &e));
+    TEST_ASSERT_EQUAL_UINT32(0, dlog_written());
+}
+
+void test_records_arguments_and_time(void)
+{
+    fake_us = 1234567;
+    DLOG_INFO("pad %d btn %u", 2, 0x80u);
+
+    dlog_cursor_t c = {0};
+    dlog_entry_t e;
+    TEST_ASSERT_TRUE(dlog_read(&c, &e));
+    TEST_ASSERT_EQUAL_UINT8(DLOG_LEVEL_INFO, e.level);
+    TEST_ASSERT_EQUAL_UINT8(2, e.nargs);
+    TEST_ASSERT_EQUAL_UINT32(1234567, e.time_us);
+    TEST_ASSERT_EQUAL_UINT32(0, e.seq);
+    TEST_ASSERT_FALSE(dlog_read(&c, &e));
+}
+
+void test_compiled_out_level_not_recorded_or_evaluated(void)
+{
+    int evaluated = 0;
+    DLOG_DEBUG("debug %d", ++evaluated);
+    TEST_ASSERT_EQUAL_UINT32(0, dlog_written());
+    TEST_ASSERT_EQUAL_INT(0, evaluated);
+
+    DLOG_ERROR("error");
+    DLOG_WARN("warn");
+    TEST_ASSERT_EQUAL_UINT32(2, dlog_written());
+}
+
+/* ── Formatting ──────────────────────────────────────────────────────── */
+
+void test_format_line(void)
+{
+    fake_us = 12345678;
+    DLOG_WARN("[usb_hid] USB %s", "mounted");
+
+    dlog_cursor_t c = {0};
+    TEST_ASSERT_TRUE(next_line(&c));
+    TEST_ASSERT_EQUAL_STRING("12.345678 W [usb_hid] USB mounted", line);
+}
+
+void test_format_conversions(void)
+{
+    DLOG_ERROR("%d|%5u|%08x|%c", -42, 7u, 0xBEEFu, 'z');
+    DLOG_INFO("%-4s|%lu|%%|%X", "ab", 99ul, 0xabu);
+
+    dlog_cursor_t c = {0};
+    TEST_ASSERT_TRUE(next_line(&c));
+    TEST_ASSERT_EQUAL_STRING("0.000000 E -42|    7|0000beef|z", line);
+    TEST_ASSERT_TRUE(next_line(&c));
+    TEST_ASSERT_EQUAL_STRING("0.000000 I ab  |99|%|AB", line);
+}
+
+void test_format_missing_and_null_args(void)
+{
+    DLOG_INFO("a=%d b=%d", 1);
+    DLOG_INFO("s=%s", (const char *)NULL);
+
+    dlog_cursor_t c = {0};
+    TEST_ASSERT_TRUE(next_line(&c));
+    TEST_ASSERT_EQUAL_STRING("0.000000 I a=1 b=?", line);
+    TEST_ASSERT_TRUE(next_line(&c));
+    TEST_ASSERT_EQUAL_STRING("0.000000 I s=(null)", line);
+}
+
+void test_format_unknown_conversion_is_literal(void)
+{
+    DLOG_INFO("%f %d", 5);
+
+    dlog_cursor_t c = {0};
+    TEST_ASSERT_TRUE(next_line(&c));
+    TEST_ASSERT_EQUAL_STRING("0.000000 I %f 5", line);
+}
+
+void test_format_truncates(void)
+{
+    DLOG_INFO("%s", "a long message that will not fit");
+
+    dlog_cursor_t c = {0};
+    dlog_entry_t e;
+    TEST_ASSERT_TRUE(dlog_read(&c, &e));
+
+    char small[16];
+    int n = dlog_format(&e, small, sizeof(small));
+    TEST_ASSERT_EQUAL_INT(15, n);
+    TEST_ASSERT_EQUAL_STRING("0.000000 I a lo", small);
+}
+
+/* ── Readers and overwrite ───────────────────────────────────────────── */
+
+void test_cursors_are_independent(void)
+{
+    dlog_cursor_t a = {0}, b = {0};
+    DLOG_INFO("one");
+    DLOG_INFO("two");
+
+    TEST_ASSERT_TRUE(next_line(&a));
+    TEST_ASSERT_TRUE(next_line(&a));
+    TEST_ASSERT_FALSE(next_line(&a));
+
+    TEST_ASSERT_TRUE(next_line(&b));
+    TEST_ASSERT_EQUAL_STRING("0.000000 I one", line);
+}
+
+void test_overwrite_counts_lost(void)
+{
+    for (int i = 0; i < DLOG_RING_SIZE + 5; i++)
+        DLOG_INFO("n=%d", i);
+
+    dlog_cursor_t c = {0};
+    dlog_entry_t e;
+    TEST_ASSERT_TRUE(dlog_read(&c, &e));
+    TEST_ASSERT_EQUAL_UINT32(5, c.lost);
+    TEST_ASSERT_EQUAL_UINT32(5, e.seq);
+    TEST_ASSERT_EQUAL_UINT(5, (unsigned)e.args[0]);
+
+    int count = 1;
+    while (dlog_read(&c, &e))
+        count++;
+    TEST_ASSERT_EQUAL_INT(DLOG_RING_SIZE, count);
+}
+
+void test_cursor_oldest_skips_without_loss(void)
+{
+    for (int i = 0; i < DLOG_RING_SIZE * 2; i++)
+        DLOG_INFO("n=%d", i);
+
+    dlog_cursor_t c;
+    dlog_cursor_oldest(&c);
+    dlog_entry_t e;
+    TEST_ASSERT_TRUE(dlog_read(&c, &e));
+    TEST_ASSERT_EQUAL_UINT32(0, c.lost);
+    TEST_ASSERT_EQUAL_UINT(DLOG_RING_SIZE, (unsigned)e.args[0]);
+}
+
+void test_reader_keeps_up_across_wrap(void)
+{
+    dlog_cursor_t c = {0};
+    dlog_entry_t e;
+
+    for (int i = 0; i < DLOG_RING_SIZE * 3; i++) {
+        DLOG_INFO("n=%d", i);
+        TEST_ASSERT_TRUE(dlog_read(&c, &e));
+        TEST_ASSERT_EQUAL_UINT(i, (unsigned)e.args[0]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, c.lost);
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* Recording */
+    RUN_TEST(test_empty_ring_reads_nothing);
+    RUN_TEST(test_records_arguments_and_time);
+    RUN_TEST(test_compiled_out_level_not_recorded_or_evaluated);
+
+    /* Formatting */
+    RUN_TEST(test_format_line);
+    RUN_TEST(test_format_conversions);
+    RUN_TEST(test_format_missing_and_null_args);
+    RUN_TEST(test_format_unknown_conversion_is_literal);
+    RUN_TEST(test_format_truncates);
+
+    /* Readers and overwrite */
+    RUN_TEST(test_cursors_are_independent);
+    RUN_TEST(test_overwrite_counts_lost);
+    RUN_TEST(test_cursor_oldest_skips_without_loss);
+    RUN_TEST(test_reader_keeps_up_across_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,224 @@
+#include "unity.h"
+#include "ds4_report.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BT_FULL_LEN 78   /* 0x11 report as received: header, payload, CRC */
+
+static uint8_t bt[BT_FULL_LEN];
+static uint8_t out[DS4_REPORT_LEN];
+
+void setUp(void)
+{
+    memset(bt, 0, sizeof(bt));
+    memset(out, 0xEE, sizeof(out));
+}
+
+void tearDown(void)
+{
+}
+
+static void make_full(void)
+{
+    bt[0] = DS4_BT_REPORT_ID;
+    bt[1] = 0xC0;               /* HID + CRC present */
+    bt[2] = 0x00;
+    for (int i = DS4_BT_HEADER_LEN; i < BT_FULL_LEN; i++)
+        bt[i] = (uint8_t)(i * 7);
+}
+
+/* ── Full report ──────────────────────────────────────────────────────── */
+
+void test_full_report_becomes_usb_report(void)
+{
+    make_full();
+    TEST_ASSERT_TRUE(ds4_report_from_bt(bt, sizeof(bt), out));
+    TEST_ASSERT_EQUAL_HEX8(DS4_REPORT_ID, out[0]);
+}
+
+void test_full_report_payload_untouched(void)
+{
+    make_full();
+    ds4_report_from_bt(bt, sizeof(bt), out);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&bt[DS4_BT_HEADER_LEN], &out[1],
+                                 DS4_REPORT_LEN - 1);
+}
+
+void test_triggers_keep_full_resolution(void)
+{
+    make_full();
+    bt[DS4_BT_HEADER_LEN + 7] = 0x01;   /* L2 barely touched */
+    bt[DS4_BT_HEADER_LEN + 8] = 0xFF;   /* R2 fully pressed  */
+    ds4_report_from_bt(bt, sizeof(bt), out);
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[8]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, out[9]);
+}
+
+void test_short_full_report_rejected(void)
+{
+    make_full();
+    TEST_ASSERT_FALSE(ds4_report_from_bt(bt, DS4_BT_HEADER_LEN + 62, out));
+    TEST_ASSERT_EQUAL_HEX8(0xEE, out[0]);
+}
+
+/* ── Basic report ─────────────────────────────────────────────────────── */
+
+void test_basic_report_copied_rest_zero(void)
+{
+    const uint8_t basic[DS4_BT_BASIC_LEN] = {
+        0x01, 0x80, 0x7F, 0x10, 0xF0, 0x28, 0x01, 0x04, 0x40, 0x00,
+    };
+    TEST_ASSERT_TRUE(ds4_report_from_bt(basic, sizeof(basic), out));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(basic, out, sizeof(basic));
+    for (int i = DS4_BT_BASIC_LEN; i < DS4_REPORT_LEN; i++)
+        TEST_ASSERT_EQUAL_HEX8(0, out[i]);
+}
+
+void test_short_basic_report_rejected(void)
+{
+    bt[0] = DS4_REPORT_ID;
+    TEST_ASSERT_FALSE(ds4_report_from_bt(bt, DS4_BT_BASIC_LEN - 1, out));
+}
+
+void test_other_report_rejected(void)
+{
+    make_full();
+    bt[0] = 0x12;
+    TEST_ASSERT_FALSE(ds4_report_from_bt(bt, sizeof(bt), out));
+}
+
+/* ── Converted from gamepad_report_t ──────────────────────────────────── */
+
+static gamepad_report_t idle_report(void)
+{
+    gamepad_report_t r;
+    memset(&r, 0, sizeof(r));
+    r.dpad = GAMEPAD_DPAD_CENTERED;
+    return r;
+}
+
+void test_idle_gamepad_report(void)
+{
+    gamepad_report_t r = idle_report();
+    TEST_ASSERT_EQUAL_UINT8(DS4_REPORT_LEN, ds4_report_from_gamepad(&r, 0, out));
+    TEST_ASSERT_EQUAL_HEX8(DS4_REPORT_ID, out[0]);
+    for (int i = 1; i <= 4; i++)
+        TEST_ASSERT_EQUAL_HEX8(0x80, out[i]);   /* sticks centred */
+    TEST_ASSERT_EQUAL_HEX8(0x08, out[5]);       /* hat centred, no buttons */
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[8]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[9]);
+}
+
+void test_gamepad_buttons_and_triggers(void)
+{
+    gamepad_report_t r = idle_report();
+    r.buttons = GAMEPAD_BTN_A | GAMEPAD_BTN_Y | GAMEPAD_BTN_L1 |
+                GAMEPAD_BTN_START | GAMEPAD_BTN_GUIDE;
+    r.dpad = GAMEPAD_DPAD_LEFT;
+    r.rt   = 1023;
+    r.lx   = -32768;
+    r.ry   = 32767;
+    ds4_report_from_gamepad(&r, 5, out);
+
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, out[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x20 | 0x80 | GAMEPAD_DPAD_LEFT, out[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x01 | 0x08 | 0x20, out[6]);   /* L1, R2, Options */
+    TEST_ASSERT_EQUAL_HEX8(0x01 | (5 << 2), out[7]);      /* PS, counter */
+    TEST_ASSERT_EQUAL_HEX8(0, out[8]);
+    TEST_ASSERT_EQUAL_HEX8(255, out[9]);
+}
+
+void test_counter_wraps_in_six_bits(void)
+{
+    gamepad_report_t r = idle_report();
+    ds4_report_from_gamepad(&r, 64 + 3, out);
+    TEST_ASSERT_EQUAL_HEX8(3 << 2, out[7]);
+}
+
+/* ── Output and feature reports ───────────────────────────────────────── */
+
+void test_output_report_sets_rumble(void)
+{
+    uint8_t buf[32] = { DS4_OUTPUT_ID, 0x01, 0, 0, 40, 200 };
+    gamepad_output_t o = { 0, 0, 3 };
+    TEST_ASSERT_TRUE(ds4_report_to_output(buf, sizeof(buf), &o));
+    TEST_ASSERT_EQUAL_UINT8(200, o.strong);
+    TEST_ASSERT_EQUAL_UINT8(40, o.weak);
+    TEST_ASSERT_EQUAL_UINT8(3, o.leds);         /* untouched */
+}
+
+void test_output_report_without_motor_flag_ignored(void)
+{
+    uint8_t buf[32] = { DS4_OUTPUT_ID, 0x02, 0, 0, 40, 200 };
+    gamepad_output_t o = { 0, 0, 0 };
+    TEST_ASSERT_FALSE(ds4_report_to_output(buf, sizeof(buf), &o));
+    buf[0] = 0x11;
+    buf[1] = 0x01;
+    TEST_ASSERT_FALSE(ds4_report_to_output(buf, sizeof(buf), &o));
+}
+
+void test_feature_reports(void)
+{
+    uint8_t buf[64];
+    TEST_ASSERT_EQUAL_UINT16(36, ds4_report_feature(DS4_FEATURE_CALIB, buf, 64));
+    /* Gyro pitch range: +8192, -8192 */
+    TEST_ASSERT_EQUAL_HEX8(0x00, buf[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x20, buf[7]);
+    TEST_ASSERT_EQUAL_HEX8(0xE0, buf[9]);
+    TEST_ASSERT_EQUAL_UINT16(6, ds4_report_feature(DS4_FEATURE_MAC, buf, 64));
+    TEST_ASSERT_EQUAL_UINT16(48, ds4_report_feature(DS4_FEATURE_FW, buf, 64));
+    TEST_ASSERT_EQUAL_UINT16(4, ds4_report_feature(DS4_FEATURE_FW, buf, 4));
+    TEST_ASSERT_EQUAL_UINT16(0, ds4_report_feature(0x12, buf, 64));
+}
+
+/* ── Benchmark ────────────────────────────────────────────────────────── */
+
+void test_benchmark_passthrough(void)
+{
+    const int n = 1000000;
+    uint32_t check = 0;
+
+    make_full();
+    clock_t start = clock();
+    for (int i = 0; i < n; i++) {
+        bt[DS4_BT_HEADER_LEN] = (uint8_t)i;
+        ds4_report_from_bt(bt, sizeof(bt), out);
+        check += out[1];
+    }
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+
+    printf("ds4 passthrough: %.1f ns per report (host)\n", ns);
+    TEST_ASSERT_NOT_EQUAL(0, check);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_full_report_becomes_usb_report);
+    RUN_TEST(test_full_report_payload_untouched);
+    RUN_TEST(test_triggers_keep_full_resolution);
+    RUN_TEST(test_short_full_report_rejected);
+
+    RUN_TEST(test_basic_report_copied_rest_zero);
+    RUN_TEST(test_short_basic_report_rejected);
+    RUN_TEST(test_other_report_rejected);
+
+    RUN_TEST(test_idle_gamepad_report);
+    RUN_TEST(test_gamepad_buttons_and_triggers);
+    RUN_TEST(test_counter_wraps_in_six_bits);
+
+    RUN_TEST(test_output_report_sets_rumble);
+    RUN_TEST(test_output_report_without_motor_flag_ignored);
+    RUN_TEST(test_feature_reports);
+
+    RUN_TEST(test_benchmark_passthrough);
+
+    return UNITY_END();
+}
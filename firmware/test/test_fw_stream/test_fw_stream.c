@@ -0,0 +1,375 @@
+#include "unity.h"
+#include "fw_stream.h"
+#include "crc32.h"
+#include <string.h>
+#include <stdio.h>
+
+/* ── Test sink ───────────────────────────────────────────────────────── */
+
+#define IMAGE_MAX (16 * 1024)
+
+static struct {
+    uint8_t data[IMAGE_MAX];
+    size_t  len;
+    int     calls;
+    bool    fail;
+} s_sink;
+
+static bool sink(const uint8_t *data, size_t len, void *ctx)
+{
+    (void)ctx;
+    s_sink.calls++;
+    if (s_sink.fail || s_sink.len + len > IMAGE_MAX)
+        return false;
+    memcpy(s_sink.data + s_sink.len, data, len);
+    s_sink.len += len;
+    return true;
+}
+
+static fw_stream_t s;
+static uint8_t image[IMAGE_MAX];
+
+void setUp(void)
+{
+    memset(&s_sink, 0, sizeof(s_sink));
+    for (size_t i = 0; i < sizeof(image); i++)
+        image[i] = (uint8_t)(i * 31 + (i >> 8));
+}
+
+void tearDown(void)
+{
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+/** Build one DATA frame into buf; returns its length. */
+static size_t make_frame(uint8_t *buf, uint16_t seq,
+                         const uint8_t *payload, uint16_t len)
+{
+    buf[0] = (uint8_t)(seq & 0xFF);
+    buf[1] = (uint8_t)(seq >> 8);
+    buf[2] = (uint8_t)(len & 0xFF);
+    buf[3] = (uint8_t)(len >> 8);
+    memcpy(buf + FW_STREAM_HEADER_SIZE, payload, len);
+    return FW_STREAM_HEADER_SIZE + len;
+}
+
+/** Serialize a whole image into back-to-back frames; returns total bytes. */
+static size_t make_stream(uint8_t *buf, const uint8_t *img, size_t img_len)
+{
+    size_t out = 0;
+    uint16_t seq = 0;
+    for (size_t off = 0; off < img_len; seq++) {
+        size_t n = img_len - off;
+        if (n > FW_STREAM_CHUNK_MAX) n = FW_STREAM_CHUNK_MAX;
+        out += make_frame(buf + out, seq, img + off, (uint16_t)n);
+        off += n;
+    }
+    return out;
+}
+
+static uint8_t wire[IMAGE_MAX + 64 * FW_STREAM_HEADER_SIZE];
+
+/* ── CRC-32 ──────────────────────────────────────────────────────────── */
+
+void test_crc32_check_value(void)
+{
+    /* Standard CRC-32 check value for "123456789" */
+    const uint8_t msg[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32_update(0, msg, 9));
+}
+
+void test_crc32_incremental_matches_oneshot(void)
+{
+    uint32_t whole = crc32_update(0, image, 5000);
+    uint32_t part = crc32_update(0, image, 1234);
+    part = crc32_update(part, image + 1234, 5000 - 1234);
+    TEST_ASSERT_EQUAL_HEX32(whole, part);
+}
+
+/* ── Happy path ──────────────────────────────────────────────────────── */
+
+void test_begin_is_active(void)
+{
+    fw_stream_begin(&s, 100, 0, sink, NULL, 0);
+    TEST_ASSERT_TRUE(fw_stream_active(&s));
+}
+
+void test_begin_zero_size_rejected(void)
+{
+    fw_stream_begin(&s, 0, 0, sink, NULL, 0);
+    TEST_ASSERT_FALSE(fw_stream_active(&s));
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_PROTOCOL, s.status);
+}
+
+void test_single_frame_image(void)
+{
+    fw_stream_begin(&s, 100, crc32_update(0, image, 100), sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, 100);
+
+    TEST_ASSERT_EQUAL(FW_STREAM_DONE, fw_stream_feed(&s, wire, n, 10));
+    TEST_ASSERT_EQUAL_UINT(100, s_sink.len);
+    TEST_ASSERT_EQUAL_MEMORY(image, s_sink.data, 100);
+}
+
+void test_multi_frame_image_in_one_feed(void)
+{
+    size_t img_len = 10000;
+    fw_stream_begin(&s, (uint32_t)img_len, crc32_update(0, image, img_len),
+                    sink, NULL, 0);
+    size_t n = make_stream(wire, image, img_len);
+
+    TEST_ASSERT_EQUAL(FW_STREAM_DONE, fw_stream_feed(&s, wire, n, 10));
+    TEST_ASSERT_EQUAL_UINT(img_len, s_sink.len);
+    TEST_ASSERT_EQUAL_MEMORY(image, s_sink.data, img_len);
+}
+
+void test_byte_at_a_time_feed(void)
+{
+    size_t img_len = 3000;
+    fw_stream_begin(&s, (uint32_t)img_len, crc32_update(0, image, img_len),
+                    sink, NULL, 0);
+    size_t n = make_stream(wire, image, img_len);
+
+    fw_stream_status_t st = FW_STREAM_ACTIVE;
+    for (size_t i = 0; i < n; i++)
+        st = fw_stream_feed(&s, &wire[i], 1, 1);
+
+    TEST_ASSERT_EQUAL(FW_STREAM_DONE, st);
+    TEST_ASSERT_EQUAL_MEMORY(image, s_sink.data, img_len);
+}
+
+void test_usb_packet_sized_feeds(void)
+{
+    /* Feed in 64-byte pieces, as the CDC endpoint delivers them */
+    size_t img_len = IMAGE_MAX;
+    fw_stream_begin(&s, (uint32_t)img_len, crc32_update(0, image, img_len),
+                    sink, NULL, 0);
+    size_t n = make_stream(wire, image, img_len);
+
+    fw_stream_status_t st = FW_STREAM_ACTIVE;
+    for (size_t off = 0; off < n; off += 64) {
+        size_t chunk = (n - off < 64) ? n - off : 64;
+        st = fw_stream_feed(&s, wire + off, chunk, 1);
+    }
+
+    TEST_ASSERT_EQUAL(FW_STREAM_DONE, st);
+    TEST_ASSERT_EQUAL_MEMORY(image, s_sink.data, img_len);
+}
+
+void test_payload_passed_without_per_byte_calls(void)
+{
+    /* One frame arriving whole must reach the sink in one call */
+    fw_stream_begin(&s, FW_STREAM_CHUNK_MAX,
+                    crc32_update(0, image, FW_STREAM_CHUNK_MAX),
+                    sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, FW_STREAM_CHUNK_MAX);
+    fw_stream_feed(&s, wire, n, 0);
+    TEST_ASSERT_EQUAL_INT(1, s_sink.calls);
+}
+
+/* ── Acknowledgement window ──────────────────────────────────────────── */
+
+void test_ack_every_n_frames(void)
+{
+    size_t img_len = FW_STREAM_CHUNK_MAX * (FW_STREAM_ACK_EVERY * 2 + 1);
+    fw_stream_begin(&s, (uint32_t)img_len, crc32_update(0, image, img_len),
+                    sink, NULL, 0);
+
+    uint8_t ack[FW_STREAM_ACK_SIZE];
+    size_t off = 0;
+    for (uint16_t seq = 0; off < img_len; seq++) {
+        size_t n = make_frame(wire, seq, image + off, FW_STREAM_CHUNK_MAX);
+        fw_stream_feed(&s, wire, n, 0);
+        off += FW_STREAM_CHUNK_MAX;
+
+        bool last = (off == img_len);
+        bool due  = ((seq + 1) % FW_STREAM_ACK_EVERY) == 0 || last;
+        TEST_ASSERT_EQUAL(due, fw_stream_take_ack(&s, ack));
+        if (due) {
+            TEST_ASSERT_EQUAL_HEX8(FW_STREAM_ACK_BYTE, ack[0]);
+            TEST_ASSERT_EQUAL_UINT16(seq, (uint16_t)(ack[1] | (ack[2] << 8)));
+        }
+    }
+}
+
+void test_ack_is_cumulative(void)
+{
+    /* Several ACK points in one feed collapse into the newest one */
+    size_t img_len = FW_STREAM_CHUNK_MAX * FW_STREAM_WINDOW;
+    fw_stream_begin(&s, (uint32_t)img_len + 1, 0, sink, NULL, 0);
+    size_t n = make_stream(wire, image, img_len);
+    fw_stream_feed(&s, wire, n, 0);
+
+    uint8_t ack[FW_STREAM_ACK_SIZE];
+    TEST_ASSERT_TRUE(fw_stream_take_ack(&s, ack));
+    TEST_ASSERT_EQUAL_UINT16(FW_STREAM_WINDOW - 1,
+                             (uint16_t)(ack[1] | (ack[2] << 8)));
+    TEST_ASSERT_FALSE(fw_stream_take_ack(&s, ack));
+}
+
+void test_window_leaves_room_for_ack_latency(void)
+{
+    /* Host must be able to keep sending while an ACK is in flight */
+    TEST_ASSERT_TRUE(FW_STREAM_WINDOW >= 2 * FW_STREAM_ACK_EVERY);
+    TEST_ASSERT_EQUAL_INT(0, FW_STREAM_WINDOW % FW_STREAM_ACK_EVERY);
+}
+
+void test_pipelined_throughput_model(void)
+{
+    /*
+     * With a stop-and-wait protocol every 1 KB chunk costs at least one
+     * 1 ms USB frame for the ACK poll.  With the window the host keeps
+     * FW_STREAM_WINDOW frames outstanding, so the per-frame ACK cost is
+     * amortised over FW_STREAM_ACK_EVERY frames and never stalls it.
+     */
+    const unsigned bytes_per_ms = 1216;   /* 19 × 64-byte packets / frame */
+    unsigned frame_bytes = FW_STREAM_HEADER_SIZE + FW_STREAM_CHUNK_MAX;
+    unsigned stop_wait_kbps = (FW_STREAM_CHUNK_MAX * 1000u) /
+                              (frame_bytes * 1000u / bytes_per_ms + 1000u);
+    unsigned windowed_kbps  = (FW_STREAM_CHUNK_MAX * bytes_per_ms) /
+                              frame_bytes;
+
+    printf("model: stop-and-wait %u KB/s, windowed %u KB/s\n",
+           stop_wait_kbps, windowed_kbps);
+    TEST_ASSERT_TRUE(windowed_kbps >= 800);
+    TEST_ASSERT_TRUE(windowed_kbps > 2 * stop_wait_kbps);
+}
+
+/* ── Errors ──────────────────────────────────────────────────────────── */
+
+void test_crc_mismatch(void)
+{
+    fw_stream_begin(&s, 100, 0xDEADBEEF, sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, 100);
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_CRC, fw_stream_feed(&s, wire, n, 0));
+}
+
+void test_out_of_order_seq_aborts(void)
+{
+    fw_stream_begin(&s, 2000, 0, sink, NULL, 0);
+    size_t n = make_frame(wire, 1, image, FW_STREAM_CHUNK_MAX);
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_PROTOCOL,
+                      fw_stream_feed(&s, wire, n, 0));
+    TEST_ASSERT_EQUAL_UINT(0, s_sink.len);
+}
+
+void test_short_non_final_frame_aborts(void)
+{
+    fw_stream_begin(&s, 2000, 0, sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, 100);
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_PROTOCOL,
+                      fw_stream_feed(&s, wire, n, 0));
+}
+
+void test_oversized_frame_aborts(void)
+{
+    fw_stream_begin(&s, 100, 0, sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, 101);
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_PROTOCOL,
+                      fw_stream_feed(&s, wire, n, 0));
+}
+
+void test_sink_failure_aborts(void)
+{
+    fw_stream_begin(&s, 100, 0, sink, NULL, 0);
+    s_sink.fail = true;
+    size_t n = make_frame(wire, 0, image, 100);
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_SINK, fw_stream_feed(&s, wire, n, 0));
+    TEST_ASSERT_FALSE(fw_stream_active(&s));
+}
+
+void test_idle_timeout(void)
+{
+    fw_stream_begin(&s, 100, 0, sink, NULL, 1000);
+    TEST_ASSERT_EQUAL(FW_STREAM_ACTIVE,
+                      fw_stream_poll(&s, 1000 + FW_STREAM_IDLE_TIMEOUT_MS - 1));
+    TEST_ASSERT_EQUAL(FW_STREAM_ERROR_TIMEOUT,
+                      fw_stream_poll(&s, 1000 + FW_STREAM_IDLE_TIMEOUT_MS));
+}
+
+void test_data_resets_idle_timeout(void)
+{
+    fw_stream_begin(&s, 2000, 0, sink, NULL, 0);
+    make_frame(wire, 0, image, FW_STREAM_CHUNK_MAX);
+    fw_stream_feed(&s, wire, 10, FW_STREAM_IDLE_TIMEOUT_MS - 1);
+    TEST_ASSERT_EQUAL(FW_STREAM_ACTIVE,
+                      fw_stream_poll(&s, 2 * FW_STREAM_IDLE_TIMEOUT_MS - 2));
+}
+
+void test_feed_after_done_is_ignored(void)
+{
+    fw_stream_begin(&s, 100, crc32_update(0, image, 100), sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, 100);
+    fw_stream_feed(&s, wire, n, 0);
+    TEST_ASSERT_EQUAL(FW_STREAM_DONE, fw_stream_feed(&s, wire, n, 0));
+    TEST_ASSERT_EQUAL_UINT(100, s_sink.len);
+}
+
+/* ── Result text ─────────────────────────────────────────────────────── */
+
+void test_result_reports_throughput(void)
+{
+    size_t img_len = 10000;
+    fw_stream_begin(&s, (uint32_t)img_len, crc32_update(0, image, img_len),
+                    sink, NULL, 100);
+    size_t n = make_stream(wire, image, img_len);
+    fw_stream_feed(&s, wire, n, 120);
+
+    char buf[64];
+    fw_stream_format_result(&s, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("OK 10000 20 500\n", buf);
+}
+
+void test_result_reports_error(void)
+{
+    fw_stream_begin(&s, 100, 0xDEADBEEF, sink, NULL, 0);
+    size_t n = make_frame(wire, 0, image, 100);
+    fw_stream_feed(&s, wire, n, 0);
+
+    char buf[96];
+    fw_stream_format_result(&s, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING_LEN("ERR crc mismatch", buf, 16);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* CRC-32 */
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_crc32_incremental_matches_oneshot);
+
+    /* Happy path */
+    RUN_TEST(test_begin_is_active);
+    RUN_TEST(test_begin_zero_size_rejected);
+    RUN_TEST(test_single_frame_image);
+    RUN_TEST(test_multi_frame_image_in_one_feed);
+    RUN_TEST(test_byte_at_a_time_feed);
+    RUN_TEST(test_usb_packet_sized_feeds);
+    RUN_TEST(test_payload_passed_without_per_byte_calls);
+
+    /* Acknowledgement window */
+    RUN_TEST(test_ack_every_n_frames);
+    RUN_TEST(test_ack_is_cumulative);
+    RUN_TEST(test_window_leaves_room_for_ack_latency);
+    RUN_TEST(test_pipelined_throughput_model);
+
+    /* Errors */
+    RUN_TEST(test_crc_mismatch);
+    RUN_TEST(test_out_of_order_seq_aborts);
+    RUN_TEST(test_short_non_final_frame_aborts);
+    RUN_TEST(test_oversized_frame_aborts);
+    RUN_TEST(test_sink_failure_aborts);
+    RUN_TEST(test_idle_timeout);
+    RUN_TEST(test_data_resets_idle_timeout);
+    RUN_TEST(test_feed_after_done_is_ignored);
+
+    /* Result text */
+    RUN_TEST(test_result_reports_throughput);
+    RUN_TEST(test_result_reports_error);
+
+    return UNITY_END();
+}
@@ -246,6 +246,110 @@ void test_hid_report_struct_is_13_bytes(void)
     TEST_ASSERT_EQUAL(13, sizeof(usb_gamepad_report_t));
 }
 
+/** Sum the bits of every Input (0x81) or Output (0x91) main item. */
+static uint32_t descriptor_bits(const uint8_t *desc, int desc_len,
+                                uint8_t main_item)
+{
+    uint32_t size = 0, count = 0, bits = 0;
+    for (int i = 0; i < desc_len; ) {
+        uint8_t  prefix = desc[i];
+        int      len    = (prefix & 0x03) == 3 ? 4 : (prefix & 0x03);
+        uint32_t value  = 0;
+        for (int b = 0; b < len; b++)
+            value |= (uint32_t)desc[i + 1 + b] << (8 * b);
+
+        switch (prefix & 0xFC) {
+        case 0x74: size  = value; break;    /* Report Size  */
+        case 0x94: count = value; break;    /* Report Count */
+        default:
+            if ((prefix & 0xFC) == (main_item & 0xFC))
+                bits += size * count;
+            break;
+        }
+        i += 1 + len;
+    }
+    return bits;
+}
+
+void test_hid_descriptor_matches_report_structs(void)
+{
+    const uint8_t *d = usb_hid_report_descriptor;
+    int len = USB_HID_REPORT_DESCRIPTOR_LEN;
+
+    TEST_ASSERT_EQUAL(8 * sizeof(usb_gamepad_report_t),
+                      descriptor_bits(d, len, 0x81));
+    TEST_ASSERT_EQUAL(8 * sizeof(usb_gamepad_output_t),
+                      descriptor_bits(d, len, 0x91));
+}
+
+/* ── Motion report ───────────────────────────────────────────────────── */
+
+void test_motion_descriptor_has_one_report_per_player(void)
+{
+    const uint8_t *d = usb_hid_motion_descriptor;
+    int len = USB_HID_MOTION_DESCRIPTOR_LEN;
+
+    TEST_ASSERT_EQUAL_HEX8(0xC0, d[len - 1]);
+    TEST_ASSERT_EQUAL(4 * 8 * sizeof(usb_motion_report_t),
+                      descriptor_bits(d, len, 0x81));
+    TEST_ASSERT_EQUAL(0, descriptor_bits(d, len, 0x91));
+}
+
+void test_motion_report_copied(void)
+{
+    gamepad_motion_t in = {
+        .gyro  = { -32768, 0, 32767 },
+        .accel = { 1, -1, 8192 },
+        .timestamp_us = 0xDEADBEEF,
+    };
+    usb_motion_report_t out;
+    usb_hid_report_from_motion(&in, &out);
+
+    TEST_ASSERT_EQUAL(16, sizeof(out));
+    TEST_ASSERT_EQUAL_INT16_ARRAY(in.gyro, out.gyro, 3);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(in.accel, out.accel, 3);
+    TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, out.timestamp_us);
+}
+
+void test_motion_fits_in_frame_with_all_gamepads(void)
+{
+    /* Four players plus motion, every endpoint busy in the same frame */
+    TEST_ASSERT_EQUAL(4 * (13 + 13) + (1 + 16 + 13),
+                      USB_HID_PERIODIC_BYTES(4));
+    TEST_ASSERT_TRUE(USB_HID_PERIODIC_BYTES(4) <= USB_FS_PERIODIC_FRAME_BYTES);
+}
+
+/* ── USB HID output report ───────────────────────────────────────────── */
+
+void test_hid_output_parsed(void)
+{
+    const uint8_t buf[] = { 0xFF, 0x40, 0x05 };
+    gamepad_output_t out;
+
+    TEST_ASSERT_TRUE(usb_hid_report_to_output(buf, sizeof(buf), &out));
+    TEST_ASSERT_EQUAL_UINT8(0xFF, out.strong);
+    TEST_ASSERT_EQUAL_UINT8(0x40, out.weak);
+    TEST_ASSERT_EQUAL_UINT8(GAMEPAD_LED_PLAYER(1) | GAMEPAD_LED_PLAYER(3),
+                            out.leds);
+}
+
+void test_hid_output_padding_ignored(void)
+{
+    const uint8_t buf[] = { 0, 0, 0xF2 };
+    gamepad_output_t out;
+
+    TEST_ASSERT_TRUE(usb_hid_report_to_output(buf, sizeof(buf), &out));
+    TEST_ASSERT_EQUAL_UINT8(GAMEPAD_LED_PLAYER(2), out.leds);
+}
+
+void test_hid_output_short_rejected(void)
+{
+    const uint8_t buf[] = { 0x10, 0x20 };
+    gamepad_output_t out;
+
+    TEST_ASSERT_FALSE(usb_hid_report_to_output(buf, sizeof(buf), &out));
+}
+
 /* ── Test runner ─────────────────────────────────────────────────────── */
 
 int main(void)
@@ -287,6 +391,17 @@ int main(void)
     RUN_TEST(test_hid_descriptor_starts_with_usage_page);
     RUN_TEST(test_hid_descriptor_ends_with_end_collection);
     RUN_TEST(test_hid_report_struct_is_13_bytes);
+    RUN_TEST(test_hid_descriptor_matches_report_structs);
+
+    /* USB HID output report */
+    RUN_TEST(test_hid_output_parsed);
+    RUN_TEST(test_hid_output_padding_ignored);
+    RUN_TEST(test_hid_output_short_rejected);
+
+    /* Motion report */
+    RUN_TEST(test_motion_descriptor_has_one_report_per_player);
+    RUN_TEST(test_motion_report_copied);
+    RUN_TEST(test_motion_fits_in_frame_with_all_gamepads);
 
     return UNITY_END();
 }
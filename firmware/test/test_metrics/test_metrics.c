@@ -0,0 +1,152 @@
+#include "unity.h"
+#include "metrics.h"
+#include <string.h>
+
+static char out[256];
+static int  getter_calls;
+
+void setUp(void)
+{
+    metrics_reset();
+    memset(out, 0, sizeof(out));
+    getter_calls = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static uint32_t get_u32(void *ctx)
+{
+    getter_calls++;
+    return *(uint32_t *)ctx;
+}
+
+static const char *get_text(void *ctx)
+{
+    getter_calls++;
+    return (const char *)ctx;
+}
+
+static const char *get_null(void *ctx)
+{
+    (void)ctx;
+    return NULL;
+}
+
+/* ── Registration ────────────────────────────────────────────────────── */
+
+void test_empty_registry(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, metrics_count());
+    TEST_ASSERT_EQUAL_INT(0, metrics_format(0, " ", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void test_register_rejects_null(void)
+{
+    uint32_t c = 0;
+    TEST_ASSERT_FALSE(metrics_register_counter(NULL, &c, 0));
+    TEST_ASSERT_FALSE(metrics_register_counter("c", NULL, 0));
+    TEST_ASSERT_FALSE(metrics_register_u32("u", NULL, NULL, 0));
+    TEST_ASSERT_FALSE(metrics_register_text("t", NULL, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, metrics_count());
+}
+
+void test_register_until_full(void)
+{
+    static uint32_t c;
+    for (int i = 0; i < METRICS_MAX; i++)
+        TEST_ASSERT_TRUE(metrics_register_counter("c", &c, 0));
+    TEST_ASSERT_FALSE(metrics_register_counter("c", &c, 0));
+    TEST_ASSERT_EQUAL_INT(METRICS_MAX, metrics_count());
+}
+
+void test_name_out_of_range(void)
+{
+    TEST_ASSERT_NULL(metrics_name(0));
+    TEST_ASSERT_NULL(metrics_name(-1));
+    TEST_ASSERT_EQUAL_INT(-1, metrics_format_value(0, out, sizeof(out)));
+}
+
+/* ── Evaluation ──────────────────────────────────────────────────────── */
+
+void test_counter_read_at_format_time(void)
+{
+    static uint32_t c;
+    c = 0;
+    metrics_register_counter("frames", &c, 0);
+    c = 1234;
+
+    metrics_format_value(0, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("1234", out);
+}
+
+void test_getters_not_called_until_read(void)
+{
+    static uint32_t v = 5;
+    metrics_register_u32("v", get_u32, &v, 0);
+    metrics_register_text("t", get_text, "on", 0);
+    TEST_ASSERT_EQUAL_INT(0, getter_calls);
+
+    metrics_format(0, " ", out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(2, getter_calls);
+    TEST_ASSERT_EQUAL_STRING("v=5 t=on", out);
+}
+
+void test_text_getter_null_is_empty(void)
+{
+    metrics_register_text("t", get_null, NULL, 0);
+    metrics_format(0, " ", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("t=", out);
+}
+
+void test_format_filters_by_flags(void)
+{
+    static uint32_t a = 1, b = 2;
+    metrics_register_counter("a", &a, METRICS_F_STATUS);
+    metrics_register_counter("b", &b, 0);
+
+    metrics_format(METRICS_F_STATUS, " ", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("a=1", out);
+
+    metrics_format(0, ",", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("a=1,b=2", out);
+}
+
+void test_format_truncates_to_buffer(void)
+{
+    static uint32_t a = 123456;
+    metrics_register_counter("alpha", &a, 0);
+    metrics_register_counter("beta", &a, 0);
+
+    char small[12];
+    int n = metrics_format(0, " ", small, sizeof(small));
+    TEST_ASSERT_EQUAL_INT((int)strlen(small), n);
+    TEST_ASSERT_TRUE(n < (int)sizeof(small));
+    TEST_ASSERT_EQUAL_STRING("alpha=12345", small);
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* Registration */
+    RUN_TEST(test_empty_registry);
+    RUN_TEST(test_register_rejects_null);
+    RUN_TEST(test_register_until_full);
+    RUN_TEST(test_name_out_of_range);
+
+    /* Evaluation */
+    RUN_TEST(test_counter_read_at_format_time);
+    RUN_TEST(test_getters_not_called_until_read);
+    RUN_TEST(test_text_getter_null_is_empty);
+    RUN_TEST(test_format_filters_by_flags);
+    RUN_TEST(test_format_truncates_to_buffer);
+
+    return UNITY_END();
+}
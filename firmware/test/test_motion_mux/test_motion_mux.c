@@ -0,0 +1,135 @@
+#include "unity.h"
+#include "motion_mux.h"
+
+#include <string.h>
+
+static motion_mux_t m;
+
+void setUp(void)
+{
+    memset(&m, 0, sizeof(m));
+}
+
+void tearDown(void)
+{
+}
+
+static gamepad_motion_t sample(int16_t gx, uint32_t t)
+{
+    gamepad_motion_t s;
+    memset(&s, 0, sizeof(s));
+    s.gyro[0]      = gx;
+    s.timestamp_us = t;
+    return s;
+}
+
+/* ── Newest sample wins ───────────────────────────────────────────────── */
+
+void test_empty_mux_has_nothing(void)
+{
+    uint8_t idx;
+    gamepad_motion_t out;
+    TEST_ASSERT_FALSE(motion_mux_take(&m, &idx, &out));
+}
+
+void test_sample_taken_once(void)
+{
+    uint8_t idx;
+    gamepad_motion_t s = sample(5, 100), out;
+    motion_mux_push(&m, 2, &s);
+
+    TEST_ASSERT_TRUE(motion_mux_take(&m, &idx, &out));
+    TEST_ASSERT_EQUAL_UINT8(2, idx);
+    TEST_ASSERT_EQUAL_INT16(5, out.gyro[0]);
+    TEST_ASSERT_EQUAL_UINT32(100, out.timestamp_us);
+    TEST_ASSERT_FALSE(motion_mux_take(&m, &idx, &out));
+}
+
+void test_unsent_sample_replaced(void)
+{
+    uint8_t idx;
+    gamepad_motion_t a = sample(1, 100), b = sample(2, 200), out;
+    motion_mux_push(&m, 0, &a);
+    motion_mux_push(&m, 0, &b);
+
+    TEST_ASSERT_TRUE(motion_mux_take(&m, &idx, &out));
+    TEST_ASSERT_EQUAL_UINT32(200, out.timestamp_us);
+    TEST_ASSERT_EQUAL_UINT32(1, m.replaced);
+    TEST_ASSERT_FALSE(motion_mux_take(&m, &idx, &out));
+}
+
+void test_out_of_range_player_ignored(void)
+{
+    uint8_t idx;
+    gamepad_motion_t s = sample(1, 1), out;
+    motion_mux_push(&m, BT_GAMEPAD_MAX, &s);
+    TEST_ASSERT_FALSE(motion_mux_take(&m, &idx, &out));
+}
+
+/* ── Fair sharing of the endpoint ─────────────────────────────────────── */
+
+void test_players_take_turns(void)
+{
+    uint8_t idx;
+    gamepad_motion_t s = sample(0, 0), out;
+
+    /* Every player streams a new sample every frame */
+    int per_player[BT_GAMEPAD_MAX] = { 0 };
+    for (int frame = 0; frame < 400; frame++) {
+        for (uint8_t i = 0; i < BT_GAMEPAD_MAX; i++)
+            motion_mux_push(&m, i, &s);
+        TEST_ASSERT_TRUE(motion_mux_take(&m, &idx, &out));
+        per_player[idx]++;
+    }
+
+    for (int i = 0; i < BT_GAMEPAD_MAX; i++)
+        TEST_ASSERT_EQUAL(400 / BT_GAMEPAD_MAX, per_player[i]);
+}
+
+void test_idle_players_skipped(void)
+{
+    uint8_t idx;
+    gamepad_motion_t s = sample(0, 0), out;
+
+    motion_mux_push(&m, 3, &s);
+    TEST_ASSERT_TRUE(motion_mux_take(&m, &idx, &out));
+    TEST_ASSERT_EQUAL_UINT8(3, idx);
+
+    /* A lone streaming player gets every frame */
+    motion_mux_push(&m, 1, &s);
+    TEST_ASSERT_TRUE(motion_mux_take(&m, &idx, &out));
+    TEST_ASSERT_EQUAL_UINT8(1, idx);
+    motion_mux_push(&m, 1, &s);
+    TEST_ASSERT_TRUE(motion_mux_take(&m, &idx, &out));
+    TEST_ASSERT_EQUAL_UINT8(1, idx);
+}
+
+void test_reset_drops_pending(void)
+{
+    uint8_t idx;
+    gamepad_motion_t s = sample(0, 0), out;
+    motion_mux_push(&m, 0, &s);
+    motion_mux_push(&m, 1, &s);
+    motion_mux_reset(&m);
+
+    TEST_ASSERT_FALSE(motion_mux_take(&m, &idx, &out));
+    TEST_ASSERT_EQUAL_UINT32(2, m.pushed);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_mux_has_nothing);
+    RUN_TEST(test_sample_taken_once);
+    RUN_TEST(test_unsent_sample_replaced);
+    RUN_TEST(test_out_of_range_player_ignored);
+
+    RUN_TEST(test_players_take_turns);
+    RUN_TEST(test_idle_players_skipped);
+    RUN_TEST(test_reset_drops_pending);
+
+    return UNITY_END();
+}
@@ -0,0 +1,132 @@
+#include "unity.h"
+#include "name_index.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static name_index_t idx;
+
+void setUp(void)
+{
+    memset(&idx, 0xEE, sizeof(idx));
+}
+
+void tearDown(void)
+{
+}
+
+/* The config schema's names, then plausible ones up to NAME_INDEX_MAX */
+static const char *const s_full[] = {
+    "wifi_ssid", "wifi_password", "power_pulse_ms", "boot_timeout_ms",
+    "device_name", "wol_mac", "usb_keepalive_ms", "stick_threshold",
+    "trigger_threshold", "motion_report", "usb_mode", "lstick_deadzone",
+    "lstick_outer", "lstick_anti", "lstick_expo", "rstick_deadzone",
+    "rstick_outer", "rstick_anti", "rstick_expo", "trigger_deadzone",
+    "trigger_outer", "trigger_anti", "trigger_expo", "button_map",
+    "lstick_invert", "rstick_invert", "led_brightness", "wake_button",
+    "sleep_timeout_ms", "rumble_scale", "wifi_hostname", "log_level",
+};
+
+#define FULL_COUNT (int)(sizeof(s_full) / sizeof(s_full[0]))
+
+_Static_assert(FULL_COUNT == NAME_INDEX_MAX, "fill the index to its limit");
+
+static void assert_finds_all(const char *const *names, int count)
+{
+    for (int i = 0; i < count; i++)
+        TEST_ASSERT_EQUAL_INT_MESSAGE(i, name_index_find(&idx, names[i]),
+                                      names[i]);
+}
+
+static void assert_rejects_unknown(void)
+{
+    TEST_ASSERT_EQUAL_INT(-1, name_index_find(&idx, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, name_index_find(&idx, ""));
+    TEST_ASSERT_EQUAL_INT(-1, name_index_find(&idx, "nonexistent"));
+    TEST_ASSERT_EQUAL_INT(-1, name_index_find(&idx, "device_nam"));
+    TEST_ASSERT_EQUAL_INT(-1, name_index_find(&idx, "device_name_"));
+}
+
+/* ── Perfect tables ───────────────────────────────────────────────────── */
+
+void test_every_prefix_of_the_schema_is_perfect(void)
+{
+    /* Every schema size up to the asserted limit gets a seed */
+    for (int n = 1; n <= FULL_COUNT; n++) {
+        TEST_ASSERT_TRUE_MESSAGE(name_index_build(&idx, s_full, n),
+                                 s_full[n - 1]);
+        TEST_ASSERT_TRUE(idx.perfect);
+        assert_finds_all(s_full, n);
+    }
+    assert_rejects_unknown();
+}
+
+void test_perfect_table_matches_its_seed(void)
+{
+    TEST_ASSERT_TRUE(name_index_build(&idx, s_full, FULL_COUNT));
+
+    int used = 0;
+    for (int s = 0; s < NAME_INDEX_SLOTS; s++) {
+        if (idx.slot[s] < 0)
+            continue;
+        TEST_ASSERT_LESS_THAN_INT(FULL_COUNT, idx.slot[s]);
+        used++;
+    }
+    TEST_ASSERT_EQUAL_INT(FULL_COUNT, used);
+}
+
+void test_empty_list(void)
+{
+    TEST_ASSERT_TRUE(name_index_build(&idx, s_full, 0));
+    TEST_ASSERT_EQUAL_INT(-1, name_index_find(&idx, "wifi_ssid"));
+    assert_rejects_unknown();
+}
+
+/* ── Fallback ─────────────────────────────────────────────────────────── */
+
+void test_duplicates_fall_back_to_scan(void)
+{
+    /* Equal names always collide, so no seed exists */
+    static const char *const dup[] = { "usb_mode", "wol_mac", "usb_mode" };
+
+    TEST_ASSERT_FALSE(name_index_build(&idx, dup, 3));
+    TEST_ASSERT_FALSE(idx.perfect);
+    TEST_ASSERT_EQUAL_UINT32(0, idx.seed);
+    for (int s = 0; s < NAME_INDEX_SLOTS; s++)
+        TEST_ASSERT_EQUAL_INT8(-1, idx.slot[s]);
+
+    TEST_ASSERT_EQUAL_INT(0, name_index_find(&idx, "usb_mode"));
+    TEST_ASSERT_EQUAL_INT(1, name_index_find(&idx, "wol_mac"));
+    assert_rejects_unknown();
+}
+
+void test_too_many_names_fall_back_to_scan(void)
+{
+    static char buf[NAME_INDEX_SLOTS][8];
+    static const char *names[NAME_INDEX_SLOTS];
+    for (int i = 0; i < NAME_INDEX_SLOTS; i++) {
+        snprintf(buf[i], sizeof(buf[i]), "k%d", i);
+        names[i] = buf[i];
+    }
+
+    TEST_ASSERT_FALSE(name_index_build(&idx, names, NAME_INDEX_SLOTS));
+    TEST_ASSERT_FALSE(idx.perfect);
+    assert_finds_all(names, NAME_INDEX_SLOTS);
+    assert_rejects_unknown();
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_every_prefix_of_the_schema_is_perfect);
+    RUN_TEST(test_perfect_table_matches_its_seed);
+    RUN_TEST(test_empty_list);
+
+    RUN_TEST(test_duplicates_fall_back_to_scan);
+    RUN_TEST(test_too_many_names_fall_back_to_scan);
+
+    return UNITY_END();
+}
@@ -0,0 +1,186 @@
+#include "unity.h"
+#include "output_coalesce.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define INTERVAL_MS 25
+#define REFRESH_MS  250
+
+static output_coalesce_t c;
+
+void setUp(void)
+{
+    output_coalesce_init(&c, INTERVAL_MS, REFRESH_MS);
+}
+
+void tearDown(void)
+{
+}
+
+static gamepad_output_t rumble(uint8_t strong, uint8_t weak)
+{
+    gamepad_output_t o = { strong, weak, 0 };
+    return o;
+}
+
+/* ── Updates ──────────────────────────────────────────────────────────── */
+
+void test_nothing_to_send_initially(void)
+{
+    gamepad_output_t out;
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, 0, &out));
+}
+
+void test_first_request_sent_at_once(void)
+{
+    gamepad_output_t o = rumble(200, 100), out;
+    output_coalesce_set(&c, &o);
+
+    TEST_ASSERT_TRUE(output_coalesce_take(&c, 1000, &out));
+    TEST_ASSERT_EQUAL_UINT8(200, out.strong);
+    TEST_ASSERT_EQUAL_UINT8(100, out.weak);
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, 1000, &out));
+}
+
+void test_motors_off_before_first_send_is_nothing(void)
+{
+    gamepad_output_t o = rumble(0, 0), out;
+    output_coalesce_set(&c, &o);
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, 0, &out));
+}
+
+void test_repeated_state_not_resent(void)
+{
+    gamepad_output_t o = rumble(50, 0), out;
+    output_coalesce_set(&c, &o);
+    output_coalesce_take(&c, 0, &out);
+
+    output_coalesce_set(&c, &o);
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, INTERVAL_MS, &out));
+}
+
+void test_led_change_sent(void)
+{
+    gamepad_output_t o = { 0, 0, GAMEPAD_LED_PLAYER(2) }, out;
+    output_coalesce_set(&c, &o);
+
+    TEST_ASSERT_TRUE(output_coalesce_take(&c, 0, &out));
+    TEST_ASSERT_EQUAL_UINT8(GAMEPAD_LED_PLAYER(2), out.leds);
+}
+
+/* ── Rate bound ───────────────────────────────────────────────────────── */
+
+void test_updates_within_interval_coalesced(void)
+{
+    gamepad_output_t out;
+    gamepad_output_t a = rumble(10, 0);
+    output_coalesce_set(&c, &a);
+    output_coalesce_take(&c, 100, &out);
+
+    for (uint8_t v = 11; v <= 20; v++) {
+        gamepad_output_t o = rumble(v, v);
+        output_coalesce_set(&c, &o);
+        TEST_ASSERT_FALSE(output_coalesce_take(&c, 100 + v, &out));
+    }
+
+    /* Only the latest state goes out once the interval has passed */
+    TEST_ASSERT_TRUE(output_coalesce_take(&c, 100 + INTERVAL_MS, &out));
+    TEST_ASSERT_EQUAL_UINT8(20, out.strong);
+    TEST_ASSERT_EQUAL_UINT32(9, c.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(2, c.updates);
+}
+
+void test_change_back_within_interval_sends_nothing(void)
+{
+    gamepad_output_t a = rumble(10, 0), b = rumble(99, 0), out;
+    output_coalesce_set(&c, &a);
+    output_coalesce_take(&c, 0, &out);
+
+    output_coalesce_set(&c, &b);
+    output_coalesce_set(&c, &a);
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, INTERVAL_MS, &out));
+}
+
+/* ── Refresh of running motors ────────────────────────────────────────── */
+
+void test_running_motor_refreshed(void)
+{
+    gamepad_output_t o = rumble(0, 80), out;
+    output_coalesce_set(&c, &o);
+    output_coalesce_take(&c, 0, &out);
+
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, REFRESH_MS - 1, &out));
+    TEST_ASSERT_TRUE(output_coalesce_take(&c, REFRESH_MS, &out));
+    TEST_ASSERT_EQUAL_UINT8(80, out.weak);
+}
+
+void test_stopped_motor_not_refreshed(void)
+{
+    gamepad_output_t on = rumble(80, 0), off = rumble(0, 0), out;
+    output_coalesce_set(&c, &on);
+    output_coalesce_take(&c, 0, &out);
+    output_coalesce_set(&c, &off);
+    TEST_ASSERT_TRUE(output_coalesce_take(&c, INTERVAL_MS, &out));
+    TEST_ASSERT_EQUAL_UINT8(0, out.strong);
+
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, 10 * REFRESH_MS, &out));
+}
+
+void test_reset_forgets_controller_state(void)
+{
+    gamepad_output_t o = rumble(80, 0), out;
+    output_coalesce_set(&c, &o);
+    output_coalesce_take(&c, 0, &out);
+    output_coalesce_reset(&c);
+
+    /* New connection: no refresh of the old motor state */
+    TEST_ASSERT_FALSE(output_coalesce_take(&c, REFRESH_MS, &out));
+    output_coalesce_set(&c, &o);
+    TEST_ASSERT_TRUE(output_coalesce_take(&c, REFRESH_MS + 1, &out));
+}
+
+/* ── Benchmark: a game rewriting rumble every millisecond ─────────────── */
+
+void test_benchmark_rumble_spam(void)
+{
+    uint32_t sent = 0;
+    gamepad_output_t out;
+
+    for (uint32_t t = 0; t < 10000; t++) {
+        gamepad_output_t o = rumble((uint8_t)(t / 4), (uint8_t)(255 - t / 4));
+        output_coalesce_set(&c, &o);
+        if (output_coalesce_take(&c, t, &out))
+            sent++;
+    }
+
+    printf("rumble: %u host updates -> %u controller updates in 10 s\n",
+           (unsigned)c.requests, (unsigned)sent);
+    /* Bounded by the interval, yet every interval carries the new state */
+    TEST_ASSERT_TRUE(sent <= 10000 / INTERVAL_MS);
+    TEST_ASSERT_TRUE(sent >= 10000 / INTERVAL_MS - 1);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nothing_to_send_initially);
+    RUN_TEST(test_first_request_sent_at_once);
+    RUN_TEST(test_motors_off_before_first_send_is_nothing);
+    RUN_TEST(test_repeated_state_not_resent);
+    RUN_TEST(test_led_change_sent);
+
+    RUN_TEST(test_updates_within_interval_coalesced);
+    RUN_TEST(test_change_back_within_interval_sends_nothing);
+
+    RUN_TEST(test_running_motor_refreshed);
+    RUN_TEST(test_stopped_motor_not_refreshed);
+    RUN_TEST(test_reset_forgets_controller_state);
+
+    RUN_TEST(test_benchmark_rumble_spam);
+
+    return UNITY_END();
+}
@@ -0,0 +1,568 @@
+#include "unity.h"
+#include "pc_power_fusion.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+/*
+ * Each scenario starts from a settled baseline, then plays a list of
+ * signal changes at ms offsets from T0 while updating every 20 ms (the
+ * hardware task period).  The verdict changes are recorded and checked.
+ *
+ * The orderings are the ones seen on real machines: Windows and Linux
+ * suspend the bus before or after the LED starts blinking, shut down
+ * with or without suspending first, keep or drop 5 V standby, and some
+ * boards light the LED steadily (or not at all) in S3.
+ */
+
+#define T0          60000u      /* baseline signals are long settled */
+#define TICK_MS     20u
+#define MAX_CHANGES 8
+
+static pc_fusion_t f;
+
+typedef enum { RAW, LED, USB, VBUS } step_sig_t;
+
+typedef struct {
+    uint32_t at_ms;         /* offset from T0 */
+    step_sig_t sig;
+    uint8_t  value;
+} step_t;
+
+typedef struct {
+    pc_fusion_verdict_t verdict;
+    pc_power_event_t    event;
+    uint32_t            at_ms;  /* offset from T0 */
+} change_t;
+
+static change_t changes[MAX_CHANGES];
+static int      change_count;
+
+void setUp(void)
+{
+    change_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+static void apply(const step_t *s, uint32_t now)
+{
+    power_led_pattern_t pattern = (power_led_pattern_t)f.led.value;
+
+    switch (s->sig) {
+    case RAW:
+        pc_fusion_set_led(&f, pattern, s->value, now);
+        break;
+    case LED:
+        pattern = (power_led_pattern_t)s->value;
+        pc_fusion_set_led(&f, pattern,
+                          pattern == POWER_LED_PATTERN_BLINK
+                              ? f.led_raw
+                              : pattern == POWER_LED_PATTERN_ON,
+                          now);
+        break;
+    case USB:
+        pc_fusion_set_usb(&f, (pc_fusion_usb_t)s->value, now);
+        break;
+    case VBUS:
+        pc_fusion_set_vbus(&f, s->value, now);
+        break;
+    }
+}
+
+static void tick(uint32_t now)
+{
+    pc_power_event_t ev;
+    if (pc_fusion_update(&f, now, &ev) && change_count < MAX_CHANGES)
+        changes[change_count++] = (change_t){ f.verdict, ev, now - T0 };
+}
+
+/** Settle the baseline until T0, then play steps for `run_ms`. */
+static void play(const step_t *steps, int count, uint32_t run_ms)
+{
+    for (uint32_t t = 0; t < T0; t += TICK_MS)
+        tick(t);
+    change_count = 0;
+
+    int next = 0;
+    for (uint32_t off = 0; off <= run_ms; off += TICK_MS) {
+        while (next < count && steps[next].at_ms <= off) {
+            apply(&steps[next], T0 + off);
+            next++;
+        }
+        tick(T0 + off);
+    }
+}
+
+#define PLAY(steps, run_ms) play(steps, (int)(sizeof(steps) / sizeof(steps[0])), run_ms)
+
+static void baseline_running(bool has_vbus)
+{
+    pc_fusion_init(&f, POWER_LED_PATTERN_ON, true, has_vbus, true, 0);
+    pc_fusion_set_usb(&f, PC_FUSION_USB_MOUNTED, 0);
+}
+
+static void baseline_sleeping(bool has_vbus)
+{
+    pc_fusion_init(&f, POWER_LED_PATTERN_BLINK, false, has_vbus, true, 0);
+    pc_fusion_set_usb(&f, PC_FUSION_USB_SUSPENDED, 0);
+}
+
+static void baseline_off(bool has_vbus)
+{
+    pc_fusion_init(&f, POWER_LED_PATTERN_OFF, false, has_vbus, false, 0);
+}
+
+static void expect_change(int i, pc_fusion_verdict_t verdict, uint32_t at_ms)
+{
+    TEST_ASSERT_TRUE_MESSAGE(i < change_count, "missing verdict change");
+    TEST_ASSERT_EQUAL_STRING(pc_fusion_verdict_name(verdict),
+                             pc_fusion_verdict_name(changes[i].verdict));
+    TEST_ASSERT_EQUAL_UINT32(at_ms, changes[i].at_ms);
+}
+
+/* ── Baselines ───────────────────────────────────────────────────────── */
+
+void test_boot_snapshot_led_on_is_powered(void)
+{
+    pc_fusion_init(&f, POWER_LED_PATTERN_ON, true, false, false, 0);
+    pc_power_event_t ev;
+    TEST_ASSERT_TRUE(pc_fusion_update(&f, 0, &ev));
+    TEST_ASSERT_EQUAL(PC_FUSION_POWERED, pc_fusion_verdict(&f));
+    TEST_ASSERT_EQUAL(PC_EVENT_POWER_LED_ON, ev);
+
+    pc_fusion_set_usb(&f, PC_FUSION_USB_MOUNTED, 500);
+    TEST_ASSERT_TRUE(pc_fusion_update(&f, 500, &ev));
+    TEST_ASSERT_EQUAL(PC_FUSION_RUNNING, pc_fusion_verdict(&f));
+    TEST_ASSERT_EQUAL(PC_EVENT_USB_ENUMERATED, ev);
+}
+
+void test_boot_snapshot_led_off_is_off(void)
+{
+    pc_fusion_init(&f, POWER_LED_PATTERN_OFF, false, false, false, 0);
+    pc_power_event_t ev;
+    TEST_ASSERT_TRUE(pc_fusion_update(&f, 0, &ev));
+    TEST_ASSERT_EQUAL(PC_FUSION_OFF, pc_fusion_verdict(&f));
+    TEST_ASSERT_EQUAL(PC_EVENT_POWER_LED_OFF, ev);
+    TEST_ASSERT_FALSE(pc_fusion_update(&f, 20, &ev));
+}
+
+void test_baselines_settle(void)
+{
+    baseline_running(false);
+    play(NULL, 0, 0);
+    TEST_ASSERT_EQUAL(PC_FUSION_RUNNING, pc_fusion_verdict(&f));
+
+    baseline_sleeping(false);
+    play(NULL, 0, 0);
+    TEST_ASSERT_EQUAL(PC_FUSION_SLEEPING, pc_fusion_verdict(&f));
+
+    baseline_off(true);
+    play(NULL, 0, 0);
+    TEST_ASSERT_EQUAL(PC_FUSION_OFF, pc_fusion_verdict(&f));
+}
+
+/* ── Entering sleep ──────────────────────────────────────────────────── */
+
+void test_sleep_suspend_then_blink(void)
+{
+    static const step_t s[] = {
+        {   0, USB, PC_FUSION_USB_SUSPENDED },
+        { 500, RAW, false }, { 1000, RAW, true }, { 1500, RAW, false },
+        {2000, RAW, true  }, { 2000, LED, POWER_LED_PATTERN_BLINK },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_SLEEPING, 2000);
+    TEST_ASSERT_EQUAL(PC_EVENT_POWER_LED_BLINK, changes[0].event);
+}
+
+void test_sleep_blink_then_suspend(void)
+{
+    static const step_t s[] = {
+        {   0, RAW, false }, {  500, RAW, true }, { 1000, RAW, false },
+        {1500, RAW, true  }, { 1500, LED, POWER_LED_PATTERN_BLINK },
+        {2500, USB, PC_FUSION_USB_SUSPENDED },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_SLEEPING, 1500);
+}
+
+void test_sleep_led_stays_lit(void)
+{
+    /* Board keeps the LED on in S3: only the sustained suspend shows it */
+    static const step_t s[] = {
+        { 0, USB, PC_FUSION_USB_SUSPENDED },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_SLEEPING, PC_FUSION_SUSPEND_CONFIRM_MS);
+}
+
+void test_sleep_led_stays_lit_with_vbus(void)
+{
+    static const step_t s[] = {
+        { 0, USB, PC_FUSION_USB_SUSPENDED },
+    };
+    baseline_running(true);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_SLEEPING, PC_FUSION_SUSPEND_CONFIRM_MS);
+}
+
+void test_brief_suspend_is_not_sleep(void)
+{
+    /* Selective suspend or a bus reset: first-event-wins would sleep */
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_SUSPENDED },
+        { 1000, USB, PC_FUSION_USB_MOUNTED },
+        { 5000, USB, PC_FUSION_USB_SUSPENDED },
+        { 7900, USB, PC_FUSION_USB_MOUNTED },
+    };
+    baseline_running(false);
+    PLAY(s, 20000);
+
+    TEST_ASSERT_EQUAL_INT(0, change_count);
+}
+
+void test_dark_sleep_with_vbus(void)
+{
+    /* LED goes dark in S3; 5 V standby tells it apart from shutdown, so
+     * the first sign of the LED going out already decides */
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_SUSPENDED },
+        {  500, RAW, false },
+        { 2000, LED, POWER_LED_PATTERN_OFF },
+    };
+    baseline_running(true);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_SLEEPING, 500);
+}
+
+void test_dark_sleep_without_vbus_reads_as_off(void)
+{
+    /* Indistinguishable from suspend-then-shutdown without VBUS */
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_SUSPENDED },
+        {  500, RAW, false },
+        { 2000, LED, POWER_LED_PATTERN_OFF },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_OFF, 2000);
+}
+
+/* ── Shutdown ────────────────────────────────────────────────────────── */
+
+void test_shutdown_detach_then_led_off(void)
+{
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_DETACHED },
+        { 1000, RAW, false },
+        { 2500, LED, POWER_LED_PATTERN_OFF },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_OFF, 2500);
+    TEST_ASSERT_EQUAL(PC_EVENT_POWER_LED_OFF, changes[0].event);
+}
+
+void test_shutdown_suspend_then_led_off(void)
+{
+    /* LED starts going out before the suspend window matures, so no
+     * transient sleep verdict */
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_SUSPENDED },
+        { 2000, RAW, false },
+        { 3500, LED, POWER_LED_PATTERN_OFF },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_OFF, 3500);
+}
+
+void test_shutdown_led_off_then_detach(void)
+{
+    static const step_t s[] = {
+        {    0, RAW, false },
+        { 1500, LED, POWER_LED_PATTERN_OFF },
+        { 4000, USB, PC_FUSION_USB_DETACHED },
+    };
+    baseline_running(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_OFF, 1500);
+}
+
+void test_shutdown_vbus_drop_beats_led_hold(void)
+{
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_DETACHED },
+        {  800, RAW, false },
+        {  800, VBUS, false },
+        { 2300, LED, POWER_LED_PATTERN_OFF },
+    };
+    baseline_running(true);
+    PLAY(s, 10000);
+
+    /* Still powered while only USB is gone, then off on the VBUS drop */
+    TEST_ASSERT_EQUAL_INT(2, change_count);
+    expect_change(0, PC_FUSION_POWERED, 0);
+    expect_change(1, PC_FUSION_OFF, 800);
+}
+
+void test_reboot_detach_is_not_shutdown(void)
+{
+    /* OS restart: USB drops for a few seconds, LED stays lit */
+    static const step_t s[] = {
+        {    0, USB, PC_FUSION_USB_DETACHED },
+        { 8000, USB, PC_FUSION_USB_MOUNTED },
+    };
+    baseline_running(false);
+    PLAY(s, 20000);
+
+    TEST_ASSERT_EQUAL_INT(0, change_count);
+}
+
+/* ── Waking and power-on ─────────────────────────────────────────────── */
+
+void test_wake_from_blink_sleep(void)
+{
+    static const step_t s[] = {
+        {    0, RAW, true },
+        {  740, LED, POWER_LED_PATTERN_ON },
+        { 2500, USB, PC_FUSION_USB_MOUNTED },
+    };
+    baseline_sleeping(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(2, change_count);
+    expect_change(0, PC_FUSION_POWERED, 740);
+    TEST_ASSERT_EQUAL(PC_EVENT_POWER_LED_ON, changes[0].event);
+    expect_change(1, PC_FUSION_RUNNING, 2500);
+    TEST_ASSERT_EQUAL(PC_EVENT_USB_ENUMERATED, changes[1].event);
+}
+
+void test_wake_usb_before_led(void)
+{
+    /* Resume signalling arrives before the LED hold elapses */
+    static const step_t s[] = {
+        {    0, RAW, true },
+        {  300, USB, PC_FUSION_USB_MOUNTED },
+        {  740, LED, POWER_LED_PATTERN_ON },
+    };
+    baseline_sleeping(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_RUNNING, 300);
+}
+
+void test_power_on_without_vbus(void)
+{
+    static const step_t s[] = {
+        {    0, RAW, true },
+        { 1500, LED, POWER_LED_PATTERN_ON },
+        { 5000, USB, PC_FUSION_USB_MOUNTED },
+    };
+    baseline_off(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(2, change_count);
+    expect_change(0, PC_FUSION_POWERED, 1500);
+    expect_change(1, PC_FUSION_RUNNING, 5000);
+}
+
+void test_power_on_vbus_beats_led_hold(void)
+{
+    static const step_t s[] = {
+        {    0, VBUS, true },
+        {  200, RAW, true },
+        { 1700, LED, POWER_LED_PATTERN_ON },
+        { 6000, USB, PC_FUSION_USB_MOUNTED },
+    };
+    baseline_off(true);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(2, change_count);
+    expect_change(0, PC_FUSION_POWERED, 200);
+    expect_change(1, PC_FUSION_RUNNING, 6000);
+}
+
+void test_vbus_alone_is_not_power_on(void)
+{
+    /* 5 V standby coming up (e.g. PSU switched on) without the LED */
+    static const step_t s[] = {
+        { 0, VBUS, true },
+    };
+    baseline_off(true);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(0, change_count);
+}
+
+void test_enumeration_without_led(void)
+{
+    /* LED header not connected: USB alone still shows the PC running */
+    static const step_t s[] = {
+        { 0, USB, PC_FUSION_USB_MOUNTED },
+    };
+    baseline_off(false);
+    PLAY(s, 10000);
+
+    TEST_ASSERT_EQUAL_INT(1, change_count);
+    expect_change(0, PC_FUSION_RUNNING, 0);
+}
+
+/* ── Ordering matrix ─────────────────────────────────────────────────── */
+
+static int cmp_steps(const void *a, const void *b)
+{
+    const step_t *x = a, *y = b;
+    return (x->at_ms > y->at_ms) - (x->at_ms < y->at_ms);
+}
+
+void test_matrix_sleep_any_skew(void)
+{
+    /* 1 Hz blink recognised at 6500 ms; the bus suspends up to 6 s
+     * before or 4 s after.  One SLEEPING verdict, never later than the
+     * blink, with or without VBUS sense. */
+    for (int vbus = 0; vbus <= 1; vbus++) {
+        for (int skew = -6000; skew <= 4000; skew += 1000) {
+            step_t s[] = {
+                { 5000, RAW, false }, { 5500, RAW, true }, { 6000, RAW, false },
+                { 6500, RAW, true  }, { 6500, LED, POWER_LED_PATTERN_BLINK },
+                { (uint32_t)(6500 + skew), USB, PC_FUSION_USB_SUSPENDED },
+            };
+            qsort(s, sizeof(s) / sizeof(s[0]), sizeof(s[0]), cmp_steps);
+
+            baseline_running(vbus);
+            PLAY(s, 20000);
+
+            TEST_ASSERT_EQUAL_INT_MESSAGE(1, change_count, "sleep matrix");
+            TEST_ASSERT_EQUAL(PC_FUSION_SLEEPING, changes[0].verdict);
+            TEST_ASSERT_TRUE(changes[0].at_ms <= 6500);
+        }
+    }
+}
+
+void test_matrix_shutdown_any_skew(void)
+{
+    /* LED starts going out at 5000 ms (confirmed off at 6500); the bus
+     * suspends or detaches up to 4 s either side.  Ends OFF by 6500 and
+     * never claims the PC is running again. */
+    for (int usb = PC_FUSION_USB_DETACHED; usb <= PC_FUSION_USB_SUSPENDED; usb++) {
+        for (int skew = -4000; skew <= 4000; skew += 1000) {
+            step_t s[] = {
+                { 5000, RAW, false }, { 6500, LED, POWER_LED_PATTERN_OFF },
+                { (uint32_t)(5000 + skew), USB, (uint8_t)usb },
+            };
+            qsort(s, sizeof(s) / sizeof(s[0]), sizeof(s[0]), cmp_steps);
+
+            baseline_running(false);
+            PLAY(s, 20000);
+
+            TEST_ASSERT_TRUE_MESSAGE(change_count >= 1, "shutdown matrix");
+            TEST_ASSERT_EQUAL(PC_FUSION_OFF, changes[change_count - 1].verdict);
+            TEST_ASSERT_TRUE(changes[change_count - 1].at_ms <= 6500);
+            for (int i = 0; i < change_count; i++) {
+                TEST_ASSERT_NOT_EQUAL(PC_FUSION_RUNNING, changes[i].verdict);
+                TEST_ASSERT_NOT_EQUAL(PC_FUSION_POWERED, changes[i].verdict);
+            }
+        }
+    }
+}
+
+/* ── Misc ────────────────────────────────────────────────────────────── */
+
+void test_verdict_names(void)
+{
+    TEST_ASSERT_EQUAL_STRING("unknown",  pc_fusion_verdict_name(PC_FUSION_UNKNOWN));
+    TEST_ASSERT_EQUAL_STRING("off",      pc_fusion_verdict_name(PC_FUSION_OFF));
+    TEST_ASSERT_EQUAL_STRING("sleeping", pc_fusion_verdict_name(PC_FUSION_SLEEPING));
+    TEST_ASSERT_EQUAL_STRING("powered",  pc_fusion_verdict_name(PC_FUSION_POWERED));
+    TEST_ASSERT_EQUAL_STRING("running",  pc_fusion_verdict_name(PC_FUSION_RUNNING));
+}
+
+void test_clock_wraparound(void)
+{
+    uint32_t t = 0xFFFFFFFFu - 5000u;
+    pc_fusion_init(&f, POWER_LED_PATTERN_ON, true, false, false, t);
+    pc_fusion_set_usb(&f, PC_FUSION_USB_MOUNTED, t);
+
+    pc_power_event_t ev;
+    TEST_ASSERT_TRUE(pc_fusion_update(&f, t, &ev));
+    TEST_ASSERT_EQUAL(PC_FUSION_RUNNING, pc_fusion_verdict(&f));
+
+    /* Suspend after the clock wrapped; the LED is stale by then */
+    uint32_t s = t + 8000u;
+    pc_fusion_set_usb(&f, PC_FUSION_USB_SUSPENDED, s);
+    TEST_ASSERT_FALSE(pc_fusion_update(&f, s + PC_FUSION_SUSPEND_CONFIRM_MS - 1, &ev));
+    TEST_ASSERT_TRUE(pc_fusion_update(&f, s + PC_FUSION_SUSPEND_CONFIRM_MS, &ev));
+    TEST_ASSERT_EQUAL(PC_FUSION_SLEEPING, pc_fusion_verdict(&f));
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* Baselines */
+    RUN_TEST(test_boot_snapshot_led_on_is_powered);
+    RUN_TEST(test_boot_snapshot_led_off_is_off);
+    RUN_TEST(test_baselines_settle);
+
+    /* Entering sleep */
+    RUN_TEST(test_sleep_suspend_then_blink);
+    RUN_TEST(test_sleep_blink_then_suspend);
+    RUN_TEST(test_sleep_led_stays_lit);
+    RUN_TEST(test_sleep_led_stays_lit_with_vbus);
+    RUN_TEST(test_brief_suspend_is_not_sleep);
+    RUN_TEST(test_dark_sleep_with_vbus);
+    RUN_TEST(test_dark_sleep_without_vbus_reads_as_off);
+
+    /* Shutdown */
+    RUN_TEST(test_shutdown_detach_then_led_off);
+    RUN_TEST(test_shutdown_suspend_then_led_off);
+    RUN_TEST(test_shutdown_led_off_then_detach);
+    RUN_TEST(test_shutdown_vbus_drop_beats_led_hold);
+    RUN_TEST(test_reboot_detach_is_not_shutdown);
+
+    /* Waking and power-on */
+    RUN_TEST(test_wake_from_blink_sleep);
+    RUN_TEST(test_wake_usb_before_led);
+    RUN_TEST(test_power_on_without_vbus);
+    RUN_TEST(test_power_on_vbus_beats_led_hold);
+    RUN_TEST(test_vbus_alone_is_not_power_on);
+    RUN_TEST(test_enumeration_without_led);
+
+    /* Ordering matrix */
+    RUN_TEST(test_matrix_sleep_any_skew);
+    RUN_TEST(test_matrix_shutdown_any_skew);
+
+    /* Misc */
+    RUN_TEST(test_verdict_names);
+    RUN_TEST(test_clock_wraparound);
+
+    return UNITY_END();
+}
@@ -0,0 +1,283 @@
+#include "unity.h"
+#include "pc_power_state.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Exhaustive exploration of the power state machine.
+ *
+ * Every sequence of inputs up to MODEL_DEPTH is fed to a fresh state
+ * machine, and every step is checked against the invariants below.
+ * Inputs are the SM events plus the host arming/disarming USB remote
+ * wakeup (the one piece of context a guard reads).  The boot timer is
+ * modelled alongside: PC_EVENT_BOOT_TIMEOUT is only delivered while the
+ * timer runs, as the HAL does.
+ */
+
+#define MODEL_DEPTH  7
+#define MODEL_STEP_MS 1000
+
+enum {
+    INPUT_ARM = PC_EVENT_COUNT,
+    INPUT_DISARM,
+    INPUT_COUNT
+};
+
+typedef struct {
+    pc_power_sm_t sm;
+    bool          timer_running;
+    uint32_t      now_ms;
+} model_t;
+
+static int      s_path[MODEL_DEPTH];
+static uint32_t s_steps;
+static bool     s_reached[PC_STATE_COUNT];
+static bool     s_edge[PC_STATE_COUNT][PC_STATE_COUNT];
+static char     s_failure[256];
+
+static const char *input_name(int input)
+{
+    if (input == INPUT_ARM)
+        return "ARM";
+    if (input == INPUT_DISARM)
+        return "DISARM";
+    return pc_power_event_name((pc_power_event_t)input);
+}
+
+static bool timed_state(pc_power_state_t state)
+{
+    return state == PC_STATE_BOOTING || state == PC_STATE_WAKING;
+}
+
+/**
+ * Check one SM step.  before/after hold the model around the event, with
+ * after->timer_running already updated from r->actions.
+ *
+ * @return NULL if every invariant holds, else a description.
+ */
+static const char *check_step(const model_t *before, pc_power_event_t event,
+                              const pc_power_result_t *r, const model_t *after)
+{
+    pc_power_state_t from = before->sm.state;
+    pc_power_state_t to   = after->sm.state;
+    uint32_t a = r->actions;
+
+    if ((unsigned)to >= PC_STATE_COUNT)
+        return "state out of range";
+    if (r->new_state != to)
+        return "result state differs from SM state";
+
+    if (!r->transitioned) {
+        if (a != PC_ACTION_NONE)
+            return "actions without a transition";
+        if (to != from)
+            return "state changed without a transition";
+        if (after->sm.last_transition_ms != before->sm.last_transition_ms)
+            return "timestamp changed without a transition";
+        return NULL;
+    }
+    if (after->sm.last_transition_ms != after->now_ms)
+        return "transition did not update the timestamp";
+
+    if ((a & PC_ACTION_TRIGGER_POWER) &&
+        (from == PC_STATE_ON || to != PC_STATE_BOOTING))
+        return "power button pulsed outside a wake into BOOTING";
+    if (!(a & PC_ACTION_SEND_WOL) != !(a & PC_ACTION_TRIGGER_POWER))
+        return "Wake-on-LAN not paired with the power pulse";
+    if ((a & PC_ACTION_USB_REMOTE_WAKEUP) &&
+        (from != PC_STATE_SLEEPING || to != PC_STATE_WAKING ||
+         !before->sm.remote_wakeup_armed))
+        return "remote wakeup outside an armed SLEEPING -> WAKING";
+    if ((a & PC_ACTION_START_BOOT_TIMER) && (a & PC_ACTION_CANCEL_BOOT_TIMER))
+        return "boot timer started and cancelled together";
+
+    if (timed_state(to) && to != from && !(a & PC_ACTION_START_BOOT_TIMER))
+        return "entered BOOTING/WAKING without starting the boot timer";
+    if (timed_state(from) && !timed_state(to) &&
+        event != PC_EVENT_BOOT_TIMEOUT && !(a & PC_ACTION_CANCEL_BOOT_TIMER))
+        return "left BOOTING/WAKING without cancelling the boot timer";
+    if (after->timer_running != timed_state(to))
+        return "boot timer running state does not match the SM state";
+
+    for (int s = 0; s < PC_BOOT_SOURCE_COUNT; s++)
+        if (after->sm.boot_history[s].count > PC_BOOT_HISTORY)
+            return "boot history overflow";
+
+    return NULL;
+}
+
+/** Apply one input to m.  Returns false if it cannot occur now. */
+static bool step(model_t *m, int input, const char **failure)
+{
+    *failure = NULL;
+    m->now_ms += MODEL_STEP_MS;
+
+    if (input == INPUT_ARM || input == INPUT_DISARM) {
+        pc_power_sm_set_remote_wakeup(&m->sm, input == INPUT_ARM);
+        return true;
+    }
+
+    pc_power_event_t event = (pc_power_event_t)input;
+    if (event == PC_EVENT_BOOT_TIMEOUT) {
+        if (!m->timer_running)
+            return false;
+        m->timer_running = false;       /* expired */
+    }
+
+    model_t before = *m;
+    pc_power_result_t r = pc_power_sm_process(&m->sm, event, m->now_ms);
+
+    if (r.actions & PC_ACTION_START_BOOT_TIMER)
+        m->timer_running = true;
+    if (r.actions & PC_ACTION_CANCEL_BOOT_TIMER)
+        m->timer_running = false;
+
+    *failure = check_step(&before, event, &r, m);
+    s_reached[m->sm.state] = true;
+    s_edge[before.sm.state][m->sm.state] |= r.transitioned;
+    s_steps++;
+    return true;
+}
+
+/** Depth-first over every input sequence; stops at the first failure. */
+static bool explore(const model_t *m, int depth)
+{
+    if (depth == MODEL_DEPTH)
+        return true;
+
+    for (int input = 0; input < INPUT_COUNT; input++) {
+        model_t next = *m;
+        const char *failure;
+
+        s_path[depth] = input;
+        if (!step(&next, input, &failure))
+            continue;
+
+        if (failure) {
+            int n = snprintf(s_failure, sizeof(s_failure), "%s after:",
+                             failure);
+            for (int i = 0; i <= depth && n < (int)sizeof(s_failure); i++)
+                n += snprintf(s_failure + n, sizeof(s_failure) - (size_t)n,
+                              " %s", input_name(s_path[i]));
+            return false;
+        }
+        if (!explore(&next, depth + 1))
+            return false;
+    }
+    return true;
+}
+
+void setUp(void)
+{
+    s_steps = 0;
+    memset(s_reached, 0, sizeof(s_reached));
+    memset(s_edge, 0, sizeof(s_edge));
+    s_failure[0] = '\0';
+}
+
+void tearDown(void)
+{
+}
+
+/* ── Exploration ──────────────────────────────────────────────────────── */
+
+void test_every_sequence_keeps_invariants(void)
+{
+    model_t m = {0};
+    pc_power_sm_init(&m.sm);
+    s_reached[PC_STATE_OFF] = true;
+
+    if (!explore(&m, 0))
+        TEST_FAIL_MESSAGE(s_failure);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(1000000, s_steps);
+}
+
+void test_every_state_reachable(void)
+{
+    model_t m = {0};
+    pc_power_sm_init(&m.sm);
+    s_reached[PC_STATE_OFF] = true;
+    TEST_ASSERT_TRUE(explore(&m, 0));
+
+    for (int s = 0; s < PC_STATE_COUNT; s++)
+        TEST_ASSERT_TRUE_MESSAGE(s_reached[s],
+                                 pc_power_state_name((pc_power_state_t)s));
+}
+
+void test_guard_takes_both_branches(void)
+{
+    model_t m = {0};
+    pc_power_sm_init(&m.sm);
+    TEST_ASSERT_TRUE(explore(&m, 0));
+
+    /* SLEEPING + WAKE_REQUESTED: remote wakeup when armed, pulse otherwise */
+    TEST_ASSERT_TRUE(s_edge[PC_STATE_SLEEPING][PC_STATE_WAKING]);
+    TEST_ASSERT_TRUE(s_edge[PC_STATE_SLEEPING][PC_STATE_BOOTING]);
+    TEST_ASSERT_TRUE(s_edge[PC_STATE_WAKING][PC_STATE_BOOTING]);
+}
+
+void test_out_of_range_event_ignored(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_COUNT, 100);
+    TEST_ASSERT_FALSE(r.transitioned);
+    TEST_ASSERT_EQUAL(PC_ACTION_NONE, r.actions);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&sm));
+}
+
+/* ── Checker self-test ────────────────────────────────────────────────── */
+
+void test_checker_rejects_pulse_while_on(void)
+{
+    model_t before = {0}, after = {0};
+    before.sm.state = PC_STATE_ON;
+    after.sm.state = PC_STATE_BOOTING;
+    after.timer_running = true;
+    pc_power_result_t r = {
+        .new_state = PC_STATE_BOOTING,
+        .actions = PC_ACTION_TRIGGER_POWER | PC_ACTION_SEND_WOL |
+                   PC_ACTION_START_BOOT_TIMER,
+        .transitioned = true,
+    };
+
+    TEST_ASSERT_NOT_NULL(check_step(&before, PC_EVENT_WAKE_REQUESTED,
+                                    &r, &after));
+}
+
+void test_checker_rejects_booting_exit_without_cancel(void)
+{
+    model_t before = {0}, after = {0};
+    before.sm.state = PC_STATE_BOOTING;
+    before.timer_running = true;
+    after.sm.state = PC_STATE_ON;
+    after.timer_running = true;
+    pc_power_result_t r = {
+        .new_state = PC_STATE_ON,
+        .actions = PC_ACTION_NONE,
+        .transitioned = true,
+    };
+
+    TEST_ASSERT_NOT_NULL(check_step(&before, PC_EVENT_USB_ENUMERATED,
+                                    &r, &after));
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_every_sequence_keeps_invariants);
+    RUN_TEST(test_every_state_reachable);
+    RUN_TEST(test_guard_takes_both_branches);
+    RUN_TEST(test_out_of_range_event_ignored);
+
+    RUN_TEST(test_checker_rejects_pulse_while_on);
+    RUN_TEST(test_checker_rejects_booting_exit_without_cancel);
+
+    return UNITY_END();
+}
@@ -43,6 +43,17 @@ void test_off_wake_requested_triggers_power_and_timer(void)
     TEST_ASSERT_BITS(PC_ACTION_START_BOOT_TIMER, PC_ACTION_START_BOOT_TIMER, r.actions);
 }
 
+void test_wake_requests_always_send_wol_with_the_pulse(void)
+{
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 0);
+    TEST_ASSERT_BITS(PC_ACTION_SEND_WOL, PC_ACTION_SEND_WOL, r.actions);
+
+    /* Passive power-on (e.g. the WoL itself worked) sends nothing */
+    pc_power_sm_init(&sm);
+    r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_ON, 0);
+    TEST_ASSERT_BITS(PC_ACTION_SEND_WOL, 0, r.actions);
+}
+
 void test_off_power_led_on_transitions_to_booting(void)
 {
     pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_ON, 200);
@@ -60,6 +71,15 @@ void test_off_usb_enumerated_jumps_to_on(void)
     TEST_ASSERT_TRUE(r.transitioned);
 }
 
+void test_off_power_led_blink_transitions_to_sleeping(void)
+{
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_BLINK, 100);
+
+    TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, r.new_state);
+    TEST_ASSERT_TRUE(r.transitioned);
+    TEST_ASSERT_EQUAL(PC_ACTION_NONE, r.actions);
+}
+
 void test_off_ignores_irrelevant_events(void)
 {
     pc_power_event_t ignore[] = {
@@ -119,6 +139,16 @@ void test_booting_timeout_returns_to_off(void)
     TEST_ASSERT_TRUE(r.transitioned);
 }
 
+void test_booting_power_led_blink_returns_to_sleeping(void)
+{
+    enter_booting(1000);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_BLINK, 4000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, r.new_state);
+    TEST_ASSERT_TRUE(r.transitioned);
+    TEST_ASSERT_BITS(PC_ACTION_CANCEL_BOOT_TIMER, PC_ACTION_CANCEL_BOOT_TIMER, r.actions);
+}
+
 void test_booting_ignores_irrelevant_events(void)
 {
     pc_power_event_t ignore[] = {
@@ -162,6 +192,15 @@ void test_on_power_led_off_transitions_to_off(void)
     TEST_ASSERT_TRUE(r.transitioned);
 }
 
+void test_on_power_led_blink_transitions_to_sleeping(void)
+{
+    enter_on(1000);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_BLINK, 10000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_SLEEPING, r.new_state);
+    TEST_ASSERT_TRUE(r.transitioned);
+}
+
 void test_on_ignores_irrelevant_events(void)
 {
     pc_power_event_t ignore[] = {
@@ -238,6 +277,7 @@ void test_sleeping_ignores_irrelevant_events(void)
     pc_power_event_t ignore[] = {
         PC_EVENT_USB_SUSPENDED,
         PC_EVENT_BOOT_TIMEOUT,
+        PC_EVENT_POWER_LED_BLINK,
     };
     for (int i = 0; i < (int)(sizeof(ignore) / sizeof(ignore[0])); i++) {
         pc_power_sm_init(&sm);
@@ -248,6 +288,102 @@ void test_sleeping_ignores_irrelevant_events(void)
     }
 }
 
+/* ── WAKING state transitions ─────────────────────────────────────────── */
+
+static void enter_waking(uint32_t at_ms)
+{
+    enter_sleeping(at_ms);
+    pc_power_sm_set_remote_wakeup(&sm, true);
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, at_ms + 20000);
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&sm));
+}
+
+void test_sleeping_wake_with_remote_wakeup_armed_tries_usb_first(void)
+{
+    enter_sleeping(1000);
+    pc_power_sm_set_remote_wakeup(&sm, true);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 20000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, r.new_state);
+    TEST_ASSERT_EQUAL_UINT32(PC_ACTION_USB_REMOTE_WAKEUP | PC_ACTION_START_BOOT_TIMER,
+                             r.actions);
+}
+
+void test_sleeping_wake_with_remote_wakeup_disarmed_pulses(void)
+{
+    enter_sleeping(1000);
+    pc_power_sm_set_remote_wakeup(&sm, true);
+    pc_power_sm_set_remote_wakeup(&sm, false);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 20000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, r.new_state);
+    TEST_ASSERT_BITS(PC_ACTION_TRIGGER_POWER, PC_ACTION_TRIGGER_POWER, r.actions);
+}
+
+void test_off_wake_ignores_remote_wakeup(void)
+{
+    /* Remote wakeup only reaches a suspended host, never one in S5 */
+    pc_power_sm_set_remote_wakeup(&sm, true);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 1000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, r.new_state);
+    TEST_ASSERT_BITS(PC_ACTION_TRIGGER_POWER, PC_ACTION_TRIGGER_POWER, r.actions);
+    TEST_ASSERT_BITS(PC_ACTION_USB_REMOTE_WAKEUP, 0, r.actions);
+}
+
+void test_waking_usb_enumerated_transitions_to_on(void)
+{
+    enter_waking(1000);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, 21500);
+
+    TEST_ASSERT_EQUAL(PC_STATE_ON, r.new_state);
+    TEST_ASSERT_EQUAL_UINT32(PC_ACTION_CANCEL_BOOT_TIMER, r.actions);
+}
+
+void test_waking_timeout_falls_back_to_power_button(void)
+{
+    enter_waking(1000);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_BOOT_TIMEOUT, 26000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, r.new_state);
+    TEST_ASSERT_EQUAL_UINT32(PC_ACTION_TRIGGER_POWER | PC_ACTION_SEND_WOL |
+                             PC_ACTION_START_BOOT_TIMER, r.actions);
+}
+
+void test_waking_power_led_on_waits_without_pulse(void)
+{
+    enter_waking(1000);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_ON, 22000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, r.new_state);
+    TEST_ASSERT_EQUAL_UINT32(PC_ACTION_START_BOOT_TIMER, r.actions);
+}
+
+void test_waking_power_led_off_transitions_to_off(void)
+{
+    enter_waking(1000);
+    pc_power_result_t r = pc_power_sm_process(&sm, PC_EVENT_POWER_LED_OFF, 22000);
+
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, r.new_state);
+    TEST_ASSERT_EQUAL_UINT32(PC_ACTION_CANCEL_BOOT_TIMER, r.actions);
+}
+
+void test_waking_ignores_irrelevant_events(void)
+{
+    pc_power_event_t ignore[] = {
+        PC_EVENT_WAKE_REQUESTED,
+        PC_EVENT_USB_SUSPENDED,
+        PC_EVENT_POWER_LED_BLINK,
+    };
+    for (int i = 0; i < (int)(sizeof(ignore) / sizeof(ignore[0])); i++) {
+        pc_power_sm_init(&sm);
+        enter_waking(100);
+        pc_power_result_t r = pc_power_sm_process(&sm, ignore[i], 30000);
+        TEST_ASSERT_FALSE_MESSAGE(r.transitioned, pc_power_event_name(ignore[i]));
+        TEST_ASSERT_EQUAL_MESSAGE(PC_STATE_WAKING, r.new_state, pc_power_event_name(ignore[i]));
+    }
+}
+
 /* ── Timestamp tracking ───────────────────────────────────────────────── */
 
 void test_transition_updates_timestamp(void)
@@ -346,6 +482,173 @@ void test_boot_failure_timeout_then_retry(void)
     TEST_ASSERT_EQUAL(PC_STATE_ON, pc_power_sm_get_state(&sm));
 }
 
+/* ── Boot duration learning ───────────────────────────────────────────── */
+
+/** Cold boot from OFF taking ms, ending at ON; returns the end time. */
+static uint32_t cold_boot(uint32_t start, uint32_t ms)
+{
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, start);
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, start + ms);
+    pc_power_sm_process(&sm, PC_EVENT_POWER_LED_OFF, start + ms + 1000);
+    return start + ms + 2000;
+}
+
+void test_boot_timeout_uses_default_until_enough_samples(void)
+{
+    uint32_t t = 1000;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES - 1; i++)
+        t = cold_boot(t, 8000);
+
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    TEST_ASSERT_EQUAL_UINT32(30000, pc_power_sm_boot_timeout(&sm, 30000));
+    TEST_ASSERT_EQUAL(PC_BOOT_MIN_SAMPLES - 1,
+                      sm.boot_history[PC_BOOT_COLD].count);
+}
+
+void test_boot_timeout_learned_from_high_percentile(void)
+{
+    /* 15 boots around 10 s and one 40 s outlier: p90 ignores the outlier */
+    uint32_t t = 1000;
+    for (int i = 0; i < PC_BOOT_HISTORY - 1; i++)
+        t = cold_boot(t, 9000 + (uint32_t)i * 100);
+    t = cold_boot(t, 40000);
+
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    /* p90 of 16 = 15th smallest = 10400 ms, plus 50 % headroom */
+    TEST_ASSERT_EQUAL_UINT32(15600, pc_power_sm_boot_timeout(&sm, 30000));
+}
+
+void test_boot_timeout_clamped_to_config_range(void)
+{
+    uint32_t t = 1000;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES; i++)
+        t = cold_boot(t, 1000);
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    TEST_ASSERT_EQUAL_UINT32(PC_BOOT_TIMEOUT_MIN_MS,
+                             pc_power_sm_boot_timeout(&sm, 30000));
+
+    pc_power_sm_init(&sm);
+    t = 1000;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES; i++)
+        t = cold_boot(t, 50000);
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    TEST_ASSERT_EQUAL_UINT32(PC_BOOT_TIMEOUT_MAX_MS,
+                             pc_power_sm_boot_timeout(&sm, 30000));
+}
+
+void test_boot_history_keeps_sources_apart(void)
+{
+    uint32_t t = 1000;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES; i++)
+        t = cold_boot(t, 20000);
+
+    /* Resumes from sleep: ON -> SLEEPING -> BOOTING -> ON */
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, t + 20000);
+    t += 21000;
+    for (int i = 0; i < PC_BOOT_MIN_SAMPLES; i++) {
+        pc_power_sm_process(&sm, PC_EVENT_USB_SUSPENDED, t);
+        pc_power_sm_process(&sm, PC_EVENT_POWER_LED_ON, t + 1000);
+        pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, t + 4000);
+        t += 5000;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(20000, pc_power_sm_boot_typical_ms(&sm, PC_BOOT_COLD));
+    TEST_ASSERT_EQUAL_UINT32(3000, pc_power_sm_boot_typical_ms(&sm, PC_BOOT_RESUME));
+
+    pc_power_sm_process(&sm, PC_EVENT_USB_SUSPENDED, t);
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t + 1000);
+    TEST_ASSERT_EQUAL(PC_BOOT_RESUME, sm.boot_source);
+    TEST_ASSERT_EQUAL_UINT32(PC_BOOT_TIMEOUT_MIN_MS,
+                             pc_power_sm_boot_timeout(&sm, 30000));
+}
+
+void test_boot_history_rolls_over(void)
+{
+    uint32_t t = 1000;
+    for (int i = 0; i < PC_BOOT_HISTORY; i++)
+        t = cold_boot(t, 30000);
+    for (int i = 0; i < PC_BOOT_HISTORY; i++)
+        t = cold_boot(t, 6000);
+
+    TEST_ASSERT_EQUAL(PC_BOOT_HISTORY, sm.boot_history[PC_BOOT_COLD].count);
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    TEST_ASSERT_EQUAL_UINT32(9000, pc_power_sm_boot_timeout(&sm, 30000));
+}
+
+void test_boot_after_timeout_recorded_as_late_sample(void)
+{
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 1000);
+    pc_power_sm_process(&sm, PC_EVENT_BOOT_TIMEOUT, 31000);
+    TEST_ASSERT_EQUAL(PC_STATE_OFF, pc_power_sm_get_state(&sm));
+
+    /* Slow BIOS: the OS comes up 45 s after the button press */
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, 46000);
+    TEST_ASSERT_EQUAL(1, sm.boot_history[PC_BOOT_COLD].count);
+    TEST_ASSERT_EQUAL_UINT32(45000, pc_power_sm_boot_typical_ms(&sm, PC_BOOT_COLD));
+}
+
+void test_boot_after_timeout_too_late_not_recorded(void)
+{
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 1000);
+    pc_power_sm_process(&sm, PC_EVENT_BOOT_TIMEOUT, 31000);
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, 1000 + PC_BOOT_LATE_MAX_MS + 1);
+    TEST_ASSERT_EQUAL(0, sm.boot_history[PC_BOOT_COLD].count);
+
+    /* Without a timeout first, OFF -> ON is never a boot sample */
+    pc_power_sm_process(&sm, PC_EVENT_POWER_LED_OFF, 200000);
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, 201000);
+    TEST_ASSERT_EQUAL(0, sm.boot_history[PC_BOOT_COLD].count);
+}
+
+void test_boot_failed_boots_not_recorded(void)
+{
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 1000);
+    pc_power_sm_process(&sm, PC_EVENT_POWER_LED_OFF, 3000);
+    pc_power_sm_process(&sm, PC_EVENT_POWER_LED_ON, 5000);
+    pc_power_sm_process(&sm, PC_EVENT_POWER_LED_BLINK, 7000);
+
+    TEST_ASSERT_EQUAL(0, sm.boot_history[PC_BOOT_COLD].count);
+    TEST_ASSERT_EQUAL(0, sm.boot_history[PC_BOOT_RESUME].count);
+}
+
+void test_boot_eta_counts_down_from_typical(void)
+{
+    uint32_t t = 1000;
+    TEST_ASSERT_EQUAL_UINT32(0, pc_power_sm_boot_eta_ms(&sm, t));
+
+    /* Nothing learned yet: no estimate */
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    TEST_ASSERT_EQUAL_UINT32(0, pc_power_sm_boot_eta_ms(&sm, t + 100));
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, t + 12000);
+    pc_power_sm_process(&sm, PC_EVENT_POWER_LED_OFF, t + 13000);
+
+    t = 20000;
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, t);
+    TEST_ASSERT_EQUAL_UINT32(12000, pc_power_sm_boot_eta_ms(&sm, t));
+    TEST_ASSERT_EQUAL_UINT32(7000, pc_power_sm_boot_eta_ms(&sm, t + 5000));
+    TEST_ASSERT_EQUAL_UINT32(0, pc_power_sm_boot_eta_ms(&sm, t + 15000));
+
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, t + 16000);
+    TEST_ASSERT_EQUAL_UINT32(0, pc_power_sm_boot_eta_ms(&sm, t + 16000));
+}
+
+void test_remote_wakeup_fallback_boot_is_resume(void)
+{
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 1000);
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, 2000);
+    pc_power_sm_process(&sm, PC_EVENT_USB_SUSPENDED, 3000);
+    pc_power_sm_set_remote_wakeup(&sm, true);
+    pc_power_sm_process(&sm, PC_EVENT_WAKE_REQUESTED, 4000);
+    TEST_ASSERT_EQUAL(PC_STATE_WAKING, pc_power_sm_get_state(&sm));
+
+    pc_power_sm_process(&sm, PC_EVENT_BOOT_TIMEOUT, 9000);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&sm));
+    TEST_ASSERT_EQUAL(PC_BOOT_RESUME, sm.boot_source);
+    pc_power_sm_process(&sm, PC_EVENT_USB_ENUMERATED, 12000);
+    TEST_ASSERT_EQUAL_UINT32(3000, pc_power_sm_boot_typical_ms(&sm, PC_BOOT_RESUME));
+}
+
 /* ── Name helpers ─────────────────────────────────────────────────────── */
 
 void test_state_names(void)
@@ -354,6 +657,7 @@ void test_state_names(void)
     TEST_ASSERT_EQUAL_STRING("PC_BOOTING",  pc_power_state_name(PC_STATE_BOOTING));
     TEST_ASSERT_EQUAL_STRING("PC_ON",       pc_power_state_name(PC_STATE_ON));
     TEST_ASSERT_EQUAL_STRING("PC_SLEEPING", pc_power_state_name(PC_STATE_SLEEPING));
+    TEST_ASSERT_EQUAL_STRING("PC_WAKING",   pc_power_state_name(PC_STATE_WAKING));
     TEST_ASSERT_EQUAL_STRING("UNKNOWN",     pc_power_state_name(PC_STATE_COUNT));
 }
 
@@ -365,6 +669,7 @@ void test_event_names(void)
     TEST_ASSERT_EQUAL_STRING("POWER_LED_ON",       pc_power_event_name(PC_EVENT_POWER_LED_ON));
     TEST_ASSERT_EQUAL_STRING("POWER_LED_OFF",      pc_power_event_name(PC_EVENT_POWER_LED_OFF));
     TEST_ASSERT_EQUAL_STRING("BOOT_TIMEOUT",       pc_power_event_name(PC_EVENT_BOOT_TIMEOUT));
+    TEST_ASSERT_EQUAL_STRING("POWER_LED_BLINK",    pc_power_event_name(PC_EVENT_POWER_LED_BLINK));
     TEST_ASSERT_EQUAL_STRING("UNKNOWN",            pc_power_event_name(PC_EVENT_COUNT));
 }
 
@@ -381,8 +686,10 @@ int main(void)
     /* OFF transitions */
     RUN_TEST(test_off_wake_requested_transitions_to_booting);
     RUN_TEST(test_off_wake_requested_triggers_power_and_timer);
+    RUN_TEST(test_wake_requests_always_send_wol_with_the_pulse);
     RUN_TEST(test_off_power_led_on_transitions_to_booting);
     RUN_TEST(test_off_usb_enumerated_jumps_to_on);
+    RUN_TEST(test_off_power_led_blink_transitions_to_sleeping);
     RUN_TEST(test_off_ignores_irrelevant_events);
 
     /* BOOTING transitions */
@@ -390,11 +697,13 @@ int main(void)
     RUN_TEST(test_booting_usb_enumerated_cancels_timer);
     RUN_TEST(test_booting_power_led_off_returns_to_off);
     RUN_TEST(test_booting_timeout_returns_to_off);
+    RUN_TEST(test_booting_power_led_blink_returns_to_sleeping);
     RUN_TEST(test_booting_ignores_irrelevant_events);
 
     /* ON transitions */
     RUN_TEST(test_on_usb_suspended_transitions_to_sleeping);
     RUN_TEST(test_on_power_led_off_transitions_to_off);
+    RUN_TEST(test_on_power_led_blink_transitions_to_sleeping);
     RUN_TEST(test_on_ignores_irrelevant_events);
 
     /* SLEEPING transitions */
@@ -405,6 +714,16 @@ int main(void)
     RUN_TEST(test_sleeping_power_led_off_transitions_to_off);
     RUN_TEST(test_sleeping_ignores_irrelevant_events);
 
+    /* WAKING */
+    RUN_TEST(test_sleeping_wake_with_remote_wakeup_armed_tries_usb_first);
+    RUN_TEST(test_sleeping_wake_with_remote_wakeup_disarmed_pulses);
+    RUN_TEST(test_off_wake_ignores_remote_wakeup);
+    RUN_TEST(test_waking_usb_enumerated_transitions_to_on);
+    RUN_TEST(test_waking_timeout_falls_back_to_power_button);
+    RUN_TEST(test_waking_power_led_on_waits_without_pulse);
+    RUN_TEST(test_waking_power_led_off_transitions_to_off);
+    RUN_TEST(test_waking_ignores_irrelevant_events);
+
     /* Timestamp tracking */
     RUN_TEST(test_transition_updates_timestamp);
     RUN_TEST(test_no_transition_preserves_timestamp);
@@ -415,6 +734,18 @@ int main(void)
     RUN_TEST(test_full_cycle_sleep_wake_cycle);
     RUN_TEST(test_boot_failure_timeout_then_retry);
 
+    /* Boot duration learning */
+    RUN_TEST(test_boot_timeout_uses_default_until_enough_samples);
+    RUN_TEST(test_boot_timeout_learned_from_high_percentile);
+    RUN_TEST(test_boot_timeout_clamped_to_config_range);
+    RUN_TEST(test_boot_history_keeps_sources_apart);
+    RUN_TEST(test_boot_history_rolls_over);
+    RUN_TEST(test_boot_after_timeout_recorded_as_late_sample);
+    RUN_TEST(test_boot_after_timeout_too_late_not_recorded);
+    RUN_TEST(test_boot_failed_boots_not_recorded);
+    RUN_TEST(test_boot_eta_counts_down_from_typical);
+    RUN_TEST(test_remote_wakeup_fallback_boot_is_resume);
+
     /* Name helpers */
     RUN_TEST(test_state_names);
     RUN_TEST(test_event_names);
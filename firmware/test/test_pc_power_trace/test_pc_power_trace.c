@@ -0,0 +1,229 @@
+#include "unity.h"
+#include "pc_power_trace.h"
+
+#include <string.h>
+
+static char line[PC_TRACE_LINE_MAX];
+
+void setUp(void)
+{
+    pc_power_trace_init();
+    memset(line, 0, sizeof(line));
+}
+
+void tearDown(void)
+{
+}
+
+/** Retained entries. */
+static uint32_t count(void)
+{
+    return pc_power_trace_written() - pc_power_trace_oldest();
+}
+
+/** Read retained entry i, 0 being the oldest. */
+static bool get(uint32_t i, pc_power_trace_entry_t *e)
+{
+    return pc_power_trace_read(pc_power_trace_oldest() + i, e);
+}
+
+/** Format retained entry i into line. */
+static const char *entry_line(uint32_t i)
+{
+    pc_power_trace_entry_t e;
+    TEST_ASSERT_TRUE(get(i, &e));
+    pc_power_trace_format(&e, line, sizeof(line));
+    return line;
+}
+
+/* ── Recording ────────────────────────────────────────────────────────── */
+
+void test_empty_trace(void)
+{
+    pc_power_trace_entry_t e;
+    TEST_ASSERT_EQUAL_UINT32(0, count());
+    TEST_ASSERT_FALSE(get(0, &e));
+}
+
+void test_records_transition(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+    pc_power_trace_process(&sm, PC_EVENT_WAKE_REQUESTED, 12345);
+
+    pc_power_trace_entry_t e;
+    TEST_ASSERT_TRUE(get(0, &e));
+    TEST_ASSERT_EQUAL(PC_TRACE_SM, e.kind);
+    TEST_ASSERT_EQUAL(PC_EVENT_WAKE_REQUESTED, e.event);
+    TEST_ASSERT_EQUAL_UINT32(12345, e.time_ms);
+    TEST_ASSERT_EQUAL_STRING("12.345 WAKE_REQUESTED OFF>BOOTING 13",
+                             entry_line(0));
+}
+
+void test_process_drives_the_state_machine(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+
+    pc_power_result_t r = pc_power_trace_process(&sm,
+                                                 PC_EVENT_WAKE_REQUESTED, 10);
+    TEST_ASSERT_TRUE(r.transitioned);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, r.new_state);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, pc_power_sm_get_state(&sm));
+
+    r = pc_power_trace_process(&sm, PC_EVENT_BOOT_TIMEOUT, 20);
+    TEST_ASSERT_EQUAL(pc_power_sm_get_state(&sm), r.new_state);
+
+    /* One entry per call, each with the state it started from */
+    TEST_ASSERT_EQUAL_UINT32(2, count());
+    TEST_ASSERT_EQUAL_STRING("0.010 WAKE_REQUESTED OFF>BOOTING 13",
+                             entry_line(0));
+    pc_power_trace_entry_t e;
+    TEST_ASSERT_TRUE(get(1, &e));
+    TEST_ASSERT_EQUAL(PC_EVENT_BOOT_TIMEOUT, e.event);
+    TEST_ASSERT_EQUAL(PC_STATE_BOOTING, e.u.sm.states >> 4);
+    TEST_ASSERT_EQUAL(r.new_state, e.u.sm.states & 0x0F);
+}
+
+void test_records_ignored_event(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+    pc_power_trace_process(&sm, PC_EVENT_USB_SUSPENDED, 5);
+
+    TEST_ASSERT_EQUAL_UINT32(1, count());
+    TEST_ASSERT_EQUAL_STRING("0.005 USB_SUSPENDED OFF -", entry_line(0));
+}
+
+void test_records_led_edges_in_order(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+
+    pc_power_trace_led(true, 1000);
+    pc_power_trace_process(&sm, PC_EVENT_POWER_LED_ON, 2500);
+    pc_power_trace_led(false, 3000);
+
+    TEST_ASSERT_EQUAL_UINT32(3, count());
+    TEST_ASSERT_EQUAL_STRING("1.000 LED 1", entry_line(0));
+    TEST_ASSERT_EQUAL_STRING("2.500 POWER_LED_ON OFF>BOOTING 02",
+                             entry_line(1));
+    TEST_ASSERT_EQUAL_STRING("3.000 LED 0", entry_line(2));
+}
+
+void test_ring_keeps_newest(void)
+{
+    pc_power_result_t r = { PC_STATE_OFF, PC_ACTION_NONE, false };
+
+    for (uint32_t i = 0; i < PC_TRACE_SIZE + 10; i++)
+        pc_power_trace_sm(PC_EVENT_USB_SUSPENDED, PC_STATE_OFF, &r, i);
+
+    pc_power_trace_entry_t e;
+    TEST_ASSERT_EQUAL_UINT32(PC_TRACE_SIZE + 10, pc_power_trace_written());
+    TEST_ASSERT_EQUAL_UINT32(PC_TRACE_SIZE, count());
+    TEST_ASSERT_TRUE(get(0, &e));
+    TEST_ASSERT_EQUAL_UINT32(10, e.time_ms);
+    TEST_ASSERT_TRUE(get(PC_TRACE_SIZE - 1, &e));
+    TEST_ASSERT_EQUAL_UINT32(PC_TRACE_SIZE + 9, e.time_ms);
+    TEST_ASSERT_FALSE(get(PC_TRACE_SIZE, &e));
+
+    /* Overwritten entries are gone */
+    TEST_ASSERT_FALSE(pc_power_trace_read(9, &e));
+    TEST_ASSERT_TRUE(pc_power_trace_read(10, &e));
+}
+
+/* ── LED burst limit ──────────────────────────────────────────────────── */
+
+void test_long_blink_counted_not_stored(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+    pc_power_trace_process(&sm, PC_EVENT_POWER_LED_BLINK, 100);
+
+    /* A sleep blink: 1000 edges, one every 500 ms */
+    for (uint32_t i = 0; i < 1000; i++)
+        pc_power_trace_led(i % 2 == 0, 1000 + i * 500);
+
+    TEST_ASSERT_EQUAL_UINT32(1 + PC_TRACE_LED_BURST + 1,
+                             count());
+    TEST_ASSERT_EQUAL_STRING("0.100 POWER_LED_BLINK OFF>SLEEPING 00",
+                             entry_line(0));
+    TEST_ASSERT_EQUAL_STRING("1.000 LED 1", entry_line(1));
+
+    pc_power_trace_entry_t e;
+    TEST_ASSERT_TRUE(get(1 + PC_TRACE_LED_BURST, &e));
+    TEST_ASSERT_EQUAL(PC_TRACE_LED_SKIPPED, e.kind);
+    TEST_ASSERT_EQUAL_UINT16(1000 - PC_TRACE_LED_BURST, e.u.skipped);
+    TEST_ASSERT_EQUAL_STRING("500.500 LED +984",
+                             entry_line(1 + PC_TRACE_LED_BURST));
+}
+
+void test_sm_entry_restarts_led_burst(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+
+    for (uint32_t i = 0; i < PC_TRACE_LED_BURST + 3; i++)
+        pc_power_trace_led(i % 2 == 0, i);
+    pc_power_trace_process(&sm, PC_EVENT_POWER_LED_OFF, 100);
+    pc_power_trace_led(true, 200);
+
+    /* burst, one counting entry, the SM entry, then a stored edge again */
+    TEST_ASSERT_EQUAL_UINT32(PC_TRACE_LED_BURST + 3, count());
+    TEST_ASSERT_EQUAL_STRING("0.018 LED +3", entry_line(PC_TRACE_LED_BURST));
+    TEST_ASSERT_EQUAL_STRING("0.200 LED 1",
+                             entry_line(PC_TRACE_LED_BURST + 2));
+}
+
+/* ── Formatting ───────────────────────────────────────────────────────── */
+
+void test_format_truncates(void)
+{
+    pc_power_sm_t sm;
+    pc_power_sm_init(&sm);
+    pc_power_trace_process(&sm, PC_EVENT_WAKE_REQUESTED, 1000);
+
+    pc_power_trace_entry_t e;
+    char small[8];
+    TEST_ASSERT_TRUE(get(0, &e));
+    TEST_ASSERT_EQUAL_INT(7, pc_power_trace_format(&e, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("1.000 W", small);
+}
+
+void test_longest_line_fits(void)
+{
+    pc_power_result_t r = {
+        PC_STATE_SLEEPING,
+        PC_ACTION_TRIGGER_POWER | PC_ACTION_SEND_WOL |
+        PC_ACTION_START_BOOT_TIMER | PC_ACTION_USB_REMOTE_WAKEUP,
+        true,
+    };
+    pc_power_trace_sm(PC_EVENT_POWER_LED_BLINK, PC_STATE_SLEEPING, &r,
+                      UINT32_MAX);
+
+    TEST_ASSERT_EQUAL_STRING("4294967.295 POWER_LED_BLINK SLEEPING>SLEEPING 1b",
+                             entry_line(0));
+    TEST_ASSERT_LESS_THAN_INT(PC_TRACE_LINE_MAX - 1, (int)strlen(line));
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_trace);
+    RUN_TEST(test_records_transition);
+    RUN_TEST(test_process_drives_the_state_machine);
+    RUN_TEST(test_records_ignored_event);
+    RUN_TEST(test_records_led_edges_in_order);
+    RUN_TEST(test_ring_keeps_newest);
+
+    RUN_TEST(test_long_blink_counted_not_stored);
+    RUN_TEST(test_sm_entry_restarts_led_burst);
+
+    RUN_TEST(test_format_truncates);
+    RUN_TEST(test_longest_line_fits);
+
+    return UNITY_END();
+}
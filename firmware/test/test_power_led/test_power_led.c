@@ -0,0 +1,411 @@
+#include "unity.h"
+#include "power_led.h"
+
+#define HOLD_MS   1500
+#define MS(x)     ((uint32_t)(x) * 1000u)
+
+static power_led_t led;
+
+void setUp(void)
+{
+    power_led_init(&led, false, HOLD_MS);
+}
+
+void tearDown(void)
+{
+}
+
+/** Feed a square wave of `cycles` (off, on) pairs starting at start_ms. */
+static uint32_t blink(uint32_t start_ms, uint32_t off_ms, uint32_t on_ms, int cycles)
+{
+    uint32_t t = start_ms;
+    for (int i = 0; i < cycles; i++) {
+        power_led_edge(&led, false, MS(t));
+        t += off_ms;
+        power_led_edge(&led, true, MS(t));
+        t += on_ms;
+    }
+    return t;
+}
+
+/* ── Steady level ────────────────────────────────────────────────────── */
+
+void test_initial_level_is_steady(void)
+{
+    TEST_ASSERT_EQUAL(POWER_LED_PATTERN_OFF, power_led_pattern(&led));
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(100000)));
+
+    power_led_init(&led, true, HOLD_MS);
+    TEST_ASSERT_EQUAL(POWER_LED_PATTERN_ON, power_led_pattern(&led));
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(100000)));
+}
+
+void test_on_reported_after_hold(void)
+{
+    power_led_edge(&led, true, MS(100));
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED,
+                      power_led_update(&led, MS(100 + HOLD_MS) - 1));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON,
+                      power_led_update(&led, MS(100 + HOLD_MS)));
+    /* Reported once */
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED,
+                      power_led_update(&led, MS(100 + HOLD_MS) + 1));
+}
+
+void test_off_reported_after_hold(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    power_led_edge(&led, false, MS(500));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_OFF,
+                      power_led_update(&led, MS(500 + HOLD_MS)));
+}
+
+void test_late_update_measures_from_edge(void)
+{
+    /* The hold runs from the edge, not from when it was seen */
+    power_led_edge(&led, true, MS(100));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON, power_led_update(&led, MS(60000)));
+}
+
+void test_repeated_level_does_not_restart(void)
+{
+    power_led_edge(&led, true, MS(100));
+    power_led_edge(&led, true, MS(1000));     /* resync with same level */
+    TEST_ASSERT_EQUAL_UINT32(1, led.edges);
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON,
+                      power_led_update(&led, MS(100 + HOLD_MS)));
+}
+
+/* ── Glitches ────────────────────────────────────────────────────────── */
+
+void test_short_pulse_ignored(void)
+{
+    power_led_edge(&led, true, MS(100));
+    power_led_edge(&led, false, MS(100) + 400);   /* 400 µs glitch */
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(10000)));
+    TEST_ASSERT_EQUAL_UINT32(2, led.edges);
+    TEST_ASSERT_EQUAL_UINT32(1, led.glitches);
+}
+
+void test_glitch_does_not_restart_hold(void)
+{
+    power_led_edge(&led, true, MS(100));
+    /* Line drops for 300 µs just before the hold would have elapsed */
+    power_led_edge(&led, false, MS(1500));
+    power_led_edge(&led, true, MS(1500) + 300);
+
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON,
+                      power_led_update(&led, MS(100 + HOLD_MS)));
+    TEST_ASSERT_EQUAL_UINT32(1, led.glitches);
+}
+
+void test_pulse_at_glitch_limit_is_kept(void)
+{
+    power_led_edge(&led, true, MS(100));
+    power_led_edge(&led, false, MS(100 + POWER_LED_GLITCH_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, led.glitches);
+    TEST_ASSERT_FALSE(led.level);
+}
+
+/* ── Blink classification ────────────────────────────────────────────── */
+
+void test_blink_identified_after_four_edges(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    power_led_edge(&led, false, MS(1000));
+    power_led_edge(&led, true,  MS(1500));
+    power_led_edge(&led, false, MS(2000));
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(2400)));
+
+    power_led_edge(&led, true, MS(2500));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_BLINKING, power_led_update(&led, MS(2500)));
+    TEST_ASSERT_EQUAL(POWER_LED_PATTERN_BLINK, power_led_pattern(&led));
+    TEST_ASSERT_EQUAL_UINT32(1000, power_led_blink_period_ms(&led));
+    TEST_ASSERT_EQUAL_UINT32(50, power_led_blink_duty_pct(&led));
+
+    /* Continuing blink is reported once */
+    blink(3000, 500, 500, 5);
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(7900)));
+}
+
+void test_blink_duty_cycle_learned(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    blink(1000, 1500, 500, 2);
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_BLINKING, power_led_update(&led, MS(5000)));
+    TEST_ASSERT_EQUAL_UINT32(2000, power_led_blink_period_ms(&led));
+    TEST_ASSERT_EQUAL_UINT32(25, power_led_blink_duty_pct(&led));
+}
+
+void test_irregular_edges_not_blink(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    power_led_edge(&led, false, MS(1000));
+    power_led_edge(&led, true,  MS(1300));
+    power_led_edge(&led, false, MS(1600));
+    power_led_edge(&led, true,  MS(3000));
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(3100)));
+    TEST_ASSERT_EQUAL_UINT32(0, power_led_blink_period_ms(&led));
+}
+
+void test_too_fast_toggling_not_blink(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    blink(1000, 50, 50, 4);
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(1400)));
+    TEST_ASSERT_EQUAL_UINT32(0, power_led_blink_period_ms(&led));
+}
+
+void test_blink_ends_with_learned_hold(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    uint32_t t = blink(1000, 500, 500, 3);        /* ends on at 3500 */
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_BLINKING, power_led_update(&led, MS(3500)));
+
+    /* Held on for 1.5x the 500 ms on-phase: the PC woke */
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(t - 500 + 749)));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON, power_led_update(&led, MS(t - 500 + 750)));
+}
+
+void test_learning_speeds_up_later_transitions(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    blink(1000, 500, 500, 3);
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_BLINKING, power_led_update(&led, MS(3500)));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON, power_led_update(&led, MS(10000)));
+
+    /* Shutdown is reported after 750 ms instead of the 1.5 s fallback */
+    power_led_edge(&led, false, MS(20000));
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(20749)));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_OFF, power_led_update(&led, MS(20750)));
+}
+
+void test_learned_hold_has_floor(void)
+{
+    power_led_init(&led, true, HOLD_MS);
+    blink(1000, 200, 50, 3);                      /* 250 ms, 20 % duty */
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_BLINKING, power_led_update(&led, MS(1750)));
+
+    /* 1.5x the 50 ms on-phase would be 75 ms */
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED,
+                      power_led_update(&led, MS(1700 + POWER_LED_HOLD_MIN_MS) - 1));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON,
+                      power_led_update(&led, MS(1700 + POWER_LED_HOLD_MIN_MS)));
+}
+
+void test_pattern_names(void)
+{
+    TEST_ASSERT_EQUAL_STRING("off",   power_led_pattern_name(POWER_LED_PATTERN_OFF));
+    TEST_ASSERT_EQUAL_STRING("on",    power_led_pattern_name(POWER_LED_PATTERN_ON));
+    TEST_ASSERT_EQUAL_STRING("blink", power_led_pattern_name(POWER_LED_PATTERN_BLINK));
+    TEST_ASSERT_EQUAL_STRING("unknown", power_led_pattern_name((power_led_pattern_t)99));
+}
+
+/* ── Clock edge cases ────────────────────────────────────────────────── */
+
+void test_edge_newer_than_now_not_held(void)
+{
+    /* Edge captured by the IRQ after the caller read the clock */
+    power_led_edge(&led, true, MS(5000) + 10);
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, MS(5000)));
+}
+
+void test_clock_wraparound(void)
+{
+    uint32_t edge = 0xFFFFFFFFu - MS(1000);
+    power_led_edge(&led, true, edge);
+    TEST_ASSERT_EQUAL(POWER_LED_UNCHANGED, power_led_update(&led, edge + MS(HOLD_MS) - 1));
+    TEST_ASSERT_EQUAL(POWER_LED_BECAME_ON, power_led_update(&led, edge + MS(HOLD_MS)));
+}
+
+/* ── Waveforms ───────────────────────────────────────────────────────────
+ *
+ * Power-LED traces modelled on common board behaviours, written as runs
+ * of (duration, level).  They are played back edge by edge with an
+ * update every 10 ms, as the firmware's hardware task does, and the
+ * reported changes are compared with what the state machine should see.
+ */
+
+typedef struct {
+    uint32_t ms;
+    bool     on;
+} segment_t;
+
+typedef struct {
+    power_led_change_t change;
+    uint32_t           at_ms;
+} report_t;
+
+#define MAX_REPORTS 16
+
+static report_t reports[MAX_REPORTS];
+static int      report_count;
+
+static void play(const segment_t *seg, int count)
+{
+    report_count = 0;
+    power_led_init(&led, seg[0].on, HOLD_MS);
+
+    uint32_t end = 0;
+    for (int i = 0; i < count; i++)
+        end += seg[i].ms;
+
+    int next = 1;
+    uint32_t next_at = seg[0].ms;
+    for (uint32_t t = 0; t <= end; t++) {
+        while (next < count && next_at == t) {
+            power_led_edge(&led, seg[next].on, MS(t));
+            next_at += seg[next].ms;
+            next++;
+        }
+        if (t % 10 != 0)
+            continue;
+        power_led_change_t c = power_led_update(&led, MS(t));
+        if (c != POWER_LED_UNCHANGED && report_count < MAX_REPORTS)
+            reports[report_count++] = (report_t){ c, t };
+    }
+}
+
+static void expect_report(int i, power_led_change_t change, uint32_t at_ms)
+{
+    TEST_ASSERT_TRUE_MESSAGE(i < report_count, "missing report");
+    TEST_ASSERT_EQUAL(change, reports[i].change);
+    TEST_ASSERT_EQUAL_UINT32(at_ms, reports[i].at_ms);
+}
+
+/* 1 Hz, 50 % sleep blink; wakes, then shuts down */
+void test_waveform_1hz_sleep_blink(void)
+{
+    static const segment_t w[] = {
+        {5000, true},
+        {500, false}, {500, true}, {500, false}, {500, true},
+        {500, false}, {500, true}, {500, false}, {500, true},
+        {500, false}, {500, true}, {500, false},
+        {5000, true},
+        {3000, false},
+    };
+    play(w, (int)(sizeof(w) / sizeof(w[0])));
+
+    TEST_ASSERT_EQUAL_INT(3, report_count);
+    expect_report(0, POWER_LED_BECAME_BLINKING, 6500);
+    expect_report(1, POWER_LED_BECAME_ON,       11250);
+    expect_report(2, POWER_LED_BECAME_OFF,      16250);
+}
+
+/* 0.5 Hz, 25 % duty ("breathing" style short flash) */
+void test_waveform_short_flash_sleep_blink(void)
+{
+    static const segment_t w[] = {
+        {4000, true},
+        {1500, false}, {500, true}, {1500, false}, {500, true},
+        {1500, false}, {500, true}, {1500, false},
+        {5000, true},
+    };
+    play(w, (int)(sizeof(w) / sizeof(w[0])));
+
+    TEST_ASSERT_EQUAL_INT(2, report_count);
+    expect_report(0, POWER_LED_BECAME_BLINKING, 7500);
+    expect_report(1, POWER_LED_BECAME_ON,       12250);
+    TEST_ASSERT_EQUAL_UINT32(25, power_led_blink_duty_pct(&led));
+}
+
+/* Slow 4 s blink: phases outlast the fallback hold until it is learned */
+void test_waveform_slow_blink(void)
+{
+    static const segment_t w[] = {
+        {3000, true},
+        {2000, false}, {2000, true}, {2000, false}, {2000, true},
+        {2000, false}, {2000, true},
+        {6000, false},
+    };
+    play(w, (int)(sizeof(w) / sizeof(w[0])));
+    TEST_ASSERT_EQUAL_INT(5, report_count);
+    /* Until learned, each 2 s phase outlasts the fallback hold */
+    expect_report(0, POWER_LED_BECAME_OFF,      4500);
+    expect_report(1, POWER_LED_BECAME_ON,       6500);
+    expect_report(2, POWER_LED_BECAME_OFF,      8500);
+    expect_report(3, POWER_LED_BECAME_BLINKING, 9000);
+    /* Learned: the final off is held 1.5x the 2 s off-phase */
+    expect_report(4, POWER_LED_BECAME_OFF,      18000);
+}
+
+/* 1 Hz blink with a noisy sense line: 2-5 ms spikes inside phases */
+void test_waveform_noisy_blink(void)
+{
+    static const segment_t w[] = {
+        {5000, true},
+        {200, false}, {3, true}, {297, false},
+        {500, true},
+        {500, false},
+        {100, true}, {2, false}, {398, true},
+        {500, false},
+        {500, true},
+        {250, false}, {5, true}, {245, false},
+        {5000, true},
+    };
+    play(w, (int)(sizeof(w) / sizeof(w[0])));
+
+    TEST_ASSERT_EQUAL_INT(2, report_count);
+    expect_report(0, POWER_LED_BECAME_BLINKING, 6500);
+    expect_report(1, POWER_LED_BECAME_ON,       9250);
+    TEST_ASSERT_EQUAL_UINT32(3, led.glitches);
+    TEST_ASSERT_EQUAL_UINT32(1000, power_led_blink_period_ms(&led));
+}
+
+/* Board that turns the LED off in sleep instead of blinking */
+void test_waveform_no_sleep_blink(void)
+{
+    static const segment_t w[] = {
+        {5000, true},
+        {10000, false},
+        {5000, true},
+    };
+    play(w, (int)(sizeof(w) / sizeof(w[0])));
+
+    TEST_ASSERT_EQUAL_INT(2, report_count);
+    expect_report(0, POWER_LED_BECAME_OFF, 6500);
+    expect_report(1, POWER_LED_BECAME_ON,  16500);
+    TEST_ASSERT_EQUAL_UINT32(0, power_led_blink_period_ms(&led));
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* Steady level */
+    RUN_TEST(test_initial_level_is_steady);
+    RUN_TEST(test_on_reported_after_hold);
+    RUN_TEST(test_off_reported_after_hold);
+    RUN_TEST(test_late_update_measures_from_edge);
+    RUN_TEST(test_repeated_level_does_not_restart);
+
+    /* Glitches */
+    RUN_TEST(test_short_pulse_ignored);
+    RUN_TEST(test_glitch_does_not_restart_hold);
+    RUN_TEST(test_pulse_at_glitch_limit_is_kept);
+
+    /* Blink classification */
+    RUN_TEST(test_blink_identified_after_four_edges);
+    RUN_TEST(test_blink_duty_cycle_learned);
+    RUN_TEST(test_irregular_edges_not_blink);
+    RUN_TEST(test_too_fast_toggling_not_blink);
+    RUN_TEST(test_blink_ends_with_learned_hold);
+    RUN_TEST(test_learning_speeds_up_later_transitions);
+    RUN_TEST(test_learned_hold_has_floor);
+    RUN_TEST(test_pattern_names);
+
+    /* Clock edge cases */
+    RUN_TEST(test_edge_newer_than_now_not_held);
+    RUN_TEST(test_clock_wraparound);
+
+    /* Waveforms */
+    RUN_TEST(test_waveform_1hz_sleep_blink);
+    RUN_TEST(test_waveform_short_flash_sleep_blink);
+    RUN_TEST(test_waveform_slow_blink);
+    RUN_TEST(test_waveform_noisy_blink);
+    RUN_TEST(test_waveform_no_sleep_blink);
+
+    return UNITY_END();
+}
@@ -0,0 +1,303 @@
+#include "unity.h"
+#include "report_filter.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static report_filter_t f;
+
+static report_filter_config_t config(uint16_t stick, uint16_t trigger,
+                                     uint32_t keepalive_ms)
+{
+    report_filter_config_t c = {
+        { stick, stick, stick, stick, trigger, trigger }, keepalive_ms,
+    };
+    return c;
+}
+
+void setUp(void)
+{
+    report_filter_config_t c = config(0, 0, 0);
+    report_filter_init(&f, &c);
+}
+
+void tearDown(void)
+{
+}
+
+static gamepad_report_t idle(void)
+{
+    gamepad_report_t r;
+    memset(&r, 0, sizeof(r));
+    r.dpad = GAMEPAD_DPAD_CENTERED;
+    return r;
+}
+
+/** Check, and send if needed; returns whether it was sent. */
+static bool offer(const gamepad_report_t *r, uint32_t now_ms)
+{
+    if (!report_filter_check(&f, r, now_ms))
+        return false;
+    report_filter_sent(&f, r, now_ms);
+    return true;
+}
+
+/* ── Change detection ─────────────────────────────────────────────────── */
+
+void test_first_report_always_sent(void)
+{
+    gamepad_report_t r = idle();
+    TEST_ASSERT_TRUE(offer(&r, 0));
+}
+
+void test_unchanged_report_suppressed(void)
+{
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+    TEST_ASSERT_FALSE(offer(&r, 1));
+    TEST_ASSERT_FALSE(offer(&r, 2));
+    TEST_ASSERT_EQUAL_UINT32(1, f.sent);
+    TEST_ASSERT_EQUAL_UINT32(2, f.suppressed);
+}
+
+void test_any_field_change_sent(void)
+{
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+
+    r.buttons = GAMEPAD_BTN_A;          TEST_ASSERT_TRUE(offer(&r, 1));
+    r.dpad    = GAMEPAD_DPAD_UP;        TEST_ASSERT_TRUE(offer(&r, 2));
+    r.lx = 1;                           TEST_ASSERT_TRUE(offer(&r, 3));
+    r.ly = -1;                          TEST_ASSERT_TRUE(offer(&r, 4));
+    r.rx = 1;                           TEST_ASSERT_TRUE(offer(&r, 5));
+    r.ry = 1;                           TEST_ASSERT_TRUE(offer(&r, 6));
+    r.lt = 1;                           TEST_ASSERT_TRUE(offer(&r, 7));
+    r.rt = 1;                           TEST_ASSERT_TRUE(offer(&r, 8));
+}
+
+void test_unsent_report_still_pending(void)
+{
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+    r.buttons = GAMEPAD_BTN_B;
+
+    /* USB busy: checked but never sent */
+    TEST_ASSERT_TRUE(report_filter_check(&f, &r, 1));
+    TEST_ASSERT_TRUE(report_filter_check(&f, &r, 2));
+    TEST_ASSERT_EQUAL_UINT32(0, f.suppressed);
+}
+
+/* ── Thresholds ───────────────────────────────────────────────────────── */
+
+void test_axis_noise_below_threshold_suppressed(void)
+{
+    report_filter_config_t c = config(100, 8, 0);
+    report_filter_init(&f, &c);
+
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+
+    r.lx = 99;  r.ry = -99; r.lt = 7;
+    TEST_ASSERT_FALSE(offer(&r, 1));
+    r.rt = 8;
+    TEST_ASSERT_TRUE(offer(&r, 2));
+    r.lx = -1;
+    TEST_ASSERT_TRUE(offer(&r, 3));     /* 100 from the value last sent */
+}
+
+void test_slow_drift_sent_once_it_adds_up(void)
+{
+    report_filter_config_t c = config(100, 0, 0);
+    report_filter_init(&f, &c);
+
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+
+    int sent = 0;
+    for (int i = 1; i <= 250; i++) {
+        r.lx = (int16_t)i;
+        sent += offer(&r, (uint32_t)i);
+    }
+    TEST_ASSERT_EQUAL_INT(2, sent);     /* at 100 and 200 */
+    TEST_ASSERT_EQUAL_INT16(200, f.last.lx);
+}
+
+void test_full_range_axis_change(void)
+{
+    report_filter_config_t c = config(4096, 0, 0);
+    report_filter_init(&f, &c);
+
+    gamepad_report_t r = idle();
+    r.lx = -32768;
+    offer(&r, 0);
+    r.lx = 32767;
+    TEST_ASSERT_TRUE(offer(&r, 1));     /* difference overflows int16 */
+}
+
+/* ── Keepalive ────────────────────────────────────────────────────────── */
+
+void test_keepalive_resends_unchanged(void)
+{
+    report_filter_config_t c = config(0, 0, 100);
+    report_filter_init(&f, &c);
+
+    gamepad_report_t r = idle();
+    offer(&r, 1000);
+    TEST_ASSERT_FALSE(offer(&r, 1099));
+    TEST_ASSERT_TRUE(offer(&r, 1100));
+    TEST_ASSERT_FALSE(offer(&r, 1101));
+}
+
+void test_keepalive_delivers_sub_threshold_value(void)
+{
+    report_filter_config_t c = config(100, 0, 50);
+    report_filter_init(&f, &c);
+
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+    r.lx = 30;
+    TEST_ASSERT_FALSE(offer(&r, 10));
+    TEST_ASSERT_TRUE(offer(&r, 50));
+    TEST_ASSERT_EQUAL_INT16(30, f.last.lx);
+}
+
+void test_keepalive_wraps_with_clock(void)
+{
+    report_filter_config_t c = config(0, 0, 100);
+    report_filter_init(&f, &c);
+
+    gamepad_report_t r = idle();
+    offer(&r, UINT32_MAX - 10);
+    TEST_ASSERT_FALSE(offer(&r, 50));
+    TEST_ASSERT_TRUE(offer(&r, 89));
+}
+
+void test_reset_sends_next_report(void)
+{
+    gamepad_report_t r = idle();
+    offer(&r, 0);
+    report_filter_reset(&f);
+    TEST_ASSERT_TRUE(offer(&r, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, f.sent);
+}
+
+/* ── Benchmark: reports per second for typical traces ─────────────────── */
+
+/*
+ * Both traces are sampled at 1 kHz for 10 s, as the main loop does when
+ * a controller streams at full rate:
+ *
+ *   idle:   controller on the table; each stick jitters +-1 LSB of a
+ *           10-bit ADC (64 in int16 units) on a new packet every 4 ms.
+ *   active: gameplay; sticks sweep continuously, triggers ramp, a button
+ *           every 150 ms; the controller updates its state every 4 ms
+ *           (250 Hz) and repeats it in between.
+ */
+#define TRACE_MS     10000
+#define PACKET_MS    4
+
+static uint32_t s_rng = 12345;
+
+static int jitter(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return (int)((s_rng >> 16) % 3) - 1;
+}
+
+static void idle_sample(uint32_t t, gamepad_report_t *r)
+{
+    if (t % PACKET_MS)
+        return;
+    *r = idle();
+    r->lx = (int16_t)(64 * jitter());
+    r->ly = (int16_t)(64 * jitter());
+    r->rx = (int16_t)(64 * jitter());
+    r->ry = (int16_t)(64 * jitter());
+}
+
+static int16_t triangle(uint32_t t, uint32_t period)
+{
+    uint32_t p = t % period;
+    int32_t  v = p < period / 2 ? (int32_t)(p * 131070 / period)
+                                : (int32_t)((period - p) * 131070 / period);
+    return (int16_t)(v - 32768 > 32767 ? 32767 : v - 32768);
+}
+
+static void active_sample(uint32_t t, gamepad_report_t *r)
+{
+    if (t % PACKET_MS)
+        return;
+    *r = idle();
+    r->lx = triangle(t, 1500);
+    r->ly = triangle(t + 400, 2300);
+    r->rx = triangle(t, 900);
+    r->ry = (int16_t)(64 * jitter());   /* resting stick */
+    r->rt = (uint16_t)((t % 2000) < 1000 ? (t % 1000) : 0);
+    if ((t % 150) < 60)
+        r->buttons = GAMEPAD_BTN_A;
+}
+
+static uint32_t run_trace(void (*sample)(uint32_t, gamepad_report_t *),
+                          const report_filter_config_t *c)
+{
+    report_filter_init(&f, c);
+    s_rng = 12345;
+    gamepad_report_t r = idle();
+    for (uint32_t t = 0; t < TRACE_MS; t++) {
+        sample(t, &r);
+        offer(&r, t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(TRACE_MS, f.sent + f.suppressed);
+    return f.sent;
+}
+
+void test_benchmark_idle_and_active_traces(void)
+{
+    report_filter_config_t exact = config(0, 0, 100);
+    report_filter_config_t noise = config(192, 4, 100);
+
+    uint32_t idle_exact   = run_trace(idle_sample, &exact);
+    uint32_t idle_noise   = run_trace(idle_sample, &noise);
+    uint32_t active_exact = run_trace(active_sample, &exact);
+    uint32_t active_noise = run_trace(active_sample, &noise);
+
+    printf("reports/s of 1000: idle %u (exact) %u (threshold 192), "
+           "active %u (exact) %u (threshold 192)\n",
+           (unsigned)(idle_exact * 1000 / TRACE_MS),
+           (unsigned)(idle_noise * 1000 / TRACE_MS),
+           (unsigned)(active_exact * 1000 / TRACE_MS),
+           (unsigned)(active_noise * 1000 / TRACE_MS));
+
+    /* Repeated packets are never resent */
+    TEST_ASSERT_TRUE(idle_exact <= TRACE_MS / PACKET_MS);
+    TEST_ASSERT_TRUE(active_exact <= TRACE_MS / PACKET_MS);
+    /* A resting controller drops to the keepalive rate with a threshold */
+    TEST_ASSERT_EQUAL_UINT32(TRACE_MS / 100, idle_noise);
+    /* Gameplay still gets every controller update */
+    TEST_ASSERT_TRUE(active_noise * 10 >= TRACE_MS / PACKET_MS * 9);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_report_always_sent);
+    RUN_TEST(test_unchanged_report_suppressed);
+    RUN_TEST(test_any_field_change_sent);
+    RUN_TEST(test_unsent_report_still_pending);
+
+    RUN_TEST(test_axis_noise_below_threshold_suppressed);
+    RUN_TEST(test_slow_drift_sent_once_it_adds_up);
+    RUN_TEST(test_full_range_axis_change);
+
+    RUN_TEST(test_keepalive_resends_unchanged);
+    RUN_TEST(test_keepalive_delivers_sub_threshold_value);
+    RUN_TEST(test_keepalive_wraps_with_clock);
+    RUN_TEST(test_reset_sends_next_report);
+
+    RUN_TEST(test_benchmark_idle_and_active_traces);
+
+    return UNITY_END();
+}
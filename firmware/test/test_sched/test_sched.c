@@ -0,0 +1,316 @@
+#include "unity.h"
+#include "sched.h"
+#include "metrics.h"
+#include <string.h>
+
+static sched_t sched;
+static uint32_t fake_us;
+
+/* Execution log: task tags in the order they ran */
+static char run_log[64];
+static int  run_len;
+
+/** Simulated runtime each task body consumes (by tag). */
+static uint32_t cost_us[128];
+
+static uint32_t clock_us(void)
+{
+    return fake_us;
+}
+
+static void task_body(uint32_t now_ms, void *ctx)
+{
+    (void)now_ms;
+    char tag = (char)(uintptr_t)ctx;
+    if (run_len < (int)sizeof(run_log) - 1)
+        run_log[run_len++] = tag;
+    run_log[run_len] = '\0';
+    fake_us += cost_us[(unsigned char)tag];
+}
+
+static int add(char tag, uint32_t period_ms, uint8_t prio)
+{
+    char name[2] = { tag, '\0' };
+    return sched_add(&sched, name, task_body, (void *)(uintptr_t)tag,
+                     period_ms, prio);
+}
+
+static void clear_log(void)
+{
+    run_len = 0;
+    run_log[0] = '\0';
+}
+
+void setUp(void)
+{
+    sched_init(&sched, clock_us);
+    metrics_reset();
+    fake_us = 0;
+    memset(cost_us, 0, sizeof(cost_us));
+    clear_log();
+}
+
+void tearDown(void)
+{
+}
+
+/* ── Registration ────────────────────────────────────────────────────── */
+
+void test_add_returns_sequential_ids(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, add('a', 10, 1));
+    TEST_ASSERT_EQUAL_INT(1, add('b', 10, 0));
+    TEST_ASSERT_EQUAL_STRING("a", sched_task(&sched, 0)->name);
+    TEST_ASSERT_EQUAL_STRING("b", sched_task(&sched, 1)->name);
+    TEST_ASSERT_NULL(sched_task(&sched, 2));
+}
+
+void test_add_until_full(void)
+{
+    for (int i = 0; i < SCHED_MAX_TASKS; i++)
+        TEST_ASSERT_TRUE(add('x', 1, 0) >= 0);
+    TEST_ASSERT_EQUAL_INT(-1, add('y', 1, 0));
+    TEST_ASSERT_EQUAL_INT(-1, sched_add(&sched, "n", NULL, NULL, 1, 0));
+}
+
+/* ── Periods and priorities ──────────────────────────────────────────── */
+
+void test_first_pass_runs_periodic_tasks_by_priority(void)
+{
+    add('c', 10, 3);
+    add('a', 5, 0);
+    add('b', 5, 1);
+    add('e', 0, 0);     /* notify-only: not run */
+
+    sched_run(&sched, 1000);
+    TEST_ASSERT_EQUAL_STRING("abc", run_log);
+}
+
+void test_equal_priorities_run_in_add_order(void)
+{
+    add('x', 5, 2);
+    add('y', 5, 2);
+    add('z', 5, 2);
+    sched_run(&sched, 0);
+    TEST_ASSERT_EQUAL_STRING("xyz", run_log);
+}
+
+void test_tasks_run_at_their_period(void)
+{
+    add('f', 5, 0);
+    add('s', 10, 1);
+
+    for (uint32_t t = 0; t < 30; t++)
+        sched_run(&sched, t);
+
+    /* f at 0,5,...,25 (6 runs), s at 0,10,20 (3 runs) */
+    TEST_ASSERT_EQUAL_UINT32(6, sched_task(&sched, 0)->runs);
+    TEST_ASSERT_EQUAL_UINT32(3, sched_task(&sched, 1)->runs);
+}
+
+void test_run_returns_time_to_next_deadline(void)
+{
+    add('f', 5, 0);
+    add('s', 10, 1);
+
+    TEST_ASSERT_EQUAL_UINT32(5, sched_run(&sched, 100));
+    TEST_ASSERT_EQUAL_UINT32(2, sched_run(&sched, 103));
+    TEST_ASSERT_EQUAL_UINT32(5, sched_run(&sched, 105));
+}
+
+void test_sleep_capped_without_periodic_tasks(void)
+{
+    add('e', 0, 0);
+    TEST_ASSERT_EQUAL_UINT32(SCHED_MAX_SLEEP_MS, sched_run(&sched, 0));
+}
+
+/* ── Notification ────────────────────────────────────────────────────── */
+
+void test_notify_runs_event_task_once(void)
+{
+    int e = add('e', 0, 0);
+
+    sched_run(&sched, 0);
+    TEST_ASSERT_EQUAL_STRING("", run_log);
+
+    sched_notify(&sched, e);
+    sched_run(&sched, 1);
+    sched_run(&sched, 2);
+    TEST_ASSERT_EQUAL_STRING("e", run_log);
+}
+
+static int notify_target;
+
+static void notifier_body(uint32_t now_ms, void *ctx)
+{
+    (void)now_ms;
+    (void)ctx;
+    sched_notify(&sched, notify_target);
+}
+
+void test_notify_during_pass_makes_sleep_zero(void)
+{
+    /* An event raised after its task was checked must not wait for
+     * the next deadline */
+    notify_target = add('e', 0, 0);
+    sched_add(&sched, "n", notifier_body, NULL, 50, 1);
+
+    TEST_ASSERT_EQUAL_UINT32(0, sched_run(&sched, 0));
+    TEST_ASSERT_EQUAL_STRING("", run_log);
+    TEST_ASSERT_EQUAL_UINT32(50, sched_run(&sched, 0));
+    TEST_ASSERT_EQUAL_STRING("e", run_log);
+}
+
+void test_notify_periodic_task_restarts_period(void)
+{
+    int p = add('p', 10, 0);
+    sched_run(&sched, 0);            /* runs, next at 10 */
+    clear_log();
+
+    sched_notify(&sched, p);
+    sched_run(&sched, 4);            /* early run, next at 14 */
+    sched_run(&sched, 10);           /* not due */
+    sched_run(&sched, 14);           /* due */
+    TEST_ASSERT_EQUAL_STRING("pp", run_log);
+    TEST_ASSERT_EQUAL_UINT32(0, sched_task(&sched, p)->late);
+}
+
+void test_notify_out_of_range_ignored(void)
+{
+    add('a', 0, 0);
+    sched_notify(&sched, -1);
+    sched_notify(&sched, 5);
+    sched_run(&sched, 0);
+    TEST_ASSERT_EQUAL_STRING("", run_log);
+}
+
+/* ── Idle tasks ──────────────────────────────────────────────────────── */
+
+void test_idle_task_waits_for_idle_pass(void)
+{
+    add('w', 5, 0);
+    add('i', 5, SCHED_PRIO_IDLE);
+
+    sched_run(&sched, 0);            /* w ran: i deferred */
+    TEST_ASSERT_EQUAL_STRING("w", run_log);
+
+    sched_run(&sched, 1);            /* nothing else due: i runs */
+    TEST_ASSERT_EQUAL_STRING("wi", run_log);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.idle_passes);
+}
+
+/* ── Statistics ──────────────────────────────────────────────────────── */
+
+void test_runtime_stats(void)
+{
+    int a = add('a', 5, 0);
+    cost_us['a'] = 120;
+    sched_run(&sched, 0);
+    cost_us['a'] = 300;
+    sched_run(&sched, 5);
+    cost_us['a'] = 80;
+    sched_run(&sched, 10);
+
+    const sched_task_t *t = sched_task(&sched, a);
+    TEST_ASSERT_EQUAL_UINT32(3, t->runs);
+    TEST_ASSERT_EQUAL_UINT32(300, t->max_us);
+    TEST_ASSERT_EQUAL_UINT32(500, t->total_us);
+}
+
+void test_late_counted_and_reanchored(void)
+{
+    int a = add('a', 5, 0);
+    sched_run(&sched, 0);            /* next at 5 */
+    sched_run(&sched, 17);           /* 12 ms late: one late run, next 22 */
+    TEST_ASSERT_EQUAL_UINT32(1, sched_task(&sched, a)->late);
+    TEST_ASSERT_EQUAL_UINT32(2, sched_task(&sched, a)->runs);
+
+    sched_run(&sched, 18);           /* no catch-up burst */
+    TEST_ASSERT_EQUAL_UINT32(2, sched_task(&sched, a)->runs);
+    sched_run(&sched, 22);
+    TEST_ASSERT_EQUAL_UINT32(3, sched_task(&sched, a)->runs);
+}
+
+void test_slightly_late_keeps_cadence(void)
+{
+    int a = add('a', 10, 0);
+    sched_run(&sched, 0);
+    sched_run(&sched, 13);           /* 3 ms late: next stays at 20 */
+    TEST_ASSERT_EQUAL_UINT32(0, sched_task(&sched, a)->late);
+    TEST_ASSERT_EQUAL_UINT32(7, sched_run(&sched, 13));
+}
+
+void test_wraparound(void)
+{
+    int a = add('a', 10, 0);
+    sched_run(&sched, 0xFFFFFFF8u);  /* next wraps to 2 */
+    sched_run(&sched, 0xFFFFFFFEu);
+    TEST_ASSERT_EQUAL_UINT32(1, sched_task(&sched, a)->runs);
+    sched_run(&sched, 2);
+    TEST_ASSERT_EQUAL_UINT32(2, sched_task(&sched, a)->runs);
+    TEST_ASSERT_EQUAL_UINT32(0, sched_task(&sched, a)->late);
+}
+
+void test_register_metrics(void)
+{
+    add('u', 1, 0);
+    cost_us['u'] = 42;
+    TEST_ASSERT_TRUE(sched_register_metrics(&sched));
+    sched_run(&sched, 0);
+
+    TEST_ASSERT_EQUAL_INT(4, metrics_count());
+    TEST_ASSERT_EQUAL_STRING("u.runs", metrics_name(0));
+    TEST_ASSERT_EQUAL_STRING("u.max_us", metrics_name(2));
+
+    char value[16];
+    metrics_format_value(2, value, sizeof(value));
+    TEST_ASSERT_EQUAL_STRING("42", value);
+}
+
+void test_register_metrics_reports_full_registry(void)
+{
+    static uint32_t counter;
+    for (int i = 0; i < METRICS_MAX - 2; i++)
+        metrics_register_counter("filler", &counter, 0);
+
+    add('u', 1, 0);
+    TEST_ASSERT_FALSE(sched_register_metrics(&sched));
+    TEST_ASSERT_EQUAL_INT(METRICS_MAX, metrics_count());
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* Registration */
+    RUN_TEST(test_add_returns_sequential_ids);
+    RUN_TEST(test_add_until_full);
+
+    /* Periods and priorities */
+    RUN_TEST(test_first_pass_runs_periodic_tasks_by_priority);
+    RUN_TEST(test_equal_priorities_run_in_add_order);
+    RUN_TEST(test_tasks_run_at_their_period);
+    RUN_TEST(test_run_returns_time_to_next_deadline);
+    RUN_TEST(test_sleep_capped_without_periodic_tasks);
+
+    /* Notification */
+    RUN_TEST(test_notify_runs_event_task_once);
+    RUN_TEST(test_notify_during_pass_makes_sleep_zero);
+    RUN_TEST(test_notify_periodic_task_restarts_period);
+    RUN_TEST(test_notify_out_of_range_ignored);
+
+    /* Idle tasks */
+    RUN_TEST(test_idle_task_waits_for_idle_pass);
+
+    /* Statistics */
+    RUN_TEST(test_runtime_stats);
+    RUN_TEST(test_late_counted_and_reanchored);
+    RUN_TEST(test_slightly_late_keeps_cadence);
+    RUN_TEST(test_wraparound);
+    RUN_TEST(test_register_metrics);
+    RUN_TEST(test_register_metrics_reports_full_registry);
+
+    return UNITY_END();
+}
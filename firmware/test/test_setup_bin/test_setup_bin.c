@@ -0,0 +1,517 @@
+#include "unity.h"
+#include "setup_bin.h"
+#include "metrics.h"
+#include <string.h>
+
+static device_config_t cfg;
+static uint8_t frame[SETUP_BIN_FRAME_MAX];
+static uint8_t rsp[SETUP_BIN_BODY_MAX];
+static int rsp_len;
+
+static const char *fake_text(void *ctx)
+{
+    return (const char *)ctx;
+}
+
+void setUp(void)
+{
+    device_config_init(&cfg);
+    setup_cmd_set_version("1.2.3");
+    metrics_reset();
+    metrics_register_text("pc_state", fake_text, "OFF", METRICS_F_STATUS);
+    metrics_register_text("bt_connected", fake_text, "false",
+                          METRICS_F_STATUS);
+}
+
+void tearDown(void)
+{
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+/**
+ * Encode a request body, run it through setup_bin_process(), check the
+ * response framing and decode the response body into rsp.
+ */
+static setup_cmd_result_t request(const uint8_t *body, size_t len)
+{
+    uint8_t enc[SETUP_BIN_FRAME_MAX];
+    size_t enc_len = setup_bin_cobs_encode(body, len, enc, sizeof(enc));
+    TEST_ASSERT_TRUE(enc_len > 0);
+
+    memset(frame, 0xEE, sizeof(frame));
+    setup_cmd_result_t r = setup_bin_process(enc, enc_len, &cfg,
+                                             frame, sizeof(frame));
+    TEST_ASSERT_TRUE(r.out_len >= 3);
+    TEST_ASSERT_EQUAL_HEX8(SETUP_BIN_MAGIC, frame[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame[r.out_len - 1]);
+    TEST_ASSERT_NULL(memchr(frame + 1, 0, (size_t)r.out_len - 2));
+
+    rsp_len = setup_bin_cobs_decode(frame + 1, (size_t)r.out_len - 2,
+                                    rsp, sizeof(rsp));
+    TEST_ASSERT_TRUE(rsp_len >= 3);
+    return r;
+}
+
+static void assert_status(uint8_t op, uint8_t tag, setup_bin_status_t st)
+{
+    TEST_ASSERT_EQUAL_HEX8(op | 0x80, rsp[0]);
+    TEST_ASSERT_EQUAL_HEX8(tag, rsp[1]);
+    TEST_ASSERT_EQUAL_UINT8(st, rsp[2]);
+}
+
+/** Append a [key][len][value] SET item. */
+static size_t put_item(uint8_t *p, int key, const char *value)
+{
+    size_t n = strlen(value);
+    p[0] = (uint8_t)key;
+    p[1] = (uint8_t)n;
+    memcpy(p + 2, value, n);
+    return 2 + n;
+}
+
+/* ── COBS ────────────────────────────────────────────────────────────── */
+
+static void check_cobs_roundtrip(const uint8_t *in, size_t len)
+{
+    uint8_t enc[600], dec[600];
+    size_t e = setup_bin_cobs_encode(in, len, enc, sizeof(enc));
+    TEST_ASSERT_TRUE(e > len);
+    TEST_ASSERT_NULL(memchr(enc, 0, e));
+    int d = setup_bin_cobs_decode(enc, e, dec, sizeof(dec));
+    TEST_ASSERT_EQUAL_INT((int)len, d);
+    if (len)
+        TEST_ASSERT_EQUAL_MEMORY(in, dec, len);
+}
+
+void test_cobs_known_vectors(void)
+{
+    uint8_t enc[16];
+
+    const uint8_t a[] = { 0x00 };
+    TEST_ASSERT_EQUAL_UINT(2, setup_bin_cobs_encode(a, 1, enc, sizeof(enc)));
+    TEST_ASSERT_EQUAL_HEX8(0x01, enc[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, enc[1]);
+
+    const uint8_t b[] = { 0x11, 0x22, 0x00, 0x33 };
+    const uint8_t b_enc[] = { 0x03, 0x11, 0x22, 0x02, 0x33 };
+    TEST_ASSERT_EQUAL_UINT(5, setup_bin_cobs_encode(b, 4, enc, sizeof(enc)));
+    TEST_ASSERT_EQUAL_MEMORY(b_enc, enc, 5);
+}
+
+void test_cobs_roundtrip_edge_lengths(void)
+{
+    uint8_t buf[520] = {0};
+
+    check_cobs_roundtrip(buf, 0);
+
+    /* Runs of non-zero bytes around the 254-byte block boundary */
+    for (size_t len = 250; len <= 260; len++) {
+        for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)(i % 255 + 1);
+        check_cobs_roundtrip(buf, len);
+    }
+
+    /* All zeros */
+    memset(buf, 0, sizeof(buf));
+    check_cobs_roundtrip(buf, 300);
+
+    /* Every byte value */
+    for (size_t i = 0; i < 512; i++) buf[i] = (uint8_t)i;
+    check_cobs_roundtrip(buf, 512);
+}
+
+void test_cobs_decode_rejects_malformed(void)
+{
+    uint8_t out[16];
+    const uint8_t zero_code[] = { 0x00, 0x01 };
+    const uint8_t truncated[] = { 0x05, 0x11, 0x22 };
+    const uint8_t embedded_zero[] = { 0x03, 0x11, 0x00 };
+
+    TEST_ASSERT_EQUAL_INT(-1, setup_bin_cobs_decode(zero_code, 2, out, 16));
+    TEST_ASSERT_EQUAL_INT(-1, setup_bin_cobs_decode(truncated, 3, out, 16));
+    TEST_ASSERT_EQUAL_INT(-1, setup_bin_cobs_decode(embedded_zero, 3, out, 16));
+}
+
+void test_cobs_encode_reports_small_buffer(void)
+{
+    const uint8_t in[] = { 1, 2, 3, 4 };
+    uint8_t out[4];
+    TEST_ASSERT_EQUAL_UINT(0, setup_bin_cobs_encode(in, 4, out, sizeof(out)));
+}
+
+/* ── GET ─────────────────────────────────────────────────────────────── */
+
+void test_get_multiple_keys_in_one_frame(void)
+{
+    int pulse = setup_cmd_find_key("power_pulse_ms");
+    int name  = setup_cmd_find_key("device_name");
+    uint8_t body[] = { SETUP_BIN_OP_GET, 0x42, (uint8_t)pulse, (uint8_t)name };
+
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_GET, 0x42, SETUP_BIN_OK);
+
+    const uint8_t expect[] = {
+        (uint8_t)pulse, 3, '2', '0', '0',
+        (uint8_t)name, 8, 'P', 'a', 'd', 'P', 'r', 'o', 'x', 'y',
+    };
+    TEST_ASSERT_EQUAL_INT(3 + (int)sizeof(expect), rsp_len);
+    TEST_ASSERT_EQUAL_MEMORY(expect, rsp + 3, sizeof(expect));
+}
+
+void test_get_masks_password(void)
+{
+    strcpy(cfg.wifi_password, "secret");
+    uint8_t body[] = { SETUP_BIN_OP_GET, 0,
+                       (uint8_t)setup_cmd_find_key("wifi_password") };
+
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_GET, 0, SETUP_BIN_OK);
+    TEST_ASSERT_EQUAL_UINT8(8, rsp[4]);
+    TEST_ASSERT_EQUAL_MEMORY("********", rsp + 5, 8);
+}
+
+void test_get_unknown_key(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_GET, 7, 0, 200 };
+
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_GET, 7, SETUP_BIN_ERR_KEY);
+    TEST_ASSERT_EQUAL_INT(4, rsp_len);
+    TEST_ASSERT_EQUAL_UINT8(200, rsp[3]);
+}
+
+/* ── SET ─────────────────────────────────────────────────────────────── */
+
+void test_set_multiple_keys(void)
+{
+    uint8_t body[128] = { SETUP_BIN_OP_SET, 1, 0 };
+    size_t n = 3;
+    n += put_item(body + n, setup_cmd_find_key("wifi_ssid"), "HomeNet");
+    n += put_item(body + n, setup_cmd_find_key("power_pulse_ms"), "500");
+    n += put_item(body + n, setup_cmd_find_key("device_name"), "Den PC");
+
+    setup_cmd_result_t r = request(body, n);
+    assert_status(SETUP_BIN_OP_SET, 1, SETUP_BIN_OK);
+    TEST_ASSERT_EQUAL_INT(3, rsp_len);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+    TEST_ASSERT_EQUAL_STRING("HomeNet", cfg.wifi_ssid);
+    TEST_ASSERT_EQUAL_UINT16(500, cfg.power_pulse_ms);
+    TEST_ASSERT_EQUAL_STRING("Den PC", cfg.device_name);
+}
+
+void test_set_is_transactional(void)
+{
+    uint8_t body[128] = { SETUP_BIN_OP_SET, 2, 0 };
+    size_t n = 3;
+    int timeout = setup_cmd_find_key("boot_timeout_ms");
+    n += put_item(body + n, setup_cmd_find_key("wifi_ssid"), "HomeNet");
+    n += put_item(body + n, setup_cmd_find_key("power_pulse_ms"), "500");
+    n += put_item(body + n, timeout, "99999");
+
+    device_config_t before = cfg;
+    request(body, n);
+    assert_status(SETUP_BIN_OP_SET, 2, SETUP_BIN_ERR_VALUE);
+    TEST_ASSERT_EQUAL_UINT8(timeout, rsp[3]);
+    TEST_ASSERT_EQUAL_MEMORY("invalid number", rsp + 4, 14);
+
+    /* Nothing from the batch was applied */
+    TEST_ASSERT_EQUAL_MEMORY(&before, &cfg, sizeof(cfg));
+}
+
+void test_set_with_save_flag_returns_save_action(void)
+{
+    uint8_t body[64] = { SETUP_BIN_OP_SET, 3, SETUP_BIN_SET_SAVE };
+    size_t n = 3;
+    n += put_item(body + n, setup_cmd_find_key("boot_timeout_ms"), "45000");
+
+    setup_cmd_result_t r = request(body, n);
+    assert_status(SETUP_BIN_OP_SET, 3, SETUP_BIN_OK);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_SAVE, r.action);
+    TEST_ASSERT_EQUAL_UINT16(45000, cfg.boot_timeout_ms);
+}
+
+void test_set_failed_save_returns_no_action(void)
+{
+    uint8_t body[64] = { SETUP_BIN_OP_SET, 3, SETUP_BIN_SET_SAVE };
+    size_t n = 3;
+    n += put_item(body + n, setup_cmd_find_key("device_name"), "");
+
+    setup_cmd_result_t r = request(body, n);
+    assert_status(SETUP_BIN_OP_SET, 3, SETUP_BIN_ERR_VALUE);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+}
+
+void test_set_truncated_item_is_malformed(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_SET, 4, 0, 0, 10, 'a', 'b' };
+
+    device_config_t before = cfg;
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_SET, 4, SETUP_BIN_ERR_MALFORMED);
+    TEST_ASSERT_EQUAL_MEMORY(&before, &cfg, sizeof(cfg));
+}
+
+void test_set_rejects_embedded_nul(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_SET, 5, 0, 0, 3, 'a', 0, 'b' };
+
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_SET, 5, SETUP_BIN_ERR_VALUE);
+}
+
+/* ── LIST / STATUS / TEXT ────────────────────────────────────────────── */
+
+void test_list_returns_every_key(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_LIST, 9 };
+
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_LIST, 9, SETUP_BIN_OK);
+
+    int pos = 3;
+    for (int k = 0; k < setup_cmd_key_count(); k++) {
+        char value[SETUP_CMD_VALUE_MAX];
+        int vlen = setup_cmd_get_value(k, &cfg, value, sizeof(value));
+        const char *name = setup_cmd_key_name(k);
+
+        TEST_ASSERT_EQUAL_UINT8(k, rsp[pos++]);
+        TEST_ASSERT_EQUAL_UINT8(strlen(name), rsp[pos++]);
+        TEST_ASSERT_EQUAL_MEMORY(name, rsp + pos, strlen(name));
+        pos += (int)strlen(name);
+        TEST_ASSERT_EQUAL_UINT8(vlen, rsp[pos++]);
+        if (vlen)
+            TEST_ASSERT_EQUAL_MEMORY(value, rsp + pos, (size_t)vlen);
+        pos += vlen;
+    }
+    TEST_ASSERT_EQUAL_INT(rsp_len, pos);
+}
+
+void test_status_op(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_STATUS, 0 };
+    const char *expect = "OK pc_state=OFF bt_connected=false\n";
+
+    request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_STATUS, 0, SETUP_BIN_OK);
+    TEST_ASSERT_EQUAL_INT(3 + (int)strlen(expect), rsp_len);
+    TEST_ASSERT_EQUAL_MEMORY(expect, rsp + 3, strlen(expect));
+}
+
+void test_text_op_runs_text_command(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_TEXT, 0, 'r', 'e', 'b', 'o', 'o', 't' };
+
+    setup_cmd_result_t r = request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_TEXT, 0, SETUP_BIN_OK);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_REBOOT, r.action);
+    TEST_ASSERT_EQUAL_MEMORY("OK\n", rsp + 3, 3);
+}
+
+void test_text_op_refuses_firmware(void)
+{
+    const char *line = "firmware 1024 deadbeef";
+    uint8_t body[64] = { SETUP_BIN_OP_TEXT, 0 };
+    memcpy(body + 2, line, strlen(line));
+
+    setup_cmd_result_t r = request(body, 2 + strlen(line));
+    assert_status(SETUP_BIN_OP_TEXT, 0, SETUP_BIN_ERR_OP);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+}
+
+void test_text_op_refuses_log_dump(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_TEXT, 0, 'l', 'o', 'g', ' ',
+                       'd', 'u', 'm', 'p' };
+
+    setup_cmd_result_t r = request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_TEXT, 0, SETUP_BIN_ERR_OP);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+}
+
+void test_text_op_refuses_trace(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_TEXT, 0, 't', 'r', 'a', 'c', 'e' };
+
+    setup_cmd_result_t r = request(body, sizeof(body));
+    assert_status(SETUP_BIN_OP_TEXT, 0, SETUP_BIN_ERR_OP);
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+}
+
+/* ── Errors ──────────────────────────────────────────────────────────── */
+
+void test_unknown_op(void)
+{
+    uint8_t body[] = { 0x7F, 0x11 };
+
+    request(body, sizeof(body));
+    assert_status(0x7F, 0x11, SETUP_BIN_ERR_OP);
+}
+
+void test_short_body_is_malformed(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_GET };
+
+    request(body, sizeof(body));
+    TEST_ASSERT_EQUAL_UINT8(SETUP_BIN_ERR_MALFORMED, rsp[2]);
+}
+
+void test_bad_cobs_is_malformed(void)
+{
+    const uint8_t bad[] = { 0x09, 0x01, 0x02 };
+    setup_cmd_result_t r = setup_bin_process(bad, sizeof(bad), &cfg,
+                                             frame, sizeof(frame));
+    TEST_ASSERT_TRUE(r.out_len > 0);
+    rsp_len = setup_bin_cobs_decode(frame + 1, (size_t)r.out_len - 2,
+                                    rsp, sizeof(rsp));
+    TEST_ASSERT_EQUAL_UINT8(SETUP_BIN_ERR_MALFORMED, rsp[2]);
+}
+
+void test_small_output_buffer_reports_overflow(void)
+{
+    uint8_t body[] = { SETUP_BIN_OP_LIST, 1 };
+    uint8_t enc[8];
+    size_t enc_len = setup_bin_cobs_encode(body, sizeof(body), enc, sizeof(enc));
+    uint8_t small[16];
+
+    setup_cmd_result_t r = setup_bin_process(enc, enc_len, &cfg,
+                                             small, sizeof(small));
+    TEST_ASSERT_TRUE(r.out_len > 0);
+    rsp_len = setup_bin_cobs_decode(small + 1, (size_t)r.out_len - 2,
+                                    rsp, sizeof(rsp));
+    TEST_ASSERT_EQUAL_INT(3, rsp_len);
+    TEST_ASSERT_EQUAL_UINT8(SETUP_BIN_ERR_OVERFLOW, rsp[2]);
+}
+
+void test_null_inputs(void)
+{
+    setup_cmd_result_t r = setup_bin_process(NULL, 0, &cfg,
+                                             frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(0, r.out_len);
+    r = setup_bin_process(frame, 1, NULL, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(0, r.out_len);
+}
+
+/* ── Frame collection ────────────────────────────────────────────────── */
+
+static setup_bin_rx_t rx;
+
+/** Feed bytes to an active frame; the status of the last one. */
+static setup_bin_rx_status_t feed(const uint8_t *p, size_t n, uint32_t now)
+{
+    setup_bin_rx_status_t st = SETUP_BIN_RX_MORE;
+    for (size_t i = 0; i < n; i++)
+        st = setup_bin_rx_byte(&rx, p[i], now);
+    return st;
+}
+
+void test_rx_collects_a_frame(void)
+{
+    const uint8_t body[] = { SETUP_BIN_OP_STATUS, 9 };
+    uint8_t enc[8];
+    size_t n = setup_bin_cobs_encode(body, sizeof(body), enc, sizeof(enc));
+
+    memset(&rx, 0, sizeof(rx));
+    setup_bin_rx_start(&rx, 1000);
+    TEST_ASSERT_EQUAL(SETUP_BIN_RX_MORE, feed(enc, n, 1010));
+    TEST_ASSERT_EQUAL(SETUP_BIN_RX_FRAME, setup_bin_rx_byte(&rx, 0x00, 1020));
+    TEST_ASSERT_EQUAL_UINT16(n, rx.len);
+
+    setup_cmd_result_t r = setup_bin_process(rx.buf, rx.len, &cfg,
+                                             frame, sizeof(frame));
+    TEST_ASSERT_TRUE(r.out_len > 0);
+    setup_bin_rx_done(&rx);
+    TEST_ASSERT_FALSE(rx.active);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.dropped);
+}
+
+void test_rx_stray_magic_times_out(void)
+{
+    memset(&rx, 0, sizeof(rx));
+    setup_bin_rx_start(&rx, 5000);
+    feed((const uint8_t *)"stat", 4, 5010);
+
+    /* Bytes keep it alive; silence for the idle time drops it */
+    TEST_ASSERT_FALSE(setup_bin_rx_expire(&rx, 5010 + SETUP_BIN_IDLE_MS - 1));
+    TEST_ASSERT_TRUE(rx.active);
+    TEST_ASSERT_TRUE(setup_bin_rx_expire(&rx, 5010 + SETUP_BIN_IDLE_MS));
+    TEST_ASSERT_FALSE(rx.active);
+    TEST_ASSERT_EQUAL_UINT16(0, rx.len);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.dropped);
+
+    /* Back in text mode: nothing more to expire */
+    TEST_ASSERT_FALSE(setup_bin_rx_expire(&rx, 60000));
+}
+
+void test_rx_timeout_across_clock_wrap(void)
+{
+    memset(&rx, 0, sizeof(rx));
+    setup_bin_rx_start(&rx, UINT32_MAX - 50);
+    TEST_ASSERT_FALSE(setup_bin_rx_expire(&rx, 10));
+    TEST_ASSERT_TRUE(setup_bin_rx_expire(&rx, SETUP_BIN_IDLE_MS));
+}
+
+void test_rx_overflow_returns_to_text(void)
+{
+    memset(&rx, 0, sizeof(rx));
+    setup_bin_rx_start(&rx, 0);
+
+    setup_bin_rx_status_t st = SETUP_BIN_RX_MORE;
+    size_t fed = 0;
+    while (st == SETUP_BIN_RX_MORE) {
+        st = setup_bin_rx_byte(&rx, 'x', 0);
+        fed++;
+    }
+    TEST_ASSERT_EQUAL(SETUP_BIN_RX_DROPPED, st);
+    TEST_ASSERT_EQUAL(SETUP_BIN_FRAME_MAX + 1, fed);
+    TEST_ASSERT_FALSE(rx.active);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.dropped);
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* COBS */
+    RUN_TEST(test_cobs_known_vectors);
+    RUN_TEST(test_cobs_roundtrip_edge_lengths);
+    RUN_TEST(test_cobs_decode_rejects_malformed);
+    RUN_TEST(test_cobs_encode_reports_small_buffer);
+
+    /* GET */
+    RUN_TEST(test_get_multiple_keys_in_one_frame);
+    RUN_TEST(test_get_masks_password);
+    RUN_TEST(test_get_unknown_key);
+
+    /* SET */
+    RUN_TEST(test_set_multiple_keys);
+    RUN_TEST(test_set_is_transactional);
+    RUN_TEST(test_set_with_save_flag_returns_save_action);
+    RUN_TEST(test_set_failed_save_returns_no_action);
+    RUN_TEST(test_set_truncated_item_is_malformed);
+    RUN_TEST(test_set_rejects_embedded_nul);
+
+    /* LIST / STATUS / TEXT */
+    RUN_TEST(test_list_returns_every_key);
+    RUN_TEST(test_status_op);
+    RUN_TEST(test_text_op_runs_text_command);
+    RUN_TEST(test_text_op_refuses_firmware);
+    RUN_TEST(test_text_op_refuses_log_dump);
+    RUN_TEST(test_text_op_refuses_trace);
+
+    /* Errors */
+    RUN_TEST(test_unknown_op);
+    RUN_TEST(test_short_body_is_malformed);
+    RUN_TEST(test_bad_cobs_is_malformed);
+    RUN_TEST(test_small_output_buffer_reports_overflow);
+    RUN_TEST(test_null_inputs);
+
+    /* Frame collection */
+    RUN_TEST(test_rx_collects_a_frame);
+    RUN_TEST(test_rx_stray_magic_times_out);
+    RUN_TEST(test_rx_timeout_across_clock_wrap);
+    RUN_TEST(test_rx_overflow_returns_to_text);
+
+    return UNITY_END();
+}
@@ -1,17 +1,27 @@
 #include "unity.h"
 #include "setup_cmd.h"
+#include "fw_stream.h"
+#include "metrics.h"
 #include <string.h>
 #include <stdio.h>
 
 static device_config_t cfg;
 static char out[1024];
 
+static const char *fake_text(void *ctx)
+{
+    return (const char *)ctx;
+}
+
 void setUp(void)
 {
     device_config_init(&cfg);
     memset(out, 0, sizeof(out));
     setup_cmd_set_version("1.2.3");
-    setup_cmd_set_status("pc_state=OFF bt_connected=false");
+    metrics_reset();
+    metrics_register_text("pc_state", fake_text, "OFF", METRICS_F_STATUS);
+    metrics_register_text("bt_connected", fake_text, "false",
+                          METRICS_F_STATUS);
 }
 
 void tearDown(void)
@@ -220,6 +230,38 @@ void test_set_device_name(void)
     TEST_ASSERT_EQUAL_STRING("MyPad", cfg.device_name);
 }
 
+void test_set_wol_mac(void)
+{
+    run("set wol_mac 00-1A-2B-3C-4D-5E");
+    assert_ok();
+    TEST_ASSERT_EQUAL_STRING("00-1A-2B-3C-4D-5E", cfg.wol_mac);
+}
+
+void test_set_wol_mac_invalid(void)
+{
+    run("set wol_mac 00:1a:2b:3c:4d:5g");
+    assert_err();
+    TEST_ASSERT_EQUAL_STRING("", cfg.wol_mac);
+}
+
+void test_set_button_map(void)
+{
+    run("set button_map switch.a=b switch.b=a ly=-ly");
+    assert_ok();
+    TEST_ASSERT_EQUAL_STRING("switch.a=b switch.b=a ly=-ly", cfg.button_map);
+}
+
+void test_set_button_map_invalid(void)
+{
+    run("set button_map a=b,zz=a");
+    assert_err();
+    TEST_ASSERT_EQUAL_STRING("", cfg.button_map);
+
+    run("set button_map lx=lt");        /* stick to trigger */
+    assert_err();
+    TEST_ASSERT_EQUAL_STRING("", cfg.button_map);
+}
+
 void test_set_device_name_empty(void)
 {
     /* "set device_name " — value is empty string after key */
@@ -394,6 +436,62 @@ void test_status(void)
     TEST_ASSERT_EQUAL_STRING("OK pc_state=OFF bt_connected=false\n", out);
 }
 
+void test_status_evaluates_on_request(void)
+{
+    static uint32_t counter;
+    counter = 1;
+    metrics_register_counter("reports", &counter, METRICS_F_STATUS);
+    counter = 42;
+
+    run("status");
+    TEST_ASSERT_EQUAL_STRING(
+        "OK pc_state=OFF bt_connected=false reports=42\n", out);
+}
+
+void test_stats_lists_every_metric(void)
+{
+    static uint32_t counter = 7;
+    metrics_register_counter("loop_overruns", &counter, 0);
+
+    run("stats");
+    TEST_ASSERT_EQUAL_STRING("OK pc_state=OFF\n"
+                             "OK bt_connected=false\n"
+                             "OK loop_overruns=7\n", out);
+}
+
+void test_stats_fits_a_full_registry(void)
+{
+    /* 24-character names, the largest uint32_t values */
+    static char names[METRICS_MAX][25];
+    static uint32_t counter = UINT32_MAX;
+    static char reply[SETUP_CMD_STATS_SIZE];
+
+    metrics_reset();
+    for (int i = 0; i < METRICS_MAX; i++) {
+        snprintf(names[i], sizeof(names[i]), "metric_%017d", i);
+        TEST_ASSERT_TRUE(metrics_register_counter(names[i], &counter, 0));
+    }
+    TEST_ASSERT_FALSE(metrics_register_counter("one_too_many", &counter, 0));
+
+    setup_cmd_result_t r = setup_cmd_process("stats", &cfg, reply,
+                                             sizeof(reply));
+    TEST_ASSERT_LESS_THAN_INT((int)sizeof(reply), r.out_len);
+
+    int lines = 0;
+    for (int i = 0; i < r.out_len; i++)
+        lines += reply[i] == '\n';
+    TEST_ASSERT_EQUAL_INT(METRICS_MAX, lines);
+    TEST_ASSERT_NOT_NULL(strstr(reply,
+                                "OK metric_00000000000000095=4294967295\n"));
+}
+
+void test_stats_empty_registry(void)
+{
+    metrics_reset();
+    run("stats");
+    TEST_ASSERT_EQUAL_STRING("OK\n", out);
+}
+
 /* ── reboot command ──────────────────────────────────────────────────── */
 
 void test_reboot_returns_reboot_action(void)
@@ -403,6 +501,74 @@ void test_reboot_returns_reboot_action(void)
     TEST_ASSERT_EQUAL(SETUP_ACTION_REBOOT, r.action);
 }
 
+/* ── firmware command ────────────────────────────────────────────────── */
+
+void test_firmware_returns_firmware_action(void)
+{
+    setup_cmd_result_t r = run("firmware 245760 1a2B3c4D");
+    TEST_ASSERT_EQUAL(SETUP_ACTION_FIRMWARE, r.action);
+    TEST_ASSERT_EQUAL_UINT32(245760, r.fw_size);
+    TEST_ASSERT_EQUAL_HEX32(0x1A2B3C4D, r.fw_crc32);
+}
+
+void test_firmware_reports_window_and_chunk(void)
+{
+    char expected[32];
+    snprintf(expected, sizeof(expected), "OK %d %d\n",
+             FW_STREAM_WINDOW, FW_STREAM_CHUNK_MAX);
+    run("firmware 1024 0");
+    TEST_ASSERT_EQUAL_STRING(expected, out);
+}
+
+void test_firmware_missing_crc(void)
+{
+    setup_cmd_result_t r = run("firmware 1024");
+    assert_err();
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+}
+
+void test_firmware_zero_size(void)
+{
+    setup_cmd_result_t r = run("firmware 0 1234");
+    assert_err();
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+}
+
+void test_firmware_bad_numbers(void)
+{
+    run("firmware abc 1234");
+    assert_err();
+    run("firmware 1024 xyz");
+    assert_err();
+    run("firmware -5 1234");
+    assert_err();
+}
+
+/* ── log command ─────────────────────────────────────────────────────── */
+
+void test_log_dump_returns_log_action(void)
+{
+    setup_cmd_result_t r = run("log dump");
+    TEST_ASSERT_EQUAL(SETUP_ACTION_LOG_DUMP, r.action);
+    TEST_ASSERT_EQUAL_INT(0, r.out_len);
+}
+
+void test_trace_returns_trace_action(void)
+{
+    setup_cmd_result_t r = run("trace");
+    TEST_ASSERT_EQUAL(SETUP_ACTION_TRACE_DUMP, r.action);
+    TEST_ASSERT_EQUAL_INT(0, r.out_len);
+}
+
+void test_log_usage(void)
+{
+    setup_cmd_result_t r = run("log");
+    assert_err();
+    TEST_ASSERT_EQUAL(SETUP_ACTION_NONE, r.action);
+    run("log clear");
+    assert_err();
+}
+
 /* ── Unknown command ─────────────────────────────────────────────────── */
 
 void test_unknown_command(void)
@@ -493,6 +659,10 @@ int main(void)
     RUN_TEST(test_set_boot_timeout_ms_too_high);
     RUN_TEST(test_set_device_name);
     RUN_TEST(test_set_device_name_empty);
+    RUN_TEST(test_set_wol_mac);
+    RUN_TEST(test_set_wol_mac_invalid);
+    RUN_TEST(test_set_button_map);
+    RUN_TEST(test_set_button_map_invalid);
     RUN_TEST(test_set_device_name_at_max_length);
     RUN_TEST(test_set_device_name_too_long);
     RUN_TEST(test_set_wifi_ssid_at_max_length);
@@ -519,10 +689,26 @@ int main(void)
 
     /* status */
     RUN_TEST(test_status);
+    RUN_TEST(test_status_evaluates_on_request);
+    RUN_TEST(test_stats_lists_every_metric);
+    RUN_TEST(test_stats_fits_a_full_registry);
+    RUN_TEST(test_stats_empty_registry);
 
     /* reboot */
     RUN_TEST(test_reboot_returns_reboot_action);
 
+    /* firmware */
+    RUN_TEST(test_firmware_returns_firmware_action);
+    RUN_TEST(test_firmware_reports_window_and_chunk);
+    RUN_TEST(test_firmware_missing_crc);
+    RUN_TEST(test_firmware_zero_size);
+    RUN_TEST(test_firmware_bad_numbers);
+
+    /* log */
+    RUN_TEST(test_log_dump_returns_log_action);
+    RUN_TEST(test_trace_returns_trace_action);
+    RUN_TEST(test_log_usage);
+
     /* Unknown command */
     RUN_TEST(test_unknown_command);
 
@@ -0,0 +1,286 @@
+#include "unity.h"
+#include "switch_pro.h"
+
+#include <string.h>
+
+static uint8_t out[SWITCH_PRO_REPORT_LEN];
+static uint8_t req[SWITCH_PRO_REPORT_LEN];
+static gamepad_report_t in;
+static gamepad_output_t output;
+static bool has_output;
+
+/* Neutral HD rumble frame for one motor */
+static const uint8_t RUMBLE_OFF[4] = { 0x00, 0x01, 0x40, 0x40 };
+
+void setUp(void)
+{
+    memset(out, 0xEE, sizeof(out));
+    memset(req, 0, sizeof(req));
+    memset(&in, 0, sizeof(in));
+    in.dpad = GAMEPAD_DPAD_CENTERED;
+    memset(&output, 0, sizeof(output));
+    has_output = false;
+}
+
+void tearDown(void)
+{
+}
+
+static uint16_t stick_x(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] & 0x0F) << 8); }
+static uint16_t stick_y(const uint8_t *p) { return (uint16_t)(p[1] >> 4 | p[2] << 4); }
+
+/** Output report 0x01 (rumble off) carrying a subcommand. */
+static void subcmd(uint8_t id)
+{
+    req[0] = 0x01;
+    req[1] = 0x00;
+    memcpy(&req[2], RUMBLE_OFF, 4);
+    memcpy(&req[6], RUMBLE_OFF, 4);
+    req[10] = id;
+}
+
+static uint8_t host(uint16_t len)
+{
+    return switch_pro_from_host(req, len, 7, &output, &has_output, out);
+}
+
+/* ── Input report 0x30 ────────────────────────────────────────────────── */
+
+void test_idle_report(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN,
+                            switch_pro_from_gamepad(&in, 9, out));
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_PRO_INPUT_ID, out[0]);
+    TEST_ASSERT_EQUAL_UINT8(9, out[1]);
+    TEST_ASSERT_EQUAL_HEX8(0, out[3]);
+    TEST_ASSERT_EQUAL_HEX8(0, out[4]);
+    TEST_ASSERT_EQUAL_HEX8(0, out[5]);
+    /* ~0 is -1, a hair off centre in 16 bits; centre in 12 */
+    TEST_ASSERT_UINT16_WITHIN(1, SWITCH_STICK_CENTER, stick_x(&out[6]));
+    TEST_ASSERT_UINT16_WITHIN(1, SWITCH_STICK_CENTER, stick_y(&out[6]));
+    TEST_ASSERT_UINT16_WITHIN(1, SWITCH_STICK_CENTER, stick_y(&out[9]));
+}
+
+void test_face_buttons_map_by_position(void)
+{
+    in.buttons = GAMEPAD_BTN_A;                 /* bottom */
+    switch_pro_from_gamepad(&in, 0, out);
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_BTN_B, out[3]);
+
+    in.buttons = GAMEPAD_BTN_B | GAMEPAD_BTN_X | GAMEPAD_BTN_Y;
+    switch_pro_from_gamepad(&in, 0, out);
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_BTN_A | SWITCH_BTN_Y | SWITCH_BTN_X, out[3]);
+}
+
+void test_shared_and_left_buttons(void)
+{
+    in.buttons = GAMEPAD_BTN_SELECT | GAMEPAD_BTN_START | GAMEPAD_BTN_GUIDE |
+                 GAMEPAD_BTN_MISC | GAMEPAD_BTN_L3 | GAMEPAD_BTN_L1;
+    in.dpad = GAMEPAD_DPAD_DOWN_LEFT;
+    switch_pro_from_gamepad(&in, 0, out);
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_BTN_MINUS | SWITCH_BTN_PLUS |
+                           SWITCH_BTN_HOME | SWITCH_BTN_CAPTURE |
+                           SWITCH_BTN_LSTICK, out[4]);
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_BTN_DOWN | SWITCH_BTN_LEFT | SWITCH_BTN_L,
+                           out[5]);
+}
+
+void test_triggers_become_zl_zr_past_threshold(void)
+{
+    in.lt = 255;
+    in.rt = 256;
+    switch_pro_from_gamepad(&in, 0, out);
+    TEST_ASSERT_EQUAL_HEX8(0, out[5] & SWITCH_BTN_ZL);
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_BTN_ZR, out[3] & SWITCH_BTN_ZR);
+}
+
+void test_sticks_full_scale_and_y_up(void)
+{
+    in.lx = 32767;
+    in.ly = -32768;                             /* full up */
+    in.rx = -32768;
+    in.ry = 32767;                              /* full down */
+    switch_pro_from_gamepad(&in, 0, out);
+    TEST_ASSERT_EQUAL_UINT16(SWITCH_STICK_CENTER + SWITCH_STICK_RANGE - 1,
+                             stick_x(&out[6]));
+    TEST_ASSERT_EQUAL_UINT16(SWITCH_STICK_CENTER + SWITCH_STICK_RANGE - 1,
+                             stick_y(&out[6]));
+    TEST_ASSERT_EQUAL_UINT16(SWITCH_STICK_CENTER - SWITCH_STICK_RANGE,
+                             stick_x(&out[9]));
+    TEST_ASSERT_EQUAL_UINT16(SWITCH_STICK_CENTER - SWITCH_STICK_RANGE,
+                             stick_y(&out[9]));
+}
+
+/* ── USB commands (0x80) ──────────────────────────────────────────────── */
+
+void test_usb_status_reply_carries_mac(void)
+{
+    req[0] = 0x80;
+    req[1] = 0x01;
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN, host(2));
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_PRO_USB_REPLY_ID, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, out[3]);       /* Pro Controller */
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[4]);       /* MAC, reversed */
+    TEST_ASSERT_EQUAL_HEX8(0x02, out[9]);
+    TEST_ASSERT_FALSE(has_output);
+}
+
+void test_usb_handshake_echoed(void)
+{
+    req[0] = 0x80;
+    req[1] = 0x02;
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN, host(2));
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_PRO_USB_REPLY_ID, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, out[1]);
+}
+
+void test_usb_only_mode_takes_no_reply(void)
+{
+    req[0] = 0x80;
+    req[1] = 0x04;
+    TEST_ASSERT_EQUAL_UINT8(0, host(2));
+    req[1] = 0x05;
+    TEST_ASSERT_EQUAL_UINT8(0, host(2));
+}
+
+/* ── Subcommands (0x01) ───────────────────────────────────────────────── */
+
+void test_device_info(void)
+{
+    subcmd(0x02);
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN, host(11));
+    TEST_ASSERT_EQUAL_HEX8(SWITCH_PRO_REPLY_ID, out[0]);
+    TEST_ASSERT_EQUAL_UINT8(7, out[1]);         /* timer */
+    TEST_ASSERT_EQUAL_HEX8(0x82, out[13]);      /* ack with data */
+    TEST_ASSERT_EQUAL_HEX8(0x02, out[14]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, out[17]);      /* Pro Controller */
+    TEST_ASSERT_EQUAL_HEX8(0x02, out[19]);      /* MAC, in order */
+}
+
+void test_spi_read_stick_calibration(void)
+{
+    static const uint8_t left[9] = {
+        0x00, 0x06, 0x60, 0x00, 0x08, 0x80, 0x00, 0x06, 0x60,
+    };
+    subcmd(0x10);
+    req[11] = 0x3D;                             /* address 0x603D */
+    req[12] = 0x60;
+    req[15] = 9;
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN, host(16));
+    TEST_ASSERT_EQUAL_HEX8(0x90, out[13]);
+    TEST_ASSERT_EQUAL_HEX8(0x10, out[14]);
+    TEST_ASSERT_EQUAL_HEX8(0x3D, out[15]);      /* address echoed */
+    TEST_ASSERT_EQUAL_HEX8(0x60, out[16]);
+    TEST_ASSERT_EQUAL_UINT8(9, out[19]);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(left, &out[20], sizeof(left));
+}
+
+void test_spi_read_unset_area_is_ff(void)
+{
+    uint8_t buf[8];
+    switch_pro_spi_read(0x8010, buf, sizeof(buf));      /* user calibration */
+    for (int i = 0; i < 8; i++)
+        TEST_ASSERT_EQUAL_HEX8(0xFF, buf[i]);
+}
+
+void test_spi_read_clamped_to_reply(void)
+{
+    subcmd(0x10);
+    req[11] = 0x20;
+    req[12] = 0x60;
+    req[15] = 0xFF;
+    host(16);
+    TEST_ASSERT_EQUAL_UINT8(0x1D, out[19]);
+}
+
+void test_short_spi_read_ignored(void)
+{
+    subcmd(0x10);
+    TEST_ASSERT_EQUAL_UINT8(0, host(12));
+}
+
+void test_player_lights(void)
+{
+    subcmd(0x30);
+    req[11] = 0x12;                             /* P2 on, P1 flashing */
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN, host(12));
+    TEST_ASSERT_TRUE(has_output);
+    TEST_ASSERT_EQUAL_HEX8(0x03, output.leds);
+    TEST_ASSERT_EQUAL_HEX8(0x80, out[13]);
+    TEST_ASSERT_EQUAL_HEX8(0x30, out[14]);
+}
+
+void test_other_subcommand_acknowledged(void)
+{
+    subcmd(0x03);                               /* set input mode */
+    req[11] = 0x30;
+    TEST_ASSERT_EQUAL_UINT8(SWITCH_PRO_REPORT_LEN, host(12));
+    TEST_ASSERT_EQUAL_HEX8(0x80, out[13]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, out[14]);
+}
+
+/* ── Rumble ───────────────────────────────────────────────────────────── */
+
+void test_rumble_only_report(void)
+{
+    req[0] = 0x10;
+    memcpy(&req[2], RUMBLE_OFF, 4);
+    memcpy(&req[6], RUMBLE_OFF, 4);
+    req[3] = 0xC8;                              /* left: full high band */
+    output.leds = 0x05;
+    TEST_ASSERT_EQUAL_UINT8(0, host(10));
+    TEST_ASSERT_TRUE(has_output);
+    TEST_ASSERT_EQUAL_UINT8(255, output.strong);
+    TEST_ASSERT_EQUAL_UINT8(0, output.weak);
+    TEST_ASSERT_EQUAL_HEX8(0x05, output.leds);  /* untouched */
+}
+
+void test_subcommand_report_carries_rumble(void)
+{
+    subcmd(0x48);
+    req[9] = 0x72;                              /* right: full low band */
+    host(12);
+    TEST_ASSERT_TRUE(has_output);
+    TEST_ASSERT_EQUAL_UINT8(0, output.strong);
+    TEST_ASSERT_EQUAL_UINT8(255, output.weak);
+}
+
+void test_unknown_report_ignored(void)
+{
+    req[0] = 0x11;
+    TEST_ASSERT_EQUAL_UINT8(0, host(SWITCH_PRO_REPORT_LEN));
+    TEST_ASSERT_FALSE(has_output);
+    TEST_ASSERT_EQUAL_UINT8(0, host(1));
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_idle_report);
+    RUN_TEST(test_face_buttons_map_by_position);
+    RUN_TEST(test_shared_and_left_buttons);
+    RUN_TEST(test_triggers_become_zl_zr_past_threshold);
+    RUN_TEST(test_sticks_full_scale_and_y_up);
+
+    RUN_TEST(test_usb_status_reply_carries_mac);
+    RUN_TEST(test_usb_handshake_echoed);
+    RUN_TEST(test_usb_only_mode_takes_no_reply);
+
+    RUN_TEST(test_device_info);
+    RUN_TEST(test_spi_read_stick_calibration);
+    RUN_TEST(test_spi_read_unset_area_is_ff);
+    RUN_TEST(test_spi_read_clamped_to_reply);
+    RUN_TEST(test_short_spi_read_ignored);
+    RUN_TEST(test_player_lights);
+    RUN_TEST(test_other_subcommand_acknowledged);
+
+    RUN_TEST(test_rumble_only_report);
+    RUN_TEST(test_subcommand_report_carries_rumble);
+    RUN_TEST(test_unknown_report_ignored);
+
+    return UNITY_END();
+}
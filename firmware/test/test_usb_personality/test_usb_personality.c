@@ -0,0 +1,275 @@
+#include "unity.h"
+#include "usb_personality.h"
+#include "device_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static gamepad_report_t idle;
+static uint8_t out[USB_REPORT_MAX];
+
+void setUp(void)
+{
+    memset(&idle, 0, sizeof(idle));
+    idle.dpad = GAMEPAD_DPAD_CENTERED;
+    memset(out, 0xEE, sizeof(out));
+}
+
+void tearDown(void)
+{
+}
+
+/* ── Report descriptor walker ─────────────────────────────────────────── */
+
+/* Bits per report ID and type, from the descriptor's main items */
+typedef struct {
+    uint32_t input[256];
+    uint32_t output[256];
+    uint32_t feature[256];
+    bool     has_ids;
+} desc_bits_t;
+
+static desc_bits_t bits;
+
+static void walk(const uint8_t *d, uint16_t len)
+{
+    uint32_t size = 0, count = 0;
+    uint8_t id = 0;
+
+    memset(&bits, 0, sizeof(bits));
+    for (uint16_t i = 0; i < len; ) {
+        uint8_t prefix = d[i];
+        uint8_t n = prefix & 0x03;
+        if (n == 3)
+            n = 4;
+        TEST_ASSERT_TRUE_MESSAGE(i + 1 + n <= len, "item runs past the end");
+
+        uint32_t v = 0;
+        for (uint8_t k = 0; k < n; k++)
+            v |= (uint32_t)d[i + 1 + k] << (8 * k);
+
+        switch (prefix & 0xFC) {
+        case 0x74: size  = v; break;                    /* Report Size  */
+        case 0x94: count = v; break;                    /* Report Count */
+        case 0x84: id = (uint8_t)v; bits.has_ids = true; break;
+        case 0x80: bits.input[id]   += size * count; break;
+        case 0x90: bits.output[id]  += size * count; break;
+        case 0xB0: bits.feature[id] += size * count; break;
+        default: break;
+        }
+        i = (uint16_t)(i + 1 + n);
+    }
+}
+
+/** The input report a converter produced matches the descriptor. */
+static void assert_input_matches(const usb_personality_t *p,
+                                 const uint8_t *r, uint8_t len)
+{
+    if (p->report_ids) {
+        TEST_ASSERT_NOT_EQUAL_MESSAGE(0, bits.input[r[0]], p->name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(bits.input[r[0]], (len - 1) * 8u,
+                                         p->name);
+    } else {
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(bits.input[0], len * 8u, p->name);
+    }
+}
+
+/* ── Table ────────────────────────────────────────────────────────────── */
+
+void test_every_mode_has_a_personality(void)
+{
+    for (uint16_t m = 0; m < USB_MODE_COUNT; m++) {
+        const usb_personality_t *p = usb_personality_get(m);
+        TEST_ASSERT_NOT_NULL(p->name);
+        TEST_ASSERT_NOT_NULL(p->manufacturer);
+        TEST_ASSERT_NOT_NULL(p->product);
+        TEST_ASSERT_TRUE(strlen(p->product) <= 31);
+        TEST_ASSERT_NOT_EQUAL(0, p->vid);
+        TEST_ASSERT_NOT_NULL(p->from_gamepad);
+        TEST_ASSERT_NOT_NULL(p->from_host);
+        TEST_ASSERT_EQUAL(p->raw_kind != BT_GAMEPAD_RAW_NONE,
+                          p->from_raw != NULL);
+        for (uint16_t k = 0; k < m; k++)
+            TEST_ASSERT_NOT_EQUAL(0, strcmp(p->name,
+                                            usb_personality_get(k)->name));
+    }
+}
+
+void test_out_of_range_mode_is_hid(void)
+{
+    TEST_ASSERT_EQUAL_PTR(usb_personality_get(USB_MODE_HID),
+                          usb_personality_get(USB_MODE_COUNT));
+    TEST_ASSERT_EQUAL_PTR(usb_personality_get(USB_MODE_HID),
+                          usb_personality_get(0xFFFF));
+}
+
+void test_default_config_is_hid(void)
+{
+    device_config_t cfg;
+    device_config_init(&cfg);
+    TEST_ASSERT_EQUAL_UINT16(USB_MODE_HID, cfg.usb_mode);
+}
+
+void test_only_hid_has_motion(void)
+{
+    for (uint16_t m = 0; m < USB_MODE_COUNT; m++)
+        TEST_ASSERT_EQUAL(m == USB_MODE_HID, usb_personality_get(m)->motion);
+}
+
+/* ── Reports agree with the descriptors ───────────────────────────────── */
+
+void test_input_reports_match_descriptor(void)
+{
+    for (uint16_t m = 0; m < USB_MODE_COUNT; m++) {
+        const usb_personality_t *p = usb_personality_get(m);
+        uint8_t len = p->from_gamepad(&idle, 0, out);
+        TEST_ASSERT_TRUE(len > 0 && len <= USB_REPORT_MAX);
+
+        if (!p->report_desc) {
+            /* XInput: the message states its own length */
+            TEST_ASSERT_EQUAL_UINT8(len, out[1]);
+            continue;
+        }
+        walk(p->report_desc, p->report_desc_len);
+        TEST_ASSERT_EQUAL_MESSAGE(p->report_ids, bits.has_ids, p->name);
+        assert_input_matches(p, out, len);
+    }
+}
+
+void test_feature_reports_match_descriptor(void)
+{
+    uint8_t buf[USB_REPORT_MAX];
+    for (uint16_t m = 0; m < USB_MODE_COUNT; m++) {
+        const usb_personality_t *p = usb_personality_get(m);
+        if (!p->report_desc)
+            continue;
+        walk(p->report_desc, p->report_desc_len);
+        for (int id = 0; id < 256; id++) {
+            if (!bits.feature[id])
+                continue;
+            TEST_ASSERT_NOT_NULL_MESSAGE(p->feature, p->name);
+            TEST_ASSERT_EQUAL_UINT16_MESSAGE(bits.feature[id] / 8,
+                                             p->feature((uint8_t)id, buf,
+                                                        sizeof(buf)),
+                                             p->name);
+        }
+    }
+}
+
+void test_replies_match_descriptor(void)
+{
+    /* Switch handshake: USB status request, then device info */
+    uint8_t status[2] = { 0x80, 0x01 };
+    uint8_t info[USB_REPORT_MAX] = { 0x01 };
+    info[10] = 0x02;
+
+    for (uint16_t m = 0; m < USB_MODE_COUNT; m++) {
+        const usb_personality_t *p = usb_personality_get(m);
+        if (!p->report_desc)
+            continue;
+        walk(p->report_desc, p->report_desc_len);
+
+        usb_host_result_t res;
+        memset(&res, 0, sizeof(res));
+        p->from_host(status, sizeof(status), 0, &res);
+        if (res.reply_len)
+            assert_input_matches(p, res.reply, res.reply_len);
+
+        memset(&res, 0, sizeof(res));
+        p->from_host(info, sizeof(info), 0, &res);
+        if (res.reply_len)
+            assert_input_matches(p, res.reply, res.reply_len);
+    }
+}
+
+void test_raw_ds4_report_matches_descriptor(void)
+{
+    const usb_personality_t *p = usb_personality_get(USB_MODE_DS4);
+    bt_gamepad_raw_t raw;
+    memset(&raw, 0, sizeof(raw));
+    raw.kind    = BT_GAMEPAD_RAW_DS4;
+    raw.len     = BT_GAMEPAD_RAW_MAX;
+    raw.data[0] = 0x11;
+    raw.data[4] = 0x42;
+
+    uint8_t len = p->from_raw(&raw, out);
+    walk(p->report_desc, p->report_desc_len);
+    assert_input_matches(p, out, len);
+    TEST_ASSERT_EQUAL_HEX8(0x42, out[2]);
+
+    raw.data[0] = 0x12;
+    TEST_ASSERT_EQUAL_UINT8(0, p->from_raw(&raw, out));
+}
+
+/* ── Host output reaches the controller ───────────────────────────────── */
+
+void test_each_mode_decodes_rumble(void)
+{
+    static const struct {
+        uint16_t mode;
+        uint8_t  len;
+        uint8_t  msg[12];
+    } cases[] = {
+        { USB_MODE_HID,    3, { 200, 0, 0 } },
+        { USB_MODE_XINPUT, 8, { 0x00, 0x08, 0x00, 200, 0 } },
+        { USB_MODE_DS4,   12, { 0x05, 0x01, 0, 0, 0, 200 } },
+        { USB_MODE_SWITCH, 10, { 0x10, 0, 0x00, 0xC8, 0x40, 0x40,
+                                 0x00, 0x01, 0x40, 0x40 } },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        usb_host_result_t res;
+        memset(&res, 0, sizeof(res));
+        usb_personality_get(cases[i].mode)->from_host(cases[i].msg,
+                                                      cases[i].len, 0, &res);
+        TEST_ASSERT_TRUE(res.has_output);
+        TEST_ASSERT_TRUE(res.output.strong >= 200);
+    }
+}
+
+/* ── Benchmark ────────────────────────────────────────────────────────── */
+
+void test_benchmark_from_gamepad(void)
+{
+    const int n = 1000000;
+    for (uint16_t m = 0; m < USB_MODE_COUNT; m++) {
+        const usb_personality_t *p = usb_personality_get(m);
+        gamepad_report_t r = idle;
+        uint32_t check = 0;
+
+        clock_t start = clock();
+        for (int i = 0; i < n; i++) {
+            r.lx = (int16_t)i;
+            r.buttons = (uint16_t)i;
+            check += p->from_gamepad(&r, (uint8_t)i, out);
+            check += out[2];
+        }
+        double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+
+        printf("%-6s from_gamepad: %.1f ns per report (host)\n", p->name, ns);
+        TEST_ASSERT_NOT_EQUAL(0, check);
+    }
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_every_mode_has_a_personality);
+    RUN_TEST(test_out_of_range_mode_is_hid);
+    RUN_TEST(test_default_config_is_hid);
+    RUN_TEST(test_only_hid_has_motion);
+
+    RUN_TEST(test_input_reports_match_descriptor);
+    RUN_TEST(test_feature_reports_match_descriptor);
+    RUN_TEST(test_replies_match_descriptor);
+    RUN_TEST(test_raw_ds4_report_matches_descriptor);
+
+    RUN_TEST(test_each_mode_decodes_rumble);
+
+    RUN_TEST(test_benchmark_from_gamepad);
+
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+#include "unity.h"
+#include "usb_report_pipe.h"
+
+#include <string.h>
+
+static usb_report_pipe_t p;
+
+void setUp(void)
+{
+    memset(&p, 0, sizeof(p));
+}
+
+void tearDown(void)
+{
+}
+
+/* A wire report whose first byte stands in for the left stick */
+static usb_report_t rep(int8_t lx, uint16_t buttons)
+{
+    usb_report_t r;
+    memset(&r, 0, sizeof(r));
+    r.data[0] = (uint8_t)lx;
+    r.len     = 1;
+    r.buttons = buttons;
+    r.dpad    = GAMEPAD_DPAD_CENTERED;
+    return r;
+}
+
+static int8_t lx_of(const usb_report_t *r)
+{
+    return (int8_t)r->data[0];
+}
+
+/* ── Submission ───────────────────────────────────────────────────────── */
+
+void test_idle_pipe_submits_immediately(void)
+{
+    usb_report_t r = rep(1, 0), out;
+    TEST_ASSERT_TRUE(usb_report_pipe_push(&p, &r));
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_INT8(1, lx_of(&out));
+    TEST_ASSERT_FALSE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_UINT32(1, p.submitted);
+    TEST_ASSERT_EQUAL_UINT32(0, p.deferred);
+}
+
+void test_busy_endpoint_defers_until_complete(void)
+{
+    usb_report_t a = rep(1, 0), b = rep(2, 0), out;
+    usb_report_pipe_push(&p, &a);
+    usb_report_pipe_next(&p, &out);
+
+    TEST_ASSERT_TRUE(usb_report_pipe_push(&p, &b));
+    TEST_ASSERT_FALSE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_UINT32(1, p.deferred);
+
+    TEST_ASSERT_FALSE(usb_report_pipe_complete(&p));
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_INT8(2, lx_of(&out));
+}
+
+void test_newest_axis_update_replaces_waiting(void)
+{
+    usb_report_t out;
+    usb_report_t a = rep(1, 0), b = rep(2, 0), c = rep(3, 0);
+    usb_report_pipe_push(&p, &a);
+    usb_report_pipe_next(&p, &out);
+    usb_report_pipe_push(&p, &b);
+    TEST_ASSERT_TRUE(usb_report_pipe_push(&p, &c));
+    TEST_ASSERT_EQUAL_UINT32(1, p.replaced);
+
+    usb_report_pipe_complete(&p);
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_INT8(3, lx_of(&out));
+}
+
+/* ── Button changes are never overwritten ─────────────────────────────── */
+
+void test_button_change_not_overwritten(void)
+{
+    usb_report_t out;
+    usb_report_t a = rep(0, 0);
+    usb_report_t tap = rep(0, 1);
+    usb_report_t up = rep(5, 0);
+
+    usb_report_pipe_push(&p, &a);
+    usb_report_pipe_next(&p, &out);
+    usb_report_pipe_push(&p, &tap);
+
+    TEST_ASSERT_FALSE(usb_report_pipe_push(&p, &up));
+    TEST_ASSERT_EQUAL_UINT32(1, p.refusals);
+
+    /* Completion submits the tap and asks the producer to retry */
+    TEST_ASSERT_TRUE(usb_report_pipe_complete(&p));
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_UINT16(1, out.buttons);
+
+    TEST_ASSERT_TRUE(usb_report_pipe_push(&p, &up));
+    TEST_ASSERT_FALSE(usb_report_pipe_complete(&p));
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_UINT16(0, out.buttons);
+    TEST_ASSERT_EQUAL_INT8(5, lx_of(&out));
+}
+
+void test_hat_change_not_overwritten(void)
+{
+    usb_report_t out;
+    usb_report_t a = rep(0, 0), b = rep(0, 0);
+    usb_report_pipe_push(&p, &a);
+    usb_report_pipe_next(&p, &out);
+    a.dpad = GAMEPAD_DPAD_UP;
+    usb_report_pipe_push(&p, &a);
+    TEST_ASSERT_FALSE(usb_report_pipe_push(&p, &b));
+}
+
+/* ── Stack rejections ─────────────────────────────────────────────────── */
+
+void test_rejected_submission_retried(void)
+{
+    usb_report_t r = rep(7, 0), out;
+    usb_report_pipe_push(&p, &r);
+    usb_report_pipe_next(&p, &out);
+    usb_report_pipe_failed(&p, &out);
+
+    TEST_ASSERT_EQUAL_UINT32(1, p.retries);
+    TEST_ASSERT_EQUAL_UINT32(0, p.submitted);
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_EQUAL_INT8(7, lx_of(&out));
+}
+
+void test_reset_empties_pipe(void)
+{
+    usb_report_t r = rep(1, 0), out;
+    usb_report_pipe_push(&p, &r);
+    usb_report_pipe_next(&p, &out);
+    usb_report_pipe_push(&p, &r);
+    usb_report_pipe_reset(&p);
+
+    TEST_ASSERT_FALSE(usb_report_pipe_next(&p, &out));
+    TEST_ASSERT_TRUE(usb_report_pipe_push(&p, &r));
+    TEST_ASSERT_TRUE(usb_report_pipe_next(&p, &out));
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_idle_pipe_submits_immediately);
+    RUN_TEST(test_busy_endpoint_defers_until_complete);
+    RUN_TEST(test_newest_axis_update_replaces_waiting);
+
+    RUN_TEST(test_button_change_not_overwritten);
+    RUN_TEST(test_hat_change_not_overwritten);
+
+    RUN_TEST(test_rejected_submission_retried);
+    RUN_TEST(test_reset_empties_pipe);
+
+    return UNITY_END();
+}
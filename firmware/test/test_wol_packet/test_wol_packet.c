@@ -0,0 +1,125 @@
+#include "unity.h"
+#include "wol_packet.h"
+#include <string.h>
+
+static const uint8_t MAC[WOL_MAC_LEN] = { 0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E };
+
+void setUp(void) { }
+void tearDown(void) { }
+
+/* ── MAC parsing ─────────────────────────────────────────────────────── */
+
+void test_parse_colon_separated(void)
+{
+    uint8_t mac[WOL_MAC_LEN];
+    TEST_ASSERT_TRUE(wol_parse_mac("00:1a:2b:3c:4d:5e", mac));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(MAC, mac, WOL_MAC_LEN);
+}
+
+void test_parse_dash_separated_upper_case(void)
+{
+    uint8_t mac[WOL_MAC_LEN];
+    TEST_ASSERT_TRUE(wol_parse_mac("00-1A-2B-3C-4D-5E", mac));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(MAC, mac, WOL_MAC_LEN);
+}
+
+void test_parse_bare_hex(void)
+{
+    uint8_t mac[WOL_MAC_LEN];
+    TEST_ASSERT_TRUE(wol_parse_mac("001a2b3c4d5e", mac));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(MAC, mac, WOL_MAC_LEN);
+}
+
+void test_parse_validate_only(void)
+{
+    TEST_ASSERT_TRUE(wol_parse_mac("00:1a:2b:3c:4d:5e", NULL));
+}
+
+void test_parse_rejects_malformed(void)
+{
+    const char *bad[] = {
+        "",
+        "00:1a:2b:3c:4d",           /* too short        */
+        "00:1a:2b:3c:4d:5e:6f",     /* too long         */
+        "00:1a-2b:3c:4d:5e",        /* mixed separators */
+        "00.1a.2b.3c.4d.5e",        /* unknown separator */
+        "00:1a:2b:3c:4d:5g",        /* not hex          */
+        "001a2b3c4d5",              /* odd digit count  */
+        "0:01a:2b:3c:4d:5e",        /* misplaced sep    */
+    };
+    for (int i = 0; i < (int)(sizeof(bad) / sizeof(bad[0])); i++)
+        TEST_ASSERT_FALSE_MESSAGE(wol_parse_mac(bad[i], NULL), bad[i]);
+    TEST_ASSERT_FALSE(wol_parse_mac(NULL, NULL));
+}
+
+void test_parse_rejects_non_unicast(void)
+{
+    TEST_ASSERT_FALSE(wol_parse_mac("00:00:00:00:00:00", NULL));
+    TEST_ASSERT_FALSE(wol_parse_mac("ff:ff:ff:ff:ff:ff", NULL));
+    TEST_ASSERT_FALSE(wol_parse_mac("01:00:5e:00:00:01", NULL));
+}
+
+void test_parse_failure_leaves_output_unchanged(void)
+{
+    uint8_t mac[WOL_MAC_LEN] = { 1, 2, 3, 4, 5, 6 };
+    TEST_ASSERT_FALSE(wol_parse_mac("00:1a:2b:3c:4d:zz", mac));
+    const uint8_t expect[WOL_MAC_LEN] = { 1, 2, 3, 4, 5, 6 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, mac, WOL_MAC_LEN);
+}
+
+/* ── Packet ──────────────────────────────────────────────────────────── */
+
+void test_packet_size_is_102(void)
+{
+    TEST_ASSERT_EQUAL(102, WOL_PACKET_SIZE);
+}
+
+void test_packet_starts_with_sync_stream(void)
+{
+    uint8_t pkt[WOL_PACKET_SIZE];
+    wol_packet_build(MAC, pkt);
+    for (int i = 0; i < 6; i++)
+        TEST_ASSERT_EQUAL_HEX8(0xFF, pkt[i]);
+}
+
+void test_packet_repeats_mac_sixteen_times(void)
+{
+    uint8_t pkt[WOL_PACKET_SIZE];
+    memset(pkt, 0xAA, sizeof(pkt));
+    wol_packet_build(MAC, pkt);
+    for (int i = 0; i < 16; i++)
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(MAC, pkt + 6 + i * WOL_MAC_LEN, WOL_MAC_LEN);
+}
+
+void test_packet_from_parsed_string(void)
+{
+    uint8_t mac[WOL_MAC_LEN], a[WOL_PACKET_SIZE], b[WOL_PACKET_SIZE];
+    TEST_ASSERT_TRUE(wol_parse_mac("00-1a-2b-3c-4d-5e", mac));
+    wol_packet_build(mac, a);
+    wol_packet_build(MAC, b);
+    TEST_ASSERT_EQUAL_MEMORY(b, a, WOL_PACKET_SIZE);
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    /* MAC parsing */
+    RUN_TEST(test_parse_colon_separated);
+    RUN_TEST(test_parse_dash_separated_upper_case);
+    RUN_TEST(test_parse_bare_hex);
+    RUN_TEST(test_parse_validate_only);
+    RUN_TEST(test_parse_rejects_malformed);
+    RUN_TEST(test_parse_rejects_non_unicast);
+    RUN_TEST(test_parse_failure_leaves_output_unchanged);
+
+    /* Packet */
+    RUN_TEST(test_packet_size_is_102);
+    RUN_TEST(test_packet_starts_with_sync_stream);
+    RUN_TEST(test_packet_repeats_mac_sixteen_times);
+    RUN_TEST(test_packet_from_parsed_string);
+
+    return UNITY_END();
+}
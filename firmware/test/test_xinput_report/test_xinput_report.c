@@ -0,0 +1,157 @@
+#include "unity.h"
+#include "xinput_report.h"
+
+#include <string.h>
+
+static uint8_t out[XINPUT_REPORT_LEN];
+static gamepad_report_t in;
+
+void setUp(void)
+{
+    memset(out, 0xEE, sizeof(out));
+    memset(&in, 0, sizeof(in));
+    in.dpad = GAMEPAD_DPAD_CENTERED;
+}
+
+void tearDown(void)
+{
+}
+
+static uint16_t le16(int off)
+{
+    return (uint16_t)(out[off] | out[off + 1] << 8);
+}
+
+/* ── Input message ────────────────────────────────────────────────────── */
+
+void test_idle_message(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(XINPUT_REPORT_LEN,
+                            xinput_report_from_gamepad(&in, out));
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(XINPUT_REPORT_LEN, out[1]);
+    for (int i = 2; i < XINPUT_REPORT_LEN; i++)
+        TEST_ASSERT_EQUAL_HEX8(0, out[i]);
+}
+
+void test_buttons_map(void)
+{
+    in.buttons = GAMEPAD_BTN_A | GAMEPAD_BTN_B | GAMEPAD_BTN_X |
+                 GAMEPAD_BTN_Y | GAMEPAD_BTN_L1 | GAMEPAD_BTN_R1 |
+                 GAMEPAD_BTN_SELECT | GAMEPAD_BTN_START |
+                 GAMEPAD_BTN_L3 | GAMEPAD_BTN_R3 | GAMEPAD_BTN_GUIDE;
+    xinput_report_from_gamepad(&in, out);
+    TEST_ASSERT_EQUAL_HEX16(XINPUT_BTN_A | XINPUT_BTN_B | XINPUT_BTN_X |
+                            XINPUT_BTN_Y | XINPUT_BTN_LB | XINPUT_BTN_RB |
+                            XINPUT_BTN_BACK | XINPUT_BTN_START |
+                            XINPUT_BTN_LS | XINPUT_BTN_RS | XINPUT_BTN_GUIDE,
+                            le16(2));
+}
+
+void test_misc_button_has_no_xinput_bit(void)
+{
+    in.buttons = GAMEPAD_BTN_MISC;
+    xinput_report_from_gamepad(&in, out);
+    TEST_ASSERT_EQUAL_HEX16(0, le16(2));
+}
+
+void test_dpad_directions(void)
+{
+    static const uint16_t expect[9] = {
+        XINPUT_BTN_UP, XINPUT_BTN_UP | XINPUT_BTN_RIGHT, XINPUT_BTN_RIGHT,
+        XINPUT_BTN_DOWN | XINPUT_BTN_RIGHT, XINPUT_BTN_DOWN,
+        XINPUT_BTN_DOWN | XINPUT_BTN_LEFT, XINPUT_BTN_LEFT,
+        XINPUT_BTN_UP | XINPUT_BTN_LEFT, 0,
+    };
+    for (uint8_t d = 0; d <= GAMEPAD_DPAD_CENTERED; d++) {
+        in.dpad = d;
+        xinput_report_from_gamepad(&in, out);
+        TEST_ASSERT_EQUAL_HEX16(expect[d], le16(2));
+    }
+}
+
+void test_sticks_y_flipped_and_saturated(void)
+{
+    in.lx = -32768;
+    in.ly = -32768;     /* full up */
+    in.rx = 1234;
+    in.ry = 32767;      /* full down */
+    xinput_report_from_gamepad(&in, out);
+    TEST_ASSERT_EQUAL_INT16(-32768, (int16_t)le16(6));
+    TEST_ASSERT_EQUAL_INT16(32767, (int16_t)le16(8));
+    TEST_ASSERT_EQUAL_INT16(1234, (int16_t)le16(10));
+    TEST_ASSERT_EQUAL_INT16(-32767, (int16_t)le16(12));
+}
+
+void test_triggers_scaled_to_8_bit(void)
+{
+    in.lt = 1023;
+    in.rt = 4;
+    xinput_report_from_gamepad(&in, out);
+    TEST_ASSERT_EQUAL_UINT8(255, out[4]);
+    TEST_ASSERT_EQUAL_UINT8(1, out[5]);
+}
+
+/* ── Output messages ──────────────────────────────────────────────────── */
+
+void test_rumble_message(void)
+{
+    const uint8_t msg[8] = { 0x00, 0x08, 0x00, 200, 50, 0, 0, 0 };
+    gamepad_output_t o = { 0, 0, 0x04 };
+    TEST_ASSERT_TRUE(xinput_report_to_output(msg, sizeof(msg), &o));
+    TEST_ASSERT_EQUAL_UINT8(200, o.strong);
+    TEST_ASSERT_EQUAL_UINT8(50, o.weak);
+    TEST_ASSERT_EQUAL_HEX8(0x04, o.leds);       /* untouched */
+}
+
+void test_led_message_names_player(void)
+{
+    uint8_t msg[3] = { 0x01, 0x03, 0x02 };
+    gamepad_output_t o = { 10, 20, 0 };
+
+    TEST_ASSERT_TRUE(xinput_report_to_output(msg, sizeof(msg), &o));
+    TEST_ASSERT_EQUAL_HEX8(GAMEPAD_LED_PLAYER(1), o.leds);
+    TEST_ASSERT_EQUAL_UINT8(10, o.strong);      /* untouched */
+
+    msg[2] = 0x09;
+    TEST_ASSERT_TRUE(xinput_report_to_output(msg, sizeof(msg), &o));
+    TEST_ASSERT_EQUAL_HEX8(GAMEPAD_LED_PLAYER(4), o.leds);
+}
+
+void test_led_animation_without_player_ignored(void)
+{
+    const uint8_t msg[3] = { 0x01, 0x03, 0x0A };   /* rotate */
+    gamepad_output_t o = { 0, 0, 0x01 };
+    TEST_ASSERT_FALSE(xinput_report_to_output(msg, sizeof(msg), &o));
+    TEST_ASSERT_EQUAL_HEX8(0x01, o.leds);
+}
+
+void test_short_or_unknown_message_ignored(void)
+{
+    const uint8_t rumble[4] = { 0x00, 0x08, 0x00, 200 };
+    const uint8_t other[8]  = { 0x02, 0x08 };
+    gamepad_output_t o = { 0, 0, 0 };
+    TEST_ASSERT_FALSE(xinput_report_to_output(rumble, sizeof(rumble), &o));
+    TEST_ASSERT_FALSE(xinput_report_to_output(other, sizeof(other), &o));
+}
+
+/* ── Test runner ──────────────────────────────────────────────────────── */
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_idle_message);
+    RUN_TEST(test_buttons_map);
+    RUN_TEST(test_misc_button_has_no_xinput_bit);
+    RUN_TEST(test_dpad_directions);
+    RUN_TEST(test_sticks_y_flipped_and_saturated);
+    RUN_TEST(test_triggers_scaled_to_8_bit);
+
+    RUN_TEST(test_rumble_message);
+    RUN_TEST(test_led_message_names_player);
+    RUN_TEST(test_led_animation_without_player_ignored);
+    RUN_TEST(test_short_or_unknown_message_ignored);
+
+    return UNITY_END();
+}